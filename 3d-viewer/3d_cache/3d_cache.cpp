@@ -25,12 +25,15 @@
 #define GLM_FORCE_RADIANS
 
 #include <mutex>
+#include <set>
 #include <utility>
 
 #include <wx/datetime.h>
 #include <wx/dir.h>
+#include <wx/ffile.h>
 #include <wx/log.h>
 #include <wx/stdpaths.h>
+#include <wx/tokenzr.h>
 
 #include <boost/version.hpp>
 
@@ -42,6 +45,7 @@
 
 #include "3d_cache.h"
 #include "3d_info.h"
+#include "3d_mesh_cache.h"
 #include "3d_plugin_manager.h"
 #include "sg/scenegraph.h"
 #include "plugins/3dapi/ifsg_api.h"
@@ -54,13 +58,21 @@
 #include <project.h>
 #include <settings/common_settings.h>
 #include <settings/settings_manager.h>
+#include <thread_pool.h>
 #include <wx_filename.h>
 
 
 #define MASK_3D_CACHE "3D_CACHE"
 
+/// File of the model file signatures, in the cache directory
+#define FILE_SIGNATURES_FILENAME wxT( "3dc_signatures.txt" )
+
 static std::mutex mutex3D_cache;
 static std::mutex mutex3D_cacheManager;
+static std::mutex mutex3D_signatures;
+
+// The plugins and the scene graph writer use global state
+static std::mutex mutex3D_plugins;
 
 
 static bool isSHA1Same( const unsigned char* shaA, const unsigned char* shaB ) noexcept
@@ -75,14 +87,24 @@ static bool isSHA1Same( const unsigned char* shaA, const unsigned char* shaB ) n
 }
 
 
-static bool checkTag( const char* aTag, void* aPluginMgrPtr )
+/// The plugin tag check of a cache file read, which keeps the tag of the file
+struct S3D_TAG_CHECK
 {
-    if( nullptr == aTag || nullptr == aPluginMgrPtr )
+    S3D_PLUGIN_MANAGER* m_Plugins;
+    std::string         m_Tag;
+};
+
+
+static bool checkTag( const char* aTag, void* aTagCheckPtr )
+{
+    if( nullptr == aTag || nullptr == aTagCheckPtr )
         return false;
 
-    S3D_PLUGIN_MANAGER *pp = (S3D_PLUGIN_MANAGER*) aPluginMgrPtr;
+    S3D_TAG_CHECK* tagCheck = static_cast<S3D_TAG_CHECK*>( aTagCheckPtr );
+
+    tagCheck->m_Tag = aTag;
 
-    return pp->CheckTag( aTag );
+    return tagCheck->m_Plugins->CheckTag( aTag );
 }
 
 
@@ -120,6 +142,25 @@ static const wxString sha1ToWXString( const unsigned char* aSHA1Sum )
 }
 
 
+static bool wxStringToSha1( const wxString& aText, unsigned char* aSHA1Sum )
+{
+    if( aText.length() != 40 )
+        return false;
+
+    for( int i = 0; i < 20; ++i )
+    {
+        unsigned long byte;
+
+        if( !aText.Mid( i * 2, 2 ).ToULong( &byte, 16 ) )
+            return false;
+
+        aSHA1Sum[i] = static_cast<unsigned char>( byte );
+    }
+
+    return true;
+}
+
+
 class S3D_CACHE_ENTRY
 {
 public:
@@ -130,10 +171,16 @@ public:
     const wxString GetCacheBaseName();
 
     wxDateTime    modTime;      // file modification time
+    wxULongLong   fileSize;
     unsigned char sha1sum[20];
     std::string   pluginInfo;   // PluginName:Version string
     SCENEGRAPH*   sceneData;
     S3DMODEL*     renderData;
+    bool          hashed;       // the modification time, size and SHA1 digest are set
+    bool          loaded;       // the scene data was loaded, or could not be loaded
+
+    // serializes the loading of this entry, the other entries can be loaded concurrently
+    std::mutex    mutex;
 
 private:
     // prohibit assignment and default copy constructor
@@ -148,6 +195,8 @@ S3D_CACHE_ENTRY::S3D_CACHE_ENTRY()
 {
     sceneData = nullptr;
     renderData = nullptr;
+    hashed = false;
+    loaded = false;
     memset( sha1sum, 0, 20 );
 }
 
@@ -172,6 +221,7 @@ void S3D_CACHE_ENTRY::SetSHA1( const unsigned char* aSHA1Sum )
     }
 
     memcpy( sha1sum, aSHA1Sum, 20 );
+    m_CacheBaseName.clear();
 }
 
 
@@ -189,12 +239,14 @@ S3D_CACHE::S3D_CACHE()
     m_FNResolver = new FILENAME_RESOLVER;
     m_project = nullptr;
     m_Plugins = new S3D_PLUGIN_MANAGER;
+    m_FileSignaturesModified = false;
 }
 
 
 S3D_CACHE::~S3D_CACHE()
 {
     FlushCache();
+    saveFileSignatures();
 
     // We'll delete ".3dc" cache files older than this many days
     int clearCacheInterval = 0;
@@ -212,15 +264,12 @@ S3D_CACHE::~S3D_CACHE()
 }
 
 
-SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, const wxString& aBasePath,
-                             S3D_CACHE_ENTRY** aCachePtr )
+S3D_CACHE_ENTRY* S3D_CACHE::getEntry( const wxString& aModelFile, const wxString& aBasePath,
+                                      wxString& aFullPath )
 {
-    if( aCachePtr )
-        *aCachePtr = nullptr;
-
-    wxString full3Dpath = m_FNResolver->ResolvePath( aModelFile, aBasePath );
+    aFullPath = m_FNResolver->ResolvePath( aModelFile, aBasePath );
 
-    if( full3Dpath.empty() )
+    if( aFullPath.empty() )
     {
         // the model cannot be found; we cannot proceed
         wxLogTrace( MASK_3D_CACHE, wxT( "%s:%s:%d\n * [3D model] could not find model '%s'\n" ),
@@ -228,58 +277,43 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, const wxString& aBasePa
         return nullptr;
     }
 
-    // check cache if file is already loaded
     std::lock_guard<std::mutex> lock( mutex3D_cache );
 
-    std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString >::iterator mi;
-    mi = m_CacheMap.find( full3Dpath );
+    auto mi = m_CacheMap.find( aFullPath );
 
     if( mi != m_CacheMap.end() )
-    {
-        wxFileName fname( full3Dpath );
+        return mi->second;
 
-        if( fname.FileExists() )    // Only check if file exists. If not, it will
-        {                           // use the same model in cache.
-            bool       reload = ADVANCED_CFG::GetCfg().m_Skip3DModelMemoryCache;
-            wxDateTime fmdate = fname.GetModificationTime();
+    // a cache item does not exist; create it, it is loaded by the caller
+    S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
+    m_CacheList.push_back( ep );
+    m_CacheMap.emplace( aFullPath, ep );
 
-            if( fmdate != mi->second->modTime )
-            {
-                unsigned char hashSum[20];
-                getSHA1( full3Dpath, hashSum );
-                mi->second->modTime = fmdate;
+    return ep;
+}
 
-                if( !isSHA1Same( hashSum, mi->second->sha1sum ) )
-                {
-                    mi->second->SetSHA1( hashSum );
-                    reload = true;
-                }
-            }
 
-            if( reload )
-            {
-                if( nullptr != mi->second->sceneData )
-                {
-                    S3D::DestroyNode( mi->second->sceneData );
-                    mi->second->sceneData = nullptr;
-                }
+SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, const wxString& aBasePath,
+                             S3D_CACHE_ENTRY** aCachePtr )
+{
+    if( aCachePtr )
+        *aCachePtr = nullptr;
 
-                if( nullptr != mi->second->renderData )
-                    S3D::Destroy3DModel( &mi->second->renderData );
+    wxString         full3Dpath;
+    S3D_CACHE_ENTRY* ep = getEntry( aModelFile, aBasePath, full3Dpath );
 
-                mi->second->sceneData = m_Plugins->Load3DModel( full3Dpath,
-                                                                mi->second->pluginInfo );
-            }
-        }
+    if( !ep )
+        return nullptr;
 
-        if( nullptr != aCachePtr )
-            *aCachePtr = mi->second;
+    // The cache lock is released, so the other models can be loaded at the same time
+    std::lock_guard<std::mutex> entryLock( ep->mutex );
 
-        return mi->second->sceneData;
-    }
+    if( aCachePtr )
+        *aCachePtr = ep;
 
-    // a cache item does not exist; search the Filename->Cachename map
-    return checkCache( full3Dpath, aCachePtr );
+    checkModified( full3Dpath, ep );
+
+    return loadScene( full3Dpath, ep );
 }
 
 
@@ -289,70 +323,235 @@ SCENEGRAPH* S3D_CACHE::Load( const wxString& aModelFile, const wxString& aBasePa
 }
 
 
-SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr )
+void S3D_CACHE::checkModified( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem )
 {
-    if( aCachePtr )
-        *aCachePtr = nullptr;
+    if( !aCacheItem->hashed )
+        return;
 
-    unsigned char    sha1sum[20];
-    S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-    m_CacheList.push_back( ep );
     wxFileName fname( aFileName );
-    ep->modTime = fname.GetModificationTime();
 
-    if( !getSHA1( aFileName, sha1sum ) || m_CacheDir.empty() )
+    if( !fname.FileExists() )   // Only check if file exists. If not, it will
+        return;                 // use the same model in cache.
+
+    bool        reload = ADVANCED_CFG::GetCfg().m_Skip3DModelMemoryCache;
+    wxDateTime  fmdate = fname.GetModificationTime();
+    wxULongLong fsize = fname.GetSize();
+
+    if( fmdate != aCacheItem->modTime || fsize != aCacheItem->fileSize )
     {
-        // just in case we can't get a hash digest (for example, on access issues)
-        // or we do not have a configured cache file directory, we create an
-        // entry to prevent further attempts at loading the file
+        unsigned char hashSum[20];
 
-        if( m_CacheMap.emplace( aFileName, ep ).second == false )
-        {
-            wxLogTrace( MASK_3D_CACHE,
-                        wxT( "%s:%s:%d\n * [BUG] duplicate entry in map file; key = '%s'" ),
-                        __FILE__, __FUNCTION__, __LINE__, aFileName );
+        aCacheItem->modTime = fmdate;
+        aCacheItem->fileSize = fsize;
 
-            m_CacheList.pop_back();
-            delete ep;
+        if( getFileSignature( aFileName, fmdate, fsize.GetValue(), hashSum )
+            && !isSHA1Same( hashSum, aCacheItem->sha1sum ) )
+        {
+            aCacheItem->SetSHA1( hashSum );
+            reload = true;
         }
-        else
+    }
+
+    if( reload )
+    {
+        if( nullptr != aCacheItem->sceneData )
         {
-            if( aCachePtr )
-                *aCachePtr = ep;
+            S3D::DestroyNode( aCacheItem->sceneData );
+            aCacheItem->sceneData = nullptr;
         }
 
-        return nullptr;
+        if( nullptr != aCacheItem->renderData )
+            S3D::Destroy3DModel( &aCacheItem->renderData );
+
+        aCacheItem->loaded = false;
     }
+}
+
+
+bool S3D_CACHE::hashEntry( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( aCacheItem->hashed )
+        return true;
+
+    unsigned char sha1sum[20];
+    wxFileName    fname( aFileName );
 
-    if( m_CacheMap.emplace( aFileName, ep ).second == false )
+    aCacheItem->modTime = fname.GetModificationTime();
+    aCacheItem->fileSize = fname.GetSize();
+
+    if( !getFileSignature( aFileName, aCacheItem->modTime, aCacheItem->fileSize.GetValue(),
+                           sha1sum )
+        || m_CacheDir.empty() )
     {
-        wxLogTrace( MASK_3D_CACHE,
-                    wxT( "%s:%s:%d\n * [BUG] duplicate entry in map file; key = '%s'" ),
-                    __FILE__, __FUNCTION__, __LINE__, aFileName );
+        return false;
+    }
+
+    aCacheItem->SetSHA1( sha1sum );
+    aCacheItem->hashed = true;
 
-        m_CacheList.pop_back();
-        delete ep;
+    return true;
+}
+
+
+SCENEGRAPH* S3D_CACHE::loadScene( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( aCacheItem->loaded )
+        return aCacheItem->sceneData;
+
+    // just in case we can't get a hash digest (for example, on access issues)
+    // or we do not have a configured cache file directory, we keep an empty
+    // entry to prevent further attempts at loading the file
+    aCacheItem->loaded = true;
+
+    if( !hashEntry( aFileName, aCacheItem ) )
         return nullptr;
-    }
 
-    if( aCachePtr )
-        *aCachePtr = ep;
+    return checkCache( aFileName, aCacheItem );
+}
 
-    ep->SetSHA1( sha1sum );
 
-    wxString bname = ep->GetCacheBaseName();
+SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem )
+{
+    wxString bname = aCacheItem->GetCacheBaseName();
     wxString cachename = m_CacheDir + bname + wxT( ".3dc" );
 
     if( !ADVANCED_CFG::GetCfg().m_Skip3DModelFileCache && wxFileName::FileExists( cachename )
-        && loadCacheData( ep ) )
-        return ep->sceneData;
+        && loadCacheData( aCacheItem ) )
+        return aCacheItem->sceneData;
+
+    loadFromPlugin( aFileName, aCacheItem );
 
-    ep->sceneData = m_Plugins->Load3DModel( aFileName, ep->pluginInfo );
+    return aCacheItem->sceneData;
+}
 
-    if( !ADVANCED_CFG::GetCfg().m_Skip3DModelFileCache && nullptr != ep->sceneData )
-        saveCacheData( ep );
 
-    return ep->sceneData;
+void S3D_CACHE::loadFromPlugin( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem )
+{
+    std::lock_guard<std::mutex> lock( mutex3D_plugins );
+
+    aCacheItem->sceneData = m_Plugins->Load3DModel( aFileName, aCacheItem->pluginInfo );
+
+    if( !ADVANCED_CFG::GetCfg().m_Skip3DModelFileCache && nullptr != aCacheItem->sceneData )
+        saveCacheData( aCacheItem );
+}
+
+
+bool S3D_CACHE::getFileSignature( const wxString& aFileName, const wxDateTime& aModTime,
+                                  unsigned long long aSize, unsigned char* aSHA1Sum )
+{
+    if( !aModTime.IsValid() )
+        return getSHA1( aFileName, aSHA1Sum );
+
+    const long long modTime = aModTime.GetValue().GetValue();
+
+    {
+        std::lock_guard<std::mutex> lock( mutex3D_signatures );
+
+        auto it = m_FileSignatures.find( aFileName );
+
+        if( it != m_FileSignatures.end() && it->second.m_Size == aSize
+            && it->second.m_ModTime == modTime )
+        {
+            memcpy( aSHA1Sum, it->second.m_SHA1Sum, 20 );
+            return true;
+        }
+    }
+
+    // The file is new or was modified: read it all
+    if( !getSHA1( aFileName, aSHA1Sum ) )
+        return false;
+
+    S3D_FILE_SIGNATURE signature;
+    signature.m_Size = aSize;
+    signature.m_ModTime = modTime;
+    memcpy( signature.m_SHA1Sum, aSHA1Sum, 20 );
+
+    std::lock_guard<std::mutex> lock( mutex3D_signatures );
+
+    m_FileSignatures[aFileName] = signature;
+    m_FileSignaturesModified = true;
+
+    return true;
+}
+
+
+void S3D_CACHE::loadFileSignatures()
+{
+    if( m_CacheDir.empty() )
+        return;
+
+    wxFFile file( m_CacheDir + FILE_SIGNATURES_FILENAME, wxT( "rb" ) );
+    wxString contents;
+
+    if( !file.IsOpened() || !file.ReadAll( &contents, wxConvUTF8 ) )
+        return;
+
+    std::lock_guard<std::mutex> lock( mutex3D_signatures );
+
+    wxStringTokenizer lines( contents, wxT( "\n" ), wxTOKEN_STRTOK );
+
+    // Each line is: <SHA1> <size> <modification time> <full path>
+    while( lines.HasMoreTokens() )
+    {
+        wxString           path = lines.GetNextToken();
+        wxString           sha1 = path.BeforeFirst( ' ' );
+        wxString           size;
+        wxString           modTime;
+        wxULongLong_t      sizeValue;
+        wxLongLong_t       modTimeValue;
+        S3D_FILE_SIGNATURE signature;
+
+        path = path.AfterFirst( ' ' );
+        size = path.BeforeFirst( ' ' );
+        path = path.AfterFirst( ' ' );
+        modTime = path.BeforeFirst( ' ' );
+        path = path.AfterFirst( ' ' );
+
+        if( path.empty() || !wxStringToSha1( sha1, signature.m_SHA1Sum )
+            || !size.ToULongLong( &sizeValue ) || !modTime.ToLongLong( &modTimeValue ) )
+        {
+            wxLogTrace( MASK_3D_CACHE, wxT( " * [3D model] invalid file signature entry" ) );
+            continue;
+        }
+
+        signature.m_Size = sizeValue;
+        signature.m_ModTime = modTimeValue;
+        m_FileSignatures[path] = signature;
+    }
+}
+
+
+void S3D_CACHE::saveFileSignatures()
+{
+    std::lock_guard<std::mutex> lock( mutex3D_signatures );
+
+    if( !m_FileSignaturesModified || m_CacheDir.empty() )
+        return;
+
+    wxString contents;
+
+    for( const auto& [ path, signature ] : m_FileSignatures )
+    {
+        wxString sha1 = sha1ToWXString( signature.m_SHA1Sum );
+
+        // Forget the models whose cache file was deleted
+        if( !wxFileName::FileExists( m_CacheDir + sha1 + wxT( ".3dc" ) ) )
+            continue;
+
+        contents << sha1 << wxString::Format( wxT( " %llu %lld " ), signature.m_Size,
+                                              signature.m_ModTime )
+                 << path << '\n';
+    }
+
+    wxFFile file( m_CacheDir + FILE_SIGNATURES_FILENAME, wxT( "wb" ) );
+
+    if( !file.IsOpened() || !file.Write( contents, wxConvUTF8 ) )
+    {
+        wxLogTrace( MASK_3D_CACHE, wxT( " * [3D model] cannot write the file signatures" ) );
+        return;
+    }
+
+    m_FileSignaturesModified = false;
 }
 
 
@@ -443,11 +642,70 @@ bool S3D_CACHE::loadCacheData( S3D_CACHE_ENTRY* aCacheItem )
     if( nullptr != aCacheItem->sceneData )
         S3D::DestroyNode( (SGNODE*) aCacheItem->sceneData );
 
-    aCacheItem->sceneData = (SCENEGRAPH*)S3D::ReadCache( fname.ToUTF8(), m_Plugins, checkTag );
+    S3D_TAG_CHECK tagCheck = { m_Plugins, std::string() };
+
+    aCacheItem->sceneData = (SCENEGRAPH*)S3D::ReadCache( fname.ToUTF8(), &tagCheck, checkTag );
 
     if( nullptr == aCacheItem->sceneData )
         return false;
 
+    // The tag is kept for the mesh cache file
+    aCacheItem->pluginInfo = tagCheck.m_Tag;
+
+    return true;
+}
+
+
+bool S3D_CACHE::loadMeshCache( S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( ADVANCED_CFG::GetCfg().m_Skip3DModelFileCache )
+        return false;
+
+    wxString fname = m_CacheDir + aCacheItem->GetCacheBaseName() + wxT( ".3dm" );
+
+    if( !wxFileName::FileExists( fname ) )
+        return false;
+
+    std::string pluginInfo;
+    S3DMODEL*   model = S3D::ReadMeshCache( fname, &pluginInfo );
+
+    if( nullptr == model )
+    {
+        wxLogTrace( MASK_3D_CACHE, wxT( " * [3D model] invalid mesh cache file '%s'" ), fname );
+        return false;
+    }
+
+    // A model loaded by another version of a plugin is loaded again
+    if( !m_Plugins->CheckTag( pluginInfo.c_str() ) )
+    {
+        S3D::Destroy3DModel( &model );
+        return false;
+    }
+
+    aCacheItem->renderData = model;
+    aCacheItem->pluginInfo = pluginInfo;
+
+    return true;
+}
+
+
+bool S3D_CACHE::saveMeshCache( S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( ADVANCED_CFG::GetCfg().m_Skip3DModelFileCache || !aCacheItem->hashed
+        || nullptr == aCacheItem->renderData || aCacheItem->pluginInfo.empty() )
+    {
+        return false;
+    }
+
+    wxString fname = m_CacheDir + aCacheItem->GetCacheBaseName() + wxT( ".3dm" );
+
+    if( !S3D::WriteMeshCache( fname, *aCacheItem->renderData, aCacheItem->pluginInfo ) )
+    {
+        wxLogTrace( MASK_3D_CACHE, wxT( " * [3D model] cannot write mesh cache file '%s'" ),
+                    fname );
+        return false;
+    }
+
     return true;
 }
 
@@ -566,6 +824,7 @@ bool S3D_CACHE::Set3DConfigDir( const wxString& aConfigDir )
     }
 
     m_CacheDir = cacheDir.GetPathWithSep();
+    loadFileSignatures();
     return true;
 }
 
@@ -644,52 +903,86 @@ void S3D_CACHE::ClosePlugins()
 
 S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName, const wxString& aBasePath )
 {
-    S3D_CACHE_ENTRY* cp = nullptr;
-    SCENEGRAPH*      sp = load( aModelFileName, aBasePath,&cp );
+    wxString         full3Dpath;
+    S3D_CACHE_ENTRY* cp = getEntry( aModelFileName, aBasePath, full3Dpath );
 
-    if( !sp )
+    if( !cp )
         return nullptr;
 
-    if( !cp )
-    {
-        wxLogTrace( MASK_3D_CACHE,
-                    wxT( "%s:%s:%d\n  * [BUG] model loaded with no associated S3D_CACHE_ENTRY" ),
-                    __FILE__, __FUNCTION__, __LINE__ );
+    std::lock_guard<std::mutex> lock( cp->mutex );
 
-        return nullptr;
-    }
+    checkModified( full3Dpath, cp );
 
     if( cp->renderData )
         return cp->renderData;
 
-    S3DMODEL* mp = S3D::GetModel( sp );
-    cp->renderData = mp;
+    // The render data is read from the mesh cache file when there is one, without loading
+    // the scene data; it is only loaded if needed by Load()
+    if( !cp->loaded )
+    {
+        if( !hashEntry( full3Dpath, cp ) )
+        {
+            cp->loaded = true;
+            return nullptr;
+        }
+
+        if( loadMeshCache( cp ) )
+            return cp->renderData;
+    }
+
+    SCENEGRAPH* sp = loadScene( full3Dpath, cp );
 
-    return mp;
+    if( !sp )
+        return nullptr;
+
+    cp->renderData = S3D::GetModel( sp );
+    saveMeshCache( cp );
+
+    return cp->renderData;
+}
+
+
+void S3D_CACHE::PrefetchModels( const std::vector<std::pair<wxString, wxString>>& aModels )
+{
+    std::set<std::pair<wxString, wxString>>    unique( aModels.begin(), aModels.end() );
+    std::vector<std::pair<wxString, wxString>> models( unique.begin(), unique.end() );
+
+    GetKiCadThreadPool().parallelize_loop( 0, models.size(),
+            [&]( const int a, const int b )
+            {
+                for( int ii = a; ii < b; ++ii )
+                    GetModel( models[ii].first, models[ii].second );
+            } ).wait();
 }
 
 void S3D_CACHE::CleanCacheDir( int aNumDaysOld )
 {
     wxDir         dir;
-    wxString      fileSpec = wxT( "*.3dc" );
-    wxArrayString fileList; // Holds list of ".3dc" files found in cache directory
+    wxArrayString fileList; // Holds list of ".3dc" and ".3dm" files found in cache directory
+    wxArrayString tempList; // Holds list of temporary mesh cache files found in cache directory
     size_t        numFilesFound = 0;
 
     wxFileName thisFile;
-    wxDateTime lastAccess, thresholdDate;
+    wxDateTime lastAccess, lastModified, thresholdDate, tempThresholdDate;
     wxDateSpan durationInDays;
 
     // Calc the threshold date above which we delete cache files
     durationInDays.SetDays( aNumDaysOld );
     thresholdDate = wxDateTime::Now() - durationInDays;
 
+    // A temporary mesh cache file is renamed as soon as it is written, so an old one was left
+    // by an interrupted write
+    tempThresholdDate = wxDateTime::Now() - wxTimeSpan::Hour();
+
     // If the cache directory can be found and opened, then we'll try and clean it up
     if( dir.Open( m_CacheDir ) )
     {
         thisFile.SetPath( m_CacheDir ); // Set the base path to the cache folder
 
-        // Get a list of all the ".3dc" files in the cache directory
-        numFilesFound = dir.GetAllFiles( m_CacheDir, &fileList, fileSpec );
+        // Get a list of all the ".3dc" and ".3dm" files in the cache directory
+        dir.GetAllFiles( m_CacheDir, &fileList, wxT( "*.3dc" ) );
+        dir.GetAllFiles( m_CacheDir, &fileList, wxT( "*.3dm" ) );
+        numFilesFound = fileList.GetCount();
 
         for( unsigned int i = 0; i < numFilesFound; i++ )
         {
@@ -706,6 +999,20 @@ void S3D_CACHE::CleanCacheDir( int aNumDaysOld )
                 }
             }
         }
+
+        // Get a list of the temporary files written by S3D::WriteMeshCache()
+        dir.GetAllFiles( m_CacheDir, &tempList, wxT( "3dm*" ), wxDIR_FILES );
+
+        for( const wxString& tempFile : tempList )
+        {
+            thisFile.SetFullName( tempFile );
+
+            if( thisFile.GetTimes( nullptr, &lastModified, nullptr )
+                && lastModified.IsEarlierThan( tempThresholdDate ) )
+            {
+                wxRemoveFile( thisFile.GetFullPath() );
+            }
+        }
     }
 }
 
@@ -34,6 +34,8 @@
 #include "string_utils.h"
 #include <list>
 #include <map>
+#include <utility>
+#include <vector>
 #include "plugins/3dapi/c3dmodel.h"
 #include <project.h>
 #include <wx/string.h>
@@ -43,6 +45,21 @@ class  S3D_CACHE_ENTRY;
 class  SCENEGRAPH;
 class  FILENAME_RESOLVER;
 class  S3D_PLUGIN_MANAGER;
+class  wxDateTime;
+
+
+/**
+ * The size and modification time of a model file, with the SHA1 digest of its content.
+ *
+ * The digest names the cache file of the model; it is only computed again when the size
+ * or the modification time of the file change.
+ */
+struct S3D_FILE_SIGNATURE
+{
+    unsigned long long m_Size;
+    long long          m_ModTime;       ///< milliseconds since the epoch
+    unsigned char      m_SHA1Sum[20];
+};
 
 
 /**
@@ -127,27 +144,67 @@ public:
      */
     S3DMODEL* GetModel( const wxString& aModelFileName, const wxString& aBasePath );
 
+    /**
+     * Load a set of models concurrently on the thread pool, so that the following calls to
+     * GetModel() for these models return immediately.
+     *
+     * The cache files are read and the render data created in parallel.  The models that
+     * must be loaded by a plugin are loaded one at a time, the plugins are not thread safe.
+     *
+     * @param aModels is a list of model file name and base path pairs, as given to GetModel().
+     */
+    void PrefetchModels( const std::vector<std::pair<wxString, wxString>>& aModels );
+
     /**
      * Delete up old cache files in cache directory.
      *
-     * Deletes ".3dc" files in the cache directory that are older than \a aNumDaysOld.
+     * Deletes ".3dc" and ".3dm" files in the cache directory that are older than
+     * \a aNumDaysOld, and the temporary ".3dm" files left by interrupted writes.
      *
-     * @param aNumDaysOld is age threshold to delete ".3dc" cache files.
+     * @param aNumDaysOld is age threshold to delete cache files.
      */
     void CleanCacheDir( int aNumDaysOld );
 
 private:
     /**
-     * Find or create cache entry for file name
+     * Find or create the cache entry of a model.
+     *
+     * @param aModelFile is the partial or full path to the model.
+     * @param aBasePath is the path to search for any relative files.
+     * @param aFullPath receives the resolved full path of the model.
+     * @return the cache entry, or NULL if the model cannot be found.
+     */
+    S3D_CACHE_ENTRY* getEntry( const wxString& aModelFile, const wxString& aBasePath,
+                               wxString& aFullPath );
+
+    /**
+     * Release the data of a cache entry if its model file changed since it was hashed, so
+     * that it is loaded again.  The entry must be locked.
+     */
+    void checkModified( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem );
+
+    /**
+     * Set the modification time, size and SHA1 digest of a cache entry, if not already set.
      *
-     * Searches the cache list for the given filename and retrieves the cache data; a cache
-     * entry is created if one does not already exist.
+     * @return true if the entry has a cache file name.
+     */
+    bool hashEntry( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem );
+
+    /**
+     * Load the scene data of a cache entry, if it was not already attempted.  The entry must
+     * be locked.
      *
-     * @param aFileName  is the file name (full or partial path).
-     * @param aCachePtr is an optional return address for cache entry pointer.
+     * @return the scene data or NULL on error.
+     */
+    SCENEGRAPH* loadScene( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem );
+
+    /**
+     * Load the scene data of a hashed cache entry from its cache file, or from a plugin.
+     *
+     * @param aFileName is the full path to the model.
      * @return SCENEGRAPH object associated with file name or NULL on error.
      */
-    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = nullptr );
+    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem );
 
     /**
      * Calculate the SHA1 hash of the given file.
@@ -158,12 +215,36 @@ private:
      */
     bool getSHA1( const wxString& aFileName, unsigned char* aSHA1Sum );
 
+    /**
+     * Get the SHA1 hash of the given file from the file signatures when its size and
+     * modification time did not change, or calculate it.
+     *
+     * @return true on success, otherwise false.
+     */
+    bool getFileSignature( const wxString& aFileName, const wxDateTime& aModTime,
+                           unsigned long long aSize, unsigned char* aSHA1Sum );
+
+    /// Read the file signatures saved in the cache directory.
+    void loadFileSignatures();
+
+    /// Save the file signatures of the models still in the cache directory, if they changed.
+    void saveFileSignatures();
+
+    /// Load the scene data of a cache entry from a plugin, and save it to a cache file.
+    void loadFromPlugin( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem );
+
     // load scene data from a cache file
     bool loadCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
     // save scene data to a cache file
     bool saveCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
+    /// Load the render data of a hashed cache entry from its mesh cache file.
+    bool loadMeshCache( S3D_CACHE_ENTRY* aCacheItem );
+
+    /// Save the render data of a hashed cache entry to a mesh cache file.
+    bool saveMeshCache( S3D_CACHE_ENTRY* aCacheItem );
+
     // the real load function (can supply a cache entry pointer to member functions)
     SCENEGRAPH* load( const wxString& aModelFile, const wxString& aBasePath, S3D_CACHE_ENTRY** aCachePtr = nullptr );
 
@@ -173,6 +254,10 @@ private:
     /// mapping of file names to cache names and data
     std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString > m_CacheMap;
 
+    /// model file signatures by full path, saved in the cache directory
+    std::map< wxString, S3D_FILE_SIGNATURE > m_FileSignatures;
+    bool                                     m_FileSignaturesModified;
+
     FILENAME_RESOLVER*  m_FNResolver;
 
     S3D_PLUGIN_MANAGER* m_Plugins;
@@ -0,0 +1,366 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/log.h>
+
+#include "3d_mesh_cache.h"
+#include "plugins/3dapi/c3dmodel.h"
+#include "plugins/3dapi/ifsg_api.h"
+
+
+#define MASK_3D_CACHE "3D_CACHE"
+
+static const char     MESH_CACHE_MAGIC[8] = { 'K', 'I', '3', 'D', 'M', 'E', 'S', 'H' };
+static const uint32_t MESH_CACHE_VERSION = 1;
+static const uint32_t MESH_CACHE_BYTE_ORDER = 0x01020304;
+
+/// Mesh flags: the optional arrays stored after the positions
+static const uint32_t MESH_HAS_NORMALS   = 1 << 0;
+static const uint32_t MESH_HAS_TEXCOORDS = 1 << 1;
+static const uint32_t MESH_HAS_COLORS    = 1 << 2;
+
+static_assert( sizeof( SFVEC3F ) == 3 * sizeof( float ), "SFVEC3F must be packed" );
+static_assert( sizeof( SFVEC2F ) == 2 * sizeof( float ), "SFVEC2F must be packed" );
+
+
+static FILE* openFile( const wxString& aFileName, bool aWrite )
+{
+#ifdef _WIN32
+    return _wfopen( aFileName.wc_str(), aWrite ? L"wb" : L"rb" );
+#else
+    return fopen( aFileName.ToUTF8(), aWrite ? "wb" : "rb" );
+#endif
+}
+
+
+namespace
+{
+
+/// Write the file sequentially, remembering any error.
+class MESH_CACHE_WRITER
+{
+public:
+    explicit MESH_CACHE_WRITER( FILE* aFile ) :
+            m_file( aFile ),
+            m_ok( true )
+    {}
+
+    void Write( const void* aData, size_t aSize )
+    {
+        if( m_ok && aSize && fwrite( aData, 1, aSize, m_file ) != aSize )
+            m_ok = false;
+    }
+
+    void WriteU32( uint32_t aValue ) { Write( &aValue, sizeof( aValue ) ); }
+
+    void WriteVec3( const SFVEC3F& aValue ) { Write( &aValue, sizeof( aValue ) ); }
+
+    bool IsOk() const { return m_ok; }
+
+private:
+    FILE* m_file;
+    bool  m_ok;
+};
+
+
+/// Read the content of a file loaded in memory, with bounds checking.
+class MESH_CACHE_READER
+{
+public:
+    explicit MESH_CACHE_READER( const std::vector<char>& aData ) :
+            m_data( aData ),
+            m_pos( 0 )
+    {}
+
+    bool Read( void* aDest, size_t aSize )
+    {
+        if( aSize > m_data.size() - m_pos )
+            return false;
+
+        if( aSize )
+            memcpy( aDest, m_data.data() + m_pos, aSize );
+
+        m_pos += aSize;
+        return true;
+    }
+
+    bool ReadU32( uint32_t& aValue ) { return Read( &aValue, sizeof( aValue ) ); }
+
+    bool ReadVec3( SFVEC3F& aValue ) { return Read( &aValue, sizeof( aValue ) ); }
+
+    /// Allocate and read an array of \a aCount items, for the S3DMODEL arrays.
+    template <typename T>
+    bool ReadArray( T*& aArray, uint32_t aCount )
+    {
+        // Checked before allocating, so a corrupt count cannot exhaust the memory
+        if( static_cast<uint64_t>( aCount ) * sizeof( T ) > m_data.size() - m_pos )
+            return false;
+
+        aArray = new T[aCount];
+        return Read( aArray, aCount * sizeof( T ) );
+    }
+
+    bool Skip( size_t aSize )
+    {
+        if( aSize > m_data.size() - m_pos )
+            return false;
+
+        m_pos += aSize;
+        return true;
+    }
+
+private:
+    const std::vector<char>& m_data;
+    size_t                   m_pos;
+};
+
+} // namespace
+
+
+static size_t paddingTo4( size_t aSize )
+{
+    return ( 4 - aSize % 4 ) % 4;
+}
+
+
+bool S3D::WriteMeshCache( const wxString& aFileName, const S3DMODEL& aModel,
+                          const std::string& aPluginInfo )
+{
+    wxFileName fn( aFileName );
+    wxString   tempName = wxFileName::CreateTempFileName( fn.GetPathWithSep() + wxT( "3dm" ) );
+
+    if( tempName.empty() )
+        return false;
+
+    FILE* fp = openFile( tempName, true );
+
+    if( !fp )
+    {
+        wxRemoveFile( tempName );
+        return false;
+    }
+
+    MESH_CACHE_WRITER writer( fp );
+    const char        padding[4] = { 0, 0, 0, 0 };
+
+    writer.Write( MESH_CACHE_MAGIC, sizeof( MESH_CACHE_MAGIC ) );
+    writer.WriteU32( MESH_CACHE_VERSION );
+    writer.WriteU32( MESH_CACHE_BYTE_ORDER );
+    writer.WriteU32( aPluginInfo.size() );
+    writer.WriteU32( aModel.m_MaterialsSize );
+    writer.WriteU32( aModel.m_MeshesSize );
+    writer.Write( aPluginInfo.data(), aPluginInfo.size() );
+    writer.Write( padding, paddingTo4( aPluginInfo.size() ) );
+
+    for( unsigned int i = 0; i < aModel.m_MaterialsSize; ++i )
+    {
+        const SMATERIAL& material = aModel.m_Materials[i];
+
+        writer.WriteVec3( material.m_Ambient );
+        writer.WriteVec3( material.m_Diffuse );
+        writer.WriteVec3( material.m_Emissive );
+        writer.WriteVec3( material.m_Specular );
+        writer.Write( &material.m_Shininess, sizeof( float ) );
+        writer.Write( &material.m_Transparency, sizeof( float ) );
+    }
+
+    for( unsigned int i = 0; i < aModel.m_MeshesSize; ++i )
+    {
+        const SMESH& mesh = aModel.m_Meshes[i];
+        uint32_t     flags = 0;
+
+        if( mesh.m_Normals )
+            flags |= MESH_HAS_NORMALS;
+
+        if( mesh.m_Texcoords )
+            flags |= MESH_HAS_TEXCOORDS;
+
+        if( mesh.m_Color )
+            flags |= MESH_HAS_COLORS;
+
+        writer.WriteU32( mesh.m_VertexSize );
+        writer.WriteU32( mesh.m_FaceIdxSize );
+        writer.WriteU32( mesh.m_MaterialIdx );
+        writer.WriteU32( flags );
+        writer.Write( mesh.m_Positions, mesh.m_VertexSize * sizeof( SFVEC3F ) );
+
+        if( mesh.m_Normals )
+            writer.Write( mesh.m_Normals, mesh.m_VertexSize * sizeof( SFVEC3F ) );
+
+        if( mesh.m_Texcoords )
+            writer.Write( mesh.m_Texcoords, mesh.m_VertexSize * sizeof( SFVEC2F ) );
+
+        if( mesh.m_Color )
+            writer.Write( mesh.m_Color, mesh.m_VertexSize * sizeof( SFVEC3F ) );
+
+        writer.Write( mesh.m_FaceIdx, mesh.m_FaceIdxSize * sizeof( unsigned int ) );
+    }
+
+    bool ok = writer.IsOk();
+
+    if( fclose( fp ) != 0 )
+        ok = false;
+
+    // Several models can have the same content, and so the same cache file, so another thread
+    // may have written it already: the content is the same
+    if( !ok || !wxRenameFile( tempName, aFileName, true ) )
+    {
+        wxLogTrace( MASK_3D_CACHE, wxT( " * [3D model] cannot write mesh cache file '%s'" ),
+                    aFileName );
+
+        wxRemoveFile( tempName );
+        return false;
+    }
+
+    return true;
+}
+
+
+S3DMODEL* S3D::ReadMeshCache( const wxString& aFileName, std::string* aPluginInfo )
+{
+    std::vector<char> data;
+
+    {
+        FILE* fp = openFile( aFileName, false );
+
+        if( !fp )
+            return nullptr;
+
+        // Read the whole file at once, the arrays are copied from memory
+        char   block[65536];
+        size_t bsize;
+
+        while( ( bsize = fread( block, 1, sizeof( block ), fp ) ) > 0 )
+            data.insert( data.end(), block, block + bsize );
+
+        fclose( fp );
+    }
+
+    MESH_CACHE_READER reader( data );
+    char              magic[sizeof( MESH_CACHE_MAGIC )];
+    uint32_t          version = 0;
+    uint32_t          byteOrder = 0;
+    uint32_t          pluginInfoSize = 0;
+    uint32_t          materialsCount = 0;
+    uint32_t          meshesCount = 0;
+
+    if( !reader.Read( magic, sizeof( magic ) )
+        || memcmp( magic, MESH_CACHE_MAGIC, sizeof( magic ) ) != 0
+        || !reader.ReadU32( version ) || version != MESH_CACHE_VERSION
+        || !reader.ReadU32( byteOrder ) || byteOrder != MESH_CACHE_BYTE_ORDER
+        || !reader.ReadU32( pluginInfoSize ) || !reader.ReadU32( materialsCount )
+        || !reader.ReadU32( meshesCount ) )
+    {
+        wxLogTrace( MASK_3D_CACHE, wxT( " * [3D model] invalid mesh cache header '%s'" ),
+                    aFileName );
+
+        return nullptr;
+    }
+
+    std::string pluginInfo( std::min<size_t>( pluginInfoSize, data.size() ), '\0' );
+
+    if( !reader.Read( &pluginInfo[0], pluginInfoSize )
+        || !reader.Skip( paddingTo4( pluginInfoSize ) ) )
+    {
+        return nullptr;
+    }
+
+    // A material and a mesh take at least 56 and 16 bytes
+    if( static_cast<uint64_t>( materialsCount ) * 56 + static_cast<uint64_t>( meshesCount ) * 16
+        > data.size() )
+    {
+        return nullptr;
+    }
+
+    S3DMODEL* model = S3D::New3DModel();
+    bool      ok = true;
+
+    model->m_Materials = new SMATERIAL[materialsCount];
+    model->m_MaterialsSize = materialsCount;
+
+    for( uint32_t i = 0; i < materialsCount && ok; ++i )
+    {
+        SMATERIAL& material = model->m_Materials[i];
+
+        ok = reader.ReadVec3( material.m_Ambient ) && reader.ReadVec3( material.m_Diffuse )
+             && reader.ReadVec3( material.m_Emissive ) && reader.ReadVec3( material.m_Specular )
+             && reader.Read( &material.m_Shininess, sizeof( float ) )
+             && reader.Read( &material.m_Transparency, sizeof( float ) );
+    }
+
+    model->m_Meshes = new SMESH[meshesCount];
+    model->m_MeshesSize = meshesCount;
+
+    // All the meshes are initialized first, so the model can be destroyed at any point
+    for( uint32_t i = 0; i < meshesCount; ++i )
+        S3D::Init3DMesh( model->m_Meshes[i] );
+
+    for( uint32_t i = 0; i < meshesCount && ok; ++i )
+    {
+        SMESH&   mesh = model->m_Meshes[i];
+        uint32_t flags = 0;
+
+        ok = reader.ReadU32( mesh.m_VertexSize ) && reader.ReadU32( mesh.m_FaceIdxSize )
+             && reader.ReadU32( mesh.m_MaterialIdx ) && reader.ReadU32( flags )
+             && mesh.m_MaterialIdx < materialsCount
+             && reader.ReadArray( mesh.m_Positions, mesh.m_VertexSize );
+
+        if( ok && ( flags & MESH_HAS_NORMALS ) )
+            ok = reader.ReadArray( mesh.m_Normals, mesh.m_VertexSize );
+
+        if( ok && ( flags & MESH_HAS_TEXCOORDS ) )
+            ok = reader.ReadArray( mesh.m_Texcoords, mesh.m_VertexSize );
+
+        if( ok && ( flags & MESH_HAS_COLORS ) )
+            ok = reader.ReadArray( mesh.m_Color, mesh.m_VertexSize );
+
+        if( ok )
+            ok = reader.ReadArray( mesh.m_FaceIdx, mesh.m_FaceIdxSize );
+
+        // The renderers index the vertex arrays without checking
+        for( uint32_t j = 0; ok && j < mesh.m_FaceIdxSize; ++j )
+            ok = mesh.m_FaceIdx[j] < mesh.m_VertexSize;
+    }
+
+    if( !ok )
+    {
+        wxLogTrace( MASK_3D_CACHE, wxT( " * [3D model] corrupt mesh cache file '%s'" ),
+                    aFileName );
+
+        S3D::Destroy3DModel( &model );
+        return nullptr;
+    }
+
+    if( aPluginInfo )
+        *aPluginInfo = std::move( pluginInfo );
+
+    return model;
+}
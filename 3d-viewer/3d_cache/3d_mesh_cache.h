@@ -0,0 +1,75 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file 3d_mesh_cache.h
+ * @brief Binary cache files of the 3D model render data.
+ *
+ * A mesh cache file (".3dm") holds an S3DMODEL as packed arrays, so it is read back with a
+ * single read of the file and one copy per array, without building the scene graph of the
+ * model.  All the values are 32 bit and 4 byte aligned, in the native byte order; a file
+ * written with another byte order or format version is rejected.
+ *
+ * Layout:
+ *  - header: "KI3DMESH", version, byte order mark, plugin info length, materials count
+ *    and meshes count
+ *  - the PluginName:Version string of the plugin that loaded the model, padded to 4 bytes
+ *  - the materials, 14 floats each
+ *  - the meshes: vertex count, face index count, material index and flags, followed by the
+ *    positions, the normals, texture coordinates and colors if flagged, and the face indices
+ */
+
+#ifndef MESH_CACHE_3D_H
+#define MESH_CACHE_3D_H
+
+#include <string>
+#include <wx/string.h>
+
+struct S3DMODEL;
+
+
+namespace S3D
+{
+    /**
+     * Write the render data of a model to a mesh cache file.
+     *
+     * The file is written under a temporary name and then renamed, so a reader never sees a
+     * partial file.
+     *
+     * @param aPluginInfo is the PluginName:Version string of the plugin that loaded the model.
+     * @return true on success.
+     */
+    bool WriteMeshCache( const wxString& aFileName, const S3DMODEL& aModel,
+                         const std::string& aPluginInfo );
+
+    /**
+     * Read the render data of a model from a mesh cache file.
+     *
+     * @param aPluginInfo receives the PluginName:Version string stored in the file.
+     * @return the model, to be destroyed with S3D::Destroy3DModel(), or nullptr if the file
+     *         cannot be read or is not valid.
+     */
+    S3DMODEL* ReadMeshCache( const wxString& aFileName, std::string* aPluginInfo = nullptr );
+}
+
+#endif  // MESH_CACHE_3D_H
@@ -29,6 +29,8 @@
 #include <board_stackup_manager/stackup_predefined_prms.h>
 #include <3d_rendering/raytracing/shapes2D/polygon_2d.h>
 #include <board.h>
+#include <fp_lib_table.h>
+#include <project.h>
 #include <dialogs/dialog_color_picker.h>
 #include <3d_math.h>
 #include "3d_fastmath.h"
@@ -281,6 +283,58 @@ bool BOARD_ADAPTER::IsFootprintShown( FOOTPRINT_ATTR_T aFPAttributes ) const
 }
 
 
+void BOARD_ADAPTER::Prefetch3DModels() const
+{
+    if( !m_board || !m_3dModelManager )
+        return;
+
+    std::vector<std::pair<wxString, wxString>> models;
+
+    for( const FOOTPRINT* footprint : m_board->Footprints() )
+    {
+        // The renderers don't draw the hidden footprints: don't load their models
+        if( footprint->Models().empty()
+                || !IsFootprintShown( (FOOTPRINT_ATTR_T) footprint->GetAttributes() ) )
+        {
+            continue;
+        }
+
+        const wxString basePath = GetFootprintBasePath( footprint );
+
+        for( const FP_3DMODEL& model : footprint->Models() )
+        {
+            if( model.m_Show && !model.m_Filename.empty() )
+                models.emplace_back( model.m_Filename, basePath );
+        }
+    }
+
+    m_3dModelManager->PrefetchModels( models );
+}
+
+
+wxString BOARD_ADAPTER::GetFootprintBasePath( const FOOTPRINT* aFootprint ) const
+{
+    if( !m_board || !m_board->GetProject() )
+        return wxEmptyString;
+
+    try
+    {
+        // FindRow() can throw an exception
+        const FP_LIB_TABLE_ROW* fpRow = m_board->GetProject()->PcbFootprintLibs()->FindRow(
+                aFootprint->GetFPID().GetLibNickname(), false );
+
+        if( fpRow )
+            return fpRow->GetFullURI( true );
+    }
+    catch( ... )
+    {
+        // Do nothing if the libraryName is not found in lib table
+    }
+
+    return wxEmptyString;
+}
+
+
 int BOARD_ADAPTER::GetHolePlatingThickness() const noexcept
 {
     return m_board ? m_board->GetDesignSettings().GetHolePlatingThickness()
@@ -80,6 +80,18 @@ public:
     void Set3dCacheManager( S3D_CACHE* aCacheMgr ) noexcept { m_3dModelManager = aCacheMgr; }
     S3D_CACHE* Get3dCacheManager() const noexcept { return m_3dModelManager; }
 
+    /**
+     * Load the 3D models of the footprints shown (see IsFootprintShown()) into the cache
+     * manager, concurrently, so the renderers get them from memory.
+     */
+    void Prefetch3DModels() const;
+
+    /**
+     * @return the path used to resolve the relative 3D model file names of \a aFootprint,
+     *         that is its library path.
+     */
+    wxString GetFootprintBasePath( const FOOTPRINT* aFootprint ) const;
+
     /**
      * Check if a layer is enabled.
      *
@@ -30,7 +30,6 @@
 #include <trigo.h>
 #include <project.h>
 #include <profile.h>        // To use GetRunningMicroSecs or another profiling utility
-#include <fp_lib_table.h>
 #include <eda_3d_canvas.h>
 #include <eda_3d_viewer_frame.h>
 
@@ -892,7 +891,32 @@ void RENDER_3D_OPENGL::generateViasAndPads()
 
 void RENDER_3D_OPENGL::Load3dModelsIfNeeded()
 {
-    if( m_3dModelMap.size() > 0 )
+    if( !m_boardAdapter.GetBoard() )
+        return;
+
+    // The models of the footprints hidden when the scene was loaded are missing
+    bool missingModels = false;
+
+    for( const FOOTPRINT* footprint : m_boardAdapter.GetBoard()->Footprints() )
+    {
+        if( !m_boardAdapter.IsFootprintShown( (FOOTPRINT_ATTR_T) footprint->GetAttributes() ) )
+            continue;
+
+        for( const FP_3DMODEL& fp_model : footprint->Models() )
+        {
+            if( fp_model.m_Show && !fp_model.m_Filename.empty()
+                    && m_3dModelMap.find( fp_model.m_Filename ) == m_3dModelMap.end() )
+            {
+                missingModels = true;
+                break;
+            }
+        }
+
+        if( missingModels )
+            break;
+    }
+
+    if( !missingModels )
         return;
 
     wxFrame* frame = dynamic_cast<EDA_3D_VIEWER_FRAME*>( m_canvas->GetParent() );
@@ -920,29 +944,21 @@ void RENDER_3D_OPENGL::load3dModels( REPORTER* aStatusReporter )
         return;
     }
 
+    if( aStatusReporter )
+        aStatusReporter->Report( _( "Loading 3D models..." ) );
+
+    // Load all the models at once, the loop below gets them from the cache
+    m_boardAdapter.Prefetch3DModels();
+
     // Go for all footprints
     for( const FOOTPRINT* footprint : m_boardAdapter.GetBoard()->Footprints() )
     {
-        wxString                libraryName = footprint->GetFPID().GetLibNickname();
-        wxString                footprintBasePath = wxEmptyString;
-
-        if( m_boardAdapter.GetBoard()->GetProject() )
-        {
-            try
-            {
-                // FindRow() can throw an exception
-                const FP_LIB_TABLE_ROW* fpRow =
-                        m_boardAdapter.GetBoard()->GetProject()->PcbFootprintLibs()->FindRow(
-                                libraryName, false );
+        // Hidden footprints are not rendered, Load3dModelsIfNeeded() loads their models when
+        // they are shown
+        if( !m_boardAdapter.IsFootprintShown( (FOOTPRINT_ATTR_T) footprint->GetAttributes() ) )
+            continue;
 
-                if( fpRow )
-                    footprintBasePath = fpRow->GetFullURI( true );
-            }
-            catch( ... )
-            {
-                // Do nothing if the libraryName is not found in lib table
-            }
-        }
+        const wxString footprintBasePath = m_boardAdapter.GetFootprintBasePath( footprint );
 
         for( const FP_3DMODEL& fp_model : footprint->Models() )
         {
@@ -965,7 +981,7 @@ void RENDER_3D_OPENGL::load3dModels( REPORTER* aStatusReporter )
                     const S3DMODEL* modelPtr =
                             m_boardAdapter.Get3dCacheManager()->GetModel( fp_model.m_Filename, footprintBasePath );
 
-                    // only add it if the return is not NULL
+                    // A model which cannot be loaded is kept as NULL, so it is not loaded again
                     if( modelPtr )
                     {
                         MATERIAL_MODE materialMode = m_boardAdapter.m_Cfg->m_Render.material_mode;
@@ -973,6 +989,10 @@ void RENDER_3D_OPENGL::load3dModels( REPORTER* aStatusReporter )
 
                         m_3dModelMap[ fp_model.m_Filename ] = model;
                     }
+                    else
+                    {
+                        m_3dModelMap[ fp_model.m_Filename ] = nullptr;
+                    }
                 }
             }
         }
@@ -67,7 +67,8 @@ public:
     }
 
     /**
-     * Load footprint models if they are not already loaded, i.e. if m_3dModelMap is empty
+     * Load the footprint models which are not already loaded, e.g. the models of the footprints
+     * hidden when the scene was loaded.
      */
     void Load3dModelsIfNeeded();
 
@@ -76,12 +76,14 @@
 #include <vector>
 
 #include <stack>
+#include <thread_pool.h>
 #include <wx/debug.h>
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
 #include <stdio.h>
 #endif
 
+
 // BVHAccel Local Declarations
 struct BVHPrimitiveInfo
 {
@@ -130,6 +132,19 @@ struct BVHBuildNode
 };
 
 
+/// A subtree built separately from the top of the tree, see BVH_PBRT::recursiveBuild().
+struct BVHSubtreeBuild
+{
+    BVHBuildNode* placeholder;  ///< node to replace with the root of the subtree
+    int           start;
+    int           end;
+};
+
+
+/// Minimum number of primitives of the subtrees built in parallel.
+static const int MIN_PARALLEL_BUILD_PRIMS = 4096;
+
+
 struct MortonPrimitive
 {
     int primitiveIndex;
@@ -268,16 +283,53 @@ BVH_PBRT::BVH_PBRT( const CONTAINER_3D_BASE& aObjectContainer, int aMaxPrimsInNo
     // Build BVH tree for primitives using _primitiveInfo_
     int totalNodes = 0;
 
-    CONST_VECTOR_OBJECT orderedPrims;
-    orderedPrims.clear();
-    orderedPrims.reserve( m_primitives.size() );
+    CONST_VECTOR_OBJECT orderedPrims( m_primitives.size() );
 
     BVHBuildNode *root;
 
     if( m_splitMethod == SPLITMETHOD::HLBVH )
+    {
         root = HLBVHBuild( primitiveInfo, &totalNodes, orderedPrims );
+    }
     else
-        root = recursiveBuild( primitiveInfo, 0, m_primitives.size(), &totalNodes, orderedPrims );
+    {
+        // Build the top of the tree on this thread, then the subtrees below it in parallel
+        thread_pool& tp = GetKiCadThreadPool();
+        const int    deferSize = std::max<int>( MIN_PARALLEL_BUILD_PRIMS,
+                                                m_primitives.size() / ( 4 * tp.get_thread_count() ) );
+
+        std::vector<BVHSubtreeBuild> subtrees;
+
+        root = recursiveBuild( primitiveInfo, 0, m_primitives.size(), &totalNodes, orderedPrims,
+                               m_nodesToFree, &subtrees, deferSize );
+
+        std::vector<std::list<void*>> subtreeNodesToFree( subtrees.size() );
+        std::vector<int>              subtreeNodeCounts( subtrees.size(), 0 );
+
+        tp.parallelize_loop( 0, subtrees.size(),
+                [&]( const int a, const int b )
+                {
+                    for( int ii = a; ii < b; ++ii )
+                    {
+                        const BVHSubtreeBuild& subtree = subtrees[ii];
+
+                        BVHBuildNode* subtreeRoot = recursiveBuild( primitiveInfo, subtree.start,
+                                                                    subtree.end,
+                                                                    &subtreeNodeCounts[ii],
+                                                                    orderedPrims,
+                                                                    subtreeNodesToFree[ii] );
+
+                        *subtree.placeholder = *subtreeRoot;
+                    }
+                } ).wait();
+
+        for( size_t ii = 0; ii < subtrees.size(); ++ii )
+        {
+            // The placeholder was already counted in place of the subtree root
+            totalNodes += subtreeNodeCounts[ii] - 1;
+            m_nodesToFree.splice( m_nodesToFree.end(), subtreeNodesToFree[ii] );
+        }
+    }
 
     wxASSERT( m_primitives.size() == orderedPrims.size() );
 
@@ -300,6 +352,11 @@ BVH_PBRT::BVH_PBRT( const CONTAINER_3D_BASE& aObjectContainer, int aMaxPrimsInNo
     flattenBVHTree( root, &offset );
 
     wxASSERT( offset == (unsigned int)totalNodes );
+
+    // The single ray traversals use the 4-wide tree (see bvh_qbvh_traversal.cpp).  Collapsing
+    // the tree roughly halves its depth and the number of nodes.
+    m_qnodes.reserve( totalNodes / 2 + 1 );
+    collapseBVHTree( 0 );
 }
 
 
@@ -425,7 +482,10 @@ struct BucketInfo
 
 BVHBuildNode *BVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo>& primitiveInfo,
                                          int start, int end, int* totalNodes,
-                                         CONST_VECTOR_OBJECT& orderedPrims )
+                                         CONST_VECTOR_OBJECT& orderedPrims,
+                                         std::list<void*>& aNodesToFree,
+                                         std::vector<BVHSubtreeBuild>* aDeferred,
+                                         int aDeferSize )
 {
     wxASSERT( totalNodes != nullptr );
     wxASSERT( start >= 0 );
@@ -439,7 +499,7 @@ BVHBuildNode *BVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo>& primitiv
 
     // !TODO: implement an memory Arena
     BVHBuildNode *node = static_cast<BVHBuildNode *>( malloc( sizeof( BVHBuildNode ) ) );
-    m_nodesToFree.push_back( node );
+    aNodesToFree.push_back( node );
 
     node->bounds.Reset();
     node->firstPrimOffset = 0;
@@ -457,19 +517,23 @@ BVHBuildNode *BVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo>& primitiv
 
     int nPrimitives = end - start;
 
-    if( nPrimitives == 1 )
+    if( aDeferred && nPrimitives > 1 && nPrimitives <= aDeferSize )
+    {
+        // Leave it to be built later, the bounds are already known for the parent node
+        node->bounds = bounds;
+        aDeferred->push_back( { node, start, end } );
+    }
+    else if( nPrimitives == 1 )
     {
         // Create leaf _BVHBuildNode_
-        int firstPrimOffset = orderedPrims.size();
-
         for( int i = start; i < end; ++i )
         {
             int primitiveNr = primitiveInfo[i].primitiveNumber;
             wxASSERT( primitiveNr < (int)m_primitives.size() );
-            orderedPrims.push_back( m_primitives[ primitiveNr ] );
+            orderedPrims[i] = m_primitives[ primitiveNr ];
         }
 
-        node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
+        node->InitLeaf( start, nPrimitives, bounds );
     }
     else
     {
@@ -489,8 +553,6 @@ BVHBuildNode *BVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo>& primitiv
                   centroidBounds.Min()[dim] ) < (FLT_EPSILON + FLT_EPSILON) )
         {
             // Create leaf _BVHBuildNode_
-            const int firstPrimOffset = orderedPrims.size();
-
             for( int i = start; i < end; ++i )
             {
                 int primitiveNr = primitiveInfo[i].primitiveNumber;
@@ -501,10 +563,10 @@ BVHBuildNode *BVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo>& primitiv
 
                 wxASSERT( obj != nullptr );
 
-                orderedPrims.push_back( obj );
+                orderedPrims[i] = obj;
             }
 
-            node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
+            node->InitLeaf( start, nPrimitives, bounds );
         }
         else
         {
@@ -644,18 +706,16 @@ BVHBuildNode *BVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo>& primitiv
                     else
                     {
                         // Create leaf _BVHBuildNode_
-                        const int firstPrimOffset = orderedPrims.size();
-
                         for( int i = start; i < end; ++i )
                         {
                             const int primitiveNr = primitiveInfo[i].primitiveNumber;
 
                             wxASSERT( primitiveNr < (int)m_primitives.size() );
 
-                            orderedPrims.push_back( m_primitives[ primitiveNr ] );
+                            orderedPrims[i] = m_primitives[ primitiveNr ];
                         }
 
-                        node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
+                        node->InitLeaf( start, nPrimitives, bounds );
 
                         return node;
                     }
@@ -665,9 +725,11 @@ BVHBuildNode *BVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo>& primitiv
             }
 
             node->InitInterior( dim, recursiveBuild( primitiveInfo, start, mid, totalNodes,
-                                                     orderedPrims ),
+                                                     orderedPrims, aNodesToFree, aDeferred,
+                                                     aDeferSize ),
                                 recursiveBuild( primitiveInfo, mid, end, totalNodes,
-                                                orderedPrims) );
+                                                orderedPrims, aNodesToFree, aDeferred,
+                                                aDeferSize ) );
         }
     }
 
@@ -756,29 +818,36 @@ BVHBuildNode *BVH_PBRT::HLBVHBuild( const std::vector<BVHPrimitiveInfo>& primiti
     }
 
     // Create LBVHs for treelets in parallel
-    int atomicTotal = 0;
-    int orderedPrimsOffset = 0;
+    std::vector<int> nodesCreated( treeletsToBuild.size(), 0 );
 
     orderedPrims.resize( m_primitives.size() );
 
-    for( int index = 0; index < (int)treeletsToBuild.size(); ++index )
-    {
-        // Generate _index_th LBVH treelet
-        int nodesCreated = 0;
-        const int firstBit = 29 - 12;
+    GetKiCadThreadPool().parallelize_loop( 0, treeletsToBuild.size(),
+            [&]( const int a, const int b )
+            {
+                for( int index = a; index < b; ++index )
+                {
+                    // Generate _index_th LBVH treelet
+                    const int firstBit = 29 - 12;
 
-        LBVHTreelet &tr = treeletsToBuild[index];
+                    LBVHTreelet &tr = treeletsToBuild[index];
 
-        wxASSERT( tr.startIndex < (int)mortonPrims.size() );
+                    wxASSERT( tr.startIndex < (int)mortonPrims.size() );
 
-        tr.buildNodes = emitLBVH( tr.buildNodes, primitiveInfo, &mortonPrims[tr.startIndex],
-                                  tr.numPrimitives, &nodesCreated, orderedPrims,
-                                  &orderedPrimsOffset, firstBit );
+                    // The treelets hold consecutive ranges of the sorted primitives
+                    int orderedPrimsOffset = tr.startIndex;
 
-        atomicTotal += nodesCreated;
-    }
+                    tr.buildNodes = emitLBVH( tr.buildNodes, primitiveInfo,
+                                              &mortonPrims[tr.startIndex], tr.numPrimitives,
+                                              &nodesCreated[index], orderedPrims,
+                                              &orderedPrimsOffset, firstBit );
+                }
+            } ).wait();
+
+    *totalNodes = 0;
 
-    *totalNodes = atomicTotal;
+    for( int count : nodesCreated )
+        *totalNodes += count;
 
     // Initialize _finishedTreelets_ with treelet root node pointers
     std::vector<BVHBuildNode *> finishedTreelets;
@@ -1068,62 +1137,7 @@ bool BVH_PBRT::Intersect( const RAY& aRay, HITINFO& aHitInfo ) const
     if( !m_nodes )
         return false;
 
-    bool hit = false;
-
-    // Follow ray through BVH nodes to find primitive intersections
-    int todoOffset = 0, nodeNum = 0;
-    int todo[MAX_TODOS];
-
-    while( true )
-    {
-        const LinearBVHNode *node = &m_nodes[nodeNum];
-
-        wxASSERT( todoOffset < MAX_TODOS );
-
-        // Check ray against BVH node
-        float hitBox = 0.0f;
-
-        const bool hitted = node->bounds.Intersect( aRay, &hitBox );
-
-        if( hitted && ( hitBox < aHitInfo.m_tHit ) )
-        {
-            if( node->nPrimitives > 0 )
-            {
-                // Intersect ray with primitives in leaf BVH node
-                for( int i = 0; i < node->nPrimitives; ++i )
-                {
-                    if( m_primitives[node->primitivesOffset + i]->Intersect( aRay, aHitInfo ) )
-                    {
-                        aHitInfo.m_acc_node_info = nodeNum;
-                        hit = true;
-                    }
-                }
-            }
-            else
-            {
-                // Put far BVH node on _todo_ stack, advance to near node
-                if( aRay.m_dirIsNeg[node->axis] )
-                {
-                    todo[todoOffset++] = nodeNum + 1;
-                    nodeNum = node->secondChildOffset;
-                }
-                else
-                {
-                    todo[todoOffset++] = node->secondChildOffset;
-                    nodeNum = nodeNum + 1;
-                }
-
-                continue;
-            }
-        }
-
-        if( todoOffset == 0 )
-            break;
-
-        nodeNum = todo[--todoOffset];
-    }
-
-    return hit;
+    return intersectQBVH( aRay, aHitInfo );
 }
 
 
@@ -1197,58 +1211,5 @@ bool BVH_PBRT::IntersectP( const RAY& aRay, float aMaxDistance ) const
     if( !m_nodes )
         return false;
 
-    // Follow ray through BVH nodes to find primitive intersections
-    int todoOffset = 0, nodeNum = 0;
-    int todo[MAX_TODOS];
-
-    while( true )
-    {
-        const LinearBVHNode* node = &m_nodes[nodeNum];
-
-        wxASSERT( todoOffset < MAX_TODOS );
-
-        // Check ray against BVH node
-        float hitBox = 0.0f;
-
-        const bool hitted = node->bounds.Intersect( aRay, &hitBox );
-
-        if( hitted && ( hitBox < aMaxDistance ) )
-        {
-            if( node->nPrimitives > 0 )
-            {
-                // Intersect ray with primitives in leaf BVH node
-                for( int i = 0; i < node->nPrimitives; ++i )
-                {
-                    const OBJECT_3D* obj = m_primitives[node->primitivesOffset + i];
-
-                    if( obj->GetMaterial()->GetCastShadows()
-                      && obj->IntersectP( aRay, aMaxDistance ) )
-                        return true;
-                }
-            }
-            else
-            {
-                // Put far BVH node on _todo_ stack, advance to near node
-                if( aRay.m_dirIsNeg[node->axis] )
-                {
-                    todo[todoOffset++] = nodeNum + 1;
-                    nodeNum = node->secondChildOffset;
-                }
-                else
-                {
-                    todo[todoOffset++] = node->secondChildOffset;
-                    nodeNum = nodeNum + 1;
-                }
-
-                continue;
-            }
-        }
-
-        if( todoOffset == 0 )
-            break;
-
-        nodeNum = todo[--todoOffset];
-    }
-
-    return false;
+    return intersectPQBVH( aRay, aMaxDistance );
 }
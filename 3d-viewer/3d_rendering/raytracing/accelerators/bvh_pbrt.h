@@ -73,10 +73,12 @@
 #include "accelerator_3d.h"
 #include <cstdint>
 #include <list>
+#include <vector>
 
 // Forward Declarations
 struct BVHBuildNode;
 struct BVHPrimitiveInfo;
+struct BVHSubtreeBuild;
 struct MortonPrimitive;
 
 struct LinearBVHNode
@@ -98,6 +100,22 @@ struct LinearBVHNode
 };
 
 
+/**
+ * Node of the 4-wide BVH used for the single ray traversals.
+ *
+ * It is made by collapsing the binary tree, so the four children boxes can be tested against
+ * a ray at once with SIMD instructions.  The leaves are the leaves of the binary tree.
+ */
+struct LinearQBVHNode
+{
+    // 96 bytes
+    float bounds[2][3][4];  ///< children bounds, [min/max][x/y/z][child]
+
+    // 16 bytes
+    int   children[4];      ///< >= 0 interior node, < 0 ~index of a leaf LinearBVHNode
+};
+
+
 enum class SPLITMETHOD
 {
     MIDDLE,
@@ -121,8 +139,21 @@ public:
     bool IntersectP( const RAY& aRay, float aMaxDistance ) const override;
 
 private:
+    /**
+     * Build the subtree of the primitives from \a start to \a end.
+     *
+     * The primitives of a leaf are stored in \a orderedPrims at the same position as in
+     * \a primitiveInfo, so disjoint subtrees can be built in parallel.
+     *
+     * @param aNodesToFree receives the allocated nodes.
+     * @param aDeferred if not null, the subtrees of at most \a aDeferSize primitives are not
+     *                  built but only added to this list, with a placeholder node.
+     */
     BVHBuildNode* recursiveBuild( std::vector<BVHPrimitiveInfo>& primitiveInfo, int start,
-                                  int end, int* totalNodes, CONST_VECTOR_OBJECT& orderedPrims );
+                                  int end, int* totalNodes, CONST_VECTOR_OBJECT& orderedPrims,
+                                  std::list<void*>& aNodesToFree,
+                                  std::vector<BVHSubtreeBuild>* aDeferred = nullptr,
+                                  int aDeferSize = 0 );
 
     BVHBuildNode* HLBVHBuild( const std::vector<BVHPrimitiveInfo>& primitiveInfo,
                               int* totalNodes, CONST_VECTOR_OBJECT& orderedPrims );
@@ -138,12 +169,19 @@ private:
 
     int flattenBVHTree( BVHBuildNode* node, uint32_t* offset );
 
+    int collapseBVHTree( int aBinaryNode );
+
+    bool intersectQBVH( const RAY& aRay, HITINFO& aHitInfo ) const;
+    bool intersectPQBVH( const RAY& aRay, float aMaxDistance ) const;
+
     // BVH Private Data
     const int           m_maxPrimsInNode;
     SPLITMETHOD         m_splitMethod;
     CONST_VECTOR_OBJECT m_primitives;
     LinearBVHNode*      m_nodes;
 
+    std::vector<LinearQBVHNode> m_qnodes;
+
     std::list<void*>    m_nodesToFree;
 
     // Partition traversal
@@ -0,0 +1,370 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file bvh_qbvh_traversal.cpp
+ * @brief This file implements the 4-wide BVH (QBVH) single ray traversal over the BVH PBRT
+ * implementation.
+ *
+ * The binary tree is collapsed into nodes of four children so a ray is tested against four
+ * boxes at once.  The boxes are stored in SoA layout and tested with SSE when available, with
+ * a scalar fallback otherwise.  The leaves are shared with the binary tree, so the hit node
+ * stored in HITINFO::m_acc_node_info still refers to a binary tree node and can be used as a
+ * start point by the packet traversal.
+ */
+
+#include "bvh_pbrt.h"
+
+#include <cfloat>
+#include <wx/debug.h>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define BVH_QBVH_SSE
+#include <emmintrin.h>
+#endif
+
+
+#define QBVH_MAX_TODOS 128
+
+/// Bounds of the unused children slots, never hit by a ray.
+#define QBVH_EMPTY_MIN FLT_MAX
+#define QBVH_EMPTY_MAX -FLT_MAX
+
+/// Scale of the box exit distance for a conservative slab test, see PBRT v3 section 3.9.2.
+static const float QBVH_TFAR_SCALE = 1.0f + 2.0f * ( 3.0f * FLT_EPSILON * 0.5f );
+
+
+/**
+ * A ray prepared for testing against the four boxes of a QBVH node.
+ */
+struct QBVH_RAY
+{
+    explicit QBVH_RAY( const RAY& aRay )
+    {
+        for( int axis = 0; axis < 3; ++axis )
+        {
+            // The sign of the inverse is used and not m_dirIsNeg, so that a -0.0 direction
+            // selects the right planes
+            nearRow[axis] = aRay.m_InvDir[axis] < 0.0f ? 1 : 0;
+
+#ifdef BVH_QBVH_SSE
+            origin[axis] = _mm_set1_ps( aRay.m_Origin[axis] );
+            invDir[axis] = _mm_set1_ps( aRay.m_InvDir[axis] );
+#else
+            origin[axis] = aRay.m_Origin[axis];
+            invDir[axis] = aRay.m_InvDir[axis];
+#endif
+        }
+    }
+
+#ifdef BVH_QBVH_SSE
+    __m128 origin[3];
+    __m128 invDir[3];
+#else
+    float  origin[3];
+    float  invDir[3];
+#endif
+
+    int    nearRow[3];  ///< index in LinearQBVHNode::bounds of the near planes for each axis
+};
+
+
+struct QBVH_TODO
+{
+    int   node;         ///< same encoding as LinearQBVHNode::children
+    float tNear;        ///< entry distance in the box of the node
+};
+
+
+/**
+ * Intersect a ray with the four children boxes of a node.
+ *
+ * @param aTNear receives the entry distances of the children.
+ * @return a mask with bit i set if the child i was hit in [0, aTMax].
+ */
+static inline unsigned int intersectChildren( const LinearQBVHNode& aNode, const QBVH_RAY& aRay,
+                                              float aTMax, float aTNear[4] )
+{
+#ifdef BVH_QBVH_SSE
+    __m128 tNear = _mm_setzero_ps();
+    __m128 tFar = _mm_set1_ps( aTMax );
+    const __m128 tFarScale = _mm_set1_ps( QBVH_TFAR_SCALE );
+
+    for( int axis = 0; axis < 3; ++axis )
+    {
+        const int nearRow = aRay.nearRow[axis];
+
+        const __m128 t0 = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( aNode.bounds[nearRow][axis] ),
+                                                  aRay.origin[axis] ),
+                                      aRay.invDir[axis] );
+
+        const __m128 t1 = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( aNode.bounds[1 - nearRow][axis] ),
+                                                  aRay.origin[axis] ),
+                                      aRay.invDir[axis] );
+
+        // The distances go in the first operand: max and min return the second one on NaN
+        // (ray origin on a slab plane of an axis the ray is parallel to), ignoring that axis
+        tNear = _mm_max_ps( t0, tNear );
+        tFar = _mm_min_ps( _mm_mul_ps( t1, tFarScale ), tFar );
+    }
+
+    _mm_storeu_ps( aTNear, tNear );
+
+    return _mm_movemask_ps( _mm_cmple_ps( tNear, tFar ) );
+#else
+    unsigned int mask = 0;
+
+    for( int i = 0; i < 4; ++i )
+    {
+        float tNear = 0.0f;
+        float tFar = aTMax;
+
+        for( int axis = 0; axis < 3; ++axis )
+        {
+            const int nearRow = aRay.nearRow[axis];
+
+            const float t0 = ( aNode.bounds[nearRow][axis][i] - aRay.origin[axis] )
+                             * aRay.invDir[axis];
+
+            const float t1 = ( aNode.bounds[1 - nearRow][axis][i] - aRay.origin[axis] )
+                             * aRay.invDir[axis] * QBVH_TFAR_SCALE;
+
+            // Written so that a NaN distance is ignored, as in the SSE version
+            tNear = t0 > tNear ? t0 : tNear;
+            tFar = t1 < tFar ? t1 : tFar;
+        }
+
+        aTNear[i] = tNear;
+
+        if( tNear <= tFar )
+            mask |= 1 << i;
+    }
+
+    return mask;
+#endif
+}
+
+
+int BVH_PBRT::collapseBVHTree( int aBinaryNode )
+{
+    const int myOffset = static_cast<int>( m_qnodes.size() );
+
+    m_qnodes.emplace_back();
+
+    // Gather up to four children, opening the largest interior nodes first
+    int slots[4];
+    int count = 0;
+
+    if( m_nodes[aBinaryNode].nPrimitives > 0 )
+    {
+        // Only happens for a root that is a leaf
+        slots[count++] = aBinaryNode;
+    }
+    else
+    {
+        slots[count++] = aBinaryNode + 1;
+        slots[count++] = m_nodes[aBinaryNode].secondChildOffset;
+    }
+
+    while( count < 4 )
+    {
+        int   toOpen = -1;
+        float maxArea = -1.0f;
+
+        for( int i = 0; i < count; ++i )
+        {
+            const LinearBVHNode& node = m_nodes[slots[i]];
+
+            if( node.nPrimitives == 0 && node.bounds.SurfaceArea() > maxArea )
+            {
+                toOpen = i;
+                maxArea = node.bounds.SurfaceArea();
+            }
+        }
+
+        if( toOpen < 0 )
+            break;
+
+        const int opened = slots[toOpen];
+
+        slots[toOpen] = opened + 1;
+        slots[count++] = m_nodes[opened].secondChildOffset;
+    }
+
+    for( int i = 0; i < 4; ++i )
+    {
+        int child;
+
+        if( i >= count )
+        {
+            // The empty slot is stored as a leaf, its bounds are never hit
+            child = ~aBinaryNode;
+        }
+        else if( m_nodes[slots[i]].nPrimitives > 0 )
+        {
+            child = ~slots[i];
+        }
+        else
+        {
+            // This can reallocate m_qnodes, so the node is only accessed by index
+            child = collapseBVHTree( slots[i] );
+        }
+
+        LinearQBVHNode& qnode = m_qnodes[myOffset];
+
+        qnode.children[i] = child;
+
+        for( int axis = 0; axis < 3; ++axis )
+        {
+            if( i < count )
+            {
+                qnode.bounds[0][axis][i] = m_nodes[slots[i]].bounds.Min()[axis];
+                qnode.bounds[1][axis][i] = m_nodes[slots[i]].bounds.Max()[axis];
+            }
+            else
+            {
+                qnode.bounds[0][axis][i] = QBVH_EMPTY_MIN;
+                qnode.bounds[1][axis][i] = QBVH_EMPTY_MAX;
+            }
+        }
+    }
+
+    return myOffset;
+}
+
+
+bool BVH_PBRT::intersectQBVH( const RAY& aRay, HITINFO& aHitInfo ) const
+{
+    const QBVH_RAY qray( aRay );
+
+    bool hit = false;
+
+    QBVH_TODO todo[QBVH_MAX_TODOS];
+    int       todoOffset = 0;
+
+    todo[todoOffset++] = { 0, 0.0f };
+
+    while( todoOffset > 0 )
+    {
+        const QBVH_TODO current = todo[--todoOffset];
+
+        // A closer hit may have been found since this node was pushed
+        if( current.tNear > aHitInfo.m_tHit )
+            continue;
+
+        if( current.node < 0 )
+        {
+            // Intersect ray with primitives in leaf BVH node
+            const int            leafNum = ~current.node;
+            const LinearBVHNode& leaf = m_nodes[leafNum];
+
+            for( int i = 0; i < leaf.nPrimitives; ++i )
+            {
+                if( m_primitives[leaf.primitivesOffset + i]->Intersect( aRay, aHitInfo ) )
+                {
+                    aHitInfo.m_acc_node_info = leafNum;
+                    hit = true;
+                }
+            }
+
+            continue;
+        }
+
+        const LinearQBVHNode& node = m_qnodes[current.node];
+
+        float              tNear[4];
+        const unsigned int mask = intersectChildren( node, qray, aHitInfo.m_tHit, tNear );
+
+        if( !mask )
+            continue;
+
+        wxASSERT( todoOffset + 4 <= QBVH_MAX_TODOS );
+
+        // Push the hit children sorted by decreasing distance, so the nearest is popped first
+        const int first = todoOffset;
+
+        for( int i = 0; i < 4; ++i )
+        {
+            if( !( mask & ( 1 << i ) ) )
+                continue;
+
+            QBVH_TODO entry = { node.children[i], tNear[i] };
+            int       j = todoOffset++;
+
+            for( ; j > first && todo[j - 1].tNear < entry.tNear; --j )
+                todo[j] = todo[j - 1];
+
+            todo[j] = entry;
+        }
+    }
+
+    return hit;
+}
+
+
+bool BVH_PBRT::intersectPQBVH( const RAY& aRay, float aMaxDistance ) const
+{
+    const QBVH_RAY qray( aRay );
+
+    int todo[QBVH_MAX_TODOS];
+    int todoOffset = 0;
+
+    todo[todoOffset++] = 0;
+
+    while( todoOffset > 0 )
+    {
+        const int nodeNum = todo[--todoOffset];
+
+        if( nodeNum < 0 )
+        {
+            // Intersect ray with primitives in leaf BVH node
+            const LinearBVHNode& leaf = m_nodes[~nodeNum];
+
+            for( int i = 0; i < leaf.nPrimitives; ++i )
+            {
+                const OBJECT_3D* obj = m_primitives[leaf.primitivesOffset + i];
+
+                if( obj->GetMaterial()->GetCastShadows() && obj->IntersectP( aRay, aMaxDistance ) )
+                    return true;
+            }
+
+            continue;
+        }
+
+        const LinearQBVHNode& node = m_qnodes[nodeNum];
+
+        // Any hit will do, so there is no need to sort the children
+        float              tNear[4];
+        const unsigned int mask = intersectChildren( node, qray, aMaxDistance, tNear );
+
+        wxASSERT( todoOffset + 4 <= QBVH_MAX_TODOS );
+
+        for( int i = 0; i < 4; ++i )
+        {
+            if( mask & ( 1 << i ) )
+                todo[todoOffset++] = node.children[i];
+        }
+    }
+
+    return false;
+}
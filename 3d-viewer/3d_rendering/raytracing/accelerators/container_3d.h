@@ -54,6 +54,16 @@ public:
         }
     }
 
+    /**
+     * Move all the objects of \a aOther to the end of this container, \a aOther is left empty.
+     */
+    void Splice( CONTAINER_3D_BASE& aOther )
+    {
+        m_objects.splice( m_objects.end(), aOther.m_objects );
+        m_bbox.Union( aOther.m_bbox );
+        aOther.m_bbox.Reset();
+    }
+
     void Clear();
 
     const LIST_OBJECT& GetList() const { return m_objects; }
@@ -27,6 +27,7 @@
 #include "shapes3D/round_segment_3d.h"
 #include "shapes3D/layer_item_3d.h"
 #include "shapes3D/cylinder_3d.h"
+#include "shapes3D/model_instance_3d.h"
 #include "shapes3D/triangle_3d.h"
 #include "shapes2D/layer_item_2d.h"
 #include "shapes2D/ring_2d.h"
@@ -39,11 +40,11 @@
 
 #include <board.h>
 #include <footprint.h>
-#include <fp_lib_table.h>
 #include <eda_3d_viewer_frame.h>
 
 #include <base_units.h>
 #include <profile.h>        // To use GetRunningMicroSecs or another profiling utility
+#include <thread_pool.h>
 
 /**
  * Perform an interpolation step to easy control the transparency based on the
@@ -69,6 +70,9 @@ static float TransparencyControl( float aGrayColorValue, float aTransparency )
   */
 #define UNITS3D_TO_UNITSPCB ( pcbIUScale.IU_PER_MM )
 
+/// Number of placements of a 3D model from which its meshes are shared by the placements
+#define MIN_MODEL_INSTANCES 2
+
 
 void RENDER_3D_RAYTRACE::setupMaterials()
 {
@@ -225,7 +229,8 @@ void RENDER_3D_RAYTRACE::createObject( CONTAINER_3D& aDstContainer, const OBJECT
 }
 
 
-void RENDER_3D_RAYTRACE::createItemsFromContainer( const BVH_CONTAINER_2D* aContainer2d,
+void RENDER_3D_RAYTRACE::createItemsFromContainer( CONTAINER_3D& aDstContainer,
+                                                   const BVH_CONTAINER_2D* aContainer2d,
                                                    PCB_LAYER_ID aLayer_id,
                                                    const MATERIAL* aMaterialLayer,
                                                    const SFVEC3F& aLayerColor,
@@ -334,7 +339,7 @@ void RENDER_3D_RAYTRACE::createItemsFromContainer( const BVH_CONTAINER_2D* aCont
                     m_boardAdapter.GetLayerTopZPos( aLayer_id ) + aLayerZOffset );
             objPtr->SetMaterial( aMaterialLayer );
             objPtr->SetColor( ConvertSRGBToLinear( aLayerColor ) );
-            m_objectContainer.Add( objPtr );
+            aDstContainer.Add( objPtr );
         }
         else
         {
@@ -349,7 +354,7 @@ void RENDER_3D_RAYTRACE::createItemsFromContainer( const BVH_CONTAINER_2D* aCont
             objPtr->SetMaterial( aMaterialLayer );
             objPtr->SetColor( ConvertSRGBToLinear( aLayerColor ) );
 
-            m_objectContainer.Add( objPtr );
+            aDstContainer.Add( objPtr );
         }
     }
 }
@@ -380,6 +385,7 @@ void RENDER_3D_RAYTRACE::Reload( REPORTER* aStatusReporter, REPORTER* aWarningRe
 
     m_objectContainer.Clear();
     m_containerWithObjectsToDelete.Clear();
+    m_instancedMeshes.clear();
 
     setupMaterials();
 
@@ -557,6 +563,19 @@ void RENDER_3D_RAYTRACE::Reload( REPORTER* aStatusReporter, REPORTER* aWarningRe
     if( aStatusReporter )
         aStatusReporter->Report( _( "Load Raytracing: layers" ) );
 
+    // The 3D objects of each layer are created in parallel, each in its own container, and
+    // then moved to the scene in the layer order
+    struct LAYER_OBJECTS
+    {
+        const BVH_CONTAINER_2D* m_container2d;
+        PCB_LAYER_ID            m_layer;
+        const MATERIAL*         m_material;
+        SFVEC3F                 m_color;
+        float                   m_zOffset;
+    };
+
+    std::vector<LAYER_OBJECTS> layersToCreate;
+
     // Add layers maps (except B_Mask and F_Mask)
     for( const std::pair<const PCB_LAYER_ID, BVH_CONTAINER_2D*>& entry : m_boardAdapter.GetLayerMap() )
     {
@@ -652,22 +671,40 @@ void RENDER_3D_RAYTRACE::Reload( REPORTER* aStatusReporter, REPORTER* aWarningRe
             break;
         }
 
-        createItemsFromContainer( container2d, layer_id, materialLayer, layerColor, 0.0f );
+        layersToCreate.push_back( { container2d, layer_id, materialLayer, layerColor, 0.0f } );
     } // for each layer on map
 
     // Create plated copper
     if( m_boardAdapter.m_Cfg->m_Render.renderPlatedPadsAsPlated
             && m_boardAdapter.m_Cfg->m_Render.realistic )
     {
-        createItemsFromContainer( m_boardAdapter.GetPlatedPadsFront(), F_Cu, &m_materials.m_Copper,
-                                  m_boardAdapter.m_CopperColor,
-                                  m_boardAdapter.GetFrontCopperThickness() * 0.1f );
+        layersToCreate.push_back( { m_boardAdapter.GetPlatedPadsFront(), F_Cu,
+                                    &m_materials.m_Copper, m_boardAdapter.m_CopperColor,
+                                    m_boardAdapter.GetFrontCopperThickness() * 0.1f } );
 
-        createItemsFromContainer( m_boardAdapter.GetPlatedPadsBack(), B_Cu, &m_materials.m_Copper,
-                                  m_boardAdapter.m_CopperColor,
-                                  -m_boardAdapter.GetBackCopperThickness() * 0.1f );
+        layersToCreate.push_back( { m_boardAdapter.GetPlatedPadsBack(), B_Cu,
+                                    &m_materials.m_Copper, m_boardAdapter.m_CopperColor,
+                                    -m_boardAdapter.GetBackCopperThickness() * 0.1f } );
     }
 
+    std::vector<CONTAINER_3D> layerContainers( layersToCreate.size() );
+
+    GetKiCadThreadPool().parallelize_loop( 0, layersToCreate.size(),
+            [&]( const int a, const int b )
+            {
+                for( int ii = a; ii < b; ++ii )
+                {
+                    const LAYER_OBJECTS& layer = layersToCreate[ii];
+
+                    createItemsFromContainer( layerContainers[ii], layer.m_container2d,
+                                              layer.m_layer, layer.m_material, layer.m_color,
+                                              layer.m_zOffset );
+                }
+            } ).wait();
+
+    for( CONTAINER_3D& layerContainer : layerContainers )
+        m_objectContainer.Splice( layerContainer );
+
     if( !aOnlyLoadCopperAndShapes )
     {
         // Add Mask layer
@@ -1199,7 +1236,7 @@ void RENDER_3D_RAYTRACE::addPadsAndVias()
 
 void RENDER_3D_RAYTRACE::load3DModels( CONTAINER_3D& aDstContainer, bool aSkipMaterialInformation )
 {
-    if( !m_boardAdapter.GetBoard() )
+    if( !m_boardAdapter.GetBoard() || !m_boardAdapter.Get3dCacheManager() )
         return;
 
     if( !m_boardAdapter.m_Cfg->m_Render.show_footprints_normal
@@ -1209,6 +1246,21 @@ void RENDER_3D_RAYTRACE::load3DModels( CONTAINER_3D& aDstContainer, bool aSkipMa
         return;
     }
 
+    // The models are first resolved from the cache and placed, then their triangles are
+    // created in parallel
+    struct MODEL_INSTANCE
+    {
+        const S3DMODEL* m_model;
+        glm::mat4       m_matrix;
+        float           m_opacity;
+        BOARD_ITEM*     m_boardItem;
+    };
+
+    std::vector<MODEL_INSTANCE> instances;
+
+    // Load all the models at once, the loop below gets them from the cache
+    m_boardAdapter.Prefetch3DModels();
+
     // Go for all footprints
     for( FOOTPRINT* fp : m_boardAdapter.GetBoard()->Footprints() )
     {
@@ -1253,26 +1305,7 @@ void RENDER_3D_RAYTRACE::load3DModels( CONTAINER_3D& aDstContainer, bool aSkipMa
             auto       sM       = fp->Models().begin();
             auto       eM       = fp->Models().end();
 
-            wxString                libraryName = fp->GetFPID().GetLibNickname();
-
-            wxString                footprintBasePath = wxEmptyString;
-            if( m_boardAdapter.GetBoard()->GetProject() )
-            {
-                try
-                {
-                    // FindRow() can throw an exception
-                    const FP_LIB_TABLE_ROW* fpRow =
-                            m_boardAdapter.GetBoard()->GetProject()->PcbFootprintLibs()->FindRow(
-                                    libraryName, false );
-
-                    if( fpRow )
-                        footprintBasePath = fpRow->GetFullURI( true );
-                }
-                catch( ... )
-                {
-                    // Do nothing if the libraryName is not found in lib table
-                }
-            }
+            const wxString footprintBasePath = m_boardAdapter.GetFootprintBasePath( fp );
 
             while( sM != eM )
             {
@@ -1306,8 +1339,12 @@ void RENDER_3D_RAYTRACE::load3DModels( CONTAINER_3D& aDstContainer, bool aSkipMa
                         modelMatrix = glm::scale( modelMatrix,
                                 SFVEC3F( sM->m_Scale.x, sM->m_Scale.y, sM->m_Scale.z ) );
 
-                        addModels( aDstContainer, modelPtr, modelMatrix, (float) sM->m_Opacity,
-                                   aSkipMaterialInformation, boardItem );
+                        // The materials map is not thread safe, so fill it now
+                        if( !aSkipMaterialInformation )
+                            getModelMaterial( modelPtr );
+
+                        instances.push_back( { modelPtr, modelMatrix, (float) sM->m_Opacity,
+                                               boardItem } );
                     }
                 }
 
@@ -1315,6 +1352,82 @@ void RENDER_3D_RAYTRACE::load3DModels( CONTAINER_3D& aDstContainer, bool aSkipMa
             }
         }
     }
+
+    // The models placed several times are instanced: the triangles of their meshes are created
+    // once in model coordinates, and each placement only adds an object per mesh.  The meshes
+    // with vertex colors are not instanced, an instance has a single color.
+    std::map<const S3DMODEL*, int> modelUseCount;
+    std::vector<const S3DMODEL*>   instancedModels;
+
+    for( const MODEL_INSTANCE& instance : instances )
+        modelUseCount[instance.m_model]++;
+
+    for( const std::pair<const S3DMODEL* const, int>& entry : modelUseCount )
+    {
+        const S3DMODEL* model = entry.first;
+        bool            hasVertexColors = false;
+
+        for( unsigned int mesh_i = 0; mesh_i < model->m_MeshesSize; ++mesh_i )
+            hasVertexColors |= model->m_Meshes[mesh_i].m_Color != nullptr;
+
+        if( entry.second >= MIN_MODEL_INSTANCES && !hasVertexColors )
+            instancedModels.push_back( model );
+    }
+
+    std::vector<std::vector<std::unique_ptr<INSTANCED_MESH>>> modelMeshes( instancedModels.size() );
+
+    GetKiCadThreadPool().parallelize_loop( 0, instancedModels.size(),
+            [&]( const int a, const int b )
+            {
+                for( int ii = a; ii < b; ++ii )
+                {
+                    createInstancedMeshes( instancedModels[ii], aSkipMaterialInformation,
+                                           modelMeshes[ii] );
+                }
+            } ).wait();
+
+    // The build of an accelerator uses the thread pool, so they are built from this thread
+    for( size_t ii = 0; ii < instancedModels.size(); ++ii )
+    {
+        for( std::unique_ptr<INSTANCED_MESH>& mesh : modelMeshes[ii] )
+        {
+            mesh->m_accelerator = std::make_unique<BVH_PBRT>( mesh->m_triangles, 8,
+                                                              SPLITMETHOD::MIDDLE );
+        }
+
+        m_instancedMeshes[instancedModels[ii]] = std::move( modelMeshes[ii] );
+    }
+
+    std::vector<CONTAINER_3D> instanceContainers( instances.size() );
+
+    GetKiCadThreadPool().parallelize_loop( 0, instances.size(),
+            [&]( const int a, const int b )
+            {
+                for( int ii = a; ii < b; ++ii )
+                {
+                    const MODEL_INSTANCE& instance = instances[ii];
+                    auto meshesIt = m_instancedMeshes.find( instance.m_model );
+
+                    // A mirrored placement would cull the other side of the triangles
+                    if( meshesIt != m_instancedMeshes.end()
+                      && glm::determinant( glm::mat3( instance.m_matrix ) ) > 0.0f )
+                    {
+                        addModelInstances( instanceContainers[ii], instance.m_model,
+                                           meshesIt->second, instance.m_matrix,
+                                           instance.m_opacity, aSkipMaterialInformation,
+                                           instance.m_boardItem );
+                    }
+                    else
+                    {
+                        addModels( instanceContainers[ii], instance.m_model, instance.m_matrix,
+                                   instance.m_opacity, aSkipMaterialInformation,
+                                   instance.m_boardItem );
+                    }
+                }
+            } ).wait();
+
+    for( CONTAINER_3D& instanceContainer : instanceContainers )
+        aDstContainer.Splice( instanceContainer );
 }
 
 
@@ -1323,10 +1436,13 @@ MODEL_MATERIALS* RENDER_3D_RAYTRACE::getModelMaterial( const S3DMODEL* a3DModel
     MODEL_MATERIALS* materialVector;
 
     // Try find if the materials already exists in the map list
-    if( m_modelMaterialMap.find( a3DModel ) != m_modelMaterialMap.end() )
+    auto it = m_modelMaterialMap.find( a3DModel );
+
+    if( it != m_modelMaterialMap.end() )
     {
-        // Found it, so get the pointer
-        materialVector = &m_modelMaterialMap[a3DModel];
+        // Found it, so get the pointer.  This doesn't modify the map, so it can be done while
+        // the models are added from several threads.
+        materialVector = &it->second;
     }
     else
     {
@@ -1563,3 +1679,110 @@ void RENDER_3D_RAYTRACE::addModels( CONTAINER_3D& aDstContainer, const S3DMODEL*
         }
     }
 }
+
+
+void RENDER_3D_RAYTRACE::createInstancedMeshes(
+        const S3DMODEL* a3DModel, bool aSkipMaterialInformation,
+        std::vector<std::unique_ptr<INSTANCED_MESH>>& aMeshes )
+{
+    if( ( a3DModel->m_Materials == nullptr ) || ( a3DModel->m_Meshes == nullptr ) )
+        return;
+
+    // The materials were created when the models were placed
+    const MODEL_MATERIALS* materialVector = nullptr;
+
+    if( !aSkipMaterialInformation )
+        materialVector = getModelMaterial( a3DModel );
+
+    for( unsigned int mesh_i = 0; mesh_i < a3DModel->m_MeshesSize; ++mesh_i )
+    {
+        const SMESH& mesh = a3DModel->m_Meshes[mesh_i];
+
+        if( ( mesh.m_Positions == nullptr ) || ( mesh.m_Normals == nullptr )
+          || ( mesh.m_FaceIdx == nullptr ) || ( mesh.m_FaceIdxSize == 0 )
+          || ( mesh.m_VertexSize == 0 ) || ( ( mesh.m_FaceIdxSize % 3 ) != 0 )
+          || ( mesh.m_MaterialIdx >= a3DModel->m_MaterialsSize ) )
+        {
+            continue;
+        }
+
+        std::unique_ptr<INSTANCED_MESH> instancedMesh = std::make_unique<INSTANCED_MESH>();
+
+        instancedMesh->m_materialIdx = mesh.m_MaterialIdx;
+
+        if( !aSkipMaterialInformation )
+        {
+            instancedMesh->m_material = ( *materialVector )[mesh.m_MaterialIdx];
+            instancedMesh->m_material.SetGenerator( nullptr );
+        }
+
+        for( unsigned int faceIdx = 0; faceIdx < mesh.m_FaceIdxSize; faceIdx += 3 )
+        {
+            const unsigned int idx0 = mesh.m_FaceIdx[faceIdx + 0];
+            const unsigned int idx1 = mesh.m_FaceIdx[faceIdx + 1];
+            const unsigned int idx2 = mesh.m_FaceIdx[faceIdx + 2];
+
+            if( ( idx0 < mesh.m_VertexSize ) && ( idx1 < mesh.m_VertexSize )
+              && ( idx2 < mesh.m_VertexSize ) )
+            {
+                TRIANGLE* newTriangle = new TRIANGLE( mesh.m_Positions[idx0],
+                                                      mesh.m_Positions[idx2],
+                                                      mesh.m_Positions[idx1],
+                                                      glm::normalize( mesh.m_Normals[idx0] ),
+                                                      glm::normalize( mesh.m_Normals[idx2] ),
+                                                      glm::normalize( mesh.m_Normals[idx1] ) );
+
+                newTriangle->SetMaterial( &instancedMesh->m_material );
+
+                instancedMesh->m_triangles.Add( newTriangle );
+            }
+        }
+
+        if( !instancedMesh->m_triangles.GetList().empty() )
+            aMeshes.push_back( std::move( instancedMesh ) );
+    }
+}
+
+
+void RENDER_3D_RAYTRACE::addModelInstances(
+        CONTAINER_3D& aDstContainer, const S3DMODEL* a3DModel,
+        const std::vector<std::unique_ptr<INSTANCED_MESH>>& aMeshes,
+        const glm::mat4& aModelMatrix, float aFPOpacity, bool aSkipMaterialInformation,
+        BOARD_ITEM* aBoardItem )
+{
+    if( aFPOpacity > 1.0f )
+        aFPOpacity = 1.0f;
+
+    const MODEL_MATERIALS* materialVector = nullptr;
+
+    if( !aSkipMaterialInformation )
+        materialVector = getModelMaterial( a3DModel );
+
+    for( const std::unique_ptr<INSTANCED_MESH>& mesh : aMeshes )
+    {
+        MODEL_INSTANCE_3D* newInstance = new MODEL_INSTANCE_3D( mesh->m_accelerator.get(),
+                                                                mesh->m_triangles.GetBBox(),
+                                                                aModelMatrix );
+
+        newInstance->SetBoardItem( aBoardItem );
+
+        aDstContainer.Add( newInstance );
+
+        if( !aSkipMaterialInformation )
+        {
+            const BLINN_PHONG_MATERIAL* blinn_material = &( *materialVector )[mesh->m_materialIdx];
+
+            newInstance->SetMaterial( blinn_material );
+            newInstance->SetModelTransparency(
+                    1.0f - ( ( 1.0f - blinn_material->GetTransparency() ) * aFPOpacity ) );
+
+            const SFVEC3F diffuseColor = a3DModel->m_Materials[mesh->m_materialIdx].m_Diffuse;
+
+            if( m_boardAdapter.m_Cfg->m_Render.material_mode == MATERIAL_MODE::CAD_MODE )
+                newInstance->SetColor(
+                        ConvertSRGBToLinear( MaterialDiffuseToColorCAD( diffuseColor ) ) );
+            else
+                newInstance->SetColor( ConvertSRGBToLinear( diffuseColor ) );
+        }
+    }
+}
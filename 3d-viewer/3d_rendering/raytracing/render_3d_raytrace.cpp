@@ -28,7 +28,8 @@
 #include <atomic>
 #include <chrono>
 #include <climits>
-#include <thread>
+#include <future>
+#include <vector>
 
 #include "render_3d_raytrace.h"
 #include "mortoncodes.h"
@@ -36,7 +37,10 @@
 #include "3d_fastmath.h"
 #include "3d_math.h"
 #include "../common_ogl/ogl_utils.h"
+#include <advanced_config.h>
 #include <profile.h>        // To use GetRunningMicroSecs or another profiling utility
+#include <thread_pool.h>
+#include <wx/image.h>
 #include <wx/log.h>
 
 
@@ -62,6 +66,7 @@ RENDER_3D_RAYTRACE::RENDER_3D_RAYTRACE( EDA_3D_CANVAS* aCanvas, BOARD_ADAPTER& a
 
     m_xoffset = 0;
     m_yoffset = 0;
+    m_blockPositionsFocus = SFVEC2UI( 0 );
 
     m_isPreview = false;
     m_renderState = RT_RENDER_STATE_MAX; // Set to an initial invalid state
@@ -130,6 +135,12 @@ void RENDER_3D_RAYTRACE::restartRenderState()
 
     m_postShaderSsao.InitFrame();
 
+    // Render first the blocks around the mouse cursor, the final image builds up from there
+    const SFVEC2UI focus = getRenderFocus();
+
+    if( focus != m_blockPositionsFocus )
+        sortBlockPositions( focus );
+
     m_blockPositionsWasProcessed.resize( m_blockPositions.size() );
 
     // Mark the blocks not processed yet
@@ -164,6 +175,7 @@ bool RENDER_3D_RAYTRACE::Redraw( bool aIsMoving, REPORTER* aStatusReporter,
         // revert to preview mode the first time the Redraw is called
         m_oldWindowsSize = m_windowSize;
         initializeBlockPositions();
+        initPbo();
     }
 
     std::unique_ptr<BUSY_INDICATOR> busy = CreateBusyIndicator();
@@ -188,6 +200,7 @@ bool RENDER_3D_RAYTRACE::Redraw( bool aIsMoving, REPORTER* aStatusReporter,
         requestRedraw = true;
 
         initializeBlockPositions();
+        initPbo();
     }
 
 
@@ -284,6 +297,76 @@ bool RENDER_3D_RAYTRACE::Redraw( bool aIsMoving, REPORTER* aStatusReporter,
 }
 
 
+bool RENDER_3D_RAYTRACE::RenderToImage( const wxSize& aSize, wxImage& aImage,
+                                        REPORTER* aStatusReporter, REPORTER* aWarningReporter )
+{
+    if( aSize.x <= 0 || aSize.y <= 0 )
+        return false;
+
+    m_camera.SetCurWindowSize( aSize );
+
+    if( m_reloadRequested )
+        Reload( aStatusReporter, aWarningReporter, false );
+
+    if( !m_accelerator )
+        return false;
+
+    m_windowSize = aSize;
+    m_oldWindowsSize = aSize;
+    initializeBlockPositions();
+
+    // The same RGBA layout as the PBO, bottom row first
+    std::vector<GLubyte> buffer( (size_t) m_realBufferSize.x * m_realBufferSize.y * 4, 0 );
+
+    m_renderState = RT_RENDER_STATE_MAX;
+
+    do
+    {
+        render( buffer.data(), aStatusReporter );
+    } while( m_renderState != RT_RENDER_STATE_FINISH );
+
+    if( !aImage.Create( aSize.x, aSize.y, false ) )
+        return false;
+
+    // The traced area is a bit smaller than the image; fill the borders with the same
+    // background gradient as the canvas
+    const SFVEC3F  bgTop = SFVEC3F( m_boardAdapter.m_BgColorTop );
+    const SFVEC3F  bgBot = SFVEC3F( m_boardAdapter.m_BgColorBot );
+    unsigned char* dst = aImage.GetData();
+
+    for( int y = 0; y < aSize.y; ++y )
+    {
+        const int     bufferY = aSize.y - 1 - y - (int) m_yoffset;
+        const float   posYfactor = (float) ( aSize.y - 1 - y ) / (float) aSize.y;
+        const SFVEC3F bgColor = bgTop * posYfactor + bgBot * ( 1.0f - posYfactor );
+        const bool    rowInBuffer = bufferY >= 0 && bufferY < (int) m_realBufferSize.y;
+
+        for( int x = 0; x < aSize.x; ++x, dst += 3 )
+        {
+            const int bufferX = x - (int) m_xoffset;
+
+            if( rowInBuffer && bufferX >= 0 && bufferX < (int) m_realBufferSize.x )
+            {
+                const size_t   offset = (size_t) bufferY * m_realBufferSize.x + bufferX;
+                const GLubyte* src = &buffer[offset * 4];
+
+                dst[0] = src[0];
+                dst[1] = src[1];
+                dst[2] = src[2];
+            }
+            else
+            {
+                dst[0] = (unsigned char) glm::clamp( (int) ( bgColor.r * 255 ), 0, 255 );
+                dst[1] = (unsigned char) glm::clamp( (int) ( bgColor.g * 255 ), 0, 255 );
+                dst[2] = (unsigned char) glm::clamp( (int) ( bgColor.b * 255 ), 0, 255 );
+            }
+        }
+    }
+
+    return true;
+}
+
+
 void RENDER_3D_RAYTRACE::render( GLubyte* ptrPBO, REPORTER* aStatusReporter )
 {
     if( ( m_renderState == RT_RENDER_STATE_FINISH ) || ( m_renderState >= RT_RENDER_STATE_MAX ) )
@@ -346,20 +429,21 @@ void RENDER_3D_RAYTRACE::renderTracing( GLubyte* ptrPBO, REPORTER* aStatusReport
 {
     m_isPreview = false;
 
-    auto startTime = std::chrono::steady_clock::now();
-    bool breakLoop = false;
+    auto              startTime = std::chrono::steady_clock::now();
+    std::atomic<bool> breakLoop( false );
 
     std::atomic<size_t> numBlocksRendered( 0 );
     std::atomic<size_t> currentBlock( 0 );
-    std::atomic<size_t> threadsFinished( 0 );
 
-    size_t parallelThreadCount = std::min<size_t>(
-            std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
-            m_blockPositions.size() );
+    thread_pool& tp = GetKiCadThreadPool();
+    const size_t parallelThreadCount = std::min<size_t>( tp.get_thread_count(),
+                                                         m_blockPositions.size() );
+
+    std::vector<std::future<void>> returns( parallelThreadCount );
 
     for( size_t ii = 0; ii < parallelThreadCount; ++ii )
     {
-        std::thread t = std::thread( [&]()
+        returns[ii] = tp.submit( [&]()
         {
             for( size_t iBlock = currentBlock.fetch_add( 1 );
                  iBlock < m_blockPositions.size() && !breakLoop;
@@ -378,15 +462,11 @@ void RENDER_3D_RAYTRACE::renderTracing( GLubyte* ptrPBO, REPORTER* aStatusReport
                         breakLoop = true;
                 }
             }
-
-            threadsFinished++;
         } );
-
-        t.detach();
     }
 
-    while( threadsFinished < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    for( std::future<void>& ret : returns )
+        ret.wait();
 
     m_blockRenderProgressCount += numBlocksRendered;
 
@@ -502,7 +582,8 @@ void RENDER_3D_RAYTRACE::renderRayPackets( const SFVEC3F* bgColorY, const RAY* a
 void RENDER_3D_RAYTRACE::renderAntiAliasPackets( const SFVEC3F* aBgColorY,
                                                  const HITINFO_PACKET* aHitPck_X0Y0,
                                                  const HITINFO_PACKET* aHitPck_AA_X1Y1,
-                                                 const RAY* aRayPck, SFVEC3F* aOutHitColor )
+                                                 const RAY* aRayPck, const bool* aConverged,
+                                                 SFVEC3F* aOutHitColor )
 {
     const bool is_testShadow =  m_boardAdapter.m_Cfg->m_Render.raytrace_shadows;
 
@@ -510,6 +591,9 @@ void RENDER_3D_RAYTRACE::renderAntiAliasPackets( const SFVEC3F* aBgColorY,
     {
         for( unsigned int x = 0; x < RAYPACKET_DIM; ++x, ++i )
         {
+            if( aConverged[i] )
+                continue;
+
             const RAY& rayAA = aRayPck[i];
 
             HITINFO hitAA;
@@ -740,30 +824,68 @@ void RENDER_3D_RAYTRACE::renderBlockTracing( GLubyte* ptrPBO, signed int iBlock
             hitColor_AA_X0Y1_half[i] = color_average;
         }
 
-        RAY blockRayPck_AA_X1Y0[RAYPACKET_RAYS_PER_PACKET];
-        RAY blockRayPck_AA_X0Y1[RAYPACKET_RAYS_PER_PACKET];
-        RAY blockRayPck_AA_X1Y1_half[RAYPACKET_RAYS_PER_PACKET];
+        // Adaptive sampling: a pixel whose two first samples hit the same node as its right
+        // and top neighbours, with about the same color, is converged.  It keeps the average
+        // color, so only the edges and the shading details get the extra samples.
+        const float aaThreshold = ADVANCED_CFG::GetCfg().m_3DRT_AdaptiveAAThreshold;
+
+        bool converged[RAYPACKET_RAYS_PER_PACKET];
+        bool allConverged = true;
+
+        for( unsigned int y = 0, i = 0; y < RAYPACKET_DIM; ++y )
+        {
+            for( unsigned int x = 0; x < RAYPACKET_DIM; ++x, ++i )
+            {
+                const HITINFO&     hit = hitPacket_X0Y0[i].m_HitInfo;
+                const SFVEC3F      diff = glm::abs( hitColor_X0Y0[i] - hitColor_AA_X1Y1[i] );
+                const unsigned int nodeRight =
+                        x < RAYPACKET_DIM - 1 ? hitPacket_X0Y0[i + 1].m_HitInfo.m_acc_node_info
+                                              : hit.m_acc_node_info;
+                const unsigned int nodeTop =
+                        y < RAYPACKET_DIM - 1
+                                ? hitPacket_X0Y0[i + RAYPACKET_DIM].m_HitInfo.m_acc_node_info
+                                : hit.m_acc_node_info;
+
+                converged[i] =
+                        ( aaThreshold > 0.0f )
+                        && ( hitPacket_X0Y0[i].m_hitresult == hitPacket_AA_X1Y1[i].m_hitresult )
+                        && ( hit.m_acc_node_info == hitPacket_AA_X1Y1[i].m_HitInfo.m_acc_node_info )
+                        && ( hit.m_acc_node_info == nodeRight )
+                        && ( hit.m_acc_node_info == nodeTop )
+                        && std::max( diff.r, std::max( diff.g, diff.b ) ) < aaThreshold;
+
+                allConverged &= converged[i];
+            }
+        }
+
+        if( !allConverged )
+        {
+            RAY blockRayPck_AA_X1Y0[RAYPACKET_RAYS_PER_PACKET];
+            RAY blockRayPck_AA_X0Y1[RAYPACKET_RAYS_PER_PACKET];
+            RAY blockRayPck_AA_X1Y1_half[RAYPACKET_RAYS_PER_PACKET];
 
-        RAYPACKET_InitRays_with2DDisplacement(
-                m_camera, (SFVEC2F) blockPosI + SFVEC2F( 0.5f - DISP_FACTOR, DISP_FACTOR ),
-                SFVEC2F( DISP_FACTOR, DISP_FACTOR ), blockRayPck_AA_X1Y0 );
+            RAYPACKET_InitRays_with2DDisplacement(
+                    m_camera, (SFVEC2F) blockPosI + SFVEC2F( 0.5f - DISP_FACTOR, DISP_FACTOR ),
+                    SFVEC2F( DISP_FACTOR, DISP_FACTOR ), blockRayPck_AA_X1Y0 );
 
-        RAYPACKET_InitRays_with2DDisplacement(
-                m_camera, (SFVEC2F) blockPosI + SFVEC2F( DISP_FACTOR, 0.5f - DISP_FACTOR ),
-                SFVEC2F( DISP_FACTOR, DISP_FACTOR ), blockRayPck_AA_X0Y1 );
+            RAYPACKET_InitRays_with2DDisplacement(
+                    m_camera, (SFVEC2F) blockPosI + SFVEC2F( DISP_FACTOR, 0.5f - DISP_FACTOR ),
+                    SFVEC2F( DISP_FACTOR, DISP_FACTOR ), blockRayPck_AA_X0Y1 );
 
-        RAYPACKET_InitRays_with2DDisplacement(
-                m_camera, (SFVEC2F) blockPosI + SFVEC2F( 0.25f - DISP_FACTOR, 0.25f - DISP_FACTOR ),
-                SFVEC2F( DISP_FACTOR, DISP_FACTOR ), blockRayPck_AA_X1Y1_half );
+            RAYPACKET_InitRays_with2DDisplacement(
+                    m_camera,
+                    (SFVEC2F) blockPosI + SFVEC2F( 0.25f - DISP_FACTOR, 0.25f - DISP_FACTOR ),
+                    SFVEC2F( DISP_FACTOR, DISP_FACTOR ), blockRayPck_AA_X1Y1_half );
 
-        renderAntiAliasPackets( bgColor, hitPacket_X0Y0, hitPacket_AA_X1Y1, blockRayPck_AA_X1Y0,
-                                hitColor_AA_X1Y0 );
+            renderAntiAliasPackets( bgColor, hitPacket_X0Y0, hitPacket_AA_X1Y1,
+                                    blockRayPck_AA_X1Y0, converged, hitColor_AA_X1Y0 );
 
-        renderAntiAliasPackets( bgColor, hitPacket_X0Y0, hitPacket_AA_X1Y1, blockRayPck_AA_X0Y1,
-                                hitColor_AA_X0Y1 );
+            renderAntiAliasPackets( bgColor, hitPacket_X0Y0, hitPacket_AA_X1Y1,
+                                    blockRayPck_AA_X0Y1, converged, hitColor_AA_X0Y1 );
 
-        renderAntiAliasPackets( bgColor, hitPacket_X0Y0, hitPacket_AA_X1Y1,
-                                blockRayPck_AA_X1Y1_half, hitColor_AA_X0Y1_half );
+            renderAntiAliasPackets( bgColor, hitPacket_X0Y0, hitPacket_AA_X1Y1,
+                                    blockRayPck_AA_X1Y1_half, converged, hitColor_AA_X0Y1_half );
+        }
 
         // Average the result
         for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
@@ -844,13 +966,15 @@ void RENDER_3D_RAYTRACE::postProcessShading( GLubyte* /* ptrPBO */, REPORTER* aS
         m_postShaderSsao.SetShadowsEnabled( m_boardAdapter.m_Cfg->m_Render.raytrace_shadows );
 
         std::atomic<size_t> nextBlock( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
 
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
+        thread_pool& tp = GetKiCadThreadPool();
+        const size_t parallelThreadCount = tp.get_thread_count();
+
+        std::vector<std::future<void>> returns( parallelThreadCount );
 
         for( size_t ii = 0; ii < parallelThreadCount; ++ii )
         {
-            std::thread t = std::thread( [&]()
+            returns[ii] = tp.submit( [&]()
             {
                 for( size_t y = nextBlock.fetch_add( 1 ); y < m_realBufferSize.y;
                      y = nextBlock.fetch_add( 1 ) )
@@ -863,15 +987,11 @@ void RENDER_3D_RAYTRACE::postProcessShading( GLubyte* /* ptrPBO */, REPORTER* aS
                         ptr++;
                     }
                 }
-
-                threadsFinished++;
             } );
-
-            t.detach();
         }
 
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+        for( std::future<void>& ret : returns )
+            ret.wait();
 
         m_postShaderSsao.SetShadedBuffer( m_shaderBuffer );
 
@@ -892,13 +1012,15 @@ void RENDER_3D_RAYTRACE::postProcessBlurFinish( GLubyte* ptrPBO, REPORTER* /* aS
     {
         // Now blurs the shader result and compute the final color
         std::atomic<size_t> nextBlock( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
 
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
+        thread_pool& tp = GetKiCadThreadPool();
+        const size_t parallelThreadCount = tp.get_thread_count();
+
+        std::vector<std::future<void>> returns( parallelThreadCount );
 
         for( size_t ii = 0; ii < parallelThreadCount; ++ii )
         {
-            std::thread t = std::thread( [&]()
+            returns[ii] = tp.submit( [&]()
             {
                 for( size_t y = nextBlock.fetch_add( 1 ); y < m_realBufferSize.y;
                      y = nextBlock.fetch_add( 1 ) )
@@ -924,15 +1046,11 @@ void RENDER_3D_RAYTRACE::postProcessBlurFinish( GLubyte* ptrPBO, REPORTER* /* aS
                         ptr += 4;
                     }
                 }
-
-                threadsFinished++;
             } );
-
-            t.detach();
         }
 
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+        for( std::future<void>& ret : returns )
+            ret.wait();
 
         // Debug code
         //m_postShaderSsao.DebugBuffersOutputAsImages();
@@ -948,15 +1066,16 @@ void RENDER_3D_RAYTRACE::renderPreview( GLubyte* ptrPBO )
     m_isPreview = true;
 
     std::atomic<size_t> nextBlock( 0 );
-    std::atomic<size_t> threadsFinished( 0 );
 
-    size_t parallelThreadCount = std::min<size_t>(
-            std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
-            m_blockPositions.size() );
+    thread_pool& tp = GetKiCadThreadPool();
+    const size_t parallelThreadCount = std::min<size_t>( tp.get_thread_count(),
+                                                         m_blockPositions.size() );
+
+    std::vector<std::future<void>> returns( parallelThreadCount );
 
     for( size_t ii = 0; ii < parallelThreadCount; ++ii )
     {
-        std::thread t = std::thread( [&]()
+        returns[ii] = tp.submit( [&]()
         {
             for( size_t iBlock = nextBlock.fetch_add( 1 ); iBlock < m_blockPositionsFast.size();
                  iBlock = nextBlock.fetch_add( 1 ) )
@@ -1525,15 +1644,11 @@ void RENDER_3D_RAYTRACE::renderPreview( GLubyte* ptrPBO )
                     }
                 }
             }
-
-            threadsFinished++;
         } );
-
-        t.detach();
     }
 
-    while( threadsFinished < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    for( std::future<void>& ret : returns )
+        ret.wait();
 }
 
 
@@ -1909,18 +2024,49 @@ void RENDER_3D_RAYTRACE::initializeBlockPositions()
             m_blockPositions.emplace_back( x * RAYPACKET_DIM, y * RAYPACKET_DIM );
     }
 
-    const SFVEC2UI center( m_realBufferSize.x / 2, m_realBufferSize.y / 2 );
-    std::sort( m_blockPositions.begin(), m_blockPositions.end(),
-            [&]( const SFVEC2UI& a, const SFVEC2UI& b ) {
-                // Sort order: inside out.
-                return distance( a, center ) < distance( b, center );
-            } );
+    sortBlockPositions( getRenderFocus() );
 
     // Create m_shader buffer
     delete[] m_shaderBuffer;
     m_shaderBuffer = new SFVEC3F[m_realBufferSize.x * m_realBufferSize.y];
+}
 
-    initPbo();
+
+SFVEC2UI RENDER_3D_RAYTRACE::getRenderFocus()
+{
+    const SFVEC2UI center( m_realBufferSize.x / 2, m_realBufferSize.y / 2 );
+
+    // Offscreen renders have no mouse cursor
+    if( !m_canvas )
+        return center;
+
+    // The render buffer is bottom row first
+    const wxPoint& mousePos = m_camera.GetCurMousePosition();
+    const int      x = mousePos.x - (int) m_xoffset;
+    const int      y = m_windowSize.y - mousePos.y - (int) m_yoffset;
+
+    if( x < 0 || y < 0 || x >= (int) m_realBufferSize.x || y >= (int) m_realBufferSize.y )
+        return center;
+
+    return SFVEC2UI( x, y );
+}
+
+
+void RENDER_3D_RAYTRACE::sortBlockPositions( const SFVEC2UI& aFocus )
+{
+    m_blockPositionsFocus = aFocus;
+
+    // The distance is from the block center
+    const unsigned int halfBlock = RAYPACKET_DIM / 2;
+    const SFVEC2UI     focus( std::max( aFocus.x, halfBlock ) - halfBlock,
+                              std::max( aFocus.y, halfBlock ) - halfBlock );
+
+    std::sort( m_blockPositions.begin(), m_blockPositions.end(),
+            [&]( const SFVEC2UI& a, const SFVEC2UI& b )
+            {
+                // Sort order: inside out.
+                return distance( a, focus ) < distance( b, focus );
+            } );
 }
 
 
@@ -35,6 +35,9 @@
 #include <plugins/3dapi/c3dmodel.h>
 
 #include <map>
+#include <memory>
+
+class wxImage;
 
 /// Vector of materials
 typedef std::vector< BLINN_PHONG_MATERIAL > MODEL_MATERIALS;
@@ -42,6 +45,18 @@ typedef std::vector< BLINN_PHONG_MATERIAL > MODEL_MATERIALS;
 /// Maps a S3DMODEL pointer with a created BLINN_PHONG_MATERIAL vector
 typedef std::map< const S3DMODEL* , MODEL_MATERIALS > MAP_MODEL_MATERIALS;
 
+/// The triangles of a mesh of a 3D model in model coordinates, shared by its instances
+struct INSTANCED_MESH
+{
+    CONTAINER_3D                    m_triangles;
+    std::unique_ptr<ACCELERATOR_3D> m_accelerator;
+    unsigned int                    m_materialIdx;
+
+    /// The material of the mesh without its normal generator, the generator is applied by
+    /// the instances in world coordinates.
+    BLINN_PHONG_MATERIAL            m_material;
+};
+
 typedef enum
 {
     RT_RENDER_STATE_TRACING = 0,
@@ -73,12 +88,31 @@ public:
 
     BOARD_ITEM *IntersectBoardItem( const RAY& aRay );
 
+    /**
+     * Render the scene at full quality into an image, without using OpenGL.
+     *
+     * The whole tracing and post processing pipeline runs on the CPU, using all the cores,
+     * so this can be used without a window or a GL context (e.g. on a headless server).  The
+     * board is loaded first if a reload is pending.  This renderer must not be used to draw
+     * a canvas at the same time.
+     *
+     * @param aSize is the size of the image, in pixels.
+     * @param aImage will receive the rendered image.
+     * @return true on success, false if there is nothing to render.
+     */
+    bool RenderToImage( const wxSize& aSize, wxImage& aImage, REPORTER* aStatusReporter = nullptr,
+                        REPORTER* aWarningReporter = nullptr );
+
+    /// @return the acceleration structure of the loaded scene, nullptr if nothing is loaded.
+    const ACCELERATOR_3D* GetAccelerator() const { return m_accelerator; }
+
 private:
     bool initializeOpenGL();
     void initializeNewWindowSize();
     void initPbo();
     void deletePbo();
-    void createItemsFromContainer( const BVH_CONTAINER_2D* aContainer2d, PCB_LAYER_ID aLayer_id,
+    void createItemsFromContainer( CONTAINER_3D& aDstContainer,
+                                   const BVH_CONTAINER_2D* aContainer2d, PCB_LAYER_ID aLayer_id,
                                    const MATERIAL* aMaterialLayer, const SFVEC3F& aLayerColor,
                                    float aLayerZOffset );
 
@@ -93,9 +127,14 @@ private:
     void renderRayPackets( const SFVEC3F* bgColorY, const RAY* aRayPkt, HITINFO_PACKET* aHitPacket,
                            bool is_testShadow, SFVEC3F* aOutHitColor );
 
+    /**
+     * Shade an anti-aliasing sample of each pixel of a packet.
+     *
+     * @param aConverged flags the pixels that need no more samples, their color is unchanged.
+     */
     void renderAntiAliasPackets( const SFVEC3F* aBgColorY, const HITINFO_PACKET* aHitPck_X0Y0,
                                  const HITINFO_PACKET* aHitPck_AA_X1Y1, const RAY* aRayPck,
-                                 SFVEC3F* aOutHitColor );
+                                 const bool* aConverged, SFVEC3F* aOutHitColor );
 
     // Materials
     void setupMaterials();
@@ -121,10 +160,29 @@ private:
                     const glm::mat4& aModelMatrix, float aFPOpacity,
                     bool aSkipMaterialInformation, BOARD_ITEM* aBoardItem );
 
+    /**
+     * Create the triangles of the meshes of a 3D model in model coordinates, to be shared by
+     * its instances.  The accelerators of the meshes are not built.
+     */
+    void createInstancedMeshes( const S3DMODEL* a3DModel, bool aSkipMaterialInformation,
+                                std::vector<std::unique_ptr<INSTANCED_MESH>>& aMeshes );
+
+    /// Add an instance of each of the shared meshes of a 3D model.
+    void addModelInstances( CONTAINER_3D& aDstContainer, const S3DMODEL* a3DModel,
+                            const std::vector<std::unique_ptr<INSTANCED_MESH>>& aMeshes,
+                            const glm::mat4& aModelMatrix, float aFPOpacity,
+                            bool aSkipMaterialInformation, BOARD_ITEM* aBoardItem );
+
     MODEL_MATERIALS* getModelMaterial( const S3DMODEL* a3DModel );
 
     void initializeBlockPositions();
 
+    /// @return the position in the render buffer the user is most likely looking at.
+    SFVEC2UI getRenderFocus();
+
+    /// Sort the blocks to render the closest to \a aFocus first.
+    void sortBlockPositions( const SFVEC2UI& aFocus );
+
     void render( GLubyte* ptrPBO, REPORTER* aStatusReporter );
     void renderPreview( GLubyte* ptrPBO );
 
@@ -189,6 +247,9 @@ private:
     ///< Encode Morton code positions.
     std::vector< SFVEC2UI > m_blockPositions;
 
+    ///< Position in the render buffer the blocks are sorted around.
+    SFVEC2UI m_blockPositionsFocus;
+
     ///< Flag if a position was already processed (cleared each new render).
     std::vector< int > m_blockPositionsWasProcessed;
 
@@ -209,6 +270,9 @@ private:
     /// Stores materials of the 3D models
     MAP_MODEL_MATERIALS m_modelMaterialMap;
 
+    /// Stores the shared meshes of the 3D models placed several times
+    std::map<const S3DMODEL*, std::vector<std::unique_ptr<INSTANCED_MESH>>> m_instancedMeshes;
+
     // Statistics
     unsigned int m_convertedDummyBlockCount;
     unsigned int m_converted2dRoundSegmentCount;
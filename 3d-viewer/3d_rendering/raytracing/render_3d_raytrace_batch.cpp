@@ -0,0 +1,119 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <gal/opengl/kiglew.h>    // Must be included first
+
+#include "render_3d_raytrace_batch.h"
+#include "render_3d_raytrace.h"
+#include "../track_ball.h"
+#include <i18n_utility.h>
+#include <pgm_base.h>
+#include <reporter.h>
+#include <settings/settings_manager.h>
+#include <wx/image.h>
+
+
+void SetRaytraceView( CAMERA& aCamera, RAYTRACE_VIEW aView )
+{
+    aCamera.Reset();
+
+    // Same rotations as EDA_3D_CANVAS::SetView3D()
+    switch( aView )
+    {
+    case RAYTRACE_VIEW::TOP:
+        break;
+
+    case RAYTRACE_VIEW::BOTTOM:
+        aCamera.RotateY( glm::radians( 179.999f ) );
+        break;
+
+    case RAYTRACE_VIEW::FRONT:
+        aCamera.RotateX( glm::radians( -90.0f ) );
+        break;
+
+    case RAYTRACE_VIEW::BACK:
+        aCamera.RotateX( glm::radians( -90.0f ) );
+        aCamera.RotateZ( glm::radians( 179.999f ) );
+        break;
+
+    case RAYTRACE_VIEW::LEFT:
+        aCamera.RotateZ( glm::radians( 90.0f ) );
+        aCamera.RotateX( glm::radians( -90.0f ) );
+        break;
+
+    case RAYTRACE_VIEW::RIGHT:
+        aCamera.RotateZ( glm::radians( -90.0f ) );
+        aCamera.RotateX( glm::radians( -90.0f ) );
+        break;
+    }
+}
+
+
+int RenderBoardImages( BOARD* aBoard, S3D_CACHE* a3DCache, EDA_3D_VIEWER_SETTINGS* aCfg,
+                       std::vector<RAYTRACE_BATCH_JOB>& aJobs, REPORTER* aReporter )
+{
+    wxCHECK( aBoard && aCfg, 0 );
+
+    BOARD_ADAPTER adapter;
+
+    adapter.SetBoard( aBoard );
+    adapter.Set3dCacheManager( a3DCache );
+    adapter.SetColorSettings( Pgm().GetSettingsManager().GetColorSettings() );
+    adapter.m_Cfg = aCfg;
+
+    TRACK_BALL         camera( 2 * RANGE_SCALE_3D );
+    RENDER_3D_RAYTRACE renderer( nullptr, adapter, camera );
+    int                successCount = 0;
+
+    // Build the scene once for all the views
+    renderer.Reload( aReporter, aReporter, false );
+
+    for( RAYTRACE_BATCH_JOB& job : aJobs )
+    {
+        wxImage image;
+
+        SetRaytraceView( camera, job.m_View );
+
+        if( job.m_Zoom > 0.0f && job.m_Zoom != 1.0f )
+            camera.Zoom( job.m_Zoom );
+
+        job.m_Success = renderer.RenderToImage( job.m_Size, image, aReporter, aReporter )
+                        && image.SaveFile( job.m_FileName, wxBITMAP_TYPE_PNG );
+
+        if( aReporter )
+        {
+            if( job.m_Success )
+                aReporter->Report( wxString::Format( _( "Rendered '%s'." ), job.m_FileName ),
+                                   RPT_SEVERITY_ACTION );
+            else
+                aReporter->Report( wxString::Format( _( "Failed to render '%s'." ),
+                                                     job.m_FileName ),
+                                   RPT_SEVERITY_ERROR );
+        }
+
+        if( job.m_Success )
+            successCount++;
+    }
+
+    return successCount;
+}
@@ -0,0 +1,90 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef RENDER_3D_RAYTRACE_BATCH_H
+#define RENDER_3D_RAYTRACE_BATCH_H
+
+#include <vector>
+#include <wx/gdicmn.h>
+#include <wx/string.h>
+
+class BOARD;
+class CAMERA;
+class EDA_3D_VIEWER_SETTINGS;
+class REPORTER;
+class S3D_CACHE;
+
+
+/// Camera presets for RenderBoardImages(), the same views as the 3D viewer toolbar.
+enum class RAYTRACE_VIEW
+{
+    TOP,
+    BOTTOM,
+    FRONT,
+    BACK,
+    LEFT,
+    RIGHT
+};
+
+
+/**
+ * Reset \a aCamera and rotate it to one of the preset views.
+ */
+void SetRaytraceView( CAMERA& aCamera, RAYTRACE_VIEW aView );
+
+
+/**
+ * An image to render with RenderBoardImages().
+ */
+struct RAYTRACE_BATCH_JOB
+{
+    RAYTRACE_BATCH_JOB( RAYTRACE_VIEW aView, const wxSize& aSize, const wxString& aFileName ) :
+            m_View( aView ),
+            m_Zoom( 1.0f ),
+            m_Size( aSize ),
+            m_FileName( aFileName ),
+            m_Success( false )
+    {}
+
+    RAYTRACE_VIEW m_View;
+    float         m_Zoom;        ///< Zoom factor from the preset view, > 1 to zoom in
+    wxSize        m_Size;        ///< Image size in pixels
+    wxString      m_FileName;    ///< Output PNG file
+    bool          m_Success;     ///< Set by RenderBoardImages()
+};
+
+
+/**
+ * Render images of a board with the raytracer and save them as PNG files.
+ *
+ * Everything runs on the CPU (using all the cores for each image) and no window or OpenGL
+ * context is needed, so this can run on a headless server.  The board scene is built only
+ * once for all the jobs.  Render options and colors are taken from \a aCfg and the current
+ * color settings, like in the 3D viewer.
+ *
+ * @return the number of images successfully written.
+ */
+int RenderBoardImages( BOARD* aBoard, S3D_CACHE* a3DCache, EDA_3D_VIEWER_SETTINGS* aCfg,
+                       std::vector<RAYTRACE_BATCH_JOB>& aJobs, REPORTER* aReporter = nullptr );
+
+#endif // RENDER_3D_RAYTRACE_BATCH_H
@@ -31,6 +31,8 @@
 
 #include "bbox_2d.h"
 
+#include <atomic>
+
 class BOARD_ITEM;
 
 enum class INTERSECTION_RESULT
@@ -121,7 +123,8 @@ class OBJECT_2D_STATS
 public:
     void ResetStats()
     {
-        memset( m_counter, 0, sizeof( unsigned int ) * static_cast<int>( OBJECT_2D_TYPE::MAX ) );
+        for( std::atomic<unsigned int>& counter : m_counter )
+            counter = 0;
     }
 
     unsigned int GetCountOf( OBJECT_2D_TYPE aObjType ) const
@@ -131,7 +134,8 @@ public:
 
     void AddOne( OBJECT_2D_TYPE aObjType )
     {
-        m_counter[static_cast<int>( aObjType )]++;
+        // Objects are created from several threads when loading a scene
+        m_counter[static_cast<int>( aObjType )].fetch_add( 1, std::memory_order_relaxed );
     }
 
     static OBJECT_2D_STATS& Instance()
@@ -148,7 +152,7 @@ private:
     const OBJECT_2D_STATS& operator=( const OBJECT_2D_STATS& old );
     ~OBJECT_2D_STATS(){}
 
-    unsigned int m_counter[static_cast<int>( OBJECT_2D_TYPE::MAX )];
+    std::atomic<unsigned int> m_counter[static_cast<int>( OBJECT_2D_TYPE::MAX )];
 
     static OBJECT_2D_STATS* s_instance;
 };
@@ -0,0 +1,126 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file model_instance_3d.cpp
+ */
+
+#include "model_instance_3d.h"
+#include "../accelerators/accelerator_3d.h"
+
+#include <limits>
+
+
+MODEL_INSTANCE_3D::MODEL_INSTANCE_3D( const ACCELERATOR_3D* aMesh, const BBOX_3D& aMeshBBox,
+                                      const glm::mat4& aModelMatrix ) :
+        OBJECT_3D( OBJECT_3D_TYPE::MODELINSTANCE ),
+        m_mesh( aMesh ),
+        m_diffuseColor( 0.0f )
+{
+    m_worldToModel = glm::inverse( aModelMatrix );
+    m_normalMatrix = glm::transpose( glm::mat3( m_worldToModel ) );
+
+    // The bounding box of the transformed corners of the mesh box
+    const SFVEC3F& pMin = aMeshBBox.Min();
+    const SFVEC3F& pMax = aMeshBBox.Max();
+
+    m_bbox.Reset();
+
+    for( int corner = 0; corner < 8; ++corner )
+    {
+        const SFVEC3F p( ( corner & 1 ) ? pMax.x : pMin.x, ( corner & 2 ) ? pMax.y : pMin.y,
+                         ( corner & 4 ) ? pMax.z : pMin.z );
+
+        m_bbox.Union( SFVEC3F( aModelMatrix * glm::vec4( p, 1.0f ) ) );
+    }
+
+    m_bbox.ScaleNextUp();
+    m_centroid = m_bbox.GetCenter();
+}
+
+
+float MODEL_INSTANCE_3D::toModel( const RAY& aRay, RAY& aModelRay ) const
+{
+    const SFVEC3F dir = SFVEC3F( m_worldToModel * glm::vec4( aRay.m_Dir, 0.0f ) );
+    const float   scale = glm::length( dir );
+
+    aModelRay.Init( SFVEC3F( m_worldToModel * glm::vec4( aRay.m_Origin, 1.0f ) ), dir / scale );
+
+    return scale;
+}
+
+
+bool MODEL_INSTANCE_3D::Intersect( const RAY& aRay, HITINFO& aHitInfo ) const
+{
+    float t;
+
+    if( !m_bbox.Intersect( aRay, &t ) || t > aHitInfo.m_tHit )
+        return false;
+
+    RAY         modelRay;
+    const float scale = toModel( aRay, modelRay );
+
+    HITINFO modelHitInfo;
+    modelHitInfo.m_tHit = aHitInfo.m_tHit * scale;
+    modelHitInfo.m_acc_node_info = 0;
+
+    if( !m_mesh->Intersect( modelRay, modelHitInfo ) )
+        return false;
+
+    aHitInfo.m_tHit = modelHitInfo.m_tHit / scale;
+    aHitInfo.m_HitPoint = aRay.at( aHitInfo.m_tHit );
+    aHitInfo.m_HitNormal = glm::normalize( m_normalMatrix * modelHitInfo.m_HitNormal );
+
+    // The procedural normals are generated in world coordinates, as for the other objects
+    m_material->Generate( aHitInfo.m_HitNormal, aRay, aHitInfo );
+
+    aHitInfo.pHitObject = this;
+
+    return true;
+}
+
+
+bool MODEL_INSTANCE_3D::IntersectP( const RAY& aRay, float aMaxDistance ) const
+{
+    float t;
+
+    if( !m_bbox.Intersect( aRay, &t ) || t > aMaxDistance )
+        return false;
+
+    RAY         modelRay;
+    const float scale = toModel( aRay, modelRay );
+
+    return m_mesh->IntersectP( modelRay, aMaxDistance * scale );
+}
+
+
+bool MODEL_INSTANCE_3D::Intersects( const BBOX_3D& aBBox ) const
+{
+    return m_bbox.Intersects( aBBox );
+}
+
+
+SFVEC3F MODEL_INSTANCE_3D::GetDiffuseColor( const HITINFO& /* aHitInfo */ ) const
+{
+    return m_diffuseColor;
+}
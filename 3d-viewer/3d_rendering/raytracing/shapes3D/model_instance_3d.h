@@ -0,0 +1,82 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file model_instance_3d.h
+ */
+
+#ifndef _MODEL_INSTANCE_3D_H_
+#define _MODEL_INSTANCE_3D_H_
+
+#include "object_3d.h"
+
+#include <glm/glm.hpp>
+
+class ACCELERATOR_3D;
+
+
+/**
+ * An instance of a mesh of a 3D model, placed in the scene by a transform.
+ *
+ * The triangles of the mesh are stored once in model coordinates, in an accelerator shared by
+ * all the instances of the mesh, and the rays are transformed to the model coordinates to be
+ * intersected with it.  All the triangles of a mesh have the same material and color, so they
+ * are taken from the instance when it is hit.
+ */
+class MODEL_INSTANCE_3D : public OBJECT_3D
+{
+public:
+    /**
+     * @param aMesh is the accelerator of the mesh triangles, it must outlive the instance.
+     * @param aMeshBBox is the bounding box of the mesh in model coordinates.
+     * @param aModelMatrix transforms the model coordinates to the world coordinates, it must
+     *                     not be a reflection.
+     */
+    MODEL_INSTANCE_3D( const ACCELERATOR_3D* aMesh, const BBOX_3D& aMeshBBox,
+                       const glm::mat4& aModelMatrix );
+
+    void SetColor( const SFVEC3F& aColor ) { m_diffuseColor = aColor; }
+
+    bool Intersect( const RAY& aRay, HITINFO& aHitInfo ) const override;
+    bool IntersectP( const RAY& aRay, float aMaxDistance ) const override;
+    bool Intersects( const BBOX_3D& aBBox ) const override;
+    SFVEC3F GetDiffuseColor( const HITINFO& aHitInfo ) const override;
+
+private:
+    /**
+     * Transform a ray to the model coordinates.
+     *
+     * @return the ratio of the model to the world distances along the ray.
+     */
+    float toModel( const RAY& aRay, RAY& aModelRay ) const;
+
+    const ACCELERATOR_3D* m_mesh;
+
+    glm::mat4 m_worldToModel;
+    glm::mat3 m_normalMatrix;       ///< model to world transform of the normals
+
+    SFVEC3F m_diffuseColor;
+};
+
+
+#endif // _MODEL_INSTANCE_3D_H_
@@ -32,6 +32,8 @@
 #include "bbox_3d.h"
 #include "../material.h"
 
+#include <atomic>
+
 class BOARD_ITEM;
 class HITINFOR;
 
@@ -43,6 +45,7 @@ enum class OBJECT_3D_TYPE
     XYPLANE,
     ROUNDSEG,
     TRIANGLE,
+    MODELINSTANCE,
     MAX
 };
 
@@ -114,7 +117,8 @@ class OBJECT_3D_STATS
 public:
     void ResetStats()
     {
-        memset( m_counter, 0, sizeof( unsigned int ) * static_cast<int>( OBJECT_3D_TYPE::MAX ) );
+        for( std::atomic<unsigned int>& counter : m_counter )
+            counter = 0;
     }
 
     unsigned int GetCountOf( OBJECT_3D_TYPE aObjType ) const
@@ -124,7 +128,8 @@ public:
 
     void AddOne( OBJECT_3D_TYPE aObjType )
     {
-        m_counter[static_cast<int>( aObjType )]++;
+        // Objects are created from several threads when loading a scene
+        m_counter[static_cast<int>( aObjType )].fetch_add( 1, std::memory_order_relaxed );
     }
 
     // void PrintStats();
@@ -143,7 +148,7 @@ private:
     const OBJECT_3D_STATS& operator=( const OBJECT_3D_STATS& old );
     ~OBJECT_3D_STATS() {}
 
-    unsigned int m_counter[static_cast<int>( OBJECT_3D_TYPE::MAX )];
+    std::atomic<unsigned int> m_counter[static_cast<int>( OBJECT_3D_TYPE::MAX )];
 
     static OBJECT_3D_STATS* s_instance;
 };
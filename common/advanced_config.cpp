@@ -196,6 +196,19 @@ static const wxChar ShowPropertiesPanel[] = wxT( "ShowPropertiesPanel" );
 static const wxChar V3DRT_BevelHeight_um[] = wxT( "V3DRT_BevelHeight_um" );
 
 static const wxChar V3DRT_BevelExtentFactor[] = wxT( "V3DRT_BevelExtentFactor" );
+
+static const wxChar V3DRT_AdaptiveAAThreshold[] = wxT( "V3DRT_AdaptiveAAThreshold" );
+
+/**
+ * Generate multi-layer plots concurrently on the thread pool, using one plotter per
+ * output file.  Output is identical to the sequential path; this is a debugging switch.
+ */
+static const wxChar ParallelPlot[] = wxT( "ParallelPlot" );
+
+/**
+ * Rasterize the buffers of the Cairo canvas in bands, concurrently on the thread pool.
+ */
+static const wxChar CairoTiledRendering[] = wxT( "CairoTiledRendering" );
 } // namespace KEYS
 
 
@@ -319,9 +332,12 @@ ADVANCED_CFG::ADVANCED_CFG()
     m_UpdateUIEventInterval     = 0;
     m_ShowRepairSchematic       = false;
     m_ShowPropertiesPanel       = false;
+    m_ParallelPlot              = true;
+    m_CairoTiledRendering       = true;
 
     m_3DRT_BevelHeight_um       = 30;
     m_3DRT_BevelExtentFactor    = 1.0 / 16.0;
+    m_3DRT_AdaptiveAAThreshold  = 0.02;
 
     loadFromConfigFile();
 }
@@ -462,6 +478,18 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
                                                   0.0, 100.0,
                                                   AC_GROUPS::V3D_RayTracing ) );
 
+    configParams.push_back( new PARAM_CFG_DOUBLE( true, AC_KEYS::V3DRT_AdaptiveAAThreshold,
+                                                  &m_3DRT_AdaptiveAAThreshold,
+                                                  m_3DRT_AdaptiveAAThreshold, 0.0, 1.0,
+                                                  AC_GROUPS::V3D_RayTracing ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::ParallelPlot,
+                                                &m_ParallelPlot, m_ParallelPlot ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::CairoTiledRendering,
+                                                &m_CairoTiledRendering,
+                                                m_CairoTiledRendering ) );
+
 
 
     // Special case for trace mask setting...we just grab them and set them immediately
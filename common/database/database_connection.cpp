@@ -18,6 +18,8 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+
 #include <boost/locale.hpp>
 #include <fmt/core.h>
 #include <nanodbc/nanodbc.h>
@@ -89,7 +91,7 @@ DATABASE_CONNECTION::DATABASE_CONNECTION( const std::string& aDataSourceName,
     m_pass    = aPassword;
     m_timeout = aTimeoutSeconds;
 
-    m_cache = std::make_unique<DATABASE_CACHE>( 10, 1 );
+    m_cache = std::make_unique<DATABASE_CACHE>( DEFAULT_CACHE_SIZE, DEFAULT_CACHE_AGE );
 
     if( aConnectNow )
         Connect();
@@ -103,7 +105,7 @@ DATABASE_CONNECTION::DATABASE_CONNECTION( const std::string& aConnectionString,
     m_connectionString = aConnectionString;
     m_timeout          = aTimeoutSeconds;
 
-    m_cache = std::make_unique<DATABASE_CACHE>( 10, 1 );
+    m_cache = std::make_unique<DATABASE_CACHE>( DEFAULT_CACHE_SIZE, DEFAULT_CACHE_AGE );
 
     if( aConnectNow )
         Connect();
@@ -140,6 +142,8 @@ bool DATABASE_CONNECTION::Connect()
     nanodbc::string pass = fromUTF8( m_pass );
     nanodbc::string cs   = fromUTF8( m_connectionString );
 
+    m_statements.clear();
+
     try
     {
         if( cs.empty() )
@@ -178,6 +182,7 @@ bool DATABASE_CONNECTION::Disconnect()
         return false;
     }
 
+    m_statements.clear();
     m_conn->disconnect();
 
     return !m_conn->connected();
@@ -283,6 +288,22 @@ bool DATABASE_CONNECTION::getQuoteChar()
 }
 
 
+nanodbc::statement& DATABASE_CONNECTION::getStatement( const std::string& aQuery )
+{
+    auto it = m_statements.find( aQuery );
+
+    if( it != m_statements.end() )
+        return *it->second;
+
+    auto statement = std::make_unique<nanodbc::statement>( *m_conn );
+    statement->prepare( fromUTF8( aQuery ) );
+
+    wxLogTrace( traceDatabase, wxT( "Prepared statement `%s`" ), aQuery );
+
+    return *m_statements.emplace( aQuery, std::move( statement ) ).first->second;
+}
+
+
 bool DATABASE_CONNECTION::SelectOne( const std::string& aTable,
                                      const std::pair<std::string, std::string>& aWhere,
                                      DATABASE_CONNECTION::ROW& aResult )
@@ -328,20 +349,19 @@ bool DATABASE_CONNECTION::SelectOne( const std::string& aTable,
                                         m_quoteChar, tableName, m_quoteChar,
                                         m_quoteChar, columnName, m_quoteChar );
 
-    nanodbc::statement statement( *m_conn );
-    nanodbc::string query = fromUTF8( queryStr );
-
     if( m_cache->Get( cacheKey, aResult ) )
     {
         wxLogTrace( traceDatabase, wxT( "SelectOne: `%s` with parameter `%s` - cache hit" ),
-                    toUTF8( query ), aWhere.second );
+                    queryStr, aWhere.second );
         return true;
     }
 
+    nanodbc::statement* statement = nullptr;
+
     try
     {
-        statement.prepare( query );
-        statement.bind( 0, aWhere.second.c_str() );
+        statement = &getStatement( queryStr );
+        statement->bind( 0, aWhere.second.c_str() );
     }
     catch( nanodbc::database_error& e )
     {
@@ -351,14 +371,14 @@ bool DATABASE_CONNECTION::SelectOne( const std::string& aTable,
         return false;
     }
 
-    wxLogTrace( traceDatabase, wxT( "SelectOne: `%s` with parameter `%s`" ), toUTF8( query ),
+    wxLogTrace( traceDatabase, wxT( "SelectOne: `%s` with parameter `%s`" ), queryStr,
                 aWhere.second );
 
     nanodbc::result results;
 
     try
     {
-        results = nanodbc::execute( statement );
+        results = nanodbc::execute( *statement );
     }
     catch( nanodbc::database_error& e )
     {
@@ -401,6 +421,123 @@ bool DATABASE_CONNECTION::SelectOne( const std::string& aTable,
 }
 
 
+bool DATABASE_CONNECTION::SelectMany( const std::string& aTable, const std::string& aColumn,
+                                      const std::vector<std::string>& aValues,
+                                      std::vector<ROW>& aResults )
+{
+    if( !m_conn )
+    {
+        wxLogTrace( traceDatabase, wxT( "Called SelectMany without valid connection!" ) );
+        return false;
+    }
+
+    auto tableMapIter = m_tables.find( aTable );
+
+    if( tableMapIter == m_tables.end() )
+    {
+        wxLogTrace( traceDatabase, wxT( "SelectMany: requested table %s not found in cache" ),
+                    aTable );
+        return false;
+    }
+
+    const std::string& tableName = tableMapIter->first;
+
+    if( !m_columnCache.count( tableName ) )
+    {
+        wxLogTrace( traceDatabase, wxT( "SelectMany: requested table %s missing from column cache" ),
+                    tableName );
+        return false;
+    }
+
+    auto columnCacheIter = m_columnCache.at( tableName ).find( aColumn );
+
+    if( columnCacheIter == m_columnCache.at( tableName ).end() )
+    {
+        wxLogTrace( traceDatabase, wxT( "SelectMany: requested column %s not found in cache for %s" ),
+                    aColumn, tableName );
+        return false;
+    }
+
+    const std::string& columnName = columnCacheIter->first;
+
+    // Look the values up in batches, so that the number of query parameters stays well below
+    // the limits of the database engines (999 for older SQLite versions)
+    for( size_t first = 0; first < aValues.size(); first += MAX_SELECT_MANY_VALUES )
+    {
+        size_t count = std::min( MAX_SELECT_MANY_VALUES, aValues.size() - first );
+
+        std::string queryStr = fmt::format( "SELECT * FROM {}{}{} WHERE {}{}{} IN (?",
+                                            m_quoteChar, tableName, m_quoteChar,
+                                            m_quoteChar, columnName, m_quoteChar );
+
+        for( size_t i = 1; i < count; ++i )
+            queryStr += ", ?";
+
+        queryStr += ")";
+
+        wxLogTrace( traceDatabase, wxT( "SelectMany: `%s` with %d parameters" ), queryStr,
+                    static_cast<int>( count ) );
+
+        nanodbc::result results;
+
+        try
+        {
+            nanodbc::statement& statement = getStatement( queryStr );
+
+            for( size_t i = 0; i < count; ++i )
+                statement.bind( static_cast<short>( i ), aValues[first + i].c_str() );
+
+            results = nanodbc::execute( statement );
+        }
+        catch( nanodbc::database_error& e )
+        {
+            m_lastError = e.what();
+            wxLogTrace( traceDatabase,
+                        wxT( "Exception while executing statement for SelectMany: %s" ),
+                        m_lastError );
+            return false;
+        }
+
+        try
+        {
+            while( results.next() )
+            {
+                ROW result;
+
+                for( short j = 0; j < results.columns(); ++j )
+                {
+                    std::string column = toUTF8( results.column_name( j ) );
+                    result[column] = toUTF8( results.get<nanodbc::string>( j,
+                                                                           NANODBC_TEXT( "" ) ) );
+                }
+
+                auto keyIter = result.find( columnName );
+
+                if( keyIter != result.end() )
+                {
+                    const std::string& key = std::any_cast<std::string&>( keyIter->second );
+                    m_cache->Put( fmt::format( "{}{}{}", tableName, columnName, key ), result );
+                }
+
+                aResults.emplace_back( std::move( result ) );
+            }
+        }
+        catch( nanodbc::database_error& e )
+        {
+            m_lastError = e.what();
+            wxLogTrace( traceDatabase, wxT( "Exception while parsing results from SelectMany: %s" ),
+                        m_lastError );
+            return false;
+        }
+    }
+
+    wxLogTrace( traceDatabase, wxT( "SelectMany: %d rows found for %d values" ),
+                static_cast<int>( aResults.size() ), static_cast<int>( aValues.size() ) );
+
+    return true;
+}
+
+
 bool DATABASE_CONNECTION::SelectAll( const std::string& aTable, std::vector<ROW>& aResults )
 {
     if( !m_conn )
@@ -24,6 +24,7 @@
 
 #include <nlohmann/json.hpp>
 
+#include <database/database_connection.h>
 #include <database/database_lib_settings.h>
 #include <settings/parameters.h>
 #include <wildcards_and_files_ext.h>
@@ -110,9 +111,11 @@ DATABASE_LIB_SETTINGS::DATABASE_LIB_SETTINGS( const std::string& aFilename ) :
             },
             {} ) );
 
-    m_params.emplace_back( new PARAM<int>( "cache.max_size", &m_Cache.max_size, 256 ) );
+    m_params.emplace_back( new PARAM<int>( "cache.max_size", &m_Cache.max_size,
+                                           DATABASE_CONNECTION::DEFAULT_CACHE_SIZE ) );
 
-    m_params.emplace_back( new PARAM<int>( "cache.max_age", &m_Cache.max_age, 10 ) );
+    m_params.emplace_back( new PARAM<int>( "cache.max_age", &m_Cache.max_age,
+                                           DATABASE_CONNECTION::DEFAULT_CACHE_AGE ) );
 }
 
 
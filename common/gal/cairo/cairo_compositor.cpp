@@ -31,15 +31,28 @@
  */
 
 #include <gal/cairo/cairo_compositor.h>
+#include <thread_pool.h>
 #include <wx/log.h>
 
+#include <algorithm>
+
+#if CAIRO_HAS_TEE_SURFACE
+#include <cairo-tee.h>
+#endif
+
 using namespace KIGFX;
 
+/// Minimum height in pixels of the bands of a tiled buffer; smaller bands are not worth the
+/// replay of the drawing commands in each of them.
+static const unsigned int MIN_BAND_HEIGHT = 64;
+
 CAIRO_COMPOSITOR::CAIRO_COMPOSITOR( cairo_t** aMainContext ) :
         m_current( 0 ),
         m_currentContext( aMainContext ),
         m_mainContext( *aMainContext ),
-        m_currentAntialiasingMode( CAIRO_ANTIALIAS_DEFAULT )
+        m_currentAntialiasingMode( CAIRO_ANTIALIAS_DEFAULT ),
+        m_tiledRendering( false ),
+        m_directDrawing( false )
 {
     // Do not have uninitialized members:
     cairo_matrix_init_identity( &m_matrix );
@@ -73,6 +86,48 @@ void CAIRO_COMPOSITOR::SetAntialiasingMode( CAIRO_ANTIALIASING_MODE aMode )
 }
 
 
+void CAIRO_COMPOSITOR::SetTiledRendering( bool aEnable )
+{
+#if CAIRO_HAS_TEE_SURFACE
+    m_tiledRendering = aEnable && GetKiCadThreadPool().get_thread_count() > 1;
+#endif
+
+    clean();
+}
+
+
+void CAIRO_COMPOSITOR::SetDirectDrawing( bool aDirect )
+{
+    m_directDrawing = aDirect;
+
+    if( aDirect && m_current < usedBuffers() )
+        setDirect( m_buffers[m_current], true );
+}
+
+
+void CAIRO_COMPOSITOR::setDirect( CAIRO_BUFFER& aBuffer, bool aDirect )
+{
+    if( aDirect == aBuffer.direct || !aBuffer.imageContext )
+        return;
+
+    // The commands recorded so far are drawn before the ones drawn directly
+    if( aDirect )
+        flush( aBuffer );
+
+    aBuffer.direct = aDirect;
+
+    if( &aBuffer == &m_buffers[m_current] )
+    {
+        // Get currently used transformation matrix, so it can be applied to the other context
+        cairo_get_matrix( *m_currentContext, &m_matrix );
+
+        *m_currentContext = drawingContext( aBuffer );
+
+        cairo_set_matrix( *m_currentContext, &m_matrix );
+    }
+}
+
+
 void CAIRO_COMPOSITOR::Resize( unsigned int aWidth, unsigned int aHeight )
 {
     clean();
@@ -108,13 +163,111 @@ unsigned int CAIRO_COMPOSITOR::CreateBuffer()
     cairo_set_matrix( context, &m_matrix );
 
     // Store the new buffer
-    CAIRO_BUFFER buffer = { context, surface, bitmap };
+    CAIRO_BUFFER buffer = { context, surface, bitmap, nullptr, nullptr, {}, false };
+
+    if( m_tiledRendering )
+        createBands( buffer );
+
     m_buffers.push_back( buffer );
 
     return usedBuffers();
 }
 
 
+void CAIRO_COMPOSITOR::createBands( CAIRO_BUFFER& aBuffer )
+{
+#if CAIRO_HAS_TEE_SURFACE
+    unsigned int bandCount = std::min<unsigned int>( GetKiCadThreadPool().get_thread_count(),
+                                                     m_height / MIN_BAND_HEIGHT );
+
+    if( bandCount < 2 )
+        return;
+
+    // Each recording surface is bounded to its band, so that Cairo drops the drawing commands
+    // falling outside of it instead of replaying them
+    for( unsigned int i = 0; i < bandCount; ++i )
+    {
+        unsigned int      top = bandTop( i, bandCount );
+        cairo_rectangle_t extents = { 0.0, (double) top, (double) m_width,
+                                      (double) ( bandTop( i + 1, bandCount ) - top ) };
+
+        aBuffer.bands.push_back( cairo_recording_surface_create( CAIRO_CONTENT_COLOR_ALPHA,
+                                                                 &extents ) );
+    }
+
+    // Cairo clips the drawing commands to the extents of the master surface of the tee, and
+    // turns a fill covering them into a paint.  The master must therefore cover the whole
+    // buffer, and not a band: its commands are never replayed, only the ones of the bands
+    cairo_rectangle_t extents = { 0.0, 0.0, (double) m_width, (double) m_height };
+    cairo_surface_t*  master = cairo_recording_surface_create( CAIRO_CONTENT_COLOR_ALPHA,
+                                                               &extents );
+
+    aBuffer.tee = cairo_tee_surface_create( master );
+
+    // The tee keeps a reference to its master
+    cairo_surface_destroy( master );
+
+    for( cairo_surface_t* band : aBuffer.bands )
+        cairo_tee_surface_add( aBuffer.tee, band );
+
+    aBuffer.imageContext = aBuffer.context;
+    aBuffer.context = cairo_create( aBuffer.tee );
+
+    cairo_set_antialias( aBuffer.context, m_currentAntialiasingMode );
+    cairo_set_matrix( aBuffer.context, &m_matrix );
+#endif
+}
+
+
+void CAIRO_COMPOSITOR::flush( CAIRO_BUFFER& aBuffer )
+{
+    // Nothing is recorded in a buffer drawn directly
+    if( aBuffer.bands.empty() || aBuffer.direct )
+        return;
+
+    const unsigned int bandCount = aBuffer.bands.size();
+
+    GetKiCadThreadPool().parallelize_loop( 0, bandCount,
+            [&]( const int a, const int b )
+            {
+                for( int i = a; i < b; ++i )
+                {
+                    unsigned int top = bandTop( i, bandCount );
+                    unsigned int height = bandTop( i + 1, bandCount ) - top;
+
+                    // The band is drawn on its own surface over the rows of the pixel storage,
+                    // so that the bands do not share any Cairo object
+                    cairo_surface_t* surface = cairo_image_surface_create_for_data(
+                            (unsigned char*) aBuffer.bitmap + (size_t) top * m_stride,
+                            CAIRO_FORMAT_ARGB32, m_width, height, m_stride );
+                    cairo_t* ct = cairo_create( surface );
+
+                    cairo_set_source_surface( ct, aBuffer.bands[i], 0.0, -(double) top );
+                    cairo_paint( ct );
+
+                    cairo_destroy( ct );
+                    cairo_surface_destroy( surface );
+                }
+            } ).wait();
+
+    discard( aBuffer );
+}
+
+
+void CAIRO_COMPOSITOR::discard( CAIRO_BUFFER& aBuffer )
+{
+    if( aBuffer.bands.empty() )
+        return;
+
+    // An unclipped clear drops the commands recorded so far, the state of the context is kept
+    cairo_save( aBuffer.context );
+    cairo_reset_clip( aBuffer.context );
+    cairo_set_operator( aBuffer.context, CAIRO_OPERATOR_CLEAR );
+    cairo_paint( aBuffer.context );
+    cairo_restore( aBuffer.context );
+}
+
+
 void CAIRO_COMPOSITOR::SetBuffer( unsigned int aBufferHandle )
 {
     wxASSERT_MSG( aBufferHandle <= usedBuffers(), wxT( "Tried to use a not existing buffer" ) );
@@ -123,7 +276,11 @@ void CAIRO_COMPOSITOR::SetBuffer( unsigned int aBufferHandle )
     cairo_get_matrix( *m_currentContext, &m_matrix );
 
     m_current = aBufferHandle - 1;
-    *m_currentContext = m_buffers[m_current].context;
+
+    if( m_directDrawing )
+        setDirect( m_buffers[m_current], true );
+
+    *m_currentContext = drawingContext( m_buffers[m_current] );
 
     // Apply the current transformation matrix
     cairo_set_matrix( *m_currentContext, &m_matrix );
@@ -137,8 +294,13 @@ void CAIRO_COMPOSITOR::Begin()
 
 void CAIRO_COMPOSITOR::ClearBuffer( const COLOR4D& aColor )
 {
-    // Clear the pixel storage
+    // Clear the recorded drawing commands and the pixel storage
+    discard( m_buffers[m_current] );
     memset( m_buffers[m_current].bitmap, 0x00, m_bufferSize * sizeof( int ) );
+
+    // The buffer records the drawing commands again, unless a negative item is being drawn
+    if( !m_directDrawing )
+        setDirect( m_buffers[m_current], false );
 }
 
 
@@ -148,6 +310,9 @@ void CAIRO_COMPOSITOR::DrawBuffer( unsigned int aSourceHandle, unsigned int aDes
     wxASSERT_MSG( aSourceHandle <= usedBuffers() && aDestHandle <= usedBuffers(),
                   wxT( "Tried to use a not existing buffer" ) );
 
+    flush( m_buffers[aSourceHandle - 1] );
+    flush( m_buffers[aDestHandle - 1] );
+
     // Reset the transformation matrix, so it is possible to composite images using
     // screen coordinates instead of world coordinates
     cairo_get_matrix( m_mainContext, &m_matrix );
@@ -169,6 +334,8 @@ void CAIRO_COMPOSITOR::DrawBuffer( unsigned int aBufferHandle )
 {
     wxASSERT_MSG( aBufferHandle <= usedBuffers(), wxT( "Tried to use a not existing buffer" ) );
 
+    flush( m_buffers[aBufferHandle - 1] );
+
     // Reset the transformation matrix, so it is possible to composite images using
     // screen coordinates instead of world coordinates
     cairo_get_matrix( m_mainContext, &m_matrix );
@@ -195,6 +362,16 @@ void CAIRO_COMPOSITOR::clean()
     for( it = m_buffers.begin(); it != m_buffers.end(); ++it )
     {
         cairo_destroy( it->context );
+
+        if( it->imageContext )
+            cairo_destroy( it->imageContext );
+
+        if( it->tee )
+            cairo_surface_destroy( it->tee );
+
+        for( cairo_surface_t* band : it->bands )
+            cairo_surface_destroy( band );
+
         cairo_surface_destroy( it->surface );
         delete[] it->bitmap;
     }
@@ -30,6 +30,7 @@
 #include <wx/image.h>
 #include <wx/log.h>
 
+#include <advanced_config.h>
 #include <gal/cairo/cairo_gal.h>
 #include <gal/cairo/cairo_compositor.h>
 #include <gal/definitions.h>
@@ -966,6 +967,25 @@ void CAIRO_GAL_BASE::SetNegativeDrawMode( bool aSetting )
 }
 
 
+void CAIRO_GAL::SetNegativeDrawMode( bool aSetting )
+{
+    // The negative items clear the pixels already drawn, which are not available to the
+    // drawing commands recorded by the tiled compositor
+    storePath();
+
+    if( aSetting )
+    {
+        m_compositor->SetDirectDrawing( true );
+        CAIRO_GAL_BASE::SetNegativeDrawMode( true );
+    }
+    else
+    {
+        CAIRO_GAL_BASE::SetNegativeDrawMode( false );
+        m_compositor->SetDirectDrawing( false );
+    }
+}
+
+
 void CAIRO_GAL::StartDiffLayer()
 {
     SetTarget( TARGET_TEMP );
@@ -1602,6 +1622,7 @@ void CAIRO_GAL::setCompositor()
     m_compositor.reset( new CAIRO_COMPOSITOR( &m_currentContext ) );
     m_compositor->Resize( m_screenSize.x, m_screenSize.y );
     m_compositor->SetAntialiasingMode( m_options.cairo_antialiasing_mode );
+    m_compositor->SetTiledRendering( ADVANCED_CFG::GetCfg().m_CairoTiledRendering );
 
     // Prepare buffers
     m_mainBuffer = m_compositor->CreateBuffer();
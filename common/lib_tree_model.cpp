@@ -22,7 +22,9 @@
 #include <lib_tree_model.h>
 
 #include <algorithm>
+#include <atomic>
 #include <eda_pattern_match.h>
+#include <iterator>
 #include <lib_tree_item.h>
 #include <utility>
 #include <pgm_base.h>
@@ -35,6 +37,12 @@
 // nodes asd the result is very unspecific.
 static const unsigned kLowestDefaultScore = 1;
 
+// Search terms shorter than this can't be looked up in the trigram index.
+static const size_t kMinIndexedTermLength = 3;
+
+// Bumped each time a node is created, deleted or updated.
+static std::atomic<unsigned long long> s_treeRevision( 0 );
+
 
 // Creates a score depending on the position of a string match. If the position
 // is 0 (= prefix match), this returns the maximum score. This degrades until
@@ -50,6 +58,41 @@ static int matchPosScore(int aPosition, int aMaximum)
 }
 
 
+// A term without any regex, wildcard or relational operator characters is handled the same way
+// by all the matchers of an EDA_COMBINED_MATCHER: as a plain substring search.  Only these terms
+// can be looked up in the search index.
+static bool isPlainTerm( const wxString& aTerm )
+{
+    static const wxString specialChars = wxT( ".*+?^${}()|[]\\<=>:" );
+
+    for( wxUniChar c : aTerm )
+    {
+        if( specialChars.Find( c ) != wxNOT_FOUND )
+            return false;
+    }
+
+    return true;
+}
+
+
+// Call aFunc for each trigram of aText, packed in 63 bits (21 bits per code point).
+template <typename FUNC>
+static void forEachTrigram( const wxString& aText, FUNC aFunc )
+{
+    const unsigned long long mask = ( 1ULL << 63 ) - 1;
+    unsigned long long       trigram = 0;
+    size_t                   count = 0;
+
+    for( wxUniChar c : aText )
+    {
+        trigram = ( ( trigram << 21 ) | ( c.GetValue() & 0x1FFFFF ) ) & mask;
+
+        if( ++count >= 3 )
+            aFunc( trigram );
+    }
+}
+
+
 void LIB_TREE_NODE::ResetScore()
 {
     for( std::unique_ptr<LIB_TREE_NODE>& child: m_Children )
@@ -133,7 +176,21 @@ LIB_TREE_NODE::LIB_TREE_NODE()
       m_Normalized( false ),
       m_Unit( 0 ),
       m_IsRoot( false )
-{}
+{
+    ++s_treeRevision;
+}
+
+
+LIB_TREE_NODE::~LIB_TREE_NODE()
+{
+    ++s_treeRevision;
+}
+
+
+unsigned long long LIB_TREE_NODE::GetRevision()
+{
+    return s_treeRevision;
+}
 
 
 LIB_TREE_NODE_UNIT::LIB_TREE_NODE_UNIT( LIB_TREE_NODE* aParent, LIB_TREE_ITEM* aItem, int aUnit )
@@ -225,22 +282,30 @@ void LIB_TREE_NODE_LIB_ID::Update( LIB_TREE_ITEM* aItem )
     m_IsRoot = aItem->IsRoot();
     m_Children.clear();
 
+    ++s_treeRevision;
+
     for( int u = 1; u <= aItem->GetUnitCount(); ++u )
         AddUnit( aItem, u );
 }
 
 
-void LIB_TREE_NODE_LIB_ID::UpdateScore( EDA_COMBINED_MATCHER& aMatcher, const wxString& aLib )
+void LIB_TREE_NODE_LIB_ID::Normalize()
 {
-    if( m_Score <= 0 )
-        return; // Leaf nodes without scores are out of the game.
-
     if( !m_Normalized )
     {
         m_MatchName = UnescapeString( m_MatchName ).Lower();
         m_SearchText = m_SearchText.Lower();
         m_Normalized = true;
     }
+}
+
+
+void LIB_TREE_NODE_LIB_ID::UpdateScore( EDA_COMBINED_MATCHER& aMatcher, const wxString& aLib )
+{
+    if( m_Score <= 0 )
+        return; // Leaf nodes without scores are out of the game.
+
+    Normalize();
 
     if( !aLib.IsEmpty() && m_Parent->m_MatchName != aLib )
     {
@@ -354,7 +419,9 @@ void LIB_TREE_NODE_LIB::UpdateScore( EDA_COMBINED_MATCHER& aMatcher, const wxStr
 }
 
 
-LIB_TREE_NODE_ROOT::LIB_TREE_NODE_ROOT()
+LIB_TREE_NODE_ROOT::LIB_TREE_NODE_ROOT() :
+        m_indexRevision( 0 ),
+        m_indexValid( false )
 {
     m_Type = ROOT;
 }
@@ -374,3 +441,162 @@ void LIB_TREE_NODE_ROOT::UpdateScore( EDA_COMBINED_MATCHER& aMatcher, const wxSt
         child->UpdateScore( aMatcher, aLib );
 }
 
+
+void LIB_TREE_NODE_ROOT::UpdateSearchScore(
+        const std::vector<std::pair<wxString, wxString>>& aTerms )
+{
+    if( !m_indexValid || m_indexRevision != GetRevision() )
+        buildSearchIndex();
+
+    bool allPlain = std::all_of( aTerms.begin(), aTerms.end(),
+                                 []( const std::pair<wxString, wxString>& aTerm )
+                                 {
+                                     return isPlainTerm( aTerm.second );
+                                 } );
+
+    // If each term of the previous search is a prefix of the same term in this one (with the
+    // same library filter), anything that didn't match the previous search can't match this one.
+    bool refine = allPlain && !m_lastTerms.empty() && m_lastTerms.size() <= aTerms.size();
+
+    for( size_t i = 0; refine && i < m_lastTerms.size(); ++i )
+    {
+        refine = m_lastTerms[i].first == aTerms[i].first
+                 && aTerms[i].second.StartsWith( m_lastTerms[i].second );
+    }
+
+    if( refine )
+    {
+        for( size_t i = 0; i < m_indexedNodes.size(); ++i )
+        {
+            if( !m_lastMatches[i] )
+                m_indexedNodes[i]->m_Score = 0;
+        }
+    }
+
+    for( const std::pair<wxString, wxString>& term : aTerms )
+    {
+        if( term.second.length() >= kMinIndexedTermLength && isPlainTerm( term.second ) )
+            filterCandidates( term.second );
+
+        EDA_COMBINED_MATCHER matcher( term.second, CTX_LIBITEM );
+
+        UpdateScore( matcher, term.first );
+    }
+
+    m_lastTerms.clear();
+    m_lastMatches.clear();
+
+    // Regex and relational terms don't shrink the results when extended, so don't keep them
+    if( allPlain )
+    {
+        m_lastTerms = aTerms;
+        m_lastMatches.reserve( m_indexedNodes.size() );
+
+        for( LIB_TREE_NODE* node : m_indexedNodes )
+            m_lastMatches.push_back( node->m_Score > 0 );
+    }
+}
+
+
+void LIB_TREE_NODE_ROOT::buildSearchIndex()
+{
+    m_indexedNodes.clear();
+    m_trigramIndex.clear();
+    m_lastTerms.clear();
+    m_lastMatches.clear();
+
+    for( std::unique_ptr<LIB_TREE_NODE>& lib : m_Children )
+    {
+        for( std::unique_ptr<LIB_TREE_NODE>& child : lib->m_Children )
+        {
+            if( child->m_Type != LIBID )
+                continue;
+
+            LIB_TREE_NODE_LIB_ID* node = static_cast<LIB_TREE_NODE_LIB_ID*>( child.get() );
+            int                   idx = static_cast<int>( m_indexedNodes.size() );
+
+            node->Normalize();
+            m_indexedNodes.push_back( node );
+
+            auto addTrigram =
+                    [&]( unsigned long long aTrigram )
+                    {
+                        std::vector<int>& nodes = m_trigramIndex[aTrigram];
+
+                        if( nodes.empty() || nodes.back() != idx )
+                            nodes.push_back( idx );
+                    };
+
+            forEachTrigram( node->m_MatchName, addTrigram );
+            forEachTrigram( node->m_SearchText, addTrigram );
+        }
+    }
+
+    m_indexRevision = GetRevision();
+    m_indexValid = true;
+}
+
+
+void LIB_TREE_NODE_ROOT::filterCandidates( const wxString& aTerm )
+{
+    std::vector<const std::vector<int>*> postings;
+    bool                                 found = true;
+
+    forEachTrigram( aTerm,
+                    [&]( unsigned long long aTrigram )
+                    {
+                        auto it = m_trigramIndex.find( aTrigram );
+
+                        if( it == m_trigramIndex.end() )
+                            found = false;
+                        else
+                            postings.push_back( &it->second );
+                    } );
+
+    // Nodes containing every trigram of the term; start from the rarest one
+    std::vector<int> candidates;
+
+    if( found && !postings.empty() )
+    {
+        std::sort( postings.begin(), postings.end(),
+                   []( const std::vector<int>* a, const std::vector<int>* b )
+                   {
+                       return a->size() < b->size();
+                   } );
+
+        candidates = *postings[0];
+
+        for( size_t i = 1; i < postings.size() && !candidates.empty(); ++i )
+        {
+            std::vector<int> common;
+
+            std::set_intersection( candidates.begin(), candidates.end(),
+                                   postings[i]->begin(), postings[i]->end(),
+                                   std::back_inserter( common ) );
+            candidates.swap( common );
+        }
+    }
+
+    std::vector<bool> isCandidate( m_indexedNodes.size(), false );
+
+    for( int idx : candidates )
+        isCandidate[idx] = true;
+
+    // Items of a library whose name matches are always candidates (parent name match)
+    LIB_TREE_NODE* parent = nullptr;
+    bool           parentMatches = false;
+
+    for( size_t i = 0; i < m_indexedNodes.size(); ++i )
+    {
+        LIB_TREE_NODE* node = m_indexedNodes[i];
+
+        if( node->m_Parent != parent )
+        {
+            parent = node->m_Parent;
+            parentMatches = parent->m_MatchName.Contains( aTerm );
+        }
+
+        if( !isCandidate[i] && !parentMatches )
+            node->m_Score = 0;
+    }
+}
@@ -190,7 +190,8 @@ void LIB_TREE_MODEL_ADAPTER::UpdateSearchString( const wxString& aSearch, bool a
 
         m_tree.ResetScore();
 
-        wxStringTokenizer tokenizer( aSearch );
+        wxStringTokenizer                          tokenizer( aSearch );
+        std::vector<std::pair<wxString, wxString>> terms;
 
         while( tokenizer.HasMoreTokens() )
         {
@@ -203,11 +204,11 @@ void LIB_TREE_MODEL_ADAPTER::UpdateSearchString( const wxString& aSearch, bool a
                 term = term.AfterFirst( ':' );
             }
 
-            EDA_COMBINED_MATCHER matcher( term, CTX_LIBITEM );
-
-            m_tree.UpdateScore( matcher, lib );
+            terms.emplace_back( lib, term );
         }
 
+        m_tree.UpdateSearchScore( terms );
+
         m_tree.SortNodes();
         AfterReset();
         Thaw();
@@ -34,6 +34,7 @@
 
 #include <plotters/plotter_gerber.h>
 #include <plotters/gbr_plotter_aperture_macros.h>
+#include <plotters/plot_line_formatter.h>
 
 #include <gbr_metadata.h>
 
@@ -154,8 +155,13 @@ void GERBER_PLOTTER::SetGerberCoordinatesFormat( int aResolution, bool aUseInche
 
 void GERBER_PLOTTER::emitDcode( const VECTOR2D& pt, int dcode )
 {
+    // Equivalent to "X%dY%dD%02d*\n", but this is by far the most used command of a Gerber
+    // file (every segment, flash and region vertex), so avoid the printf parser.
+    PLOT_LINE_FORMATTER line;
 
-    fprintf( m_outputFile, "X%dY%dD%02d*\n", KiROUND( pt.x ), KiROUND( pt.y ), dcode );
+    line.Char( 'X' ).Int( KiROUND( pt.x ) ).Char( 'Y' ).Int( KiROUND( pt.y ) )
+        .Char( 'D' ).Int02( dcode ).Str( "*\n" );
+    line.Write( m_outputFile );
 }
 
 void GERBER_PLOTTER::ClearAllAttributes()
@@ -255,6 +261,9 @@ bool GERBER_PLOTTER::StartPlot( const wxString& aPageNumber )
     m_outputFile = workFile;
     wxASSERT( m_outputFile );
 
+    if( workFile )
+        setvbuf( workFile, nullptr, _IOFBF, OUTPUT_FILE_BUFFER_SIZE );
+
     if( m_outputFile == nullptr )
         return false;
 
@@ -382,9 +391,19 @@ bool GERBER_PLOTTER::EndPlot()
 
             writeApertureList();
             fputs( "G04 APERTURE END LIST*\n", m_outputFile );
+
+            // The aperture list is the only insertion: the remaining of the work file is
+            // copied as is, by blocks rather than line by line.
+            break;
         }
     }
 
+    char   block[16384];
+    size_t count;
+
+    while( ( count = fread( block, 1, sizeof( block ), workFile ) ) > 0 )
+        fwrite( block, 1, count, m_outputFile );
+
     fclose( workFile );
     fclose( finalFile );
     ::wxRemoveFile( m_workFilename );
@@ -862,9 +881,12 @@ void GERBER_PLOTTER::plotArc( const SHAPE_ARC& aArc, bool aPlotInRegion )
     else
         fprintf( m_outputFile, "G03*\n" );    // Active circular interpolation, CCW
 
-    fprintf( m_outputFile, "X%dY%dI%dJ%dD01*\n",
-             KiROUND( devEnd.x ), KiROUND( devEnd.y ),
-             KiROUND( devCenter.x ), KiROUND( devCenter.y ) );
+    PLOT_LINE_FORMATTER line;
+
+    line.Char( 'X' ).Int( KiROUND( devEnd.x ) ).Char( 'Y' ).Int( KiROUND( devEnd.y ) )
+        .Char( 'I' ).Int( KiROUND( devCenter.x ) ).Char( 'J' ).Int( KiROUND( devCenter.y ) )
+        .Str( "D01*\n" );
+    line.Write( m_outputFile );
 
     fprintf( m_outputFile, "G01*\n" ); // Back to linear interpolate (perhaps useless here).
 }
@@ -894,9 +916,12 @@ void GERBER_PLOTTER::plotArc( const VECTOR2I& aCenter, const EDA_ANGLE& aStartAn
     else
         fprintf( m_outputFile, "G02*\n" );    // Active circular interpolation, CW
 
-    fprintf( m_outputFile, "X%dY%dI%dJ%dD01*\n",
-             KiROUND( devEnd.x ), KiROUND( devEnd.y ),
-             KiROUND( devCenter.x ), KiROUND( devCenter.y ) );
+    PLOT_LINE_FORMATTER line;
+
+    line.Char( 'X' ).Int( KiROUND( devEnd.x ) ).Char( 'Y' ).Int( KiROUND( devEnd.y ) )
+        .Char( 'I' ).Int( KiROUND( devCenter.x ) ).Char( 'J' ).Int( KiROUND( devCenter.y ) )
+        .Str( "D01*\n" );
+    line.Write( m_outputFile );
 
     fprintf( m_outputFile, "G01*\n" ); // Back to linear interpolate (perhaps useless here).
 }
@@ -119,6 +119,8 @@ bool PDF_PLOTTER::OpenFile( const wxString& aFullFilename )
     if( m_outputFile == nullptr )
         return false ;
 
+    setvbuf( m_outputFile, nullptr, _IOFBF, OUTPUT_FILE_BUFFER_SIZE );
+
     return true;
 }
 
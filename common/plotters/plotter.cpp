@@ -83,6 +83,8 @@ bool PLOTTER::OpenFile( const wxString& aFullFilename )
     if( m_outputFile == nullptr )
         return false ;
 
+    setvbuf( m_outputFile, nullptr, _IOFBF, OUTPUT_FILE_BUFFER_SIZE );
+
     return true;
 }
 
@@ -26,6 +26,7 @@
  */
 
 
+#include <core/kicad_algo.h>
 #include <eda_item.h>
 #include <layer_ids.h>
 #include <trace_helpers.h>
@@ -41,6 +42,7 @@
 #include <painter.h>
 
 #include <profile.h>
+#include <thread_pool.h>
 
 #ifdef KICAD_GAL_PROFILE
 #include <wx/log.h>
@@ -57,6 +59,7 @@ public:
         m_view( nullptr ),
         m_flags( KIGFX::VISIBLE ),
         m_requiredUpdate( KIGFX::NONE ),
+        m_queueIndex( -1 ),
         m_drawPriority( 0 ),
         m_groups( nullptr ),
         m_groupsSize( 0 ) {}
@@ -228,6 +231,8 @@ private:
     VIEW*                m_view;             ///< Current dynamic view the item is assigned to.
     int                  m_flags;            ///< Visibility flags
     int                  m_requiredUpdate;   ///< Flag required for updating
+    int                  m_queueIndex;       ///< Index in the dirty items queue of its view, or
+                                             ///< -1 if the item is not queued
     int                  m_drawPriority;     ///< Order to draw this item in a layer, lowest first
 
     std::pair<int, int>* m_groups;           ///< layer_number:group_id pairs for each layer the
@@ -278,6 +283,8 @@ VIEW::VIEW( bool aIsDynamic ) :
     m_allItems.reset( new std::vector<VIEW_ITEM*> );
     m_allItems->reserve( 32768 );
 
+    m_dirtyItems = std::make_shared<std::vector<VIEW_ITEM*>>();
+
     // Redraw everything at the beginning
     MarkDirty();
 
@@ -362,6 +369,13 @@ void VIEW::Remove( VIEW_ITEM* aItem )
         viewData->clearUpdateFlags();
     }
 
+    // The slot of the item is emptied, UpdateItems() skips it
+    if( viewData->m_queueIndex >= 0 )
+    {
+        ( *m_dirtyItems )[viewData->m_queueIndex] = nullptr;
+        viewData->m_queueIndex = -1;
+    }
+
     int layers[VIEW::VIEW_MAX_LAYERS], layers_count;
     viewData->getLayers( layers, layers_count );
 
@@ -700,7 +714,7 @@ void VIEW::ReorderLayerData( std::unordered_map<int, int> aReorderMap )
 
         viewData->reorderGroups( aReorderMap );
 
-        viewData->m_requiredUpdate |= COLOR;
+        Update( item, COLOR );
     }
 
     UpdateItems();
@@ -1099,6 +1113,14 @@ void VIEW::Clear()
     r.SetMaximum();
     m_allItems->clear();
 
+    for( VIEW_ITEM* item : *m_dirtyItems )
+    {
+        if( item && item->viewPrivData() )
+            item->viewPrivData()->m_queueIndex = -1;
+    }
+
+    m_dirtyItems->clear();
+
     for( VIEW_LAYER& layer : m_layers )
         layer.items->RemoveAll();
 
@@ -1397,19 +1419,31 @@ void VIEW::RecacheAllItems()
 
 void VIEW::UpdateItems()
 {
-    if( !m_gal->IsVisible() )
+    if( !m_gal->IsVisible() || m_dirtyItems->empty() )
         return;
 
+    PROF_TIMER updateTimer;
+
+    // Only the items queued by Update() have to be visited.  The queue is taken over first,
+    // so the items updated while it is processed are kept for the next call.
+    std::vector<VIEW_ITEM*> dirtyItems;
+    dirtyItems.swap( *m_dirtyItems );
+
+    // The slots of the items removed from the view are empty
+    alg::delete_matching( dirtyItems, nullptr );
+
     unsigned int cntGeomUpdate = 0;
     unsigned int cntAnyUpdate = 0;
 
-    for( VIEW_ITEM* item : *m_allItems )
+    for( VIEW_ITEM* item : dirtyItems )
     {
         auto vpd = item->viewPrivData();
 
         if( !vpd )
             continue;
 
+        vpd->m_queueIndex = -1;
+
         if( vpd->m_requiredUpdate & ( GEOMETRY | LAYERS ) )
         {
             cntGeomUpdate++;
@@ -1432,35 +1466,38 @@ void VIEW::UpdateItems()
 
     if( ratio > 0.3 )
     {
-        auto allItems = *m_allItems;
-        int  layers[VIEW_MAX_LAYERS], layers_count;
+        std::vector<std::vector<VIEW_ITEM*>> layerItems( m_layers.size() );
+        int                                  layers[VIEW_MAX_LAYERS], layers_count;
 
-        // kill all Rtrees
-        for( VIEW_LAYER& layer : m_layers )
-            layer.items->RemoveAll();
-
-        // and re-insert items from scratch
-        for( VIEW_ITEM* item : allItems )
+        // gather the items of each layer
+        for( VIEW_ITEM* item : *m_allItems )
         {
             item->ViewGetLayers( layers, layers_count );
             item->viewPrivData()->saveLayers( layers, layers_count );
 
             for( int i = 0; i < layers_count; ++i )
-            {
-                VIEW_LAYER& l = m_layers[layers[i]];
-                l.items->Insert( item );
-                MarkTargetDirty( l.target );
-            }
+                layerItems[layers[i]].push_back( item );
 
             item->viewPrivData()->m_requiredUpdate &= ~( LAYERS | GEOMETRY );
         }
+
+        // and pack all the Rtrees from scratch
+        for( VIEW_LAYER& layer : m_layers )
+        {
+            layer.items->BulkLoad( layerItems[layer.id] );
+
+            if( !layerItems[layer.id].empty() )
+                MarkTargetDirty( layer.target );
+        }
     }
 
     if( cntAnyUpdate )
     {
+        precacheItems( dirtyItems );
+
         GAL_UPDATE_CONTEXT ctx( m_gal );
 
-        for( VIEW_ITEM* item : *m_allItems.get() )
+        for( VIEW_ITEM* item : dirtyItems )
         {
             if( item->viewPrivData() && item->viewPrivData()->m_requiredUpdate != NONE )
             {
@@ -1470,18 +1507,50 @@ void VIEW::UpdateItems()
         }
     }
 
-    KI_TRACE( traceGalProfile, "View update: total items %u, geom %u updates %u\n", cntTotal,
-              cntGeomUpdate, cntAnyUpdate );
+    updateTimer.Stop();
+
+    KI_TRACE( traceGalProfile, "View update: total items %u, queued %u, geom %u updates %u, "
+                               "%.3f ms\n",
+              cntTotal, (unsigned int) dirtyItems.size(), cntGeomUpdate, cntAnyUpdate,
+              updateTimer.msecs() );
 }
 
 
-void VIEW::UpdateAllItems( int aUpdateFlags )
+void VIEW::precacheItems( const std::vector<VIEW_ITEM*>& aItems )
 {
-    for( VIEW_ITEM* item : *m_allItems )
+    // Below this count, dispatching the items to the thread pool costs more than it saves
+    const size_t minParallelItems = 64;
+
+    std::vector<VIEW_ITEM*> items;
+
+    for( VIEW_ITEM* item : aItems )
     {
-        if( item->viewPrivData() )
-            item->viewPrivData()->m_requiredUpdate |= aUpdateFlags;
+        VIEW_ITEM_DATA* viewData = item->viewPrivData();
+        const int       redrawFlags = INITIAL_ADD | GEOMETRY | LAYERS | REPAINT;
+
+        if( viewData && ( viewData->m_requiredUpdate & redrawFlags ) )
+            items.push_back( item );
     }
+
+    if( items.size() < minParallelItems )
+        return;
+
+    GetKiCadThreadPool().parallelize_loop( 0, items.size(),
+            [&]( const int a, const int b )
+            {
+                for( int ii = a; ii < b; ++ii )
+                {
+                    m_painter->PrecacheItem( items[ii],
+                                             items[ii]->viewPrivData()->m_requiredUpdate );
+                }
+            } ).wait();
+}
+
+
+void VIEW::UpdateAllItems( int aUpdateFlags )
+{
+    for( VIEW_ITEM* item : *m_allItems )
+        Update( item, aUpdateFlags );
 }
 
 
@@ -1491,10 +1560,7 @@ void VIEW::UpdateAllItemsConditionally( int aUpdateFlags,
     for( VIEW_ITEM* item : *m_allItems )
     {
         if( aCondition( item ) )
-        {
-            if( item->viewPrivData() )
-                item->viewPrivData()->m_requiredUpdate |= aUpdateFlags;
-        }
+            Update( item, aUpdateFlags );
     }
 }
 
@@ -1503,6 +1569,18 @@ std::unique_ptr<VIEW> VIEW::DataReference() const
 {
     std::unique_ptr<VIEW> ret = std::make_unique<VIEW>();
     ret->m_allItems = m_allItems;
+
+    // Keep the items already queued by the new view (its preview group)
+    for( VIEW_ITEM* item : *ret->m_dirtyItems )
+    {
+        if( !item )
+            continue;
+
+        item->viewPrivData()->m_queueIndex = (int) m_dirtyItems->size();
+        m_dirtyItems->push_back( item );
+    }
+
+    ret->m_dirtyItems = m_dirtyItems;
     ret->m_layers = m_layers;
     ret->sortLayers();
     return ret;
@@ -1581,6 +1659,15 @@ void VIEW::Update( const VIEW_ITEM* aItem, int aUpdateFlags ) const
     assert( aUpdateFlags != NONE );
 
     viewData->m_requiredUpdate |= aUpdateFlags;
+
+    // Queue the item in its view, so UpdateItems() only visits the items to update
+    if( viewData->m_queueIndex < 0 && viewData->m_view )
+    {
+        std::vector<VIEW_ITEM*>& queue = *viewData->m_view->m_dirtyItems;
+
+        viewData->m_queueIndex = (int) queue.size();
+        queue.push_back( const_cast<VIEW_ITEM*>( aItem ) );
+    }
 }
 
 
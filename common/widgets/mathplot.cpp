@@ -34,6 +34,7 @@
 #include <wx/module.h>
 #include <wx/image.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdio>   // used only for debug
 #include <ctime>    // used for representation of x axes involving date
@@ -533,6 +534,183 @@ void mpFY::Plot( wxDC& dc, mpWindow& w )
 }
 
 
+mpContinuousLine::mpContinuousLine( wxCoord startPx, wxCoord endPx ) :
+    m_startPx( startPx ),
+    m_endPx( endPx ),
+    m_ymin0( 0 ),
+    m_ymax0( 0 ),
+    m_dupx0( 0 )
+{
+    m_points.reserve( endPx - startPx + 1 );
+}
+
+
+void mpContinuousLine::AddPoint( wxCoord x1, wxCoord y1 )
+{
+    // Store only points on the drawing area, to speed up the drawing time
+    // Note: x1 is a value truncated from px by w.x2p(). So to be sure the
+    // first point is drawn, the x1 low limit is startPx-1 in plot coordinates
+    if( x1 < m_startPx - 1 || x1 > m_endPx )
+        return;
+
+    if( m_points.empty() || m_points.back().x != x1 )
+    {
+        if( !m_points.empty() && m_dupx0 > 1 && m_ymin0 != m_ymax0 )
+        {
+            // Vertical points are merged, draw the pending vertical line
+            // However, if the line is one pixel length, it is not drawn,
+            // because the main trace show this point
+            wxCoord x0 = m_points.back().x;
+            m_verticalLines.emplace_back( wxPoint( x0, m_ymin0 ), wxPoint( x0, m_ymax0 ) );
+        }
+
+        m_ymin0 = m_ymax0 = y1;
+        m_dupx0 = 0;
+
+        m_points.emplace_back( x1, y1 );
+    }
+    else
+    {
+        m_ymin0 = std::min( m_ymin0, y1 );
+        m_ymax0 = std::max( m_ymax0, y1 );
+        m_dupx0++;
+    }
+}
+
+
+std::vector<wxPoint> mpContinuousLine::GetLinePoints() const
+{
+    if( m_points.size() <= 1 )
+        return m_points;
+
+    // For a better look (when using dashed lines) and more optimization,
+    // try to merge horizontal segments, in order to plot longer lines
+    // we are merging horizontal segments because this is easy,
+    // and horizontal segments are a frequent cases
+    std::vector<wxPoint> drawPoints;
+    drawPoints.reserve( m_endPx - m_startPx + 1 );
+
+    drawPoints.push_back( m_points[0] );   // push the first point in list
+
+    for( size_t ii = 1; ii < m_points.size() - 1; ii++ )
+    {
+        // Skip intermediate points between the first point and the last
+        // point of the segment candidate
+        if( drawPoints.back().y == m_points[ii].y && drawPoints.back().y == m_points[ii + 1].y )
+            continue;
+        else
+            drawPoints.push_back( m_points[ii] );
+    }
+
+    // push the last point to draw in list
+    if( drawPoints.back() != m_points.back() )
+        drawPoints.push_back( m_points.back() );
+
+    return drawPoints;
+}
+
+
+mpLineDecimator::mpLineDecimator() :
+    m_count( 0 ),
+    m_lastRunStart( 0 ),
+    m_lastRun( { 0.0, 0, 0, 0, 0 } )
+{
+}
+
+
+void mpLineDecimator::Clear()
+{
+    m_indices.clear();
+    m_count = 0;
+}
+
+
+void mpLineDecimator::appendLastRun()
+{
+    size_t idx[4] = { m_lastRun.first, m_lastRun.min, m_lastRun.max, m_lastRun.last };
+    std::sort( idx, idx + 4 );
+
+    m_lastRunStart = m_indices.size();
+
+    for( size_t ii = 0; ii < 4; ii++ )
+    {
+        if( ii == 0 || idx[ii] != idx[ii - 1] )
+            m_indices.push_back( idx[ii] );
+    }
+
+    // mpContinuousLine draws the vertical line of a column from its third point, so a run of
+    // more than two points keeps a third one when its first and last points are the extrema
+    if( m_indices.size() - m_lastRunStart == 2 && m_lastRun.last - m_lastRun.first > 1 )
+        m_indices.insert( m_indices.end() - 1, m_lastRun.first + 1 );
+}
+
+
+void mpLineDecimator::Update( const std::vector<double>& xs, const std::vector<double>& ys,
+                              const std::function<double( double )>& transformX, double posX,
+                              double scaleX, wxCoord startPx, wxCoord endPx )
+{
+    if( xs.empty() )
+    {
+        Clear();
+        return;
+    }
+
+    // The scales are linear or logarithmic, so the columns of all the selected points are
+    // known from the columns of the first point and of the last selected point
+    auto getView =
+            [&]( size_t aLast ) -> std::vector<double>
+            {
+                return { (double) startPx, (double) endPx, posX, scaleX,
+                         transformX( xs.front() ), transformX( xs[aLast] ) };
+            };
+
+    if( m_count == 0 || m_count > xs.size() || getView( m_count - 1 ) != m_view )
+    {
+        Clear();
+    }
+    else
+    {
+        // The last run is added again with the new points
+        m_indices.resize( m_lastRunStart );
+    }
+
+    // The points out of the drawing area are merged in the columns next to it, which are
+    // not drawn
+    const double minColumn = startPx - 2;
+    const double maxColumn = endPx + 1;
+
+    for( size_t ii = m_count; ii < xs.size(); ii++ )
+    {
+        // Same truncation as mpWindow::x2p()
+        double column = std::trunc( ( transformX( xs[ii] ) - posX ) * scaleX );
+        column = std::clamp( column, minColumn, maxColumn );
+
+        if( ii == 0 || column != m_lastRun.column )
+        {
+            if( ii > 0 )
+                appendLastRun();
+
+            m_lastRun = { column, ii, ii, ii, ii };
+        }
+        else
+        {
+            if( ys[ii] < ys[m_lastRun.min] )
+                m_lastRun.min = ii;
+
+            if( ys[ii] > ys[m_lastRun.max] )
+                m_lastRun.max = ii;
+
+            m_lastRun.last = ii;
+        }
+    }
+
+    appendLastRun();
+
+    m_count = xs.size();
+    m_view = getView( m_count - 1 );
+}
+
+
 IMPLEMENT_ABSTRACT_CLASS( mpFXY, mpLayer )
 
 mpFXY::mpFXY( const wxString& name, int flags )
@@ -632,17 +810,6 @@ void mpFXY::Plot( wxDC& dc, mpWindow& w )
         }
         else
         {
-            int count = 0;
-            int x0=0;               // X position of merged current vertical line
-            int ymin0=0;            // y min coord of merged current vertical line
-            int ymax0=0;            // y max coord of merged current vertical line
-            int dupx0 = 0;          // count of currently merged vertical lines
-            wxPoint line_start;     // starting point of the current line to draw
-
-            // A buffer to store coordinates of lines to draw
-            std::vector<wxPoint>pointList;
-            pointList.reserve( endPx - startPx + 1 );
-
             // Note: we can use dc.DrawLines() only for a reasonable number or points (<10000),
             // because at least on Windows dc.DrawLines() can hang for a lot of points.
             // (> 10000 points) (can happens when a lot of points is calculated)
@@ -650,77 +817,26 @@ void mpFXY::Plot( wxDC& dc, mpWindow& w )
             // To avoid artifacts when skipping points to the same x coordinate, for each
             // group of points at a give, x coordinate we also draw a vertical line at this coord,
             // from the ymin to the ymax vertical coordinates of skipped points
+            // The layer can give only the points needed at the screen resolution.
+            mpContinuousLine line( startPx, endPx );
+
+            RewindForPlot( w, startPx, endPx );
+
             while( GetNextXY( x, y ) )
             {
                 double px = m_scaleX->TransformToPlot( x );
                 double py = m_scaleY->TransformToPlot( y );
 
-                wxCoord x1 = w.x2p( px );
-                wxCoord y1 = w.y2p( py );
-
-                // Store only points on the drawing area, to speed up the drawing time
-                // Note: x1 is a value truncated from px by w.x2p(). So to be sure the
-                // first point is drawn, the x1 low limit is startPx-1 in plot coordinates
-                if( x1 >= startPx-1 && x1 <= endPx )
-                {
-                    if( !count || line_start.x != x1 )
-                    {
-                        if( count && dupx0 > 1 && ymin0 != ymax0 )
-                        {
-                            // Vertical points are merged, draw the pending vertical line
-                            // However, if the line is one pixel length, it is not drawn,
-                            // because the main trace show this point
-                            dc.DrawLine( x0, ymin0, x0, ymax0 );
-                        }
-
-                        x0 = x1;
-                        ymin0 = ymax0 = y1;
-                        dupx0 = 0;
-
-                        pointList.emplace_back( wxPoint( x1, y1 ) );
-
-                        line_start.x = x1;
-                        line_start.y = y1;
-                        count++;
-                    }
-                    else
-                    {
-                        ymin0 = std::min( ymin0, y1 );
-                        ymax0 = std::max( ymax0, y1 );
-                        x0 = x1;
-                        dupx0++;
-                    }
-                }
+                line.AddPoint( w.x2p( px ), w.y2p( py ) );
             }
 
-            if( pointList.size() > 1 )
-            {
-                // For a better look (when using dashed lines) and more optimization,
-                // try to merge horizontal segments, in order to plot longer lines
-                // we are merging horizontal segments because this is easy,
-                // and horizontal segments are a frequent cases
-                std::vector<wxPoint> drawPoints;
-                drawPoints.reserve( endPx - startPx + 1 );
+            for( const std::pair<wxPoint, wxPoint>& vertical : line.GetVerticalLines() )
+                dc.DrawLine( vertical.first, vertical.second );
 
-                drawPoints.push_back( pointList[0] );   // push the first point in list
-
-                for( size_t ii = 1; ii < pointList.size()-1; ii++ )
-                {
-                    // Skip intermediate points between the first point and the last
-                    // point of the segment candidate
-                    if( drawPoints.back().y == pointList[ii].y &&
-                        drawPoints.back().y == pointList[ii+1].y )
-                        continue;
-                    else
-                        drawPoints.push_back( pointList[ii] );
-                }
-
-                // push the last point to draw in list
-                if( drawPoints.back() != pointList.back() )
-                    drawPoints.push_back( pointList.back() );
+            std::vector<wxPoint> drawPoints = line.GetLinePoints();
 
+            if( drawPoints.size() > 1 )
                 dc.DrawLines( drawPoints.size(), &drawPoints[0] );
-            }
         }
 
         if( !m_name.IsEmpty() && m_showName )
@@ -2789,6 +2905,8 @@ mpFXYVector::mpFXYVector( const wxString& name, int flags ) : mpFXY( name, flags
     m_minY  = -1;
     m_maxY  = 1;
     m_type  = mpLAYER_PLOT;
+
+    m_plotDecimated  = false;
 }
 
 
@@ -2847,6 +2965,7 @@ IMPLEMENT_DYNAMIC_CLASS( mpFSemiLogXVector, mpFXYVector )
 void mpFXYVector::Rewind()
 {
     m_index = 0;
+    m_plotDecimated = false;
 }
 
 size_t mpFXYVector::GetCount() const
@@ -2857,6 +2976,18 @@ size_t mpFXYVector::GetCount() const
 
 bool mpFXYVector::GetNextXY( double& x, double& y )
 {
+    if( m_plotDecimated )
+    {
+        const std::vector<size_t>& indices = m_decimator.GetIndices();
+
+        if( m_index >= indices.size() )
+            return false;
+
+        x = m_xs[indices[m_index]];
+        y = m_ys[indices[m_index++]];
+        return true;
+    }
+
     if( m_index >= m_xs.size() )
     {
         return false;
@@ -2870,32 +3001,55 @@ bool mpFXYVector::GetNextXY( double& x, double& y )
 }
 
 
+void mpFXYVector::RewindForPlot( mpWindow& w, wxCoord startPx, wxCoord endPx )
+{
+    m_decimator.Update( m_xs, m_ys,
+                        [&]( double x )
+                        {
+                            return m_scaleX->TransformToPlot( x );
+                        },
+                        w.GetPosX(), w.GetScaleX(), startPx, endPx );
+
+    m_index = 0;
+    m_plotDecimated = true;
+}
+
+
 void mpFXYVector::Clear()
 {
     m_xs.clear();
     m_ys.clear();
+    m_decimator.Clear();
 }
 
 
-void mpFXYVector::SetData( const std::vector<double>& xs, const std::vector<double>& ys )
+void mpFXYVector::SetData( std::vector<double> xs, std::vector<double> ys )
 {
     // Check if the data vectors are of the same size
     if( xs.size() != ys.size() )
         return;
 
-    // Copy the data:
-    m_xs    = xs;
-    m_ys    = ys;
+    // The decimation is extended when points are only appended to the data
+    bool appended = xs.size() >= m_xs.size()
+                    && std::equal( m_xs.begin(), m_xs.end(), xs.begin() )
+                    && std::equal( m_ys.begin(), m_ys.end(), ys.begin() );
+
+    if( !appended )
+        m_decimator.Clear();
+
+    // Move the data:
+    m_xs    = std::move( xs );
+    m_ys    = std::move( ys );
 
     // Update internal variables for the bounding box.
-    if( xs.size() > 0 )
+    if( m_xs.size() > 0 )
     {
-        m_minX  = xs[0];
-        m_maxX  = xs[0];
-        m_minY  = ys[0];
-        m_maxY  = ys[0];
+        m_minX  = m_xs[0];
+        m_maxX  = m_xs[0];
+        m_minY  = m_ys[0];
+        m_maxY  = m_ys[0];
 
-        for( const double x : xs )
+        for( const double x : m_xs )
         {
             if( x < m_minX )
                 m_minX = x;
@@ -2904,7 +3058,7 @@ void mpFXYVector::SetData( const std::vector<double>& xs, const std::vector<doub
                 m_maxX = x;
         }
 
-        for( const double y : ys )
+        for( const double y : m_ys )
         {
             if( y < m_minY )
                 m_minY = y;
@@ -400,6 +400,9 @@ EESCHEMA_SETTINGS::EESCHEMA_SETTINGS() :
     m_params.emplace_back( new PARAM<bool>( "simulator.white_background",
             &m_Simulator.white_background, false ) );
 
+    m_params.emplace_back( new PARAM<wxString>( "simulator.ngspice_command",
+            &m_Simulator.ngspice_command, "" ) );
+
     m_params.emplace_back( new PARAM<int>( "symbol_chooser.sash_pos_h",
             &m_SymChooserPanel.sash_pos_h, -1 ) );
 
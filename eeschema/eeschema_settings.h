@@ -235,6 +235,7 @@ public:
         int signal_panel_height;
         int cursors_panel_height;
         bool white_background;
+        wxString ngspice_command;     ///< ngspice program of the sweeps, empty to search it
         WINDOW_SETTINGS window;
     };
 
@@ -321,6 +321,25 @@ public:
     virtual LIB_SYMBOL* LoadSymbol( const wxString& aLibraryPath, const wxString& aPartName,
                                     const PROPERTIES* aProperties = nullptr );
 
+    /**
+     * Tell the plugin that the symbols \a aPartNames from \a aLibraryPath are about to be
+     * loaded one by one with LoadSymbol().
+     *
+     * Plugins for which loading a single symbol is expensive (e.g. a database query) can use
+     * this to fetch all of them at once.  The default implementation does nothing.
+     *
+     * @param aLibraryPath is a locator for the "library", usually a directory, file,
+     *                     or URL containing several symbols.
+     * @param aPartNames is the list of symbol names which will be loaded.
+     * @param aProperties is an associative array of additional named tuning arguments.
+     *
+     * @throw IO_ERROR if the library cannot be found or read.
+     */
+    virtual void PrefetchSymbols( const wxString& aLibraryPath,
+                                  const std::vector<wxString>& aPartNames,
+                                  const PROPERTIES* aProperties = nullptr )
+    {}
+
     /**
      * Write \a aSymbol to an existing library located at \a aLibraryPath.  If a #LIB_SYMBOL
      * by the same name already exists or there are any conflicting alias names, the new
@@ -142,6 +142,44 @@ LIB_SYMBOL* SCH_DATABASE_PLUGIN::LoadSymbol( const wxString&   aLibraryPath,
 }
 
 
+void SCH_DATABASE_PLUGIN::PrefetchSymbols( const wxString& aLibraryPath,
+                                           const std::vector<wxString>& aPartNames,
+                                           const PROPERTIES* aProperties )
+{
+    wxCHECK_RET( m_libTable, "Database plugin missing library table handle!" );
+    ensureSettings( aLibraryPath );
+    ensureConnection();
+
+    std::map<const DATABASE_LIB_TABLE*, std::vector<std::string>> keysByTable;
+
+    for( const wxString& partName : aPartNames )
+    {
+        std::string tableName( partName.BeforeFirst( '/' ).ToUTF8() );
+
+        for( const DATABASE_LIB_TABLE& tableIter : m_settings->m_Tables )
+        {
+            if( tableIter.name == tableName )
+            {
+                keysByTable[&tableIter].emplace_back( partName.AfterFirst( '/' ).ToUTF8() );
+                break;
+            }
+        }
+    }
+
+    // The rows end up in the connection cache, where LoadSymbol() will find them
+    for( const auto& [table, keys] : keysByTable )
+    {
+        std::vector<DATABASE_CONNECTION::ROW> results;
+
+        if( !m_conn->SelectMany( table->table, table->key_col, keys, results ) )
+        {
+            wxLogTrace( traceDatabase, wxT( "PrefetchSymbols: SelectMany (%s, %s) failed" ),
+                        table->table, table->key_col );
+        }
+    }
+}
+
+
 void SCH_DATABASE_PLUGIN::GetSubLibraryNames( std::vector<wxString>& aNames )
 {
     ensureSettings( wxEmptyString );
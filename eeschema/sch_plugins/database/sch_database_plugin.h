@@ -73,6 +73,9 @@ public:
     LIB_SYMBOL* LoadSymbol( const wxString& aLibraryPath, const wxString& aAliasName,
                             const PROPERTIES* aProperties = nullptr ) override;
 
+    void PrefetchSymbols( const wxString& aLibraryPath, const std::vector<wxString>& aPartNames,
+                          const PROPERTIES* aProperties = nullptr ) override;
+
     bool SupportsSubLibraries() const override { return true; }
 
     void GetSubLibraryNames( std::vector<wxString>& aNames ) override;
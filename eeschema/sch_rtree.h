@@ -105,6 +105,34 @@ public:
         return true;
     }
 
+    /**
+     * Pack the tree again from its items, with their current bounding boxes.
+     *
+     * This is much faster than removing and inserting back each item when the bounding boxes
+     * of many items changed.
+     */
+    void rebuild()
+    {
+        std::vector<std::pair<ee_rtree::Rect, SCH_ITEM*>> entries;
+        entries.reserve( m_count );
+
+        for( SCH_ITEM* item : *m_tree )
+        {
+            BOX2I bbox = item->GetBoundingBox();
+
+            // Inflate a bit for safety, selection shadows, etc.
+            bbox.Inflate( item->GetPenWidth() );
+
+            const int      type = int( item->Type() );
+            ee_rtree::Rect rect = { { type, bbox.GetX(), bbox.GetY() },
+                                    { type, bbox.GetRight(), bbox.GetBottom() } };
+
+            entries.emplace_back( rect, item );
+        }
+
+        m_tree->BulkLoad( entries );
+    }
+
     /**
      * Remove all items from the RTree
      */
@@ -52,6 +52,7 @@
 #include <tool/common_tools.h>
 
 #include <algorithm>
+#include <set>
 
 // TODO(JE) Debugging only
 #include <profile.h>
@@ -1001,9 +1002,6 @@ void SCH_SCREEN::UpdateLocalLibSymbolLinks()
 
     for( SCH_SYMBOL* symbol : symbols )
     {
-        // Changing the symbol may adjust the bbox of the symbol; remove and reinsert it afterwards.
-        m_rtree.remove( symbol );
-
         auto it = m_libSymbols.find( symbol->GetSchSymbolLibraryName() );
 
         LIB_SYMBOL* libSymbol = nullptr;
@@ -1012,9 +1010,12 @@ void SCH_SCREEN::UpdateLocalLibSymbolLinks()
             libSymbol = new LIB_SYMBOL( *it->second );
 
         symbol->SetLibSymbol( libSymbol );
-
-        m_rtree.insert( symbol );
     }
+
+    // Changing the symbols may adjust their bboxes.  Packing the tree again at once is much
+    // faster than removing and reinserting each symbol.
+    if( !symbols.empty() )
+        m_rtree.rebuild();
 }
 
 
@@ -1713,9 +1714,6 @@ void SCH_SCREENS::DeleteAllMarkers( enum MARKER_BASE::TYPEMARKER aMarkerType,
 
 void SCH_SCREENS::UpdateSymbolLinks( REPORTER* aReporter )
 {
-    for( SCH_SCREEN* screen = GetFirst(); screen; screen = GetNext() )
-        screen->UpdateSymbolLinks( aReporter );
-
     SCH_SCREEN* first = GetFirst();
 
     if( !first )
@@ -1725,6 +1723,40 @@ void SCH_SCREENS::UpdateSymbolLinks( REPORTER* aReporter )
 
     wxCHECK_RET( sch, "Null schematic in SCH_SCREENS::UpdateSymbolLinks" );
 
+    // Let the libraries which are slow to load symbols one by one (database libraries) fetch
+    // all the symbols of the schematic at once.
+    std::map<wxString, std::set<wxString>> symbolsByLib;
+    SYMBOL_LIB_TABLE*                      libs = sch->Prj().SchSymbolLibTable();
+
+    for( SCH_SCREEN* screen = GetFirst(); screen; screen = GetNext() )
+    {
+        for( SCH_ITEM* item : screen->Items().OfType( SCH_SYMBOL_T ) )
+        {
+            const LIB_ID& libId = static_cast<SCH_SYMBOL*>( item )->GetLibId();
+
+            if( libId.IsValid() )
+                symbolsByLib[libId.GetLibNickname()].insert( libId.GetLibItemName() );
+        }
+    }
+
+    for( const auto& [nickname, names] : symbolsByLib )
+    {
+        if( !libs->HasLibrary( nickname ) )
+            continue;
+
+        try
+        {
+            libs->PrefetchSymbols( nickname, std::vector<wxString>( names.begin(), names.end() ) );
+        }
+        catch( const IO_ERROR& )
+        {
+            // Errors will be reported when loading the symbols
+        }
+    }
+
+    for( SCH_SCREEN* screen = GetFirst(); screen; screen = GetNext() )
+        screen->UpdateSymbolLinks( aReporter );
+
     SCH_SHEET_LIST sheets = sch->GetSheets();
 
     // All of the library symbols have been replaced with copies so the connection graph
@@ -116,28 +116,38 @@ vector<string> NGSPICE::AllPlots() const
 }
 
 
-vector<COMPLEX> NGSPICE::GetPlot( const string& aName, int aMaxLen )
+SPICE_VECTOR_VIEW NGSPICE::GetPlotView( const string& aName, int aMaxLen )
 {
+    // The complex values are viewed as pairs of doubles
+    static_assert( sizeof( ngcomplex_t ) == 2 * sizeof( double ),
+                   "ngcomplex_t is not a pair of doubles" );
+
     LOCALE_IO c_locale;       // ngspice works correctly only with C locale
-    vector<COMPLEX> data;
     vector_info* vi = m_ngGet_Vec_Info( (char*) aName.c_str() );
 
-    if( vi )
-    {
-        int length = aMaxLen < 0 ? vi->v_length : std::min( aMaxLen, vi->v_length );
-        data.reserve( length );
+    if( !vi )
+        return SPICE_VECTOR_VIEW();
 
-        if( vi->v_realdata )
-        {
-            for( int i = 0; i < length; i++ )
-                data.emplace_back( vi->v_realdata[i], 0.0 );
-        }
-        else if( vi->v_compdata )
-        {
-            for( int i = 0; i < length; i++ )
-                data.emplace_back( vi->v_compdata[i].cx_real, vi->v_compdata[i].cx_imag );
-        }
-    }
+    int length = aMaxLen < 0 ? vi->v_length : std::min( aMaxLen, vi->v_length );
+
+    if( vi->v_realdata )
+        return SPICE_VECTOR_VIEW( vi->v_realdata, length, false );
+    else if( vi->v_compdata )
+        return SPICE_VECTOR_VIEW( &vi->v_compdata[0].cx_real, length, true );
+
+    return SPICE_VECTOR_VIEW();
+}
+
+
+vector<COMPLEX> NGSPICE::GetPlot( const string& aName, int aMaxLen )
+{
+    SPICE_VECTOR_VIEW view = GetPlotView( aName, aMaxLen );
+    vector<COMPLEX> data;
+
+    data.reserve( view.size() );
+
+    for( size_t i = 0; i < view.size(); i++ )
+        data.emplace_back( view.Real( i ), view.Imag( i ) );
 
     return data;
 }
@@ -145,30 +155,15 @@ vector<COMPLEX> NGSPICE::GetPlot( const string& aName, int aMaxLen )
 
 vector<double> NGSPICE::GetRealPlot( const string& aName, int aMaxLen )
 {
-    LOCALE_IO c_locale;       // ngspice works correctly only with C locale
+    SPICE_VECTOR_VIEW view = GetPlotView( aName, aMaxLen );
     vector<double> data;
-    vector_info* vi = m_ngGet_Vec_Info( (char*) aName.c_str() );
 
-    if( vi )
-    {
-        int length = aMaxLen < 0 ? vi->v_length : std::min( aMaxLen, vi->v_length );
-        data.reserve( length );
+    data.reserve( view.size() );
 
-        if( vi->v_realdata )
-        {
-            for( int i = 0; i < length; i++ )
-            {
-                data.push_back( vi->v_realdata[i] );
-            }
-        }
-        else if( vi->v_compdata )
-        {
-            for( int i = 0; i < length; i++ )
-            {
-                wxASSERT( vi->v_compdata[i].cx_imag == 0.0 );
-                data.push_back( vi->v_compdata[i].cx_real );
-            }
-        }
+    for( size_t i = 0; i < view.size(); i++ )
+    {
+        wxASSERT( view.Imag( i ) == 0.0 );
+        data.push_back( view.Real( i ) );
     }
 
     return data;
@@ -177,22 +172,16 @@ vector<double> NGSPICE::GetRealPlot( const string& aName, int aMaxLen )
 
 vector<double> NGSPICE::GetImagPlot( const string& aName, int aMaxLen )
 {
-    LOCALE_IO c_locale;       // ngspice works correctly only with C locale
+    SPICE_VECTOR_VIEW view = GetPlotView( aName, aMaxLen );
     vector<double> data;
-    vector_info* vi = m_ngGet_Vec_Info( (char*) aName.c_str() );
 
-    if( vi )
+    // A real vector has no imaginary part
+    if( view.IsComplex() )
     {
-        int length = aMaxLen < 0 ? vi->v_length : std::min( aMaxLen, vi->v_length );
-        data.reserve( length );
+        data.reserve( view.size() );
 
-        if( vi->v_compdata )
-        {
-            for( int i = 0; i < length; i++ )
-            {
-                data.push_back( vi->v_compdata[i].cx_imag );
-            }
-        }
+        for( size_t i = 0; i < view.size(); i++ )
+            data.push_back( view.Imag( i ) );
     }
 
     return data;
@@ -201,26 +190,13 @@ vector<double> NGSPICE::GetImagPlot( const string& aName, int aMaxLen )
 
 vector<double> NGSPICE::GetMagPlot( const string& aName, int aMaxLen )
 {
-    LOCALE_IO c_locale;       // ngspice works correctly only with C locale
+    SPICE_VECTOR_VIEW view = GetPlotView( aName, aMaxLen );
     vector<double> data;
-    vector_info* vi = m_ngGet_Vec_Info( (char*) aName.c_str() );
 
-    if( vi )
-    {
-        int length = aMaxLen < 0 ? vi->v_length : std::min( aMaxLen, vi->v_length );
-        data.reserve( length );
+    data.reserve( view.size() );
 
-        if( vi->v_realdata )
-        {
-            for( int i = 0; i < length; i++ )
-                data.push_back( vi->v_realdata[i] );
-        }
-        else if( vi->v_compdata )
-        {
-            for( int i = 0; i < length; i++ )
-                data.push_back( hypot( vi->v_compdata[i].cx_real, vi->v_compdata[i].cx_imag ) );
-        }
-    }
+    for( size_t i = 0; i < view.size(); i++ )
+        data.push_back( view.Mag( i ) );
 
     return data;
 }
@@ -228,26 +204,13 @@ vector<double> NGSPICE::GetMagPlot( const string& aName, int aMaxLen )
 
 vector<double> NGSPICE::GetPhasePlot( const string& aName, int aMaxLen )
 {
-    LOCALE_IO c_locale;       // ngspice works correctly only with C locale
+    SPICE_VECTOR_VIEW view = GetPlotView( aName, aMaxLen );
     vector<double> data;
-    vector_info* vi = m_ngGet_Vec_Info( (char*) aName.c_str() );
 
-    if( vi )
-    {
-        int length = aMaxLen < 0 ? vi->v_length : std::min( aMaxLen, vi->v_length );
-        data.reserve( length );
+    data.reserve( view.size() );
 
-        if( vi->v_realdata )
-        {
-            for( int i = 0; i < length; i++ )
-                data.push_back( 0.0 );      // well, that's life
-        }
-        else if( vi->v_compdata )
-        {
-            for( int i = 0; i < length; i++ )
-                data.push_back( atan2( vi->v_compdata[i].cx_imag, vi->v_compdata[i].cx_real ) );
-        }
-    }
+    for( size_t i = 0; i < view.size(); i++ )
+        data.push_back( view.Phase( i ) );      // 0 for a real vector, well, that's life
 
     return data;
 }
@@ -529,12 +492,59 @@ void NGSPICE::init_dll()
     wxFileName exeDir( stdPaths.GetExecutablePath() );
     wxSetWorkingDirectory( exeDir.GetPath() );
 
+    for( const string& command : getInitCommands() )
+        Command( command );
+
+    // Restore the working directory
+    wxSetWorkingDirectory( cwd );
+
+    // Workarounds to avoid hang ups on certain errors
+    // These commands have to be called, no matter what is in the spinit file
+    Command( "unset interactive" );
+    Command( "set noaskquit" );
+    Command( "set nomoremode" );
+
+    m_initialized = true;
+}
+
+
+vector<string> NGSPICE::GetProcessInitCommands() const
+{
+    vector<string> commands;
+
+    // The paths of the spinit file and of the code models are relative to the executable
+    // directory, the process goes back to the current directory to read the netlist
+    wxString   cwd( wxGetCwd() );
+    wxFileName exeDir( wxStandardPaths::Get().GetExecutablePath() );
+    wxSetWorkingDirectory( exeDir.GetPath() );
+
+    commands.emplace_back( "cd \"" + exeDir.GetPath().ToStdString() + "\"" );
+
+    for( const string& command : getInitCommands() )
+        commands.push_back( command );
+
+    wxSetWorkingDirectory( cwd );
+
+    commands.emplace_back( "cd \"" + cwd.ToStdString() + "\"" );
+
+    for( const string& command : GetSettingCommands() )
+        commands.push_back( command );
+
+    return commands;
+}
+
+
+vector<string> NGSPICE::getInitCommands() const
+{
+    const wxStandardPaths& stdPaths = wxStandardPaths::Get();
+    vector<string>         commands;
+
     // Find *.cm files
     string cmPath = findCmPath();
 
     // __CMPATH is used in custom spinit file to point to the codemodels directory
     if( !cmPath.empty() )
-        Command( "set __CMPATH=\"" + cmPath + "\"" );
+        commands.emplace_back( "set __CMPATH=\"" + cmPath + "\"" );
 
     // Possible relative locations for spinit file
     const vector<string> spiceinitPaths =
@@ -557,7 +567,7 @@ void NGSPICE::init_dll()
     {
         wxLogTrace( traceNgspice, "ngspice init script search path: %s", path );
 
-        if( loadSpinit( path + "/spiceinit" ) )
+        if( readSpinit( path + "/spiceinit", commands ) )
         {
             wxLogTrace( traceNgspice, "ngspice path found in: %s", path );
             foundSpiceinit = true;
@@ -568,22 +578,13 @@ void NGSPICE::init_dll()
     // Last chance to load codemodel files, we have not found
     // spiceinit file, but we know the path to *.cm files
     if( !foundSpiceinit && !cmPath.empty() )
-        loadCodemodels( cmPath );
-
-    // Restore the working directory
-    wxSetWorkingDirectory( cwd );
-
-    // Workarounds to avoid hang ups on certain errors
-    // These commands have to be called, no matter what is in the spinit file
-    Command( "unset interactive" );
-    Command( "set noaskquit" );
-    Command( "set nomoremode" );
+        readCodemodels( cmPath, commands );
 
-    m_initialized = true;
+    return commands;
 }
 
 
-bool NGSPICE::loadSpinit( const string& aFileName )
+bool NGSPICE::readSpinit( const string& aFileName, vector<string>& aCommands ) const
 {
     if( !wxFileName::FileExists( aFileName ) )
         return false;
@@ -594,7 +595,7 @@ bool NGSPICE::loadSpinit( const string& aFileName )
         return false;
 
     for( wxString& cmd = file.GetFirstLine(); !file.Eof(); cmd = file.GetNextLine() )
-        Command( cmd.ToStdString() );
+        aCommands.push_back( cmd.ToStdString() );
 
     return true;
 }
@@ -633,13 +634,13 @@ string NGSPICE::findCmPath() const
 }
 
 
-bool NGSPICE::loadCodemodels( const string& aPath )
+bool NGSPICE::readCodemodels( const string& aPath, vector<string>& aCommands ) const
 {
     wxArrayString cmFiles;
     size_t count = wxDir::GetAllFiles( aPath, &cmFiles );
 
     for( const auto& cm : cmFiles )
-        Command( "codemodel " + cm.ToStdString() );
+        aCommands.push_back( "codemodel " + cm.ToStdString() );
 
     return count != 0;
 }
@@ -97,8 +97,14 @@ public:
     ///< @copydoc SPICE_SIMULATOR::GetPhasePlot()
     std::vector<double> GetPhasePlot( const std::string& aName, int aMaxLen = -1 ) override final;
 
+    ///< @copydoc SPICE_SIMULATOR::GetPlotView()
+    SPICE_VECTOR_VIEW GetPlotView( const std::string& aName, int aMaxLen = -1 ) override final;
+
     std::vector<std::string> GetSettingCommands() const override final;
 
+    ///< @copydoc SPICE_SIMULATOR::GetProcessInitCommands()
+    std::vector<std::string> GetProcessInitCommands() const override final;
+
     ///< @copydoc SPICE_SIMULATOR::GetNetlist()
     virtual const std::string GetNetlist() const override final;
 
@@ -135,14 +141,18 @@ private:
     wxDynamicLibrary m_dll;
 
 
-    ///< Execute commands from a file
-    bool loadSpinit( const std::string& aFileName );
+    ///< Return the commands loading the spinit file or the code models, to be executed from the
+    ///< executable directory.
+    std::vector<std::string> getInitCommands() const;
+
+    ///< Read the commands of a file.
+    bool readSpinit( const std::string& aFileName, std::vector<std::string>& aCommands ) const;
 
     ///< Check a few different locations for codemodel files and returns one if it exists.
     std::string findCmPath() const;
 
-    ///< Load codemodel files from a directory.
-    bool loadCodemodels( const std::string& aPath );
+    ///< Read the commands loading the codemodel files of a directory.
+    bool readCodemodels( const std::string& aPath, std::vector<std::string>& aCommands ) const;
 
     // Callback functions
     static int cbSendChar( char* what, int aId, void* aUser );
@@ -35,7 +35,9 @@
 #include <bitmaps.h>
 #include <wildcards_and_files_ext.h>
 #include <widgets/tuner_slider.h>
+#include <widgets/wx_progress_reporters.h>
 #include <dialogs/dialog_signal_list.h>
+#include <dialogs/dialog_text_entry.h>
 #include <scintilla_tricks.h>
 #include "string_utils.h"
 #include "ngspice_helpers.h"
@@ -44,6 +46,7 @@
 #include "sim_plot_colors.h"
 #include "sim_plot_frame.h"
 #include "sim_plot_panel.h"
+#include "sim_sweep.h"
 #include "spice_simulator.h"
 #include "spice_reporter.h"
 #include <menus_helpers.h>
@@ -55,6 +58,8 @@
 #include <dialog_shim.h>
 #include <wx_filename.h>
 
+#include <algorithm>
+
 
 SIM_PLOT_TYPE operator|( SIM_PLOT_TYPE aFirst, SIM_PLOT_TYPE aSecond )
 {
@@ -199,6 +204,13 @@ SIM_PLOT_FRAME::SIM_PLOT_FRAME( KIWAY* aKiway, wxWindow* aParent ) :
     Bind( wxEVT_COMMAND_TOOL_CLICKED, &SIM_PLOT_FRAME::onTune, this, m_toolTune->GetId() );
     Bind( wxEVT_COMMAND_TOOL_CLICKED, &SIM_PLOT_FRAME::onSettings, this, m_toolSettings->GetId() );
 
+    size_t tunePos = 0;
+    m_simulationMenu->FindChildItem( m_tuneValue->GetId(), &tunePos );
+    m_monteCarlo = m_simulationMenu->Insert( tunePos + 1, wxID_ANY, _( "Monte Carlo Runs..." ),
+            _( "Run the simulation with random component values in their tolerance" ) );
+
+    Bind( wxEVT_UPDATE_UI, &SIM_PLOT_FRAME::menuTuneUpdate, this, m_monteCarlo->GetId() );
+
     Bind( EVT_WORKBOOK_MODIFIED, &SIM_PLOT_FRAME::onWorkbookModified, this );
     Bind( EVT_WORKBOOK_CLR_MODIFIED, &SIM_PLOT_FRAME::onWorkbookClrModified, this );
 
@@ -210,6 +222,8 @@ SIM_PLOT_FRAME::SIM_PLOT_FRAME( KIWAY* aKiway, wxWindow* aParent ) :
     Bind( wxEVT_COMMAND_MENU_SELECTED, &SIM_PLOT_FRAME::onTune, this, m_tuneValue->GetId() );
     Bind( wxEVT_COMMAND_MENU_SELECTED, &SIM_PLOT_FRAME::onShowNetlist, this,
           m_showNetlist->GetId() );
+    Bind( wxEVT_COMMAND_MENU_SELECTED, &SIM_PLOT_FRAME::onMonteCarlo, this,
+          m_monteCarlo->GetId() );
     Bind( wxEVT_COMMAND_MENU_SELECTED, &SIM_PLOT_FRAME::onSettings, this,
           m_boardAdapter->GetId() );
 
@@ -713,17 +727,25 @@ void SIM_PLOT_FRAME::removePlot( const wxString& aPlotName )
 }
 
 
-bool SIM_PLOT_FRAME::updatePlot( const wxString& aName, SIM_PLOT_TYPE aType,
-                                 SIM_PLOT_PANEL* aPlotPanel )
+static wxString traceTitle( const wxString& aName, SIM_PLOT_TYPE aType )
 {
-    SIM_TYPE simType = m_circuitModel->GetSimType();
-
     wxString plotTitle = aName;
     if( aType & SPT_AC_MAG )
         plotTitle += " (mag)";
     else if( aType & SPT_AC_PHASE )
         plotTitle += " (phase)";
 
+    return plotTitle;
+}
+
+
+bool SIM_PLOT_FRAME::updatePlot( const wxString& aName, SIM_PLOT_TYPE aType,
+                                 SIM_PLOT_PANEL* aPlotPanel )
+{
+    SIM_TYPE simType = m_circuitModel->GetSimType();
+
+    wxString plotTitle = traceTitle( aName, aType );
+
     if( !SIM_PANEL_BASE::IsPlottable( simType ) )
     {
         // There is no plot to be shown
@@ -738,13 +760,14 @@ bool SIM_PLOT_FRAME::updatePlot( const wxString& aName, SIM_PLOT_TYPE aType,
     if( xAxisName.IsEmpty() )
         return false;
 
-    auto data_x = m_simulator->GetMagPlot( (const char*) xAxisName.c_str() );
-    unsigned int size = data_x.size();
+    // The vectors are viewed in the simulator memory, and copied once to the traces
+    SPICE_VECTOR_VIEW data_x = m_simulator->GetPlotView( (const char*) xAxisName.c_str() );
+    size_t size = data_x.size();
 
     if( data_x.empty() )
         return false;
 
-    std::vector<double> data_y;
+    SPICE_VECTOR_VIEW data_y;
 
     // Now, Y axis data
     switch( m_circuitModel->GetSimType() )
@@ -753,19 +776,17 @@ bool SIM_PLOT_FRAME::updatePlot( const wxString& aName, SIM_PLOT_TYPE aType,
         wxASSERT_MSG( !( ( aType & SPT_AC_MAG ) && ( aType & SPT_AC_PHASE ) ),
                       "Cannot set both AC_PHASE and AC_MAG bits" );
 
-        if( aType & SPT_AC_MAG )
-            data_y = m_simulator->GetMagPlot( (const char*) aName.c_str() );
-        else if( aType & SPT_AC_PHASE )
-            data_y = m_simulator->GetPhasePlot( (const char*) aName.c_str() );
-        else
-            wxASSERT_MSG( false, "Plot type missing AC_PHASE or AC_MAG bit" );
+        wxASSERT_MSG( ( aType & ( SPT_AC_MAG | SPT_AC_PHASE ) ) != 0,
+                      "Plot type missing AC_PHASE or AC_MAG bit" );
 
+        // The trace takes the magnitude or the phase of the complex values
+        data_y = m_simulator->GetPlotView( (const char*) aName.c_str() );
         break;
 
     case ST_NOISE:
     case ST_DC:
     case ST_TRANSIENT:
-        data_y = m_simulator->GetMagPlot( (const char*) aName.c_str() );
+        data_y = m_simulator->GetPlotView( (const char*) aName.c_str() );
         break;
 
     default:
@@ -776,6 +797,29 @@ bool SIM_PLOT_FRAME::updatePlot( const wxString& aName, SIM_PLOT_TYPE aType,
     if( data_y.size() != size )
         return false;
 
+    addTraces( aPlotPanel, plotTitle, aName, data_x, data_y, aType );
+
+    return true;
+}
+
+
+void SIM_PLOT_FRAME::addTraces( SIM_PLOT_PANEL* aPlotPanel, const wxString& aTitle,
+                                const wxString& aName, const SPICE_VECTOR_VIEW& aX,
+                                const SPICE_VECTOR_VIEW& aY, SIM_PLOT_TYPE aType,
+                                const wxString& aRun )
+{
+    wxString plotTitle = aRun.IsEmpty() ? aTitle : aTitle + wxS( " " ) + aRun;
+
+    auto addTrace =
+            [&]( const wxString& aTraceTitle, const SPICE_VECTOR_VIEW& aTraceX,
+                 const SPICE_VECTOR_VIEW& aTraceY )
+            {
+                m_workbook->AddTrace( aPlotPanel, aTraceTitle, aName, aTraceX, aTraceY, aType );
+
+                if( !aRun.IsEmpty() )
+                    aPlotPanel->GetTrace( aTraceTitle )->SetSweepRun( true );
+            };
+
     // If we did a two-source DC analysis, we need to split the resulting vector and add traces
     // for each input step
     SPICE_DC_PARAMS source1, source2;
@@ -791,34 +835,41 @@ bool SIM_PLOT_FRAME::updatePlot( const wxString& aName, SIM_PLOT_TYPE aType,
 
             size_t offset = 0;
             size_t outer = ( size_t )( ( source2.m_vend - v ) / source2.m_vincrement ).ToDouble();
-            size_t inner = data_x.size() / ( outer + 1 );
+            size_t inner = aX.size() / ( outer + 1 );
 
-            wxASSERT( data_x.size() % ( outer + 1 ) == 0 );
+            wxASSERT( aX.size() % ( outer + 1 ) == 0 );
 
             for( size_t idx = 0; idx <= outer; idx++ )
             {
                 name = wxString::Format( "%s (%s = %s V)", plotTitle, source2.m_source,
                                          v.ToString() );
 
-                std::vector<double> sub_x( data_x.begin() + offset,
-                                           data_x.begin() + offset + inner );
-                std::vector<double> sub_y( data_y.begin() + offset,
-                                           data_y.begin() + offset + inner );
-
-                m_workbook->AddTrace( aPlotPanel, name, aName, inner, sub_x.data(), sub_y.data(),
-                                      aType );
+                addTrace( name, aX.Slice( offset, inner ), aY.Slice( offset, inner ) );
 
                 v = v + source2.m_vincrement;
                 offset += inner;
             }
 
-            return true;
+            return;
         }
     }
 
-    m_workbook->AddTrace( aPlotPanel, plotTitle, aName, size, data_x.data(), data_y.data(), aType );
+    addTrace( plotTitle, aX, aY );
+}
+
 
-    return true;
+void SIM_PLOT_FRAME::removeSweepRuns( SIM_PLOT_PANEL* aPlotPanel )
+{
+    std::vector<wxString> runs;
+
+    for( const auto& trace : aPlotPanel->GetTraces() )
+    {
+        if( trace.second->IsSweepRun() )
+            runs.push_back( trace.first );
+    }
+
+    for( const wxString& run : runs )
+        m_workbook->DeleteTrace( aPlotPanel, run );
 }
 
 
@@ -1078,10 +1129,22 @@ bool SIM_PLOT_FRAME::saveWorkbook( const wxString& aPath )
             continue;
         }
 
-        file.AddLine( wxString::Format( "%llu", plotPanel->GetTraces().size() ) );
+        // The traces of the sweep runs are not saved, they are copies of the saved traces
+        size_t traceCount = 0;
 
         for( const auto& trace : plotPanel->GetTraces() )
         {
+            if( !trace.second->IsSweepRun() )
+                traceCount++;
+        }
+
+        file.AddLine( wxString::Format( "%llu", traceCount ) );
+
+        for( const auto& trace : plotPanel->GetTraces() )
+        {
+            if( trace.second->IsSweepRun() )
+                continue;
+
             file.AddLine( wxString::Format( "%d", trace.second->GetType() ) );
             file.AddLine( trace.second->GetName() );
             file.AddLine( trace.second->GetParam() );
@@ -1570,6 +1633,187 @@ void SIM_PLOT_FRAME::onTune( wxCommandEvent& event )
 }
 
 
+void SIM_PLOT_FRAME::onMonteCarlo( wxCommandEvent& event )
+{
+    wxCHECK_RET( m_simFinished, "No simulation results available" );
+
+    SIM_PLOT_PANEL* plotPanel = GetCurrentPlot();
+    SIM_TYPE        simType = m_circuitModel->GetSimType();
+
+    // The signals of the runs are the signals of the plot, the traces of the previous runs and
+    // the traces of the steps of a DC analysis are their copies
+    struct SIGNAL_DESC
+    {
+        wxString      m_name;
+        SIM_PLOT_TYPE m_type;
+    };
+
+    std::vector<SIGNAL_DESC> signals;
+    std::vector<std::string> vectors;
+
+    if( plotPanel )
+    {
+        for( const auto& trace : plotPanel->GetTraces() )
+        {
+            const wxString& name = trace.second->GetName();
+            SIM_PLOT_TYPE   type = trace.second->GetType();
+
+            if( trace.second->IsSweepRun() )
+                continue;
+
+            if( std::none_of( signals.begin(), signals.end(),
+                              [&]( const SIGNAL_DESC& aSignal )
+                              {
+                                  return aSignal.m_name == name && aSignal.m_type == type;
+                              } ) )
+            {
+                signals.push_back( { name, type } );
+            }
+
+            if( std::find( vectors.begin(), vectors.end(), name.ToStdString() ) == vectors.end() )
+                vectors.push_back( name.ToStdString() );
+        }
+    }
+
+    if( !plotPanel || plotPanel->GetType() != simType || signals.empty() )
+    {
+        DisplayInfoMessage( this, _( "Add the signals to analyze to the current plot first." ) );
+        return;
+    }
+
+    std::vector<wxString> tolerances = { wxT( "1%" ), wxT( "2%" ), wxT( "5%" ), wxT( "10%" ),
+                                         wxT( "20%" ) };
+    const double          toleranceValues[] = { 0.01, 0.02, 0.05, 0.1, 0.2 };
+
+    WX_TEXT_ENTRY_DIALOG dlg( this, _( "Number of runs:" ), _( "Monte Carlo Runs" ), wxT( "20" ),
+                              _( "Tolerance of R, C and L:" ), tolerances, 2 );
+    dlg.SetTextValidator( wxFILTER_DIGITS );
+
+    if( dlg.ShowModal() != wxID_OK )
+        return;
+
+    long count = 0;
+
+    if( !dlg.GetValue().ToLong( &count ) || count < 1 )
+        return;
+
+    // The runs need the ngspice program, which is not always installed with the ngspice library
+    EESCHEMA_SETTINGS* cfg = m_schematicFrame->eeconfig();
+    wxString           command = cfg ? cfg->m_Simulator.ngspice_command : wxString();
+
+    if( wxFileName( command ).IsAbsolute() && !wxFileName::FileExists( command ) )
+        command.Clear();
+
+    if( command.IsEmpty() )
+        command = SIM_SWEEP::FindSimulatorCommand();
+
+    if( command.IsEmpty() )
+    {
+        wxFileDialog openDlg( this, _( "Select the ngspice Program" ), wxEmptyString,
+                              wxEmptyString, AllFilesWildcard(),
+                              wxFD_OPEN | wxFD_FILE_MUST_EXIST );
+
+        if( openDlg.ShowModal() == wxID_CANCEL )
+            return;
+
+        command = openDlg.GetPath();
+
+        if( cfg )
+            cfg->m_Simulator.ngspice_command = command;
+    }
+
+    // The runs use the netlist of the last simulation, which holds the simulation command
+    STRING_FORMATTER formatter;
+
+    if( !m_circuitModel->GetNetlist( &formatter ) )
+    {
+        DisplayErrorMessage( this, _( "There were errors during netlist export, aborted." ) );
+        return;
+    }
+
+    SIM_SWEEP sweep( formatter.GetString() );
+
+    sweep.SetSimulatorCommand( command );
+    sweep.SetInitCommands( m_simulator->GetProcessInitCommands() );
+    sweep.SetVectors( vectors );
+    sweep.AddMonteCarloVariants( *m_circuitModel, (int) count,
+                                 toleranceValues[ std::max( 0, dlg.GetChoice() ) ] );
+
+    {
+        WX_PROGRESS_REPORTER progress( this, _( "Monte Carlo Runs" ), 1, true );
+
+        if( !sweep.Run( &progress ) )
+            return;
+    }
+
+    std::string xAxisName = m_simulator->GetXAxis( simType );
+
+    removeSweepRuns( plotPanel );
+
+    const std::vector<SIM_SWEEP::VARIANT>& variants = sweep.GetVariants();
+    const std::vector<SIM_SWEEP::RESULT>&  results = sweep.GetResults();
+    int                                    failures = 0;
+
+    for( size_t ii = 0; ii < results.size(); ii++ )
+    {
+        const SIM_SWEEP::RESULT& result = results[ii];
+
+        if( !result.m_Ok )
+        {
+            if( failures++ == 0 )
+            {
+                m_simConsole->AppendText( wxString::Format( _( "\nRun %s failed:\n%s\n" ),
+                                                            variants[ii].m_Title,
+                                                            result.m_Error ) );
+            }
+
+            continue;
+        }
+
+        SPICE_VECTOR_VIEW data_x = result.GetVector( xAxisName );
+
+        if( data_x.empty() )
+            continue;
+
+        for( const SIGNAL_DESC& signal : signals )
+        {
+            SPICE_VECTOR_VIEW data_y = result.GetVector( signal.m_name.ToStdString() );
+
+            if( data_y.size() != data_x.size() )
+                continue;
+
+            addTraces( plotPanel, traceTitle( signal.m_name, signal.m_type ), signal.m_name,
+                       data_x, data_y, signal.m_type, variants[ii].m_Title );
+        }
+    }
+
+    m_simConsole->AppendText( wxString::Format( _( "\nMonte Carlo runs: %d, failed: %d\n" ),
+                                                (int) results.size(), failures ) );
+
+    for( const std::string& vector : vectors )
+    {
+        SIM_SWEEP::STATISTICS stats = sweep.GetStatistics( vector );
+
+        if( stats.m_Count == 0 )
+            continue;
+
+        m_simConsole->AppendText( wxString::Format( _( "%s: min %s, mean %s, max %s, "
+                                                       "std dev %s\n" ),
+                                                    vector,
+                                                    SPICE_VALUE( stats.m_Min ).ToString(),
+                                                    SPICE_VALUE( stats.m_Mean ).ToString(),
+                                                    SPICE_VALUE( stats.m_Max ).ToString(),
+                                                    SPICE_VALUE( stats.m_StdDev ).ToString() ) );
+    }
+
+    m_simConsole->SetInsertionPointEnd();
+
+    updateSignalList();
+    plotPanel->GetPlotWin()->UpdateAll();
+    plotPanel->ResetScales();
+}
+
+
 void SIM_PLOT_FRAME::onShowNetlist( wxCommandEvent& event )
 {
     class NETLIST_VIEW_DIALOG : public DIALOG_SHIM
@@ -1784,6 +2028,9 @@ void SIM_PLOT_FRAME::onSimFinished( wxCommandEvent& aEvent )
 
         std::vector<struct TRACE_DESC> traceInfo;
 
+        // The sweep runs were simulated from the previous circuit
+        removeSweepRuns( plotPanel );
+
         // Get information about all the traces on the plot, remove and add again
         for( auto& trace : plotPanel->GetTraces() )
         {
@@ -190,6 +190,24 @@ private:
      */
     bool updatePlot( const wxString& aName, SIM_PLOT_TYPE aType, SIM_PLOT_PANEL* aPlotPanel );
 
+    /**
+     * Add the traces of a signal to a plot panel.  A DC analysis with two sources has a trace
+     * for each step of the second source.
+     *
+     * @param aTitle is the title of the trace.
+     * @param aName is the device/net name.
+     * @param aRun is the title of the sweep run the signal comes from, or empty for the signal
+     *             of the simulation.
+     */
+    void addTraces( SIM_PLOT_PANEL* aPlotPanel, const wxString& aTitle, const wxString& aName,
+                    const SPICE_VECTOR_VIEW& aX, const SPICE_VECTOR_VIEW& aY,
+                    SIM_PLOT_TYPE aType, const wxString& aRun = wxEmptyString );
+
+    /**
+     * Remove the traces of the sweep runs of a plot panel.
+     */
+    void removeSweepRuns( SIM_PLOT_PANEL* aPlotPanel );
+
     /**
      * Update the list of currently plotted signals.
      */
@@ -307,6 +325,7 @@ private:
     void onAddSignal( wxCommandEvent& event );
     void onProbe( wxCommandEvent& event );
     void onTune( wxCommandEvent& event );
+    void onMonteCarlo( wxCommandEvent& event );
     void onShowNetlist( wxCommandEvent& event );
 
     bool canCloseWindow( wxCloseEvent& aEvent ) override;
@@ -331,6 +350,8 @@ private:
     wxToolBarToolBase* m_toolTune;
     wxToolBarToolBase* m_toolSettings;
 
+    wxMenuItem*        m_monteCarlo;
+
     SCH_EDIT_FRAME* m_schematicFrame;
     std::shared_ptr<NGSPICE_CIRCUIT_MODEL> m_circuitModel;
     std::shared_ptr<SPICE_SIMULATOR> m_simulator;
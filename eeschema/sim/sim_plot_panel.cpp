@@ -28,6 +28,7 @@
 #include "sim_plot_colors.h"
 #include "sim_plot_panel.h"
 #include "sim_plot_frame.h"
+#include "spice_simulator.h"
 
 #include <algorithm>
 #include <limits>
@@ -469,8 +470,9 @@ void SIM_PLOT_PANEL::UpdateTraceStyle( TRACE* trace )
 }
 
 
-bool SIM_PLOT_PANEL::addTrace( const wxString& aTitle, const wxString& aName, int aPoints,
-                               const double* aX, const double* aY, SIM_PLOT_TYPE aType )
+bool SIM_PLOT_PANEL::addTrace( const wxString& aTitle, const wxString& aName,
+                               const SPICE_VECTOR_VIEW& aX, const SPICE_VECTOR_VIEW& aY,
+                               SIM_PLOT_TYPE aType )
 {
     TRACE* trace = nullptr;
     wxString name = aTitle;
@@ -522,27 +524,40 @@ bool SIM_PLOT_PANEL::addTrace( const wxString& aTitle, const wxString& aName, in
         trace = prev->second;
     }
 
-    std::vector<double> tmp( aY, aY + aPoints );
+    // The trace data is read once from the simulator memory, and moved to the trace
+    size_t              points = std::min( aX.size(), aY.size() );
+    std::vector<double> xs( points );
+    std::vector<double> ys( points );
+
+    for( size_t i = 0; i < points; i++ )
+        xs[i] = aX.Mag( i );
 
     if( GetType() == ST_AC )
     {
         if( aType & SPT_AC_PHASE )
         {
-            for( int i = 0; i < aPoints; i++ )
-                tmp[i] = tmp[i] * 180.0 / M_PI;                 // convert to degrees
+            for( size_t i = 0; i < points; i++ )
+                ys[i] = aY.Phase( i ) * 180.0 / M_PI;            // convert to degrees
         }
         else
         {
-            for( int i = 0; i < aPoints; i++ )
+            for( size_t i = 0; i < points; i++ )
             {
+                ys[i] = aY.Mag( i );
+
                 // log( 0 ) is not valid.
-                if( tmp[i] != 0 )
-                    tmp[i] = 20 * log( tmp[i] ) / log( 10.0 );  // convert to dB
+                if( ys[i] != 0 )
+                    ys[i] = 20 * log( ys[i] ) / log( 10.0 );    // convert to dB
             }
         }
     }
+    else
+    {
+        for( size_t i = 0; i < points; i++ )
+            ys[i] = aY.Mag( i );
+    }
 
-    trace->SetData( std::vector<double>( aX, aX + aPoints ), tmp );
+    trace->SetData( std::move( xs ), std::move( ys ) );
 
     if( ( aType & SPT_AC_PHASE ) || ( aType & SPT_CURRENT ) )
         trace->SetScale( m_axis_x, m_axis_y2 );
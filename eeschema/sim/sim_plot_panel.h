@@ -38,6 +38,7 @@
 
 class SIM_PLOT_FRAME;
 class SIM_PLOT_PANEL;
+class SPICE_VECTOR_VIEW;
 class TRACE;
 
 ///< Cursor attached to a trace to follow its values:
@@ -95,7 +96,7 @@ class TRACE : public mpFXYVector
 {
 public:
     TRACE( const wxString& aName, SIM_PLOT_TYPE aType ) :
-            mpFXYVector( aName ), m_cursor( nullptr ), m_type( aType )
+            mpFXYVector( aName ), m_cursor( nullptr ), m_type( aType ), m_sweepRun( false )
     {
         SetContinuity( true );
         SetDrawOutsideMargins( false );
@@ -108,12 +109,12 @@ public:
      * @param aX are the X axis values.
      * @param aY are the Y axis values.
      */
-    void SetData( const std::vector<double>& aX, const std::vector<double>& aY ) override
+    void SetData( std::vector<double> aX, std::vector<double> aY ) override
     {
         if( m_cursor )
             m_cursor->Update();
 
-        mpFXYVector::SetData( aX, aY );
+        mpFXYVector::SetData( std::move( aX ), std::move( aY ) );
     }
 
     const std::vector<double>& GetDataX() const
@@ -161,11 +162,27 @@ public:
         return m_param;
     }
 
+    /**
+     * A trace of a run of a sweep is a copy of a trace of the plot, with the results of a
+     * variant of the circuit.  It is neither saved in the workbook nor updated by a new
+     * simulation.
+     */
+    void SetSweepRun( bool aSweepRun )
+    {
+        m_sweepRun = aSweepRun;
+    }
+
+    bool IsSweepRun() const
+    {
+        return m_sweepRun;
+    }
+
 
 protected:
     CURSOR* m_cursor;
     SIM_PLOT_TYPE m_type;
     wxColour m_traceColour;
+    bool m_sweepRun;
 
 private:
     ///< Name of the signal parameter
@@ -290,8 +307,8 @@ public:
     }
 
 protected:
-    bool addTrace( const wxString& aTitle, const wxString& aName, int aPoints, const double* aX,
-                   const double* aY, SIM_PLOT_TYPE aType );
+    bool addTrace( const wxString& aTitle, const wxString& aName, const SPICE_VECTOR_VIEW& aX,
+                   const SPICE_VECTOR_VIEW& aY, SIM_PLOT_TYPE aType );
 
     bool deleteTrace( const wxString& aName );
 
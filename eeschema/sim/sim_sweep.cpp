@@ -0,0 +1,708 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * https://www.gnu.org/licenses/gpl-3.0.html
+ * or you may search the http://www.gnu.org website for the version 3 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "sim_sweep.h"
+#include "spice_value.h"
+
+#include <ki_exception.h>
+#include <netlist_exporters/netlist_exporter_spice.h>
+#include <progress_reporter.h>
+#include <thread_pool.h>
+
+#include <wx/evtloop.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/intl.h>
+#include <wx/log.h>
+#include <wx/process.h>
+#include <wx/stdpaths.h>
+#include <wx/utils.h>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <locale>
+#include <memory>
+#include <random>
+#include <sstream>
+
+
+/**
+ * Flag to enable the debug output of the simulation sweeps.
+ *
+ * Use "KICAD_SIM_SWEEP" to enable.
+ *
+ * @ingroup trace_env_vars
+ */
+static const wxChar* const traceSimSweep = wxT( "KICAD_SIM_SWEEP" );
+
+
+/// An ngspice process running a variant
+class SIM_SWEEP_PROCESS : public wxProcess
+{
+public:
+    SIM_SWEEP_PROCESS( size_t aIdx ) :
+            m_Idx( aIdx ),
+            m_Pid( 0 ),
+            m_Status( 0 ),
+            m_Done( false ),
+            m_Abandoned( false )
+    {
+    }
+
+    void OnTerminate( int aPid, int aStatus ) override
+    {
+        // Nobody waits anymore for a process which could not be killed
+        if( m_Abandoned )
+        {
+            delete this;
+            return;
+        }
+
+        m_Status = aStatus;
+        m_Done = true;
+    }
+
+    size_t m_Idx;
+    long   m_Pid;
+    int    m_Status;
+    bool   m_Done;
+    bool   m_Abandoned;
+};
+
+
+static wxString variantFile( const wxString& aDir, size_t aIdx, const wxString& aExt )
+{
+    return wxFileName( aDir, wxString::Format( wxT( "variant_%lu" ), (unsigned long) aIdx ),
+                       aExt ).GetFullPath();
+}
+
+
+static bool readFile( const wxString& aPath, std::string& aContents )
+{
+    std::ifstream file( aPath.fn_str(), std::ios::binary );
+
+    if( !file )
+        return false;
+
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    aContents = contents.str();
+
+    return true;
+}
+
+
+SPICE_VECTOR_VIEW SIM_SWEEP::RESULT::GetVector( const std::string& aName ) const
+{
+    std::string name = NormalizeVectorName( aName );
+    auto        it = m_Vectors.find( name );
+
+    // The node voltages are named with or without v()
+    if( it == m_Vectors.end() )
+    {
+        if( name.size() > 3 && name.compare( 0, 2, "v(" ) == 0 && name.back() == ')' )
+            it = m_Vectors.find( name.substr( 2, name.size() - 3 ) );
+        else
+            it = m_Vectors.find( "v(" + name + ")" );
+    }
+
+    if( it == m_Vectors.end() )
+        return SPICE_VECTOR_VIEW();
+
+    return SPICE_VECTOR_VIEW( it->second.data(), it->second.size() / ( m_Complex ? 2 : 1 ),
+                              m_Complex );
+}
+
+
+SIM_SWEEP::SIM_SWEEP( const std::string& aNetlist ) :
+        m_netlist( aNetlist ),
+        m_simulatorCommand( wxT( "ngspice" ) ),
+        m_processCount( 0 )
+{
+}
+
+
+wxString SIM_SWEEP::FindSimulatorCommand()
+{
+    wxPathList paths;
+
+    paths.Add( wxFileName( wxStandardPaths::Get().GetExecutablePath() ).GetPath() );
+    paths.AddEnvList( wxT( "PATH" ) );
+
+#ifdef __WINDOWS__
+    // The console program writes its output, the other one opens a window
+    wxString command = paths.FindAbsoluteValidPath( wxT( "ngspice_con.exe" ) );
+
+    if( command.IsEmpty() )
+        command = paths.FindAbsoluteValidPath( wxT( "ngspice.exe" ) );
+
+    return command;
+#else
+    return paths.FindAbsoluteValidPath( wxT( "ngspice" ) );
+#endif
+}
+
+
+void SIM_SWEEP::AddStepVariants( const std::string& aDevice, double aStart, double aStop,
+                                 int aCount )
+{
+    for( int ii = 0; ii < aCount; ii++ )
+    {
+        double  value = aCount > 1 ? aStart + ( aStop - aStart ) * ii / ( aCount - 1 ) : aStart;
+        VARIANT variant;
+
+        variant.m_Title = wxString::Format( wxT( "%s = %s" ), aDevice,
+                                            SPICE_VALUE( value ).ToSpiceString() );
+        variant.m_Changes.push_back( { aDevice, value } );
+        m_variants.push_back( std::move( variant ) );
+    }
+}
+
+
+void SIM_SWEEP::AddMonteCarloVariants( const NETLIST_EXPORTER_SPICE& aCircuit, int aCount,
+                                       double aTolerance, unsigned aSeed )
+{
+    std::vector<CHANGE> nominals;
+
+    for( const NETLIST_EXPORTER_SPICE::ITEM& item : aCircuit.GetItems() )
+    {
+        SIM_MODEL::TYPE type = item.model->GetType();
+
+        if( type != SIM_MODEL::TYPE::R && type != SIM_MODEL::TYPE::C
+                && type != SIM_MODEL::TYPE::L )
+        {
+            continue;
+        }
+
+        if( item.model->GetParamCount() < 1 || !item.model->GetParam( 0 ).value->HasValue() )
+            continue;
+
+        try
+        {
+            SPICE_VALUE value( item.model->GetParam( 0 ).value->ToSpiceString() );
+            nominals.push_back( { aCircuit.GetItemName( item.refName ), value.ToDouble() } );
+        }
+        catch( const KI_PARAM_ERROR& )
+        {
+            // The value is an expression, which is left unchanged
+        }
+    }
+
+    std::mt19937                           rng( aSeed );
+    std::uniform_real_distribution<double> deviation( -aTolerance, aTolerance );
+
+    for( int ii = 0; ii < aCount; ii++ )
+    {
+        VARIANT variant;
+
+        variant.m_Title = wxString::Format( wxT( "#%d" ), ii + 1 );
+
+        for( const CHANGE& nominal : nominals )
+            variant.m_Changes.push_back( { nominal.m_Device,
+                                           nominal.m_Value * ( 1.0 + deviation( rng ) ) } );
+
+        m_variants.push_back( std::move( variant ) );
+    }
+}
+
+
+bool SIM_SWEEP::Run( PROGRESS_REPORTER* aProgressReporter )
+{
+    m_results.clear();
+    m_results.resize( m_variants.size() );
+
+    // Each run has its own directory, so that the ngspice processes left by a previous run
+    // cannot write over its files.  The unique name is reserved by a temporary file.
+    wxString tempName = wxFileName::CreateTempFileName( wxT( "kicad_sim_sweep_" ) );
+
+    if( tempName.IsEmpty() )
+    {
+        for( RESULT& result : m_results )
+            result.m_Error = _( "Cannot create the simulation directory." );
+
+        return true;
+    }
+
+    wxRemoveFile( tempName );
+
+    wxFileName workDir = wxFileName::DirName( tempName );
+    workDir.Mkdir( wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL );
+    m_workDir = workDir.GetPath();
+
+    // ngspice reads the init file of its working directory before the netlist
+    wxString      initFile = wxFileName( m_workDir, wxT( ".spiceinit" ) ).GetFullPath();
+    std::ofstream init( initFile.fn_str(), std::ios::binary );
+
+    for( const std::string& command : m_initCommands )
+        init << command << "\n";
+
+    init.close();
+
+    wxExecuteEnv env;
+    env.cwd = m_workDir;
+
+    if( aProgressReporter )
+        aProgressReporter->SetMaxProgress( m_variants.size() );
+
+    thread_pool& tp = GetKiCadThreadPool();
+    size_t       processCount = m_processCount > 0 ? m_processCount : tp.get_thread_count();
+    size_t       next = 0;
+    bool         cancelled = false;
+
+    std::vector<std::unique_ptr<SIM_SWEEP_PROCESS>> running;
+    std::vector<std::future<void>>                  returns;
+
+    processCount = std::max<size_t>( processCount, 1 );
+
+    while( ( !cancelled && next < m_variants.size() ) || !running.empty() )
+    {
+        while( !cancelled && next < m_variants.size() && running.size() < processCount )
+        {
+            size_t      idx = next++;
+            wxString    netlistFile = variantFile( m_workDir, idx, wxT( "cir" ) );
+            std::string netlist = BuildVariantNetlist( m_netlist, m_variants[idx], m_vectors,
+                    variantFile( m_workDir, idx, wxT( "raw" ) ).ToStdString() );
+
+            std::ofstream file( netlistFile.fn_str(), std::ios::binary );
+            file << netlist;
+            file.close();
+
+            if( !file )
+            {
+                m_results[idx].m_Error = wxString::Format( _( "Cannot write '%s'." ),
+                                                           netlistFile );
+                continue;
+            }
+
+            // The output of ngspice goes to a log file, a redirected output would have to be
+            // read while the process is running
+            wxString cmd = wxString::Format( wxT( "\"%s\" -b -o \"%s\" \"%s\"" ),
+                                             m_simulatorCommand,
+                                             variantFile( m_workDir, idx, wxT( "log" ) ),
+                                             netlistFile );
+
+            // The process leads its group, so it can be killed with its children
+            auto process = std::make_unique<SIM_SWEEP_PROCESS>( idx );
+            process->m_Pid = wxExecute( cmd, wxEXEC_ASYNC | wxEXEC_HIDE_CONSOLE
+                                                     | wxEXEC_MAKE_GROUP_LEADER,
+                                        process.get(), &env );
+
+            if( process->m_Pid <= 0 )
+            {
+                m_results[idx].m_Error = wxString::Format( _( "Cannot run '%s'." ),
+                                                           m_simulatorCommand );
+                wxRemoveFile( netlistFile );
+                continue;
+            }
+
+            running.push_back( std::move( process ) );
+        }
+
+        // The results of the finished processes are read on the thread pool
+        for( auto it = running.begin(); it != running.end(); )
+        {
+            SIM_SWEEP_PROCESS* process = it->get();
+
+            if( !process->m_Done )
+            {
+                ++it;
+                continue;
+            }
+
+            size_t idx = process->m_Idx;
+
+            if( process->m_Status != 0 && !cancelled )
+            {
+                m_results[idx].m_Error = wxString::Format( _( "ngspice exited with code %d." ),
+                                                           process->m_Status );
+            }
+
+            if( cancelled )
+            {
+                m_results[idx].m_Error = _( "Cancelled." );
+            }
+
+            returns.push_back( tp.submit(
+                    [this, idx, aProgressReporter]()
+                    {
+                        readResult( idx );
+
+                        if( aProgressReporter )
+                            aProgressReporter->AdvanceProgress();
+                    } ) );
+
+            it = running.erase( it );
+        }
+
+        if( !cancelled && aProgressReporter && !aProgressReporter->KeepRefreshing() )
+        {
+            cancelled = true;
+
+            for( auto it = running.begin(); it != running.end(); )
+            {
+                SIM_SWEEP_PROCESS* process = it->get();
+                wxKillError        err = wxProcess::Kill( process->m_Pid, wxSIGKILL,
+                                                          wxKILL_CHILDREN );
+
+                // A process which has already ended is reported terminated by the event loop
+                if( err == wxKILL_OK || err == wxKILL_NO_PROCESS )
+                {
+                    ++it;
+                    continue;
+                }
+
+                // The process is left running, and deletes itself when it ends.  Its files are
+                // left in use.
+                wxLogTrace( traceSimSweep, wxT( "Cannot kill ngspice process %ld (error %d)." ),
+                            process->m_Pid, (int) err );
+
+                m_results[process->m_Idx].m_Error = _( "Cancelled." );
+                process->m_Abandoned = true;
+                it->release();
+                it = running.erase( it );
+
+                if( aProgressReporter )
+                    aProgressReporter->AdvanceProgress();
+            }
+        }
+
+        // The processes are reported terminated by the event loop
+        if( !running.empty() )
+        {
+            if( wxEventLoopBase* loop = wxEventLoopBase::GetActive() )
+                loop->YieldFor( wxEVT_CATEGORY_UI );
+
+            wxMilliSleep( 10 );
+        }
+    }
+
+    for( const std::future<void>& ret : returns )
+    {
+        std::future_status status = ret.wait_for( std::chrono::milliseconds( 250 ) );
+
+        while( status != std::future_status::ready )
+        {
+            if( aProgressReporter )
+                aProgressReporter->KeepRefreshing();
+
+            status = ret.wait_for( std::chrono::milliseconds( 250 ) );
+        }
+    }
+
+    wxRemoveFile( initFile );
+    workDir.Rmdir();
+
+    return !cancelled;
+}
+
+
+void SIM_SWEEP::readResult( size_t aIdx )
+{
+    RESULT&     result = m_results[aIdx];
+    wxString    rawFile = variantFile( m_workDir, aIdx, wxT( "raw" ) );
+    wxString    logFile = variantFile( m_workDir, aIdx, wxT( "log" ) );
+    std::string contents;
+
+    if( result.m_Error.IsEmpty() )
+    {
+        if( !readFile( rawFile, contents ) )
+            result.m_Error = _( "ngspice did not write the results." );
+        else if( !ParseRawFile( contents, result ) )
+            result.m_Error = _( "Cannot read the results written by ngspice." );
+        else
+            result.m_Ok = true;
+    }
+
+    // Keep the end of the log, which tells why the simulation failed
+    if( !result.m_Ok && readFile( logFile, contents ) && !contents.empty() )
+    {
+        const size_t maxLog = 1000;
+
+        if( contents.size() > maxLog )
+            contents = contents.substr( contents.size() - maxLog );
+
+        result.m_Error += wxT( "\n" ) + wxString::FromUTF8( contents.c_str() );
+    }
+
+    wxRemoveFile( variantFile( m_workDir, aIdx, wxT( "cir" ) ) );
+    wxRemoveFile( rawFile );
+    wxRemoveFile( logFile );
+}
+
+
+SIM_SWEEP::STATISTICS SIM_SWEEP::GetStatistics( const std::string& aVector ) const
+{
+    STATISTICS          stats;
+    std::vector<double> values;
+
+    for( const RESULT& result : m_results )
+    {
+        if( !result.m_Ok )
+            continue;
+
+        SPICE_VECTOR_VIEW view = result.GetVector( aVector );
+
+        if( !view.empty() )
+            values.push_back( view.Mag( view.size() - 1 ) );
+    }
+
+    if( values.empty() )
+        return stats;
+
+    stats.m_Count = (int) values.size();
+    stats.m_Min = *std::min_element( values.begin(), values.end() );
+    stats.m_Max = *std::max_element( values.begin(), values.end() );
+
+    for( double value : values )
+        stats.m_Mean += value;
+
+    stats.m_Mean /= values.size();
+
+    // Standard deviation of the sample
+    if( values.size() > 1 )
+    {
+        double sum = 0.0;
+
+        for( double value : values )
+            sum += ( value - stats.m_Mean ) * ( value - stats.m_Mean );
+
+        stats.m_StdDev = std::sqrt( sum / ( values.size() - 1 ) );
+    }
+
+    return stats;
+}
+
+
+std::string SIM_SWEEP::BuildVariantNetlist( const std::string& aNetlist,
+                                            const VARIANT& aVariant,
+                                            const std::vector<std::string>& aVectors,
+                                            const std::string& aRawFile )
+{
+    std::string control = ".control\n";
+
+    for( const CHANGE& change : aVariant.m_Changes )
+        control += fmt::format( "alter {} = {:.12g}\n", change.m_Device, change.m_Value );
+
+    control += "run\n";
+    control += fmt::format( "write \"{}\"", aRawFile );
+
+    for( const std::string& vector : aVectors )
+        control += " " + vector;
+
+    control += "\n.endc\n";
+
+    // The control section is inserted before the .end line closing the netlist
+    size_t lineEnd = aNetlist.size();
+
+    while( lineEnd > 0 )
+    {
+        size_t lineStart = aNetlist.rfind( '\n', lineEnd - 1 );
+        lineStart = ( lineStart == std::string::npos ) ? 0 : lineStart + 1;
+
+        std::string line = aNetlist.substr( lineStart, lineEnd - lineStart );
+        line.erase( line.find_last_not_of( " \t\r\n" ) + 1 );
+        std::transform( line.begin(), line.end(), line.begin(), ::tolower );
+
+        if( line == ".end" )
+            return aNetlist.substr( 0, lineStart ) + control + aNetlist.substr( lineStart );
+
+        if( lineStart == 0 )
+            break;
+
+        lineEnd = lineStart - 1;
+    }
+
+    return aNetlist + ( aNetlist.empty() || aNetlist.back() == '\n' ? "" : "\n" ) + control
+           + ".end\n";
+}
+
+
+bool SIM_SWEEP::ParseRawFile( const std::string& aContents, RESULT& aResult )
+{
+    size_t                   pos = 0;
+    int                      varCount = -1;
+    int                      pointCount = -1;
+    bool                     binary = false;
+    bool                     values = false;
+    std::vector<std::string> names;
+    std::string              line;
+
+    auto nextLine =
+            [&]() -> bool
+            {
+                if( pos >= aContents.size() )
+                    return false;
+
+                size_t eol = aContents.find( '\n', pos );
+
+                if( eol == std::string::npos )
+                    eol = aContents.size();
+
+                line = aContents.substr( pos, eol - pos );
+
+                if( !line.empty() && line.back() == '\r' )
+                    line.pop_back();
+
+                pos = eol + 1;
+                return true;
+            };
+
+    auto startsWith =
+            [&]( const char* aPrefix ) -> bool
+            {
+                return line.compare( 0, strlen( aPrefix ), aPrefix ) == 0;
+            };
+
+    while( !binary && !values && nextLine() )
+    {
+        if( startsWith( "Flags:" ) )
+        {
+            aResult.m_Complex = line.find( "complex" ) != std::string::npos;
+        }
+        else if( startsWith( "No. Variables:" ) )
+        {
+            varCount = atoi( line.c_str() + strlen( "No. Variables:" ) );
+        }
+        else if( startsWith( "No. Points:" ) )
+        {
+            pointCount = atoi( line.c_str() + strlen( "No. Points:" ) );
+        }
+        else if( startsWith( "Variables:" ) )
+        {
+            for( int ii = 0; ii < varCount && nextLine(); ii++ )
+            {
+                std::istringstream fields( line );
+                std::string        idx, name;
+
+                fields >> idx >> name;
+                names.push_back( NormalizeVectorName( name ) );
+            }
+        }
+        else if( startsWith( "Binary:" ) )
+        {
+            binary = true;
+        }
+        else if( startsWith( "Values:" ) )
+        {
+            values = true;
+        }
+    }
+
+    if( ( !binary && !values ) || varCount <= 0 || pointCount < 0
+            || names.size() != (size_t) varCount )
+    {
+        return false;
+    }
+
+    const size_t valueSize = aResult.m_Complex ? 2 : 1;
+    std::vector<std::vector<double>> data( varCount );
+
+    for( std::vector<double>& vector : data )
+        vector.reserve( pointCount * valueSize );
+
+    if( binary )
+    {
+        size_t count = (size_t) pointCount * varCount * valueSize;
+
+        // The header may end the file without an end of line, which leaves pos past the end
+        if( pos > aContents.size() || aContents.size() - pos < count * sizeof( double ) )
+            return false;
+
+        const char* ptr = aContents.data() + pos;
+
+        for( int point = 0; point < pointCount; point++ )
+        {
+            for( int var = 0; var < varCount; var++ )
+            {
+                for( size_t ii = 0; ii < valueSize; ii++ )
+                {
+                    double value;
+                    memcpy( &value, ptr, sizeof( double ) );
+                    data[var].push_back( value );
+                    ptr += sizeof( double );
+                }
+            }
+        }
+    }
+    else
+    {
+        // The values are written with the C locale
+        std::istringstream stream( aContents.substr( std::min( pos, aContents.size() ) ) );
+        stream.imbue( std::locale::classic() );
+
+        for( int point = 0; point < pointCount; point++ )
+        {
+            int idx;
+            stream >> idx;
+
+            for( int var = 0; var < varCount; var++ )
+            {
+                double real = 0.0;
+                double imag = 0.0;
+                char   separator = 0;
+
+                stream >> real;
+
+                if( aResult.m_Complex )
+                    stream >> separator >> imag;
+
+                if( !stream || ( aResult.m_Complex && separator != ',' ) )
+                    return false;
+
+                data[var].push_back( real );
+
+                if( aResult.m_Complex )
+                    data[var].push_back( imag );
+            }
+        }
+    }
+
+    for( int var = 0; var < varCount; var++ )
+        aResult.m_Vectors[names[var]] = std::move( data[var] );
+
+    return true;
+}
+
+
+std::string SIM_SWEEP::NormalizeVectorName( const std::string& aName )
+{
+    std::string name = aName;
+    std::transform( name.begin(), name.end(), name.begin(), ::tolower );
+
+    const std::string branch = "#branch";
+
+    if( name.size() > branch.size()
+            && name.compare( name.size() - branch.size(), branch.size(), branch ) == 0 )
+    {
+        name = "i(" + name.substr( 0, name.size() - branch.size() ) + ")";
+    }
+
+    return name;
+}
@@ -0,0 +1,206 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * https://www.gnu.org/licenses/gpl-3.0.html
+ * or you may search the http://www.gnu.org website for the version 3 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef SIM_SWEEP_H
+#define SIM_SWEEP_H
+
+#include "spice_simulator.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <wx/string.h>
+
+class NETLIST_EXPORTER_SPICE;
+class PROGRESS_REPORTER;
+
+
+/**
+ * Run variants of a circuit, and collect their results.
+ *
+ * The shared ngspice library used by the simulator frame is not reentrant, so the variants are
+ * run concurrently by a pool of ngspice processes in batch mode.  Each variant is the netlist of
+ * the circuit, with a control section changing the values of some devices with the ngspice
+ * "alter" command before running the simulation.
+ */
+class SIM_SWEEP
+{
+public:
+    struct CHANGE
+    {
+        std::string m_Device;       ///< Spice device name, e.g. R1
+        double      m_Value;
+    };
+
+    struct VARIANT
+    {
+        wxString            m_Title;
+        std::vector<CHANGE> m_Changes;
+    };
+
+    struct RESULT
+    {
+        bool     m_Ok = false;
+        wxString m_Error;
+        bool     m_Complex = false;
+
+        ///< The values of the vectors, laid out as in the ngspice memory, by lower case name
+        std::map<std::string, std::vector<double>> m_Vectors;
+
+        /**
+         * @return a view on a vector of the result, empty if there is no such vector.
+         */
+        SPICE_VECTOR_VIEW GetVector( const std::string& aName ) const;
+    };
+
+    struct STATISTICS
+    {
+        int    m_Count = 0;
+        double m_Min = 0.0;
+        double m_Max = 0.0;
+        double m_Mean = 0.0;
+        double m_StdDev = 0.0;
+    };
+
+    /**
+     * @param aNetlist is the netlist of the circuit, including the simulation command.
+     */
+    SIM_SWEEP( const std::string& aNetlist );
+
+    /**
+     * Set the vectors to save from each run.  The scale vector is always saved.
+     */
+    void SetVectors( const std::vector<std::string>& aVectors ) { m_vectors = aVectors; }
+
+    /**
+     * Set the command starting the ngspice program, "ngspice" by default.
+     */
+    void SetSimulatorCommand( const wxString& aCommand ) { m_simulatorCommand = aCommand; }
+
+    /**
+     * Search the ngspice program next to the KiCad programs, then in the PATH.
+     *
+     * @return the path of the program, or an empty string if it was not found.
+     */
+    static wxString FindSimulatorCommand();
+
+    /**
+     * Set the commands run by each ngspice process before reading the netlist, to load the
+     * code models and apply the simulator settings as the simulator frame does.
+     *
+     * @see SPICE_SIMULATOR::GetProcessInitCommands()
+     */
+    void SetInitCommands( const std::vector<std::string>& aCommands )
+    {
+        m_initCommands = aCommands;
+    }
+
+    /**
+     * Set the count of ngspice processes running at the same time.  0 to use one process per
+     * thread of the thread pool.
+     */
+    void SetProcessCount( int aCount ) { m_processCount = aCount; }
+
+    void AddVariant( const VARIANT& aVariant ) { m_variants.push_back( aVariant ); }
+
+    /**
+     * Add variants changing the value of a device in \a aCount linear steps.
+     */
+    void AddStepVariants( const std::string& aDevice, double aStart, double aStop, int aCount );
+
+    /**
+     * Add variants where the value of each resistor, capacitor and inductor of the circuit is
+     * taken at random in its tolerance, with a uniform distribution.
+     *
+     * @param aCircuit is the exporter which has read the schematic of the circuit.
+     * @param aCount is the count of variants to add.
+     * @param aTolerance is the relative tolerance of the values, e.g. 0.05 for 5%.
+     * @param aSeed is the seed of the random values, to repeat the same variants.
+     */
+    void AddMonteCarloVariants( const NETLIST_EXPORTER_SPICE& aCircuit, int aCount,
+                                double aTolerance, unsigned aSeed = 0 );
+
+    const std::vector<VARIANT>& GetVariants() const { return m_variants; }
+
+    /**
+     * Run all the variants.  The end of the ngspice processes is reported by the event loop, so
+     * this must be called from the GUI thread.
+     *
+     * @param aProgressReporter is an optional progress reporter, which can cancel the runs.
+     * @return false if the runs were cancelled.
+     */
+    bool Run( PROGRESS_REPORTER* aProgressReporter = nullptr );
+
+    /**
+     * @return the results of the last runs, in the order of the variants.
+     */
+    const std::vector<RESULT>& GetResults() const { return m_results; }
+
+    /**
+     * @return the statistics of the last values of a vector (the magnitude of complex values)
+     *         over the successful runs.
+     */
+    STATISTICS GetStatistics( const std::string& aVector ) const;
+
+    /**
+     * Build the netlist of a variant.
+     *
+     * @param aNetlist is the netlist of the circuit.
+     * @param aVariant is the variant to build.
+     * @param aVectors are the vectors to save.  All the vectors are saved if empty.
+     * @param aRawFile is the raw file to save the vectors to.
+     */
+    static std::string BuildVariantNetlist( const std::string& aNetlist, const VARIANT& aVariant,
+                                            const std::vector<std::string>& aVectors,
+                                            const std::string& aRawFile );
+
+    /**
+     * Read the first plot of an ngspice raw file, in ASCII or binary format.
+     *
+     * @return false if the file could not be parsed, \a aResult is then incomplete.
+     */
+    static bool ParseRawFile( const std::string& aContents, RESULT& aResult );
+
+    /**
+     * @return the name of a vector as found in the results, e.g. v(out) for out, and i(v1) for
+     *         v1#branch.
+     */
+    static std::string NormalizeVectorName( const std::string& aName );
+
+private:
+    /// Read the raw file of a variant, then remove the files of the variant.
+    void readResult( size_t aIdx );
+
+    std::string              m_netlist;
+    std::vector<std::string> m_vectors;
+    std::vector<std::string> m_initCommands;
+    wxString                 m_simulatorCommand;
+    int                      m_processCount;
+    wxString                 m_workDir;        ///< Directory of the netlist and raw files
+
+    std::vector<VARIANT>     m_variants;
+    std::vector<RESULT>      m_results;
+};
+
+#endif // SIM_SWEEP_H
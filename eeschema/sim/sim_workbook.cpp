@@ -71,10 +71,10 @@ bool SIM_WORKBOOK::DeletePage( size_t page )
 
 
 bool SIM_WORKBOOK::AddTrace( SIM_PLOT_PANEL* aPlotPanel, const wxString& aTitle,
-                             const wxString& aName, int aPoints, const double* aX, const double* aY,
-                             SIM_PLOT_TYPE aType )
+                             const wxString& aName, const SPICE_VECTOR_VIEW& aX,
+                             const SPICE_VECTOR_VIEW& aY, SIM_PLOT_TYPE aType )
 {
-    bool res = aPlotPanel->addTrace( aTitle, aName, aPoints, aX, aY, aType );
+    bool res = aPlotPanel->addTrace( aTitle, aName, aX, aY, aType );
     setModified( res );
     return res;
 }
@@ -31,6 +31,8 @@
 #include "spice_settings.h"
 #include "simulator.h"
 
+#include <algorithm>
+#include <cmath>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -44,6 +46,69 @@ class SPICE_REPORTER;
 typedef std::complex<double> COMPLEX;
 
 
+/**
+ * A view on a vector of simulation results, in the memory of the simulator.
+ *
+ * The values are not copied, so the view is valid only until the simulator runs again or is
+ * cleaned.  A real vector is seen as a complex vector having a null imaginary part.
+ */
+class SPICE_VECTOR_VIEW
+{
+public:
+    SPICE_VECTOR_VIEW() :
+        m_data( nullptr ),
+        m_size( 0 ),
+        m_complex( false )
+    {}
+
+    /**
+     * @param aData is the first value, or the real part of the first value for a complex vector.
+     * @param aSize is the count of values.
+     * @param aComplex is true if each value is stored as its real part then its imaginary part.
+     */
+    SPICE_VECTOR_VIEW( const double* aData, size_t aSize, bool aComplex ) :
+        m_data( aData ),
+        m_size( aData ? aSize : 0 ),
+        m_complex( aComplex )
+    {}
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    bool IsComplex() const { return m_complex; }
+
+    double Real( size_t aIdx ) const { return m_complex ? m_data[2 * aIdx] : m_data[aIdx]; }
+    double Imag( size_t aIdx ) const { return m_complex ? m_data[2 * aIdx + 1] : 0.0; }
+
+    /// The magnitude of a complex value, or the value itself (with its sign) for a real vector.
+    double Mag( size_t aIdx ) const
+    {
+        return m_complex ? std::hypot( m_data[2 * aIdx], m_data[2 * aIdx + 1] ) : m_data[aIdx];
+    }
+
+    double Phase( size_t aIdx ) const
+    {
+        return m_complex ? std::atan2( m_data[2 * aIdx + 1], m_data[2 * aIdx] ) : 0.0;
+    }
+
+    /**
+     * @return a view on \a aCount values starting at \a aOffset, clamped to this view.
+     */
+    SPICE_VECTOR_VIEW Slice( size_t aOffset, size_t aCount ) const
+    {
+        if( aOffset >= m_size )
+            return SPICE_VECTOR_VIEW();
+
+        return SPICE_VECTOR_VIEW( m_data + ( m_complex ? 2 * aOffset : aOffset ),
+                                  std::min( aCount, m_size - aOffset ), m_complex );
+    }
+
+private:
+    const double* m_data;
+    size_t        m_size;
+    bool          m_complex;
+};
+
+
 class SPICE_SIMULATOR : public SIMULATOR
 {
 public:
@@ -146,6 +211,17 @@ public:
      */
     virtual std::vector<double> GetPhasePlot( const std::string& aName, int aMaxLen = -1 ) = 0;
 
+    /**
+     * Return a view on a requested vector, without copying its values.
+     *
+     * @param aName is the vector named in Spice convention (e.g. V(3), I(R1)).
+     * @param aMaxLen is max count of viewed values.
+     * if -1 (default) all available values are viewed.
+     * @return Requested view. It is empty if there is no vector with requested name.  It is
+     *         valid until the simulator runs again or is cleaned.
+     */
+    virtual SPICE_VECTOR_VIEW GetPlotView( const std::string& aName, int aMaxLen = -1 ) = 0;
+
     /**
      * Return current SPICE netlist used by the simulator.
      *
@@ -158,6 +234,12 @@ public:
      */
     virtual std::vector<std::string> GetSettingCommands() const = 0;
 
+    /**
+     * @return the commands initializing a separate simulator process as this simulator is
+     *         initialized, including the setting commands.
+     */
+    virtual std::vector<std::string> GetProcessInitCommands() const = 0;
+
     /**
      * Return the simulator configuration settings.
      *
@@ -409,6 +409,24 @@ LIB_SYMBOL* SYMBOL_LIB_TABLE::LoadSymbol( const wxString& aNickname, const wxStr
 }
 
 
+void SYMBOL_LIB_TABLE::PrefetchSymbols( const wxString& aNickname,
+                                        const std::vector<wxString>& aNames )
+{
+    SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname, true );
+
+    if( !row || !row->plugin )
+        return;
+
+    // If another thread is loading this library at the moment, it's too late to prefetch
+    std::unique_lock<std::mutex> lock( row->GetMutex(), std::try_to_lock );
+
+    if( !lock.owns_lock() )
+        return;
+
+    row->plugin->PrefetchSymbols( row->GetFullURI( true ), aNames, row->GetProperties() );
+}
+
+
 SYMBOL_LIB_TABLE::SAVE_T SYMBOL_LIB_TABLE::SaveSymbol( const wxString& aNickname,
                                                        const LIB_SYMBOL* aSymbol, bool aOverwrite )
 {
@@ -198,6 +198,15 @@ public:
         return LoadSymbol( aLibId.GetLibNickname(), aLibId.GetLibItemName() );
     }
 
+    /**
+     * Let the library given by @a aNickname know that the symbols @a aNames are about to be
+     * loaded, so that it can fetch them in bulk if that is faster.
+     *
+     * @see SCH_PLUGIN::PrefetchSymbols
+     * @throw IO_ERROR if the library cannot be read.
+     */
+    void PrefetchSymbols( const wxString& aNickname, const std::vector<wxString>& aNames );
+
     /**
      * The set of return values from SaveSymbol() below.
      */
@@ -111,7 +111,8 @@ void AM_PRIMITIVE::DrawBasicShape( const GERBER_DRAW_ITEM* aParent, SHAPE_POLY_S
 
     // Draw the primitive shape for flashed items.
     // Create a static buffer to avoid a lot of memory reallocation.
-    static std::vector<VECTOR2I> polybuffer;
+    // It is per thread, because several files can be read at the same time.
+    thread_local std::vector<VECTOR2I> polybuffer;
     polybuffer.clear();
 
     VECTOR2I curPos = aShapePos;
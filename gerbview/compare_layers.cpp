@@ -0,0 +1,117 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file compare_layers.cpp
+ * @brief load the geometric differences of two layers in a new layer
+ */
+
+#include <gerbview_frame.h>
+#include <gerber_compare.h>
+#include <gerber_file_image.h>
+#include <gerber_file_image_list.h>
+#include <widgets/gerbview_layer_widget.h>
+#include <widgets/wx_progress_reporters.h>
+
+#include <wx/filename.h>
+
+#include <memory>
+
+
+bool GERBVIEW_FRAME::CompareLayers( int aReferenceLayer, int aComparedLayer )
+{
+    GERBER_FILE_IMAGE* reference = GetGbrImage( aReferenceLayer );
+    GERBER_FILE_IMAGE* compared = GetGbrImage( aComparedLayer );
+
+    if( !reference || !compared )
+        return false;
+
+    int layer = getNextAvailableLayer();
+
+    if( layer == NO_AVAILABLE_LAYERS )
+    {
+        ShowInfoBarError( _( "No more available layers in GerbView to load the differences." ) );
+        return false;
+    }
+
+    GERBER_COMPARE compare( reference, compared );
+
+    {
+        WX_PROGRESS_REPORTER progress( this, _( "Comparing Layers" ), 1, true );
+
+        if( !compare.Compare( &progress ) )
+            return false;
+    }
+
+    // The regions are drawn from a single outline, so the holes are bridged to the outlines
+    SHAPE_POLY_SET differences = compare.GetDifferences();
+    differences.Fracture( SHAPE_POLY_SET::PM_FAST );
+
+    if( differences.OutlineCount() == 0 )
+    {
+        ShowInfoBarMsg( _( "No differences found." ) );
+        return true;
+    }
+
+    auto image = std::make_unique<GERBER_FILE_IMAGE>( layer );
+
+    image->m_FileName = wxString::Format( _( "Differences %s / %s" ),
+                                          wxFileName( reference->m_FileName ).GetFullName(),
+                                          wxFileName( compared->m_FileName ).GetFullName() );
+    image->m_InUse = true;
+
+    // Each difference is a region, its holes included in its outline by the fracture
+    for( int ii = 0; ii < differences.OutlineCount(); ii++ )
+    {
+        GERBER_DRAW_ITEM* item = image->NewItem();
+
+        item->m_Shape = GBR_POLYGON;
+        item->m_Flashed = false;
+        item->m_DCode = 0;
+        item->m_Polygon.NewOutline();
+
+        for( const VECTOR2I& pt : differences.COutline( ii ).CPoints() )
+            item->m_Polygon.Append( item->GetXYPosition( pt ) );
+
+        item->m_Start = item->m_Polygon.CVertex( 0 );
+        item->m_End = item->m_Start;
+    }
+
+    SetActiveLayer( layer, false );
+    addGerberImage( std::move( image ) );
+
+    LSET visibility = GetVisibleLayers();
+    visibility[ layer ] = true;
+    SetVisibleLayers( visibility );
+
+    SetActiveLayer( layer, true );
+    ReFillLayerWidget();
+    m_LayersManager->UpdateLayerIcons();
+    syncLayerBox( true );
+    GetCanvas()->Refresh();
+
+    ShowInfoBarMsg( wxString::Format( _( "%d difference(s) found." ),
+                                      differences.OutlineCount() ) );
+
+    return true;
+}
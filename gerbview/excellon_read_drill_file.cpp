@@ -272,8 +272,22 @@ bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName )
         return false;
     }
 
-    EXCELLON_IMAGE* drill_layer = drill_layer_uptr.release();
+    return addExcellonImage( std::move( drill_layer_uptr ) );
+}
+
+
+bool GERBVIEW_FRAME::addExcellonImage( std::unique_ptr<EXCELLON_IMAGE> aDrill )
+{
+    int                     layerId = GetActiveLayer();
+    GERBER_FILE_IMAGE_LIST* images = GetGerberLayout()->GetImagesList();
+
+    // If the active layer contains old gerber or nc drill data, remove it
+    if( images->GetGbrImage( layerId ) )
+        Erase_Current_DrawLayer( false );
+
+    EXCELLON_IMAGE* drill_layer = aDrill.release();
 
+    drill_layer->m_GraphicLayer = layerId;
     layerId = images->AddGbrImage( drill_layer, layerId );
 
     if( layerId < 0 )
@@ -297,7 +311,7 @@ bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName )
             GetCanvas()->GetView()->Add( (KIGFX::VIEW_ITEM*) item );
     }
 
-    return success;
+    return true;
 }
 
 
@@ -863,8 +877,7 @@ bool EXCELLON_IMAGE::Execute_Drill_Command( char*& text )
                     return false;
                 }
 
-                gbritem = new GERBER_DRAW_ITEM( this );
-                AddItemToList( gbritem );
+                gbritem = NewItem();
 
                 if( m_SlotOn )  // Oblong hole
                 {
@@ -1130,7 +1143,7 @@ void EXCELLON_IMAGE::FinishRouteCommand()
 
     for( size_t ii = 1; ii < m_RoutePositions.size(); ii++ )
     {
-        GERBER_DRAW_ITEM* gbritem = new GERBER_DRAW_ITEM( this );
+        GERBER_DRAW_ITEM* gbritem = NewItem();
 
         if( m_RoutePositions[ii].m_rmode == 0 )     // linear routing
         {
@@ -1157,8 +1170,6 @@ void EXCELLON_IMAGE::FinishRouteCommand()
                          false );
         }
 
-        AddItemToList( gbritem );
-
         StepAndRepeatItem( *gbritem );
     }
 
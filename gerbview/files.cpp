@@ -32,13 +32,22 @@
 #include <gerbview_id.h>
 #include <gerber_file_image.h>
 #include <gerber_file_image_list.h>
+#include <gerbview_settings.h>
+#include <excellon_defaults.h>
 #include <excellon_image.h>
+#include <locale_io.h>
+#include <thread_pool.h>
 #include <wildcards_and_files_ext.h>
 #include <view/view.h>
 #include <widgets/wx_progress_reporters.h>
 #include "widgets/gerbview_layer_widget.h"
 #include <tool/tool_manager.h>
 
+#include <chrono>
+#include <future>
+#include <memory>
+#include <vector>
+
 // HTML Messages used more than one time:
 #define MSG_NO_MORE_LAYER _( "<b>No more available layers</b> in GerbView to load files" )
 #define MSG_NOT_LOADED _( "<b>Not loaded:</b> <i>%s</i>" )
@@ -240,6 +249,96 @@ bool GERBVIEW_FRAME::LoadExcellonFiles( const wxString& aFileName )
 }
 
 
+/**
+ * A Gerber or drill file to read, and the image read from it.
+ */
+struct IMAGE_FILE
+{
+    wxString                           m_FullFileName;
+    int                                m_FileType;      ///< 0 = Gerber, 1 = NC drill,
+                                                        ///< 2 = autodetect
+    std::unique_ptr<GERBER_FILE_IMAGE> m_Gerber;        ///< The Gerber image read, if any
+    std::unique_ptr<EXCELLON_IMAGE>    m_Drill;         ///< The drill image read, if any
+    bool                               m_OutOfMemory;
+};
+
+
+/**
+ * Read a list of Gerber and drill files concurrently on the thread pool.
+ *
+ * Each file is read into its own image, which is not put in a GerbView layer: this is done
+ * afterwards, in the order of the list.  The files to autodetect have their type changed
+ * when it is recognized.
+ */
+static void readImageFiles( std::vector<IMAGE_FILE>& aFiles, const EXCELLON_DEFAULTS& aDefaults,
+                            PROGRESS_REPORTER* aProgress )
+{
+    // The locale is GLOBAL: it is only thread safe to switch it before the threads start and
+    // to restore it after they finish, while the GUI thread waits for them.
+    LOCALE_IO toggle_locale;
+
+    thread_pool&                   tp = GetKiCadThreadPool();
+    std::vector<std::future<void>> returns;
+
+    for( IMAGE_FILE& file : aFiles )
+    {
+        returns.push_back( tp.submit(
+                [&file, &aDefaults, aProgress]()
+                {
+                    // 2 = Autodetect
+                    if( file.m_FileType == 2 )
+                    {
+                        if( EXCELLON_IMAGE::TestFileIsExcellon( file.m_FullFileName ) )
+                            file.m_FileType = 1;
+                        else if( GERBER_FILE_IMAGE::TestFileIsRS274( file.m_FullFileName ) )
+                            file.m_FileType = 0;
+                    }
+
+                    try
+                    {
+                        if( file.m_FileType == 0 )
+                        {
+                            auto gerber = std::make_unique<GERBER_FILE_IMAGE>( 0 );
+
+                            if( gerber->LoadGerberFile( file.m_FullFileName ) )
+                                file.m_Gerber = std::move( gerber );
+                        }
+                        else if( file.m_FileType == 1 )
+                        {
+                            auto              drill = std::make_unique<EXCELLON_IMAGE>( 0 );
+                            EXCELLON_DEFAULTS defaults = aDefaults;
+
+                            if( drill->LoadFile( file.m_FullFileName, &defaults ) )
+                                file.m_Drill = std::move( drill );
+                        }
+                    }
+                    catch( const std::bad_alloc& )
+                    {
+                        file.m_Gerber.reset();
+                        file.m_Drill.reset();
+                        file.m_OutOfMemory = true;
+                    }
+
+                    if( aProgress )
+                        aProgress->AdvanceProgress();
+                } ) );
+    }
+
+    for( const std::future<void>& ret : returns )
+    {
+        std::future_status status = ret.wait_for( std::chrono::milliseconds( 250 ) );
+
+        while( status != std::future_status::ready )
+        {
+            if( aProgress )
+                aProgress->KeepRefreshing();
+
+            status = ret.wait_for( std::chrono::milliseconds( 250 ) );
+        }
+    }
+}
+
+
 bool GERBVIEW_FRAME::LoadListOfGerberAndDrillFiles( const wxString&      aPath,
                                                     const wxArrayString& aFilenameList,
                                                     std::vector<int>*    aFileType )
@@ -259,8 +358,9 @@ bool GERBVIEW_FRAME::LoadListOfGerberAndDrillFiles( const wxString&      aPath,
     wxString msg;
     WX_STRING_REPORTER reporter( &msg );
 
-    // Create progress dialog (only used if more than 1 file to load
-    std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
+    // The files are read concurrently, then put in the layers in the order of the list
+    std::vector<IMAGE_FILE> files;
+    std::vector<unsigned>   fileIndices;
 
     for( unsigned ii = 0; ii < aFilenameList.GetCount(); ii++ )
     {
@@ -293,28 +393,59 @@ bool GERBVIEW_FRAME::LoadListOfGerberAndDrillFiles( const wxString&      aPath,
             continue;
         }
 
-
         m_lastFileName = filename.GetFullPath();
 
-        if( !progress && ( aFilenameList.GetCount() > 1 ) )
+        files.push_back( { filename.GetFullPath(), ( *aFileType )[ii], nullptr, nullptr, false } );
+        fileIndices.push_back( ii );
+    }
+
+    // Create progress dialog (only used if more than 1 file to load
+    std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
+
+    if( files.size() > 1 )
+    {
+        progress = std::make_unique<WX_PROGRESS_REPORTER>( this, _( "Loading files..." ), 1,
+                                                           false );
+        progress->SetMaxProgress( files.size() );
+        progress->Report( wxString::Format( _( "Loading %zu files..." ), files.size() ) );
+    }
+
+    EXCELLON_DEFAULTS nc_defaults;
+    GERBVIEW_SETTINGS* cfg = static_cast<GERBVIEW_SETTINGS*>( config() );
+    cfg->GetExcellonDefaults( nc_defaults );
+
+    readImageFiles( files, nc_defaults, progress.get() );
+
+    for( size_t jj = 0; jj < files.size(); jj++ )
+    {
+        IMAGE_FILE& file = files[jj];
+
+        filename = file.m_FullFileName;
+        ( *aFileType )[ fileIndices[jj] ] = file.m_FileType;
+
+        if( file.m_OutOfMemory )
         {
-            progress = std::make_unique<WX_PROGRESS_REPORTER>( this, _( "Loading files..." ), 1,
-                                                               false );
-            progress->SetMaxProgress( aFilenameList.GetCount() - 1 );
-            progress->Report( wxString::Format( _("Loading %u/%zu %s..." ),
-                                                ii+1,
-                                                aFilenameList.GetCount(),
-                                                m_lastFileName ) );
+            wxString txt = wxString::Format( MSG_OOM, filename.GetFullName() );
+            reporter.Report( txt, RPT_SEVERITY_ERROR );
+            success = false;
+            continue;
         }
-        else if( progress )
+
+        if( !file.m_Gerber && !file.m_Drill )
         {
-            progress->Report( wxString::Format( _("Loading %u/%zu %s..." ),
-                                                ii+1,
-                                                aFilenameList.GetCount(),
-                                                m_lastFileName ) );
-            progress->KeepRefreshing();
-        }
+            if( file.m_FileType == 0 || file.m_FileType == 1 )
+            {
+                ShowInfoBarError( wxString::Format( _( "File '%s' not found" ),
+                                                    filename.GetFullPath() ) );
+            }
+            else
+            {
+                wxString txt = wxString::Format( MSG_NOT_LOADED, filename.GetFullName() );
+                reporter.Report( txt, RPT_SEVERITY_ERROR );
+            }
 
+            continue;
+        }
 
         // Make sure we have a layer available to load into
         layer = getNextAvailableLayer();
@@ -325,9 +456,9 @@ bool GERBVIEW_FRAME::LoadListOfGerberAndDrillFiles( const wxString&      aPath,
             reporter.Report( MSG_NO_MORE_LAYER, RPT_SEVERITY_ERROR );
 
             // Report the name of not loaded files:
-            while( ii < aFilenameList.GetCount() )
+            while( jj < files.size() )
             {
-                filename = aFilenameList[ii++];
+                filename = files[jj++].m_FullFileName;
                 wxString txt = wxString::Format( MSG_NOT_LOADED, filename.GetFullName() );
                 reporter.Report( txt, RPT_SEVERITY_ERROR );
             }
@@ -337,64 +468,26 @@ bool GERBVIEW_FRAME::LoadListOfGerberAndDrillFiles( const wxString&      aPath,
         SetActiveLayer( layer, false );
         visibility[ layer ] = true;
 
-        try
+        if( file.m_Gerber )
         {
-            // 2 = Autodetect
-            if( ( *aFileType )[ii] == 2 )
-            {
-                if( EXCELLON_IMAGE::TestFileIsExcellon( filename.GetFullPath() ) )
-                    ( *aFileType )[ii] = 1;
-                else if( GERBER_FILE_IMAGE::TestFileIsRS274( filename.GetFullPath() ) )
-                    ( *aFileType )[ii] = 0;
-            }
-
-            switch( ( *aFileType )[ii] )
-            {
-            case 0:
-
-                if( Read_GERBER_File( filename.GetFullPath() ) )
-                {
-                    UpdateFileHistory( filename.GetFullPath() );
-
-                    if( firstLoadedLayer == NO_AVAILABLE_LAYERS )
-                    {
-                        firstLoadedLayer = layer;
-                    }
-                }
-
-                break;
-
-            case 1:
-
-                if( Read_EXCELLON_File( filename.GetFullPath() ) )
-                {
-                    UpdateFileHistory( filename.GetFullPath(), &m_drillFileHistory );
-
-                    // Select the first added layer by default when done loading
-                    if( firstLoadedLayer == NO_AVAILABLE_LAYERS )
-                    {
-                        firstLoadedLayer = layer;
-                    }
-                }
-
-                break;
-            default:
-                wxString txt = wxString::Format( MSG_NOT_LOADED, filename.GetFullName() );
-                reporter.Report( txt, RPT_SEVERITY_ERROR );
-            }
+            addGerberImage( std::move( file.m_Gerber ) );
+            UpdateFileHistory( filename.GetFullPath() );
         }
-        catch( const std::bad_alloc& )
+        else
         {
-            wxString txt = wxString::Format( MSG_OOM, filename.GetFullName() );
-            reporter.Report( txt, RPT_SEVERITY_ERROR );
-            success = false;
-            continue;
+            if( !addExcellonImage( std::move( file.m_Drill ) ) )
+                continue;
+
+            UpdateFileHistory( filename.GetFullPath(), &m_drillFileHistory );
         }
 
-        if( progress )
-            progress->AdvanceProgress();
+        // Select the first added layer by default when done loading
+        if( firstLoadedLayer == NO_AVAILABLE_LAYERS )
+            firstLoadedLayer = layer;
     }
 
+    progress.reset();
+
     if( !success )
     {
         wxSafeYield();  // Allows slice of time to redraw the screen
@@ -421,8 +514,6 @@ bool GERBVIEW_FRAME::LoadListOfGerberAndDrillFiles( const wxString&      aPath,
 }
 
 
-
-
 bool GERBVIEW_FRAME::unarchiveFiles( const wxString& aFullFileName, REPORTER* aReporter )
 {
     bool     foundX2Gerbers = false;
@@ -449,20 +540,16 @@ bool GERBVIEW_FRAME::unarchiveFiles( const wxString& aFullFileName, REPORTER* aR
     // Update the list of recent zip files.
     UpdateFileHistory( aFullFileName, &m_zipFileHistory );
 
-    // The unzipped file in only a temporary file. Give it a filename
-    // which cannot conflict with an usual filename.
-    // TODO: make Read_GERBER_File() and Read_EXCELLON_File() able to
-    // accept a stream, and avoid using a temp file.
-    wxFileName temp_fn( "$tempfile.tmp" );
-    temp_fn.MakeAbsolute( unzipDir );
-    wxString unzipped_tempfile = temp_fn.GetFullPath();
-
-
     bool success = true;
     wxZipInputStream zipArchive( zipFile );
     wxZipEntry* entry;
     bool reported_no_more_layer = false;
 
+    // The files are unzipped first, read concurrently, then put in the layers in the order of
+    // the archive
+    std::vector<IMAGE_FILE> files;
+    std::vector<wxString>   entryNames;
+
     while( ( entry = zipArchive.GetNextEntry() ) )
     {
         wxString fname = entry->GetName();
@@ -481,6 +568,7 @@ bool GERBVIEW_FRAME::unarchiveFiles( const wxString& aFullFileName, REPORTER* aR
                 aReporter->Report( msg, RPT_SEVERITY_WARNING );
             }
 
+            delete entry;
             continue;
         }
 
@@ -488,27 +576,15 @@ bool GERBVIEW_FRAME::unarchiveFiles( const wxString& aFullFileName, REPORTER* aR
         enum GERBER_ORDER_ENUM order;
         GERBER_FILE_IMAGE_LIST::GetGerberLayerFromFilename( fname, order, matchedExt );
 
-        int layer = GetActiveLayer();
-
-        if( layer == NO_AVAILABLE_LAYERS )
-        {
-            success = false;
-
-            if( aReporter )
-            {
-                if( !reported_no_more_layer )
-                    aReporter->Report( MSG_NO_MORE_LAYER,  RPT_SEVERITY_ERROR );
-
-                reported_no_more_layer = true;
+        delete entry;
 
-                // Report the name of not loaded files:
-                msg.Printf( MSG_NOT_LOADED, entry->GetName() );
-                aReporter->Report( msg, RPT_SEVERITY_ERROR );
-            }
-
-            delete entry;
-            continue;
-        }
+        // The unzipped file in only a temporary file. Give it a filename
+        // which cannot conflict with an usual filename.
+        // TODO: make Read_GERBER_File() and Read_EXCELLON_File() able to
+        // accept a stream, and avoid using a temp file.
+        wxFileName temp_fn( wxString::Format( wxT( "$tempfile%zu.tmp" ), files.size() ) );
+        temp_fn.MakeAbsolute( unzipDir );
+        wxString unzipped_tempfile = temp_fn.GetFullPath();
 
         // Create the unzipped temporary file:
         {
@@ -526,82 +602,117 @@ bool GERBVIEW_FRAME::unarchiveFiles( const wxString& aFullFileName, REPORTER* aR
                                 unzipped_tempfile );
                     aReporter->Report( msg, RPT_SEVERITY_ERROR );
                 }
+
+                continue;
             }
         }
 
-        bool read_ok = true;
-
         // Try to parse files if we can't tell from file extension
-        if( order == GERBER_ORDER_ENUM::GERBER_LAYER_UNKNOWN )
+        int fileType = 2;
+
+        if( order == GERBER_ORDER_ENUM::GERBER_DRILL )
+            fileType = 1;
+        else if( order != GERBER_ORDER_ENUM::GERBER_LAYER_UNKNOWN )
+            fileType = 0;
+
+        files.push_back( { unzipped_tempfile, fileType, nullptr, nullptr, false } );
+        entryNames.push_back( fname );
+    }
+
+    EXCELLON_DEFAULTS nc_defaults;
+    GERBVIEW_SETTINGS* cfg = static_cast<GERBVIEW_SETTINGS*>( config() );
+    cfg->GetExcellonDefaults( nc_defaults );
+
+    readImageFiles( files, nc_defaults, nullptr );
+
+    for( size_t ii = 0; ii < files.size(); ii++ )
+    {
+        IMAGE_FILE&     file = files[ii];
+        const wxString& fname = entryNames[ii];
+
+        // The unzipped file is only a temporary file, delete it.
+        wxRemoveFile( file.m_FullFileName );
+
+        if( file.m_FileType == 2 )
         {
-            if( EXCELLON_IMAGE::TestFileIsExcellon( unzipped_tempfile ) )
-            {
-                order = GERBER_ORDER_ENUM::GERBER_DRILL;
-            }
-            else if( GERBER_FILE_IMAGE::TestFileIsRS274( unzipped_tempfile ) )
+            if( aReporter )
             {
-                // If we have no way to know what layer it is, just guess
-                order = GERBER_ORDER_ENUM::GERBER_TOP_COPPER;
+                msg.Printf( _( "Skipped file '%s' (unknown type)." ), fname );
+                aReporter->Report( msg, RPT_SEVERITY_WARNING );
             }
-            else
+
+            continue;
+        }
+
+        int layer = GetActiveLayer();
+
+        if( layer == NO_AVAILABLE_LAYERS )
+        {
+            success = false;
+
+            if( aReporter )
             {
-                if( aReporter )
-                {
-                    msg.Printf( _( "Skipped file '%s' (unknown type)." ), entry->GetName() );
-                    aReporter->Report( msg, RPT_SEVERITY_WARNING );
-                }
+                if( !reported_no_more_layer )
+                    aReporter->Report( MSG_NO_MORE_LAYER,  RPT_SEVERITY_ERROR );
+
+                reported_no_more_layer = true;
+
+                // Report the name of not loaded files:
+                msg.Printf( MSG_NOT_LOADED, fname );
+                aReporter->Report( msg, RPT_SEVERITY_ERROR );
             }
+
+            continue;
         }
 
-        if( order == GERBER_ORDER_ENUM::GERBER_DRILL )
+        bool read_ok = false;
+
+        if( file.m_Drill )
         {
-            read_ok = Read_EXCELLON_File( unzipped_tempfile );
+            read_ok = addExcellonImage( std::move( file.m_Drill ) );
         }
-        else if( order != GERBER_ORDER_ENUM::GERBER_LAYER_UNKNOWN )
+        else if( file.m_Gerber )
         {
             // Read gerber files: each file is loaded on a new GerbView layer
-            read_ok = Read_GERBER_File( unzipped_tempfile );
+            addGerberImage( std::move( file.m_Gerber ) );
+            read_ok = true;
 
-            if( read_ok )
-                GetCanvas()->GetView()->SetLayerHasNegatives(
-                        GERBER_DRAW_LAYER( layer ), GetGbrImage( layer )->HasNegativeItems() );
+            GetCanvas()->GetView()->SetLayerHasNegatives(
+                    GERBER_DRAW_LAYER( layer ), GetGbrImage( layer )->HasNegativeItems() );
         }
 
-        // Select the first added layer by default when done loading
-        if( read_ok && firstLoadedLayer == NO_AVAILABLE_LAYERS )
-        {
-            firstLoadedLayer = layer;
-        }
-
-        delete entry;
-
-        // The unzipped file is only a temporary file, delete it.
-        wxRemoveFile( unzipped_tempfile );
-
         if( !read_ok )
         {
             success = false;
 
             if( aReporter )
             {
-                msg.Printf( _( "<b>unzipped file %s read error</b>" ), unzipped_tempfile );
+                if( file.m_OutOfMemory )
+                    msg.Printf( MSG_OOM, fname );
+                else
+                    msg.Printf( _( "<b>unzipped file %s read error</b>" ), fname );
+
                 aReporter->Report( msg, RPT_SEVERITY_ERROR );
             }
+
+            continue;
         }
-        else
-        {
-            GERBER_FILE_IMAGE* gerber_image = GetGbrImage( layer );
 
-            if( gerber_image )
-            {
-                gerber_image->m_FileName = fname;
-                if( gerber_image->m_IsX2_file )
-                    foundX2Gerbers = true;
-            }
+        // Select the first added layer by default when done loading
+        if( firstLoadedLayer == NO_AVAILABLE_LAYERS )
+            firstLoadedLayer = layer;
 
-            layer = getNextAvailableLayer();
-            SetActiveLayer( layer, false );
+        GERBER_FILE_IMAGE* gerber_image = GetGbrImage( layer );
+
+        if( gerber_image )
+        {
+            gerber_image->m_FileName = fname;
+            if( gerber_image->m_IsX2_file )
+                foundX2Gerbers = true;
         }
+
+        layer = getNextAvailableLayer();
+        SetActiveLayer( layer, false );
     }
 
     if( foundX2Gerbers )
@@ -0,0 +1,303 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <base_units.h>
+#include <gerber_compare.h>
+#include <gerber_draw_item.h>
+#include <gerber_file_image.h>
+#include <progress_reporter.h>
+#include <thread_pool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <future>
+
+
+// The tiles are sized to have about this count of items, when not set
+#define ITEMS_PER_TILE 1000
+
+// Smallest size of the tiles, when not set
+#define MIN_TILE_SIZE_MM 1.0
+
+// Count of segments used to round the differences when removing those thinner than the
+// tolerance
+#define TOLERANCE_CIRCLE_SEGMENTS 16
+
+
+GERBER_COMPARE::GERBER_COMPARE( GERBER_FILE_IMAGE* aReference, GERBER_FILE_IMAGE* aCompared ) :
+        m_reference( aReference ),
+        m_compared( aCompared ),
+        m_maxError( gerbIUScale.mmToIU( 0.005 ) ),
+        m_tolerance( gerbIUScale.mmToIU( 0.005 ) ),
+        m_tileSize( 0 )
+{
+}
+
+
+bool GERBER_COMPARE::Compare( PROGRESS_REPORTER* aProgressReporter )
+{
+    m_differences.RemoveAllContours();
+
+    buildTiles();
+
+    if( aProgressReporter )
+        aProgressReporter->SetMaxProgress( m_tiles.size() );
+
+    thread_pool&                   tp = GetKiCadThreadPool();
+    std::vector<std::future<void>> returns;
+    std::atomic<bool>              cancelled( false );
+
+    returns.reserve( m_tiles.size() );
+
+    for( TILE& tile : m_tiles )
+    {
+        returns.push_back( tp.submit(
+                [this, &tile, &cancelled, aProgressReporter]()
+                {
+                    if( cancelled )
+                        return;
+
+                    compareTile( tile );
+
+                    if( aProgressReporter )
+                        aProgressReporter->AdvanceProgress();
+                } ) );
+    }
+
+    for( const std::future<void>& ret : returns )
+    {
+        std::future_status status = ret.wait_for( std::chrono::milliseconds( 250 ) );
+
+        while( status != std::future_status::ready )
+        {
+            if( aProgressReporter && !aProgressReporter->KeepRefreshing() )
+                cancelled = true;
+
+            status = ret.wait_for( std::chrono::milliseconds( 250 ) );
+        }
+    }
+
+    if( cancelled )
+        return false;
+
+    for( TILE& tile : m_tiles )
+    {
+        m_differences.Append( tile.m_Differences );
+        tile.m_Differences.RemoveAllContours();
+    }
+
+    // Join the differences split by the tile borders
+    if( m_differences.OutlineCount() )
+        m_differences.Simplify( SHAPE_POLY_SET::PM_FAST );
+
+    return true;
+}
+
+
+void GERBER_COMPARE::buildTiles()
+{
+    m_tiles.clear();
+
+    std::vector<BOX2I> referenceBoxes;
+    std::vector<BOX2I> comparedBoxes;
+    BOX2I              area;
+    bool               hasItems = false;
+
+    auto getBoxes =
+            [&]( GERBER_FILE_IMAGE* aImage, std::vector<BOX2I>& aBoxes )
+            {
+                for( GERBER_DRAW_ITEM* item : aImage->GetItems() )
+                {
+                    D_CODE* code = item->GetDcodeDescr();
+
+                    // Build the shared polygons of the D-codes now, the tiles use them
+                    // concurrently
+                    if( code && item->m_Flashed && item->m_Shape != GBR_SPOT_MACRO
+                            && code->m_Polygon.OutlineCount() == 0 )
+                    {
+                        code->ConvertShapeToPolygon( item );
+                    }
+
+                    BOX2I bbox = item->GetBoundingBox();
+                    bbox.Normalize();
+                    bbox.Inflate( m_maxError + 1 );
+                    aBoxes.push_back( bbox );
+
+                    if( hasItems )
+                        area.Merge( bbox );
+                    else
+                        area = bbox;
+
+                    hasItems = true;
+                }
+            };
+
+    getBoxes( m_reference, referenceBoxes );
+    getBoxes( m_compared, comparedBoxes );
+
+    if( !hasItems )
+        return;
+
+    int tileSize = m_tileSize;
+
+    if( tileSize <= 0 )
+    {
+        double itemCount = referenceBoxes.size() + comparedBoxes.size();
+        double tileCount = std::max( 1.0, itemCount / ITEMS_PER_TILE );
+        double side = std::sqrt( (double) area.GetWidth() * area.GetHeight() / tileCount );
+
+        tileSize = (int) std::max( side, (double) gerbIUScale.mmToIU( MIN_TILE_SIZE_MM ) );
+    }
+
+    int cols = area.GetWidth() / tileSize + 1;
+    int rows = area.GetHeight() / tileSize + 1;
+
+    m_tiles.resize( (size_t) cols * rows );
+
+    for( int row = 0; row < rows; row++ )
+    {
+        for( int col = 0; col < cols; col++ )
+        {
+            m_tiles[(size_t) row * cols + col].m_Box =
+                    BOX2I( VECTOR2I( area.GetX() + col * tileSize, area.GetY() + row * tileSize ),
+                           VECTOR2I( tileSize, tileSize ) );
+        }
+    }
+
+    // The items are added in their order in the images, which is the order to draw them
+    auto addItems =
+            [&]( const std::vector<BOX2I>& aBoxes, std::vector<int> TILE::*aItems )
+            {
+                for( size_t ii = 0; ii < aBoxes.size(); ii++ )
+                {
+                    const BOX2I& bbox = aBoxes[ii];
+                    int colStart = std::clamp( ( bbox.GetX() - area.GetX() ) / tileSize, 0,
+                                               cols - 1 );
+                    int colEnd = std::clamp( ( bbox.GetRight() - area.GetX() ) / tileSize, 0,
+                                             cols - 1 );
+                    int rowStart = std::clamp( ( bbox.GetY() - area.GetY() ) / tileSize, 0,
+                                               rows - 1 );
+                    int rowEnd = std::clamp( ( bbox.GetBottom() - area.GetY() ) / tileSize, 0,
+                                             rows - 1 );
+
+                    for( int row = rowStart; row <= rowEnd; row++ )
+                    {
+                        for( int col = colStart; col <= colEnd; col++ )
+                            ( m_tiles[(size_t) row * cols + col].*aItems ).push_back( (int) ii );
+                    }
+                }
+            };
+
+    addItems( referenceBoxes, &TILE::m_ReferenceItems );
+    addItems( comparedBoxes, &TILE::m_ComparedItems );
+
+    // Nothing to compare in the empty tiles
+    m_tiles.erase( std::remove_if( m_tiles.begin(), m_tiles.end(),
+                                   []( const TILE& aTile )
+                                   {
+                                       return aTile.m_ReferenceItems.empty()
+                                              && aTile.m_ComparedItems.empty();
+                                   } ),
+                   m_tiles.end() );
+}
+
+
+void GERBER_COMPARE::buildTileShape( GERBER_FILE_IMAGE* aImage, const std::vector<int>& aItems,
+                                     const BOX2I& aTileBox, SHAPE_POLY_SET& aShape )
+{
+    // The consecutive items having the same polarity are merged, then added to or removed
+    // from the shape
+    SHAPE_POLY_SET run;
+    bool           runNegative = false;
+
+    auto flushRun =
+            [&]()
+            {
+                if( run.OutlineCount() == 0 )
+                    return;
+
+                if( runNegative )
+                    aShape.BooleanSubtract( run, SHAPE_POLY_SET::PM_FAST );
+                else
+                    aShape.BooleanAdd( run, SHAPE_POLY_SET::PM_FAST );
+
+                run.RemoveAllContours();
+            };
+
+    for( int idx : aItems )
+    {
+        const GERBER_DRAW_ITEM* item = aImage->GetItems()[idx];
+
+        if( item->GetLayerPolarity() != runNegative )
+        {
+            flushRun();
+            runNegative = item->GetLayerPolarity();
+        }
+
+        if( item->m_Shape == GBR_SPOT_MACRO )
+        {
+            std::lock_guard<std::mutex> lock( m_macroMutex );
+            item->TransformShapeToPolygon( run, m_maxError );
+        }
+        else
+        {
+            item->TransformShapeToPolygon( run, m_maxError );
+        }
+    }
+
+    flushRun();
+
+    SHAPE_POLY_SET tile;
+
+    tile.NewOutline();
+    tile.Append( aTileBox.GetOrigin() );
+    tile.Append( aTileBox.GetRight(), aTileBox.GetY() );
+    tile.Append( aTileBox.GetEnd() );
+    tile.Append( aTileBox.GetX(), aTileBox.GetBottom() );
+
+    aShape.BooleanIntersection( tile, SHAPE_POLY_SET::PM_FAST );
+}
+
+
+void GERBER_COMPARE::compareTile( TILE& aTile )
+{
+    SHAPE_POLY_SET reference;
+    SHAPE_POLY_SET compared;
+
+    buildTileShape( m_reference, aTile.m_ReferenceItems, aTile.m_Box, reference );
+    buildTileShape( m_compared, aTile.m_ComparedItems, aTile.m_Box, compared );
+
+    SHAPE_POLY_SET added;
+
+    aTile.m_Differences.BooleanSubtract( reference, compared, SHAPE_POLY_SET::PM_FAST );
+    added.BooleanSubtract( compared, reference, SHAPE_POLY_SET::PM_FAST );
+    aTile.m_Differences.BooleanAdd( added, SHAPE_POLY_SET::PM_FAST );
+
+    if( m_tolerance > 0 && aTile.m_Differences.OutlineCount() )
+    {
+        aTile.m_Differences.Deflate( m_tolerance, TOLERANCE_CIRCLE_SEGMENTS );
+        aTile.m_Differences.Inflate( m_tolerance, TOLERANCE_CIRCLE_SEGMENTS );
+    }
+}
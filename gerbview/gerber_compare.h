@@ -0,0 +1,116 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef GERBER_COMPARE_H
+#define GERBER_COMPARE_H
+
+#include <geometry/shape_poly_set.h>
+#include <math/box2.h>
+
+#include <mutex>
+#include <vector>
+
+class GERBER_FILE_IMAGE;
+class PROGRESS_REPORTER;
+
+
+/**
+ * Compare the geometry of two Gerber images.
+ *
+ * The differences are the exclusive or of the areas covered by the two images.  The images
+ * are split in square tiles, and the differences of each tile are calculated concurrently on
+ * the thread pool from the items overlapping this tile only, so the polygon booleans stay
+ * small even for large panels.
+ */
+class GERBER_COMPARE
+{
+public:
+    GERBER_COMPARE( GERBER_FILE_IMAGE* aReference, GERBER_FILE_IMAGE* aCompared );
+
+    /**
+     * Set the maximum error allowed to approximate the arcs and circles.
+     */
+    void SetMaxError( int aMaxError ) { m_maxError = aMaxError; }
+
+    /**
+     * Set the width of the differences to ignore, which come from different approximations
+     * of the same shapes.  0 to keep all the differences.
+     */
+    void SetTolerance( int aTolerance ) { m_tolerance = aTolerance; }
+
+    /**
+     * Set the size of the tiles.  0 to calculate it from the count of items.
+     */
+    void SetTileSize( int aTileSize ) { m_tileSize = aTileSize; }
+
+    /**
+     * Calculate the differences between the two images.
+     *
+     * @param aProgressReporter is an optional progress reporter, which can cancel the compare.
+     * @return false if the compare was cancelled.
+     */
+    bool Compare( PROGRESS_REPORTER* aProgressReporter = nullptr );
+
+    /**
+     * @return the areas which are in only one of the images, in absolute (A,B) coordinates.
+     */
+    const SHAPE_POLY_SET& GetDifferences() const { return m_differences; }
+
+    /**
+     * @return the count of tiles used by the last compare.
+     */
+    size_t GetTileCount() const { return m_tiles.size(); }
+
+private:
+    struct TILE
+    {
+        BOX2I            m_Box;
+        std::vector<int> m_ReferenceItems;      ///< indices of the reference items overlapping
+        std::vector<int> m_ComparedItems;       ///< indices of the compared items overlapping
+        SHAPE_POLY_SET   m_Differences;
+    };
+
+    /// Split the area covered by the two images in tiles, and find the items of each tile.
+    void buildTiles();
+
+    /// Calculate the area covered by some items of an image, clipped to a tile.
+    void buildTileShape( GERBER_FILE_IMAGE* aImage, const std::vector<int>& aItems,
+                         const BOX2I& aTileBox, SHAPE_POLY_SET& aShape );
+
+    /// Calculate the differences of a tile.
+    void compareTile( TILE& aTile );
+
+    GERBER_FILE_IMAGE* m_reference;
+    GERBER_FILE_IMAGE* m_compared;
+
+    int                m_maxError;
+    int                m_tolerance;
+    int                m_tileSize;
+
+    std::vector<TILE>  m_tiles;
+    SHAPE_POLY_SET     m_differences;
+
+    std::mutex         m_macroMutex;    ///< the aperture macros build their shape in place
+};
+
+#endif  // GERBER_COMPARE_H
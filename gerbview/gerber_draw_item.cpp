@@ -52,6 +52,7 @@ GERBER_DRAW_ITEM::GERBER_DRAW_ITEM( GERBER_FILE_IMAGE* aGerberImageFile ) :
     m_mirrorB       = false;
     m_drawScale.x   = m_drawScale.y = 1.0;
     m_lyrRotation   = 0;
+    m_netAttributes = emptyNetAttributes();
 
     if( m_GerberImageFile )
         SetLayerParameters();
@@ -65,16 +66,25 @@ GERBER_DRAW_ITEM::~GERBER_DRAW_ITEM()
 
 void GERBER_DRAW_ITEM::SetNetAttributes( const GBR_NETLIST_METADATA& aNetAttributes )
 {
-    m_netAttributes = aNetAttributes;
+    m_netAttributes = m_GerberImageFile->ShareNetAttributes( aNetAttributes );
 
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP )
-        || ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
+    if( ( aNetAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP )
+        || ( aNetAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
     {
-        m_GerberImageFile->m_ComponentsList.insert( std::make_pair( m_netAttributes.m_Cmpref, 0 ) );
+        m_GerberImageFile->m_ComponentsList.insert( std::make_pair( aNetAttributes.m_Cmpref, 0 ) );
     }
 
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
-        m_GerberImageFile->m_NetnamesList.insert( std::make_pair( m_netAttributes.m_Netname, 0 ) );
+    if( ( aNetAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
+        m_GerberImageFile->m_NetnamesList.insert( std::make_pair( aNetAttributes.m_Netname, 0 ) );
+}
+
+
+const std::shared_ptr<const GBR_NETLIST_METADATA>& GERBER_DRAW_ITEM::emptyNetAttributes()
+{
+    static const std::shared_ptr<const GBR_NETLIST_METADATA> empty =
+            std::make_shared<GBR_NETLIST_METADATA>();
+
+    return empty;
 }
 
 
@@ -403,6 +413,30 @@ void GERBER_DRAW_ITEM::MoveXY( const VECTOR2I& aMoveVector )
     m_ArcCentre += aMoveVector;
 
     m_Polygon.Move( aMoveVector );
+    m_absolutePolygon.reset();
+}
+
+
+SHAPE_POLY_SET& GERBER_DRAW_ITEM::GetAbsolutePolygon()
+{
+    if( !m_absolutePolygon )
+    {
+        m_absolutePolygon = std::make_shared<SHAPE_POLY_SET>();
+
+        if( m_Polygon.OutlineCount() )
+        {
+            std::vector<VECTOR2I> pts = m_Polygon.COutline( 0 ).CPoints();
+
+            for( VECTOR2I& pt : pts )
+                pt = GetABPosition( pt );
+
+            SHAPE_LINE_CHAIN chain( pts );
+            chain.SetClosed( true );
+            m_absolutePolygon->AddOutline( chain );
+        }
+    }
+
+    return *m_absolutePolygon;
 }
 
 
@@ -605,6 +639,170 @@ void GERBER_DRAW_ITEM::ConvertSegmentToPolygon()
 }
 
 
+/**
+ * Append the contours of \a aPolygon, moved by \a aOffset, to \a aBuffer in the absolute
+ * (A,B) coordinates of \a aItem.
+ */
+static void appendABPolygon( const GERBER_DRAW_ITEM* aItem, const SHAPE_POLY_SET& aPolygon,
+                             const VECTOR2I& aOffset, SHAPE_POLY_SET& aBuffer )
+{
+    for( int ii = 0; ii < aPolygon.OutlineCount(); ii++ )
+    {
+        const SHAPE_POLY_SET::POLYGON& polygon = aPolygon.CPolygon( ii );
+
+        for( size_t jj = 0; jj < polygon.size(); jj++ )
+        {
+            std::vector<VECTOR2I> pts = polygon[jj].CPoints();
+
+            for( VECTOR2I& pt : pts )
+                pt = aItem->GetABPosition( pt + aOffset );
+
+            SHAPE_LINE_CHAIN chain( pts );
+            chain.SetClosed( true );
+
+            if( jj == 0 )
+                aBuffer.AddOutline( chain );
+            else
+                aBuffer.AddHole( chain );
+        }
+    }
+}
+
+
+void GERBER_DRAW_ITEM::TransformShapeToPolygon( SHAPE_POLY_SET& aBuffer, int aError ) const
+{
+    D_CODE* code = GetDcodeDescr();
+
+    switch( m_Shape )
+    {
+    case GBR_POLYGON:
+        if( m_Polygon.OutlineCount() )
+        {
+            SHAPE_POLY_SET outline;
+            outline.AddOutline( m_Polygon.COutline( 0 ) );
+            appendABPolygon( this, outline, VECTOR2I( 0, 0 ), aBuffer );
+        }
+
+        break;
+
+    case GBR_CIRCLE:
+        TransformRingToPolygon( aBuffer, GetABPosition( m_Start ),
+                                KiROUND( GetLineLength( m_Start, m_End ) ), m_Size.x, aError,
+                                ERROR_INSIDE );
+        break;
+
+    case GBR_ARC:
+    {
+        // Same geometry as the GAL arc: from m_End to m_Start, with increasing angles in
+        // absolute coordinates
+        VECTOR2I  center = GetABPosition( m_ArcCentre );
+        VECTOR2I  arcStart = GetABPosition( m_End );
+        VECTOR2I  arcEnd = GetABPosition( m_Start );
+        double    radius = GetLineLength( arcStart, center );
+
+        if( m_Start == m_End )
+        {
+            TransformRingToPolygon( aBuffer, center, KiROUND( radius ), m_Size.x, aError,
+                                    ERROR_INSIDE );
+            break;
+        }
+
+        EDA_ANGLE startAngle( arcStart - center );
+        EDA_ANGLE endAngle( arcEnd - center );
+
+        if( startAngle > endAngle )
+            endAngle += ANGLE_360;
+
+        EDA_ANGLE midAngle = ( startAngle + endAngle ) / 2;
+        VECTOR2I  mid = center + VECTOR2I( KiROUND( radius * midAngle.Cos() ),
+                                           KiROUND( radius * midAngle.Sin() ) );
+
+        TransformArcToPolygon( aBuffer, arcStart, mid, arcEnd, m_Size.x, aError, ERROR_INSIDE );
+        break;
+    }
+
+    case GBR_SEGMENT:
+        if( code && code->m_Shape == APT_RECT )
+        {
+            SHAPE_POLY_SET segment;
+            ConvertSegmentToPolygon( &segment );
+            appendABPolygon( this, segment, VECTOR2I( 0, 0 ), aBuffer );
+        }
+        else
+        {
+            TransformOvalToPolygon( aBuffer, GetABPosition( m_Start ), GetABPosition( m_End ),
+                                    m_Size.x, aError, ERROR_INSIDE );
+        }
+
+        break;
+
+    case GBR_SPOT_CIRCLE:
+    case GBR_SPOT_RECT:
+    case GBR_SPOT_OVAL:
+    case GBR_SPOT_POLY:
+        if( !code )
+            break;
+
+        if( m_Shape == GBR_SPOT_POLY || code->m_DrillShape != APT_DEF_NO_HOLE )
+        {
+            if( code->m_Polygon.OutlineCount() == 0 )
+                code->ConvertShapeToPolygon( this );
+
+            appendABPolygon( this, code->m_Polygon, m_Start, aBuffer );
+        }
+        else if( m_Shape == GBR_SPOT_CIRCLE )
+        {
+            TransformCircleToPolygon( aBuffer, GetABPosition( m_Start ), code->m_Size.x / 2,
+                                      aError, ERROR_INSIDE );
+        }
+        else if( m_Shape == GBR_SPOT_RECT )
+        {
+            VECTOR2I corner = m_Start - VECTOR2I( code->m_Size.x / 2, code->m_Size.y / 2 );
+            SHAPE_POLY_SET rect;
+
+            rect.NewOutline();
+            rect.Append( corner );
+            rect.Append( corner.x + code->m_Size.x, corner.y );
+            rect.Append( corner.x + code->m_Size.x, corner.y + code->m_Size.y );
+            rect.Append( corner.x, corner.y + code->m_Size.y );
+            appendABPolygon( this, rect, VECTOR2I( 0, 0 ), aBuffer );
+        }
+        else    // GBR_SPOT_OVAL
+        {
+            VECTOR2I start = m_Start;
+            VECTOR2I end = m_Start;
+            int      delta = std::abs( code->m_Size.x - code->m_Size.y ) / 2;
+
+            if( code->m_Size.x > code->m_Size.y )
+            {
+                start.x -= delta;
+                end.x += delta;
+            }
+            else
+            {
+                start.y -= delta;
+                end.y += delta;
+            }
+
+            TransformOvalToPolygon( aBuffer, GetABPosition( start ), GetABPosition( end ),
+                                    std::min( code->m_Size.x, code->m_Size.y ), aError,
+                                    ERROR_INSIDE );
+        }
+
+        break;
+
+    case GBR_SPOT_MACRO:
+        if( code && code->GetMacro() )
+            aBuffer.Append( *code->GetMacro()->GetApertureMacroShape( this, m_Start ) );
+
+        break;
+
+    default:
+        break;
+    }
+}
+
+
 void GERBER_DRAW_ITEM::PrintGerberPoly( wxDC* aDC, const COLOR4D& aColor, const VECTOR2I& aOffset,
                                         bool aFilledShape )
 {
@@ -701,45 +899,45 @@ void GERBER_DRAW_ITEM::GetMsgPanelInfo( EDA_DRAW_FRAME* aFrame, std::vector<MSG_
     aList.emplace_back( _( "AB axis" ), msg );
 
     // Display net info, if exists
-    if( m_netAttributes.m_NetAttribType == GBR_NETLIST_METADATA::GBR_NETINFO_UNSPECIFIED )
+    if( m_netAttributes->m_NetAttribType == GBR_NETLIST_METADATA::GBR_NETINFO_UNSPECIFIED )
         return;
 
     // Build full net info:
     wxString net_msg;
     wxString cmp_pad_msg;
 
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
+    if( ( m_netAttributes->m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
     {
         net_msg = _( "Net:" );
         net_msg << wxS( " " );
 
-        if( m_netAttributes.m_Netname.IsEmpty() )
+        if( m_netAttributes->m_Netname.IsEmpty() )
             net_msg << wxT( "<no net>" );
         else
-            net_msg << UnescapeString( m_netAttributes.m_Netname );
+            net_msg << UnescapeString( m_netAttributes->m_Netname );
     }
 
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
+    if( ( m_netAttributes->m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
     {
-        if( m_netAttributes.m_PadPinFunction.IsEmpty() )
+        if( m_netAttributes->m_PadPinFunction.IsEmpty() )
         {
             cmp_pad_msg.Printf( _( "Cmp: %s  Pad: %s" ),
-                                m_netAttributes.m_Cmpref,
-                                m_netAttributes.m_Padname.GetValue() );
+                                m_netAttributes->m_Cmpref,
+                                m_netAttributes->m_Padname.GetValue() );
         }
         else
         {
             cmp_pad_msg.Printf( _( "Cmp: %s  Pad: %s  Fct %s" ),
-                                m_netAttributes.m_Cmpref,
-                                m_netAttributes.m_Padname.GetValue(),
-                                m_netAttributes.m_PadPinFunction.GetValue() );
+                                m_netAttributes->m_Cmpref,
+                                m_netAttributes->m_Padname.GetValue(),
+                                m_netAttributes->m_PadPinFunction.GetValue() );
         }
     }
 
-    else if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) )
+    else if( ( m_netAttributes->m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) )
     {
         cmp_pad_msg = _( "Cmp:" );
-        cmp_pad_msg << wxS( " " ) << m_netAttributes.m_Cmpref;
+        cmp_pad_msg << wxS( " " ) << m_netAttributes->m_Cmpref;
     }
 
     aList.emplace_back( net_msg, cmp_pad_msg );
@@ -33,6 +33,8 @@
 #include <geometry/shape_poly_set.h>
 #include <geometry/eda_angle.h>
 
+#include <memory>
+
 class GERBER_FILE_IMAGE;
 class GBR_LAYOUT;
 class D_CODE;
@@ -68,7 +70,7 @@ public:
     ~GERBER_DRAW_ITEM();
 
     void SetNetAttributes( const GBR_NETLIST_METADATA& aNetAttributes );
-    const GBR_NETLIST_METADATA& GetNetAttributes() const { return m_netAttributes; }
+    const GBR_NETLIST_METADATA& GetNetAttributes() const { return *m_netAttributes; }
 
     /**
      * Return the layer this item is on.
@@ -155,6 +157,13 @@ public:
 
     void Print( wxDC* aDC, const VECTOR2I& aOffset, GBR_DISPLAY_OPTIONS* aOptions );
 
+    /**
+     * Return the polygon to draw a GBR_POLYGON item, in absolute coordinates.
+     *
+     * It is built from m_Polygon and the layer parameters on the first call.
+     */
+    SHAPE_POLY_SET& GetAbsolutePolygon();
+
     /**
      * Convert a line to an equivalent polygon.
      *
@@ -166,6 +175,18 @@ public:
     void ConvertSegmentToPolygon();
     void ConvertSegmentToPolygon( SHAPE_POLY_SET* aPolygon ) const;
 
+    /**
+     * Convert the shape of this item to polygons, in absolute (A,B) coordinates, as drawn.
+     *
+     * The polygon of the D-code of a flashed item is built if not already done, and the
+     * shape of an aperture macro is built in the macro: this function is not thread safe for
+     * these items.
+     *
+     * @param aBuffer is the buffer to append the polygons to.
+     * @param aError is the maximum error allowed to approximate arcs and circles.
+     */
+    void TransformShapeToPolygon( SHAPE_POLY_SET& aBuffer, int aError ) const;
+
     /**
      * Print the polygon stored in m_PolyCorners.
      */
@@ -257,10 +278,10 @@ public:
                                              * redundancy for these parameters
                                              */
 
-    // This polygon is to draw this item (mainly GBR_POLYGON), according to layer parameters
-    SHAPE_POLY_SET   m_AbsolutePolygon;     // the polygon to draw, in absolute coordinates
-
 private:
+    /// The net attributes of the items without attributes
+    static const std::shared_ptr<const GBR_NETLIST_METADATA>& emptyNetAttributes();
+
     // These values are used to draw this item, according to gerber layers parameters
     // Because they can change inside a gerber image, they are stored here
     // for each item
@@ -271,9 +292,15 @@ private:
     VECTOR2I    m_drawScale;                // A and B scaling factor
     VECTOR2I    m_layerOffset;              // Offset for A and B axis, from OF parameter
     double      m_lyrRotation;              // Fine rotation, from OR parameter, in degrees
-    GBR_NETLIST_METADATA m_netAttributes;   ///< the string given by a %TO attribute set in aperture
-                                            ///< (dcode). Stored in each item, because %TO is
-                                            ///< a dynamic object attribute
+
+    ///< the string given by a %TO attribute set in aperture (dcode). Stored in each item,
+    ///< because %TO is a dynamic object attribute, but shared by the consecutive items
+    ///< having the same attributes
+    std::shared_ptr<const GBR_NETLIST_METADATA> m_netAttributes;
+
+    ///< the polygon to draw this item (mainly GBR_POLYGON), according to layer parameters, in
+    ///< absolute coordinates.  Built when first drawn, and shared by the copies of the item
+    std::shared_ptr<SHAPE_POLY_SET> m_absolutePolygon;
 };
 
 
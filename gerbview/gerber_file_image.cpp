@@ -30,6 +30,12 @@
 #include <algorithm>
 #include <map>
 #include <core/arraydim.h>
+#include <memory>
+
+
+// Count of items allocated at once: panelized images can have millions of items, so they are
+// allocated in blocks rather than one at a time
+#define GERBER_ITEM_BLOCK_SIZE 1024
 
 
 /**
@@ -87,6 +93,7 @@ GERBER_FILE_IMAGE::GERBER_FILE_IMAGE( int aLayer ) :
 
     m_Selected_Tool = 0;
     m_FileFunction = nullptr;          // file function parameters
+    m_itemBlockUsed = GERBER_ITEM_BLOCK_SIZE;
 
     ResetDefaultValues();
 
@@ -97,10 +104,12 @@ GERBER_FILE_IMAGE::GERBER_FILE_IMAGE( int aLayer ) :
 
 GERBER_FILE_IMAGE::~GERBER_FILE_IMAGE()
 {
+    // The items are in the item blocks, only destroy them
     for( GERBER_DRAW_ITEM* item : GetItems() )
-        delete item;
+        item->~GERBER_DRAW_ITEM();
 
     m_drawings.clear();
+    m_itemBlocks.clear();
 
     for( unsigned ii = 0; ii < arrayDim( m_Aperture_List ); ii++ )
         delete m_Aperture_List[ii];
@@ -109,6 +118,47 @@ GERBER_FILE_IMAGE::~GERBER_FILE_IMAGE()
 }
 
 
+void* GERBER_FILE_IMAGE::allocItem()
+{
+    if( m_itemBlockUsed == GERBER_ITEM_BLOCK_SIZE )
+    {
+        m_itemBlocks.push_back(
+                std::make_unique<char[]>( GERBER_ITEM_BLOCK_SIZE * sizeof( GERBER_DRAW_ITEM ) ) );
+        m_itemBlockUsed = 0;
+    }
+
+    return m_itemBlocks.back().get() + sizeof( GERBER_DRAW_ITEM ) * m_itemBlockUsed++;
+}
+
+
+GERBER_DRAW_ITEM* GERBER_FILE_IMAGE::NewItem()
+{
+    GERBER_DRAW_ITEM* item = new( allocItem() ) GERBER_DRAW_ITEM( this );
+
+    m_drawings.push_back( item );
+    return item;
+}
+
+
+GERBER_DRAW_ITEM* GERBER_FILE_IMAGE::NewItem( const GERBER_DRAW_ITEM& aItem )
+{
+    GERBER_DRAW_ITEM* item = new( allocItem() ) GERBER_DRAW_ITEM( aItem );
+
+    m_drawings.push_back( item );
+    return item;
+}
+
+
+std::shared_ptr<const GBR_NETLIST_METADATA>
+GERBER_FILE_IMAGE::ShareNetAttributes( const GBR_NETLIST_METADATA& aNetAttributes )
+{
+    if( !m_sharedNetAttributes || *m_sharedNetAttributes != aNetAttributes )
+        m_sharedNetAttributes = std::make_shared<GBR_NETLIST_METADATA>( aNetAttributes );
+
+    return m_sharedNetAttributes;
+}
+
+
 D_CODE* GERBER_FILE_IMAGE::GetDCODEOrCreate( int aDCODE, bool aCreateIfNoExist )
 {
     unsigned ndx = aDCODE - FIRST_DCODE;
@@ -289,14 +339,13 @@ void GERBER_FILE_IMAGE::StepAndRepeatItem( const GERBER_DRAW_ITEM& aItem )
             if( jj == 0 && ii == 0 )
                 continue;
 
-            GERBER_DRAW_ITEM* dupItem = new GERBER_DRAW_ITEM( aItem );
+            GERBER_DRAW_ITEM* dupItem = NewItem( aItem );
             VECTOR2I          move_vector;
             move_vector.x = scaletoIU( ii * GetLayerParams().m_StepForRepeat.x,
                                        GetLayerParams().m_StepForRepeatMetric );
             move_vector.y = scaletoIU( jj * GetLayerParams().m_StepForRepeat.y,
                                        GetLayerParams().m_StepForRepeatMetric );
             dupItem->MoveXY( move_vector );
-            AddItemToList( dupItem );
         }
     }
 }
@@ -25,6 +25,7 @@
 #ifndef GERBER_FILE_IMAGE_H
 #define GERBER_FILE_IMAGE_H
 
+#include <memory>
 #include <vector>
 #include <set>
 
@@ -163,14 +164,31 @@ public:
     int GetItemsCount() { return m_drawings.size(); }
 
     /**
-     * Add a new GERBER_DRAW_ITEM item to the drawings list
+     * Create a new GERBER_DRAW_ITEM and add it to the drawings list.
      *
-     * @param aItem is the GERBER_DRAW_ITEM to add to list
+     * The items are allocated in large blocks owned by this image: they are destroyed with
+     * the image and must never be deleted.
+     *
+     * @return the new item.
      */
-    void AddItemToList( GERBER_DRAW_ITEM* aItem )
-    {
-        m_drawings.push_back( aItem );
-    }
+    GERBER_DRAW_ITEM* NewItem();
+
+    /**
+     * Create a copy of a GERBER_DRAW_ITEM and add it to the drawings list.
+     *
+     * @param aItem is the GERBER_DRAW_ITEM to copy.
+     * @return the new item.
+     */
+    GERBER_DRAW_ITEM* NewItem( const GERBER_DRAW_ITEM& aItem );
+
+    /**
+     * Return net attributes equal to \a aNetAttributes, shared with the last items created
+     * if they have the same attributes.
+     *
+     * Consecutive items usually have the same %TO attributes, so they are stored only once.
+     */
+    std::shared_ptr<const GBR_NETLIST_METADATA>
+    ShareNetAttributes( const GBR_NETLIST_METADATA& aNetAttributes );
 
     /**
      * @return the last GERBER_DRAW_ITEM* item of the items list
@@ -459,8 +477,16 @@ public:
     GERBER_DRAW_ITEMS  m_drawings;                       // linked list of Gerber Items to draw
 
 private:
+    /// Return the storage for a new item, in the last item block
+    void* allocItem();
+
     wxArrayString      m_messagesList;         // A list of messages created when reading a file
 
+    std::vector<std::unique_ptr<char[]>> m_itemBlocks;     // storage of the items to draw
+    size_t             m_itemBlockUsed;        // count of items in the last block
+
+    std::shared_ptr<const GBR_NETLIST_METADATA> m_sharedNetAttributes;
+
     /**
      * True if the image is negative or has some negative items.
      *
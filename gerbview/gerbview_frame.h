@@ -34,6 +34,7 @@
 #define NO_AVAILABLE_LAYERS UNDEFINED_LAYER
 
 class DCODE_SELECTION_BOX;
+class EXCELLON_IMAGE;
 class GERBER_LAYER_WIDGET;
 class GBR_LAYER_BOX_SELECTOR;
 class GERBER_DRAW_ITEM;
@@ -352,6 +353,15 @@ public:
     void SortLayersByFileExtension();
     void SortLayersByX2Attributes();
 
+    /**
+     * Compare the geometry of two layers, and load their differences in a new layer.
+     *
+     * @param aReferenceLayer is the layer of the previous revision of the image.
+     * @param aComparedLayer is the layer of the new revision of the image.
+     * @return false if the differences were not loaded.
+     */
+    bool CompareLayers( int aReferenceLayer, int aComparedLayer );
+
     /**
      * Takes a layer remapping and reorders the layers.
      *
@@ -502,6 +512,20 @@ private:
     bool LoadFileOrShowDialog( const wxString& aFileName, const wxString& dialogFiletypes,
                                const wxString& dialogTitle, const int filetype );
 
+    /**
+     * Put a Gerber image read from a file in the active layer, replacing the image already
+     * in this layer, and report the errors found when reading the file.
+     */
+    void addGerberImage( std::unique_ptr<GERBER_FILE_IMAGE> aGerber );
+
+    /**
+     * Put a drill image read from a file in the active layer, replacing the image already
+     * in this layer.
+     *
+     * @return false if the image cannot be put in the layer.
+     */
+    bool addExcellonImage( std::unique_ptr<EXCELLON_IMAGE> aDrill );
+
     // The Tool Framework initialization
     void setupTools();
 
@@ -256,22 +256,15 @@ void GERBVIEW_PAINTER::draw( /*const*/ GERBER_DRAW_ITEM* aItem, int aLayer )
         if( !isFilled )
             m_gal->SetLineWidth( m_gerbviewSettings.m_outlineWidth );
 
-        if( aItem->m_AbsolutePolygon.OutlineCount() == 0 )
-        {
-            std::vector<VECTOR2I> pts = aItem->m_Polygon.COutline( 0 ).CPoints();
-
-            for( auto& pt : pts )
-                pt = aItem->GetABPosition( pt );
+        SHAPE_POLY_SET& absolutePolygon = aItem->GetAbsolutePolygon();
 
-            SHAPE_LINE_CHAIN chain( pts );
-            chain.SetClosed( true );
-            aItem->m_AbsolutePolygon.AddOutline( chain );
-        }
+        if( absolutePolygon.OutlineCount() == 0 )
+            break;
 
         // Degenerated polygons (having < 3 points) are drawn as lines
         // to avoid issues in draw polygon functions
-        if( !isFilled || aItem->m_AbsolutePolygon.COutline( 0 ).PointCount() < 3 )
-            m_gal->DrawPolyline( aItem->m_AbsolutePolygon.COutline( 0 ) );
+        if( !isFilled || absolutePolygon.COutline( 0 ).PointCount() < 3 )
+            m_gal->DrawPolyline( absolutePolygon.COutline( 0 ) );
         else
         {
             // On Opengl, a not convex filled polygon is usually drawn by using triangles as
@@ -280,10 +273,10 @@ void GERBVIEW_PAINTER::draw( /*const*/ GERBER_DRAW_ITEM* aItem, int aLayer )
             // We use the fastest CacheTriangulation calculation mode: no partition created because
             // the partition is useless in Gerbview, and very time consumming (optimized only
             // for pcbnew that has different internal unit)
-            if( m_gal->IsOpenGlEngine() && !aItem->m_AbsolutePolygon.IsTriangulationUpToDate() )
-                aItem->m_AbsolutePolygon.CacheTriangulation( false /* fastest triangulation calculation mode */ );
+            if( m_gal->IsOpenGlEngine() && !absolutePolygon.IsTriangulationUpToDate() )
+                absolutePolygon.CacheTriangulation( false /* fastest triangulation calculation mode */ );
 
-            m_gal->DrawPolygon( aItem->m_AbsolutePolygon );
+            m_gal->DrawPolygon( absolutePolygon );
         }
 
         break;
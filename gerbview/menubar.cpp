@@ -210,6 +210,7 @@ void GERBVIEW_FRAME::ReCreateMenuBar()
 
     toolsMenu->Add( GERBVIEW_ACTIONS::showDCodes );
     toolsMenu->Add( GERBVIEW_ACTIONS::showSource );
+    toolsMenu->Add( GERBVIEW_ACTIONS::compareLayers );
 
     toolsMenu->Add( ACTIONS::measureTool );
 
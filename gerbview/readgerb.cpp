@@ -36,6 +36,8 @@
 
 #include <wx/msgdlg.h>
 
+#include <memory>
+
 /* Read a gerber file, RS274D, RS274X or RS274X2 format.
  */
 bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
@@ -43,7 +45,6 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
     wxString msg;
 
     int layer = GetActiveLayer();
-    GERBER_FILE_IMAGE_LIST* images = GetImagesList();
     GERBER_FILE_IMAGE* gerber = GetGbrImage( layer );
 
     if( gerber != nullptr )
@@ -66,8 +67,25 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
         return false;
     }
 
-    gerber = gerber_uptr.release();
+    addGerberImage( std::move( gerber_uptr ) );
+
+    return true;
+}
+
+
+void GERBVIEW_FRAME::addGerberImage( std::unique_ptr<GERBER_FILE_IMAGE> aGerber )
+{
+    wxString                msg;
+    int                     layer = GetActiveLayer();
+    GERBER_FILE_IMAGE_LIST* images = GetImagesList();
+
+    // If the active layer contains old gerber or nc drill data, remove it
+    if( GetGbrImage( layer ) )
+        Erase_Current_DrawLayer( false );
+
+    GERBER_FILE_IMAGE* gerber = aGerber.release();
     wxASSERT( gerber != nullptr );
+    gerber->m_GraphicLayer = layer;
     images->AddGbrImage( gerber, layer );
 
     // Display errors list
@@ -106,8 +124,6 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
         for( GERBER_DRAW_ITEM* item : gerber->GetItems() )
             GetCanvas()->GetView()->Add( (KIGFX::VIEW_ITEM*) item );
     }
-
-    return true;
 }
 
 
@@ -226,8 +242,9 @@ bool GERBER_FILE_IMAGE::TestFileIsRS274( const wxString& aFullFileName )
 // size of a single line of text from a gerber file.
 // warning: some files can have *very long* lines, so the buffer must be large.
 #define GERBER_BUFZ 1000000
-// A large buffer to store one line
-static char lineBuffer[GERBER_BUFZ+1];
+
+// size of the stdio buffer of a gerber file, so the file is read in large blocks
+#define GERBER_FILE_BLOCK_SIZE ( 1 << 20 )
 
 bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 {
@@ -244,8 +261,15 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
     if( m_Current_File == nullptr )
         return false;
 
+    setvbuf( m_Current_File, nullptr, _IOFBF, GERBER_FILE_BLOCK_SIZE );
+
     m_FileName = aFullFileName;
 
+    // A large buffer to store one line.  It is not shared, so that several files can be
+    // read at the same time
+    std::unique_ptr<char[]> buffer = std::make_unique<char[]>( GERBER_BUFZ + 1 );
+    char*                   lineBuffer = buffer.get();
+
     LOCALE_IO toggleIo;
 
     wxString msg;
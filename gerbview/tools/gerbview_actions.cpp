@@ -88,6 +88,12 @@ TOOL_ACTION GERBVIEW_ACTIONS::exportToPcbnew( "gerbview.Control.exportToPcbnew",
         _( "Export data as a KiCad PCB file" ),
         BITMAPS::export_to_pcbnew );
 
+TOOL_ACTION GERBVIEW_ACTIONS::compareLayers( "gerbview.Control.compareLayers",
+        AS_GLOBAL, 0, "",
+        _( "Compare Layers..." ),
+        _( "Load the geometric differences between the current layer and another layer" ),
+        BITMAPS::gbr_select_mode2 );
+
 TOOL_ACTION GERBVIEW_ACTIONS::clearLayer( "gerbview.Control.clearLayer",
         AS_GLOBAL, 0, "",
         _( "Clear Current Layer..." ), _( "Clear the selected graphic layer" ),
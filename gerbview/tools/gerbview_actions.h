@@ -56,6 +56,7 @@ public:
     static TOOL_ACTION showSource;
 
     static TOOL_ACTION exportToPcbnew;
+    static TOOL_ACTION compareLayers;
 
     // Display modes
     static TOOL_ACTION linesDisplayOutlines;
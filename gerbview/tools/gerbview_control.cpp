@@ -33,6 +33,7 @@
 #include <project.h>
 #include <view/view.h>
 #include <wildcards_and_files_ext.h>
+#include <wx/choicdlg.h>
 #include <wx/filedlg.h>
 
 #include "gerbview_actions.h"
@@ -155,6 +156,50 @@ int GERBVIEW_CONTROL::ExportToPcbnew( const TOOL_EVENT& aEvent )
 }
 
 
+int GERBVIEW_CONTROL::CompareLayers( const TOOL_EVENT& aEvent )
+{
+    GERBER_FILE_IMAGE_LIST* images = m_frame->GetGerberLayout()->GetImagesList();
+    int                     activeLayer = m_frame->GetActiveLayer();
+
+    if( !images->GetGbrImage( activeLayer ) )
+    {
+        DisplayInfoMessage( m_frame, _( "The current layer does not contain any data" ) );
+        return 0;
+    }
+
+    wxArrayString    layerNames;
+    std::vector<int> layers;
+
+    for( int ii = 0; ii < (int) images->ImagesMaxCount(); ++ii )
+    {
+        if( ii != activeLayer && images->GetGbrImage( ii ) )
+        {
+            layerNames.Add( images->GetDisplayName( ii ) );
+            layers.push_back( ii );
+        }
+    }
+
+    if( layers.empty() )
+    {
+        DisplayInfoMessage( m_frame, _( "No other layer contains data to compare with" ) );
+        return 0;
+    }
+
+    wxSingleChoiceDialog dlg( m_frame,
+                              wxString::Format( _( "Compare '%s' with:" ),
+                                                images->GetDisplayName( activeLayer, true ) ),
+                              _( "Compare Layers" ), layerNames );
+
+    if( dlg.ShowModal() == wxID_CANCEL )
+        return 0;
+
+    // The other layer is the reference: the current layer is usually the new revision
+    m_frame->CompareLayers( layers[dlg.GetSelection()], activeLayer );
+
+    return 0;
+}
+
+
 int GERBVIEW_CONTROL::HighlightControl( const TOOL_EVENT& aEvent )
 {
     auto settings = static_cast<KIGFX::GERBVIEW_PAINTER*>( getView()->GetPainter() )->GetSettings();
@@ -509,6 +554,7 @@ void GERBVIEW_CONTROL::setTransitions()
     Go( &GERBVIEW_CONTROL::OpenZipFile,        GERBVIEW_ACTIONS::openZipFile.MakeEvent() );
     Go( &GERBVIEW_CONTROL::ToggleLayerManager, GERBVIEW_ACTIONS::toggleLayerManager.MakeEvent() );
     Go( &GERBVIEW_CONTROL::ExportToPcbnew,     GERBVIEW_ACTIONS::exportToPcbnew.MakeEvent() );
+    Go( &GERBVIEW_CONTROL::CompareLayers,      GERBVIEW_ACTIONS::compareLayers.MakeEvent() );
     Go( &GERBVIEW_CONTROL::Print,              ACTIONS::print.MakeEvent() );
 
     Go( &GERBVIEW_CONTROL::HighlightControl,   GERBVIEW_ACTIONS::highlightClear.MakeEvent() );
@@ -65,6 +65,7 @@ public:
 
     // Miscellaneous
     int ExportToPcbnew( const TOOL_EVENT& aEvent );
+    int CompareLayers( const TOOL_EVENT& aEvent );
     int UpdateMessagePanel( const TOOL_EVENT& aEvent );
     int Print( const TOOL_EVENT& aEvent );
 
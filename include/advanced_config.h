@@ -225,6 +225,22 @@ public:
      */
     bool m_ShowPropertiesPanel;
 
+    /**
+     * Plot the files of a multi-layer plot concurrently on the thread pool, each one with its
+     * own plotter.  Turn it off to plot the files one after the other, e.g. to compare the
+     * files or to debug a plotter.
+     */
+    bool m_ParallelPlot;
+
+    /**
+     * Record the drawing commands of the Cairo canvas buffers in horizontal bands, and
+     * rasterize the bands concurrently on the thread pool when a buffer is composited.
+     * The buffers with negative items are drawn directly on their pixels from the first
+     * negative item.  The CairoCompositor QA tests compare its pixels to the direct
+     * rasterization.
+     */
+    bool m_CairoTiledRendering;
+
     /**
      * 3D-Viewer, Raytracing
      * Bevel height of layer items. Controls the start of curvature normal on the edge.
@@ -238,6 +254,14 @@ public:
      */
     double m_3DRT_BevelExtentFactor;
 
+    /**
+     * 3D-Viewer, Raytracing
+     * Adaptive anti-aliasing: a pixel whose first two samples differ by less than this value
+     * (on any linear color channel, 0.0 to 1.0) is considered converged and is not sampled
+     * further.  Set to 0 to always take all the anti-aliasing samples.
+     */
+    double m_3DRT_AdaptiveAAThreshold;
+
 private:
     ADVANCED_CFG();
 
@@ -24,6 +24,7 @@
 #include <any>
 #include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 extern const char* const traceDatabase;
@@ -32,6 +33,7 @@ extern const char* const traceDatabase;
 namespace nanodbc
 {
     class connection;
+    class statement;
 }
 
 class DATABASE_CACHE;
@@ -42,6 +44,13 @@ class DATABASE_CONNECTION
 public:
     static const long DEFAULT_TIMEOUT = 10;
 
+    static constexpr int DEFAULT_CACHE_SIZE = 4096;
+
+    static constexpr int DEFAULT_CACHE_AGE = 10;
+
+    /// Maximum number of values looked up by a single query in SelectMany()
+    static constexpr size_t MAX_SELECT_MANY_VALUES = 100;
+
     typedef std::map<std::string, std::any> ROW;
 
     DATABASE_CONNECTION( const std::string& aDataSourceName, const std::string& aUsername,
@@ -74,6 +83,19 @@ public:
     bool SelectOne( const std::string& aTable, const std::pair<std::string, std::string>& aWhere,
                     ROW& aResult );
 
+    /**
+     * Retrieves the rows of a database table matching any of a list of values, using as few
+     * queries as possible.  The rows found are also stored in the cache used by SelectOne(), so
+     * this can be used to prefetch rows which will be requested one by one later.
+     * @param aTable the name of a table in the database
+     * @param aColumn column to search
+     * @param aValues the values to search for
+     * @param aResults will be filled with the rows found, in no particular order
+     * @return true if the queries succeeded (even if no row was found); false otherwise
+     */
+    bool SelectMany( const std::string& aTable, const std::string& aColumn,
+                     const std::vector<std::string>& aValues, std::vector<ROW>& aResults );
+
     /**
      * Retrieves all rows from a database table.
      * @param aTable the name of a table in the database
@@ -91,8 +113,18 @@ private:
 
     bool getQuoteChar();
 
+    /**
+     * Returns a prepared statement for the given query, reusing the one prepared by a previous
+     * call if any.  The statements are released when disconnecting.
+     * @throw nanodbc::database_error if the statement could not be prepared
+     */
+    nanodbc::statement& getStatement( const std::string& aQuery );
+
     std::unique_ptr<nanodbc::connection> m_conn;
 
+    /// Prepared statements, by query string
+    std::map<std::string, std::unique_ptr<nanodbc::statement>> m_statements;
+
     std::string m_dsn;
     std::string m_user;
     std::string m_pass;
@@ -27,6 +27,7 @@
 #ifndef OUTLINE_FONT_H_
 #define OUTLINE_FONT_H_
 
+#include <mutex>
 #include <gal/graphics_abstraction_layer.h>
 #include <geometry/shape_poly_set.h>
 #ifdef _MSC_VER
@@ -127,6 +128,11 @@ private:
     FT_Face           m_face;
     const int         m_faceSize;
 
+    // FT_Face objects are not thread safe: serialize glyph generation so that several
+    // plotters can run concurrently on the same board (recursive because the underline
+    // glyph is generated from within getTextAsGlyphs)
+    mutable std::recursive_mutex m_faceMutex;
+
     // cache for glyphs converted to straight segments
     // key is glyph index (FT_GlyphSlot field glyph_index)
     std::map<unsigned int, GLYPH_POINTS_LIST> m_contourCache;
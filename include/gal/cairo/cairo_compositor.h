@@ -38,6 +38,7 @@
 
 #include <cstdint>
 #include <deque>
+#include <vector>
 
 namespace KIGFX
 {
@@ -87,6 +88,27 @@ public:
     virtual void Present() override;
 
     void SetAntialiasingMode( CAIRO_ANTIALIASING_MODE aMode ); // clears all buffers
+
+    /**
+     * Enable the rasterization of the buffers in horizontal bands, concurrently on the thread
+     * pool.  Clears all buffers.
+     *
+     * The drawing commands are recorded for each band, and are replayed in parallel when the
+     * buffer is composited or when its pixels are needed.  It has no effect if Cairo was built
+     * without the tee surface, or if the thread pool has a single thread.
+     */
+    void SetTiledRendering( bool aEnable );
+
+    /**
+     * Draw directly on the pixels of the buffers instead of recording the drawing commands of
+     * the bands, as needed by the operators depending on the pixels already drawn (e.g.
+     * CAIRO_OPERATOR_CLEAR).  The commands recorded in the current buffer are rasterized first.
+     *
+     * A buffer drawn directly is drawn directly until it is cleared, even after the direct
+     * drawing is disabled: the items interleaved with the negative ones are not worth a
+     * rasterization of the bands each.
+     */
+    void SetDirectDrawing( bool aDirect );
     CAIRO_ANTIALIASING_MODE GetAntialiasingMode() const
     {
         switch( m_currentAntialiasingMode )
@@ -132,8 +154,37 @@ protected:
         cairo_t*            context;        ///< Main texture handle
         cairo_surface_t*    surface;        ///< Point to which an image from texture is attached
         BitmapPtr           bitmap;         ///< Pixel storage
+        cairo_t*            imageContext;   ///< Context drawing on the surface, when tiled
+        cairo_surface_t*    tee;            ///< Surface recording to all the bands, when tiled,
+                                            ///< over a master covering the whole buffer
+        std::vector<cairo_surface_t*> bands; ///< Recording surfaces of the bands, when tiled
+        bool                direct;         ///< Drawn directly on its pixels until cleared
     };
 
+    /// Return the top row of a band of the buffers, or the height of the buffers.
+    unsigned int bandTop( unsigned int aBand, unsigned int aBandCount ) const
+    {
+        return (unsigned int) ( (unsigned long long) m_height * aBand / aBandCount );
+    }
+
+    /// Return the context drawing on a buffer, depending on its direct drawing mode.
+    cairo_t* drawingContext( const CAIRO_BUFFER& aBuffer ) const
+    {
+        return aBuffer.direct && aBuffer.imageContext ? aBuffer.imageContext : aBuffer.context;
+    }
+
+    /// Draw directly on the pixels of a buffer, or record its drawing commands in its bands.
+    void setDirect( CAIRO_BUFFER& aBuffer, bool aDirect );
+
+    /// Create the band recording surfaces of a buffer, and make its context record to them.
+    void createBands( CAIRO_BUFFER& aBuffer );
+
+    /// Rasterize the commands recorded in the bands of a buffer, then discard them.
+    void flush( CAIRO_BUFFER& aBuffer );
+
+    /// Discard the commands recorded in the bands of a buffer.
+    void discard( CAIRO_BUFFER& aBuffer );
+
     unsigned int            m_current;      ///< Currently used buffer handle
     typedef std::deque<CAIRO_BUFFER> CAIRO_BUFFERS;
 
@@ -153,6 +204,9 @@ protected:
     unsigned int m_bufferSize;          ///< Amount of memory needed to store a buffer
 
     cairo_antialias_t       m_currentAntialiasingMode;
+
+    bool m_tiledRendering;              ///< Buffers are rasterized in bands on the thread pool
+    bool m_directDrawing;               ///< Negative items are drawn on the pixels
 };
 } // namespace KIGFX
 
@@ -425,6 +425,9 @@ public:
     /// @copydoc GAL::EndNegativesLayer()
     void EndNegativesLayer() override;
 
+    /// @copydoc GAL::SetNegativeDrawMode()
+    void SetNegativeDrawMode( bool aSetting ) override;
+
     /**
      * Post an event to m_paint_listener.
      *
@@ -124,6 +124,14 @@ public:
 
     std::string GetGerberString() const;
 
+    bool operator==( const GBR_DATA_FIELD& aOther ) const
+    {
+        return m_field == aOther.m_field && m_useUTF8 == aOther.m_useUTF8
+                && m_escapeString == aOther.m_escapeString;
+    }
+
+    bool operator!=( const GBR_DATA_FIELD& aOther ) const { return !( *this == aOther ); }
+
 private:
     wxString m_field;       ///< the Unicode text to print in Gbr file
                             ///< (after escape and quoting)
@@ -180,6 +188,17 @@ public:
         m_ExtraData = aExtraData;
     }
 
+    bool operator==( const GBR_NETLIST_METADATA& aOther ) const
+    {
+        return m_NetAttribType == aOther.m_NetAttribType && m_NotInNet == aOther.m_NotInNet
+                && m_Padname == aOther.m_Padname && m_PadPinFunction == aOther.m_PadPinFunction
+                && m_Cmpref == aOther.m_Cmpref && m_Netname == aOther.m_Netname
+                && m_ExtraData == aOther.m_ExtraData
+                && m_TryKeepPreviousAttributes == aOther.m_TryKeepPreviousAttributes;
+    }
+
+    bool operator!=( const GBR_NETLIST_METADATA& aOther ) const { return !( *this == aOther ); }
+
     /**
      * Remove the net attribute specified by \a aName.
      *
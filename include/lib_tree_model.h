@@ -25,6 +25,7 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <unordered_map>
 #include <wx/string.h>
 #include <lib_tree_item.h>
 
@@ -52,6 +53,8 @@ class EDA_COMBINED_MATCHER;
  * Quick summary of methods used to drive this class:
  *
  * - `UpdateScore()` - accumulate scores recursively given a new search token
+ * - `LIB_TREE_NODE_ROOT::UpdateSearchScore()` - score the whole tree for a
+ *      tokenized search string, using the search index
  * - `ResetScore()` - reset scores recursively for a new search string
  * - `AssignIntrinsicRanks()` - calculate and cache the initial sort order
  * - `SortNodes()` - recursively sort the tree by score
@@ -107,7 +110,13 @@ public:
     static int Compare( LIB_TREE_NODE const& aNode1, LIB_TREE_NODE const& aNode2 );
 
     LIB_TREE_NODE();
-    virtual ~LIB_TREE_NODE() {}
+    virtual ~LIB_TREE_NODE();
+
+    /**
+     * Return a number which changes each time a node is created, deleted or updated.  Used to
+     * know when cached data about the nodes (e.g. the search index) must be rebuilt.
+     */
+    static unsigned long long GetRevision();
 
     enum TYPE {
         ROOT, LIB, LIBID, UNIT, INVALID
@@ -210,6 +219,11 @@ public:
      */
     void Update( LIB_TREE_ITEM* aItem );
 
+    /**
+     * Normalize m_MatchName and m_SearchText for matching, if not already done.
+     */
+    void Normalize();
+
     /**
      * Perform the actual search.
      */
@@ -282,6 +296,40 @@ public:
     LIB_TREE_NODE_LIB& AddLib( wxString const& aName, wxString const& aDesc );
 
     virtual void UpdateScore( EDA_COMBINED_MATCHER& aMatcher, const wxString& aLib ) override;
+
+    /**
+     * Score the tree for a whole search string.
+     *
+     * This gives the same scores as calling UpdateScore() for each term, but the pattern
+     * matching only runs on the nodes that can match: for plain text terms, a trigram index
+     * of the names and search texts (built on first use, and rebuilt when the tree changes)
+     * gives the candidates.  When the search string only extends the previous one, the nodes
+     * which did not match the previous search are not scored again.
+     *
+     * @param aTerms is the list of (library filter, term) pairs of the search string, lowercase.
+     */
+    void UpdateSearchScore( const std::vector<std::pair<wxString, wxString>>& aTerms );
+
+private:
+    void buildSearchIndex();
+
+    /**
+     * Set the score of the indexed nodes which cannot match \a aTerm to zero.
+     */
+    void filterCandidates( const wxString& aTerm );
+
+    /// #LIB_TREE_NODE_LIB_ID nodes in the index, in tree order
+    std::vector<LIB_TREE_NODE*>                      m_indexedNodes;
+
+    /// Packed trigram -> sorted indices in m_indexedNodes of the nodes containing it
+    std::unordered_map<unsigned long long, std::vector<int>> m_trigramIndex;
+
+    unsigned long long                               m_indexRevision;
+    bool                                             m_indexValid;
+
+    /// The previous search, used to refine results when the search string is extended
+    std::vector<std::pair<wxString, wxString>>       m_lastTerms;
+    std::vector<bool>                                m_lastMatches;
 };
 
 
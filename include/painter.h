@@ -95,6 +95,19 @@ public:
      */
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) = 0;
 
+    /**
+     * Compute the geometry an item caches for drawing, such as the triangulation of its
+     * polygons, ahead of drawing it.
+     *
+     * The view calls it on the thread pool for the items to recache, before drawing them in
+     * turn, so it must not use the GAL drawing functions nor any data shared between items.
+     *
+     * @param aItem is an item about to be drawn to the cached layers.
+     * @param aUpdateFlags are the #VIEW_UPDATE_FLAGS of the update of the item, so only the
+     *                     geometry changed is computed again.
+     */
+    virtual void PrecacheItem( const VIEW_ITEM* aItem, int aUpdateFlags ) {}
+
 protected:
     /// Instance of graphic abstraction layer that gives an interface to call
     /// commands used to draw (eg. DrawLine, DrawCircle, etc.)
@@ -0,0 +1,120 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/gpl-3.0.html
+ * or you may search the http://www.gnu.org website for the version 3 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef PLOT_LINE_FORMATTER_H_
+#define PLOT_LINE_FORMATTER_H_
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+
+/**
+ * Build a plotter command line made of literals and integer values, and write it in one call.
+ *
+ * This is a replacement for fprintf() in the hot paths of the plotters (coordinates of
+ * segments, flashes and region vertices): the integers are converted without going through
+ * the printf format parser and nothing is allocated, the line lives on the stack.  The output
+ * is byte-identical to the equivalent "%d" / "%02d" printf formats.
+ *
+ * Lines longer than the internal buffer are truncated, so this must only be used for short
+ * commands whose maximum length is known.
+ */
+class PLOT_LINE_FORMATTER
+{
+public:
+    PLOT_LINE_FORMATTER() :
+            m_end( m_buffer )
+    {}
+
+    /// Append a literal string.
+    PLOT_LINE_FORMATTER& Str( const char* aText )
+    {
+        size_t len = std::min( strlen( aText ), room() );
+
+        memcpy( m_end, aText, len );
+        m_end += len;
+        return *this;
+    }
+
+    /// Append a single char.
+    PLOT_LINE_FORMATTER& Char( char aChar )
+    {
+        if( room() )
+            *m_end++ = aChar;
+
+        return *this;
+    }
+
+    /// Append \a aValue, formatted like "%d".
+    PLOT_LINE_FORMATTER& Int( int aValue )
+    {
+        // Digits are generated backwards into a scratch area large enough for INT_MIN
+        char         digits[12];
+        char*        p = digits + sizeof( digits );
+        unsigned int magnitude = aValue < 0 ? 0U - static_cast<unsigned int>( aValue )
+                                            : static_cast<unsigned int>( aValue );
+
+        do
+        {
+            *--p = static_cast<char>( '0' + magnitude % 10 );
+            magnitude /= 10;
+        } while( magnitude );
+
+        if( aValue < 0 )
+            *--p = '-';
+
+        size_t len = std::min( static_cast<size_t>( digits + sizeof( digits ) - p ), room() );
+
+        memcpy( m_end, p, len );
+        m_end += len;
+        return *this;
+    }
+
+    /// Append \a aValue, formatted like "%02d".
+    PLOT_LINE_FORMATTER& Int02( int aValue )
+    {
+        if( aValue >= 0 && aValue < 10 )
+            Char( '0' );
+
+        return Int( aValue );
+    }
+
+    /// Write the line to \a aFile, and reset the formatter for a new line.
+    void Write( FILE* aFile )
+    {
+        fwrite( m_buffer, 1, m_end - m_buffer, aFile );
+        m_end = m_buffer;
+    }
+
+    const char* GetData() const { return m_buffer; }
+    size_t      GetLength() const { return m_end - m_buffer; }
+
+private:
+    size_t room() const { return m_buffer + sizeof( m_buffer ) - m_end; }
+
+    char  m_buffer[256];
+    char* m_end;
+};
+
+#endif    // PLOT_LINE_FORMATTER_H_
@@ -113,6 +113,10 @@ public:
     static const int DO_NOT_SET_LINE_WIDTH = -2;    // Skip selection
     static const int USE_DEFAULT_LINE_WIDTH = -1;   // use the default pen
 
+    // Size of the stdio buffer of the output file.  Plot files are written in many small
+    // chunks, so a large buffer keeps the number of write system calls low.
+    static const size_t OUTPUT_FILE_BUFFER_SIZE = 256 * 1024;
+
     PLOTTER();
 
     virtual ~PLOTTER();
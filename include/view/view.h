@@ -802,6 +802,9 @@ protected:
     ///< Update all information needed to draw an item
     void updateItemGeometry( VIEW_ITEM* aItem, int aLayer );
 
+    ///< Let the painter compute the cached geometry of the items to redraw, in parallel
+    void precacheItems( const std::vector<VIEW_ITEM*>& aItems );
+
     ///< Update bounding box of an item
     void updateBbox( VIEW_ITEM* aItem );
 
@@ -839,6 +842,9 @@ protected:
     ///< Flat list of all items.
     std::shared_ptr<std::vector<VIEW_ITEM*>> m_allItems;
 
+    ///< Items marked for update by Update(), to be processed by UpdateItems().
+    std::shared_ptr<std::vector<VIEW_ITEM*>> m_dirtyItems;
+
     ///< The set of layers that are displayed on the top.
     std::set<unsigned int>             m_topLayers;
 
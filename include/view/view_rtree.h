@@ -29,6 +29,8 @@
 
 #include <math/box2.h>
 
+#include <vector>
+
 #include <geometry/rtree.h>
 
 namespace KIGFX
@@ -55,6 +57,32 @@ public:
         VIEW_RTREE_BASE::Insert( mmin, mmax, aItem );
     }
 
+    /**
+     * Replace the content of the tree by a set of items, packed at once.
+     *
+     * This is much faster than inserting the items one by one, and gives a tree that is faster
+     * to query.
+     */
+    void BulkLoad( const std::vector<VIEW_ITEM*>& aItems )
+    {
+        std::vector<std::pair<Rect, VIEW_ITEM*>> entries;
+        entries.reserve( aItems.size() );
+
+        for( VIEW_ITEM* item : aItems )
+        {
+            const BOX2I& bbox = item->ViewBBox();
+            Rect         rect;
+
+            rect.m_min[0] = bbox.GetX();
+            rect.m_min[1] = bbox.GetY();
+            rect.m_max[0] = bbox.GetRight();
+            rect.m_max[1] = bbox.GetBottom();
+            entries.emplace_back( rect, item );
+        }
+
+        VIEW_RTREE_BASE::BulkLoad( entries );
+    }
+
     /**
      * Remove an item from the tree.
      *
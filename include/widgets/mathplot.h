@@ -77,6 +77,8 @@
 
 
 #include <deque>
+#include <functional>
+#include <utility>
 
 #include <algorithm>
 
@@ -579,6 +581,88 @@ protected:
     DECLARE_DYNAMIC_CLASS( mpFY )
 };
 
+/** Builds the lines of a continuous plot from the pixel coordinates of its points.
+ *  The line goes through the first of the consecutive points in a same pixel column, and the
+ *  lowest and highest of them are joined by a vertical line.  Only the points in the pixel
+ *  columns \a startPx - 1 to \a endPx are used.
+ */
+class WXDLLIMPEXP_MATHPLOT mpContinuousLine
+{
+public:
+    mpContinuousLine( wxCoord startPx, wxCoord endPx );
+
+    /** Add the next point of the plot. */
+    void AddPoint( wxCoord x, wxCoord y );
+
+    /** @return the vertical lines, to be drawn before the line. */
+    const std::vector<std::pair<wxPoint, wxPoint>>& GetVerticalLines() const
+    {
+        return m_verticalLines;
+    }
+
+    /** @return the points of the line, without the inner points of its horizontal segments. */
+    std::vector<wxPoint> GetLinePoints() const;
+
+private:
+    wxCoord m_startPx, m_endPx;
+
+    std::vector<wxPoint>                     m_points;          // !< First point of each column
+    std::vector<std::pair<wxPoint, wxPoint>> m_verticalLines;
+
+    int m_ymin0;        // !< y min coord of merged current vertical line
+    int m_ymax0;        // !< y max coord of merged current vertical line
+    int m_dupx0;        // !< count of currently merged vertical lines
+};
+
+
+/** Selects the points of a continuous plot needed to draw it at the screen resolution.
+ *  Only the first, lowest, highest and last points of each run of points in a same pixel column
+ *  change the lines built by mpContinuousLine, and another point of the run when there are
+ *  only two of them, so the same vertical line is drawn.  The points out of the drawing area
+ *  are merged in the columns next to it, which are not drawn.
+ *
+ *  The indices of the selected points are kept until the view changes, and are extended when
+ *  points are appended to the data.
+ */
+class WXDLLIMPEXP_MATHPLOT mpLineDecimator
+{
+public:
+    mpLineDecimator();
+
+    /** Select the points of the data \a xs, \a ys to plot in the pixel columns \a startPx
+     *  to \a endPx, extending the previous selection if the view has not changed.  The data
+     *  must only have been appended to since the previous call, otherwise call Clear() first.
+     *  @param transformX gives the plot coordinate of a x value, as mpScaleBase::TransformToPlot
+     *  @param posX the view position, as mpWindow::GetPosX
+     *  @param scaleX the view scale, as mpWindow::GetScaleX
+     */
+    void Update( const std::vector<double>& xs, const std::vector<double>& ys,
+                 const std::function<double( double )>& transformX, double posX, double scaleX,
+                 wxCoord startPx, wxCoord endPx );
+
+    /** Forget the selection, when the data has changed. */
+    void Clear();
+
+    /** @return the indices of the points to plot, in the data order. */
+    const std::vector<size_t>& GetIndices() const { return m_indices; }
+
+private:
+    struct RUN
+    {
+        double column;
+        size_t first, min, max, last;
+    };
+
+    void appendLastRun();
+
+    std::vector<size_t> m_indices;      // !< Indices of the points to plot
+    size_t              m_count;        // !< Count of data points selected from
+    size_t              m_lastRunStart; // !< Start of the last run in m_indices
+    RUN                 m_lastRun;      // !< The last run, which can get more points
+    std::vector<double> m_view;         // !< The view m_indices was built for
+};
+
+
 /** Abstract base class providing plot and labeling functionality for a locus plot F:N->X,Y.
  *  Locus argument N is assumed to be in range 0 .. MAX_N, and implicitly derived by enumerating
  *  all locus values. Override mpFXY::Rewind and mpFXY::GetNextXY to implement a locus.
@@ -638,6 +722,12 @@ protected:
      */
     void UpdateViewBoundary( wxCoord xnew, wxCoord ynew );
 
+    /** Rewind value enumeration before plotting a continuous line in the pixel columns
+     *  \a startPx to \a endPx of \a w.  The layer can then enumerate only the points needed
+     *  to draw the line at the screen resolution.  The default enumerates all the points.
+     */
+    virtual void RewindForPlot( mpWindow& w, wxCoord startPx, wxCoord endPx ) { Rewind(); }
+
     DECLARE_DYNAMIC_CLASS( mpFXY )
 };
 
@@ -1578,9 +1668,10 @@ public:
 
     /** Changes the internal data: the set of points to draw.
      *  Both vectors MUST be of the same length. This method DOES NOT refresh the mpWindow; do it manually.
+     *  The vectors are moved to the layer when given as temporaries.
      * @sa Clear
      */
-    virtual void SetData( const std::vector<double>& xs, const std::vector<double>& ys );
+    virtual void SetData( std::vector<double> xs, std::vector<double> ys );
 
     /** Clears all the data, leaving the layer empty.
      * @sa SetData
@@ -1596,6 +1687,13 @@ protected:
      */
     size_t m_index;
 
+    /** The points to plot a continuous line, kept until the view or the data changes
+     */
+    mpLineDecimator m_decimator;
+    bool            m_plotDecimated;    // !< GetNextXY enumerates the decimated points
+
+    void RewindForPlot( mpWindow& w, wxCoord startPx, wxCoord endPx ) override;
+
     /** Loaded at SetData
      */
     double m_minX, m_maxX, m_minY, m_maxY;
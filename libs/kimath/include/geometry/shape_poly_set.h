@@ -513,6 +513,12 @@ public:
 
     MD5_HASH GetHash() const;
 
+    /**
+     * Return the hash of the polygons as they are now, unlike GetHash() which returns the hash
+     * cached by the last triangulation when there is one.
+     */
+    MD5_HASH GetChecksum() const { return checksum(); }
+
     virtual bool HasIndexableSubshapes() const override;
 
     virtual size_t GetIndexableSubshapeCount() const override;
@@ -21,6 +21,7 @@
 
 #include "sexpr/sexpr.h"
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -37,6 +38,35 @@ namespace SEXPR
         std::unique_ptr<SEXPR> ParseFromFile( const std::string& aFilename );
         static std::string GetFileContents( const std::string& aFilename );
 
+        /// Receives an element of the list read by ParseList(); returns false to stop parsing.
+        typedef std::function<bool( std::unique_ptr<SEXPR> aElement )> ELEMENT_HANDLER;
+
+        /// Tells from its leading symbol if a list element of the list read by ParseList()
+        /// is needed.
+        typedef std::function<bool( const std::string& aSymbol )> ELEMENT_FILTER;
+
+        /**
+         * Parse a single list, handing each of its elements to \a aHandler as soon as it is
+         * parsed instead of building the whole tree, so only one element of the list is held
+         * in memory at a time.
+         *
+         * @param aHandler receives the elements of the list in order, including the leading
+         *                 symbol.
+         * @param aFilter is called with the leading symbol of the elements which are lists, the
+         *                elements it rejects are skipped without being built.  Optional.
+         * @return false if the parsing was stopped by \a aHandler.
+         * @throw PARSE_EXCEPTION if the list is not valid.
+         */
+        bool ParseList( const std::string& aString, const ELEMENT_HANDLER& aHandler,
+                        const ELEMENT_FILTER& aFilter = nullptr );
+
+        /**
+         * Parse the single list of a file as ParseList() does, reading the file in chunks
+         * instead of loading it all.
+         */
+        bool ParseListFromFile( const std::string& aFilename, const ELEMENT_HANDLER& aHandler,
+                                const ELEMENT_FILTER& aFilter = nullptr );
+
     private:
         std::unique_ptr<SEXPR> parseString(
                 const std::string& aString, std::string::const_iterator& it );
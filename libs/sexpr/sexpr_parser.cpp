@@ -19,9 +19,12 @@
 #include "sexpr/sexpr_parser.h"
 #include "sexpr/sexpr_exception.h"
 #include <cctype>
+#include <cstdio>      /* EOF */
 #include <cstdlib>     /* strtod */
+#include <cstring>
 #include <iterator>
 #include <stdexcept>
+#include <vector>
 
 #include <fstream>
 #include <streambuf>
@@ -32,7 +35,334 @@
 
 namespace SEXPR
 {
-    const std::string PARSER::whitespaceCharacters = " \t\n\r\b\f\v";
+namespace
+{
+    const char WHITESPACE_CHARACTERS[] = " \t\n\r\b\f\v";
+
+
+    bool isWhitespace( int aChar )
+    {
+        return aChar != EOF && aChar != 0 && strchr( WHITESPACE_CHARACTERS, aChar ) != nullptr;
+    }
+
+
+    /**
+     * Create the atom of a token which is not a string: a number if it is made of digits,
+     * otherwise a symbol.
+     */
+    std::unique_ptr<SEXPR> makeAtom( const std::string& aToken, int aLineNumber )
+    {
+        if( aToken.find_first_not_of( "0123456789." ) == std::string::npos ||
+            ( aToken.size() > 1 && aToken[0] == '-'
+              && aToken.find_first_not_of( "0123456789.", 1 ) == std::string::npos ) )
+        {
+            if( aToken.find( '.' ) != std::string::npos )
+            {
+                //floating point type
+                return std::make_unique<SEXPR_DOUBLE>( strtod( aToken.c_str(), nullptr ),
+                                                       aLineNumber );
+            }
+            else
+            {
+                return std::make_unique<SEXPR_INTEGER>( strtoll( aToken.c_str(), nullptr, 0 ),
+                                                        aLineNumber );
+            }
+        }
+
+        return std::make_unique<SEXPR_SYMBOL>( aToken, aLineNumber );
+    }
+
+
+    /// Reads the characters of a string, for ParseList().
+    class STRING_SOURCE
+    {
+    public:
+        explicit STRING_SOURCE( const std::string& aString ) :
+                m_string( aString ),
+                m_pos( 0 ),
+                m_lineNumber( 1 )
+        {
+        }
+
+        int Peek() const
+        {
+            return m_pos < m_string.size() ? (unsigned char) m_string[m_pos] : EOF;
+        }
+
+        int Get()
+        {
+            const int ch = Peek();
+
+            if( ch != EOF )
+            {
+                ++m_pos;
+
+                if( ch == '\n' )
+                    ++m_lineNumber;
+            }
+
+            return ch;
+        }
+
+        int LineNumber() const { return m_lineNumber; }
+
+    private:
+        const std::string& m_string;
+        size_t             m_pos;
+        int                m_lineNumber;
+    };
+
+
+    /// Reads the characters of a file through a buffer of fixed size, for ParseListFromFile().
+    class FILE_SOURCE
+    {
+    public:
+        explicit FILE_SOURCE( const std::string& aFileName ) :
+                m_buffer( BUFFER_SIZE ),
+                m_pos( 0 ),
+                m_end( 0 ),
+                m_lineNumber( 1 )
+        {
+            // the filename is not always a UTF7 string, so do not use ifstream
+            // that do not work with unicode chars.
+            if( !m_file.Open( FROM_UTF8( aFileName.c_str() ), "rb" ) )
+                throw PARSE_EXCEPTION( "Error occurred attempting to read in file" );
+        }
+
+        int Peek()
+        {
+            if( m_pos == m_end )
+            {
+                m_pos = 0;
+                m_end = m_file.Read( m_buffer.data(), m_buffer.size() );
+
+                if( m_end == 0 )
+                    return EOF;
+            }
+
+            return (unsigned char) m_buffer[m_pos];
+        }
+
+        int Get()
+        {
+            const int ch = Peek();
+
+            if( ch != EOF )
+            {
+                ++m_pos;
+
+                if( ch == '\n' )
+                    ++m_lineNumber;
+            }
+
+            return ch;
+        }
+
+        int LineNumber() const { return m_lineNumber; }
+
+    private:
+        static constexpr size_t BUFFER_SIZE = 1 << 16;
+
+        wxFFile           m_file;
+        std::vector<char> m_buffer;
+        size_t            m_pos;
+        size_t            m_end;
+        int               m_lineNumber;
+    };
+
+
+    template <typename SOURCE>
+    void skipWhitespace( SOURCE& aSource )
+    {
+        while( isWhitespace( aSource.Peek() ) )
+            aSource.Get();
+    }
+
+
+    /// Read the rest of a quoted string, the escaped characters are kept as they are.
+    template <typename SOURCE>
+    std::string readString( SOURCE& aSource )
+    {
+        std::string str;
+
+        for( int ch = aSource.Get(); ch != '"'; ch = aSource.Get() )
+        {
+            if( ch == EOF )
+                throw PARSE_EXCEPTION( "missing closing quote" );
+
+            str.push_back( (char) ch );
+
+            if( ch == '\\' )
+            {
+                // Keep the next escaped character
+                ch = aSource.Get();
+
+                if( ch == EOF )
+                    throw PARSE_EXCEPTION( "missing closing quote" );
+
+                str.push_back( (char) ch );
+            }
+        }
+
+        return str;
+    }
+
+
+    template <typename SOURCE>
+    std::unique_ptr<SEXPR> parseElement( SOURCE& aSource );
+
+
+    /// Parse the elements of a list up to its closing parenthesis.
+    template <typename SOURCE>
+    void parseListElements( SOURCE& aSource, SEXPR_LIST& aList )
+    {
+        while( true )
+        {
+            skipWhitespace( aSource );
+
+            const int ch = aSource.Peek();
+
+            if( ch == EOF )
+                throw PARSE_EXCEPTION( "missing closing parenthesis" );
+
+            if( ch == ')' )
+            {
+                aSource.Get();
+                return;
+            }
+
+            aList.AddChild( parseElement( aSource ).release() );
+        }
+    }
+
+
+    /// Skip the elements of a list up to its closing parenthesis, without building them.
+    template <typename SOURCE>
+    void skipListElements( SOURCE& aSource )
+    {
+        int depth = 1;
+
+        while( depth > 0 )
+        {
+            const int ch = aSource.Get();
+
+            if( ch == EOF )
+                throw PARSE_EXCEPTION( "missing closing parenthesis" );
+            else if( ch == '(' )
+                depth++;
+            else if( ch == ')' )
+                depth--;
+            else if( ch == '"' )
+                readString( aSource );
+        }
+    }
+
+
+    template <typename SOURCE>
+    std::unique_ptr<SEXPR> parseElement( SOURCE& aSource )
+    {
+        skipWhitespace( aSource );
+
+        const int lineNumber = aSource.LineNumber();
+        const int ch = aSource.Get();
+
+        if( ch == '(' )
+        {
+            auto list = std::make_unique<SEXPR_LIST>( lineNumber );
+            parseListElements( aSource, *list );
+            return list;
+        }
+        else if( ch == '"' )
+        {
+            return std::make_unique<SEXPR_STRING>( readString( aSource ), lineNumber );
+        }
+        else if( ch == ')' )
+        {
+            throw PARSE_EXCEPTION( "unexpected closing parenthesis" );
+        }
+        else if( ch == EOF )
+        {
+            throw PARSE_EXCEPTION( "unexpected end of file" );
+        }
+
+        std::string token( 1, (char) ch );
+
+        for( int next = aSource.Peek(); next != EOF && next != '(' && next != ')'
+                                        && !isWhitespace( next ); next = aSource.Peek() )
+        {
+            token.push_back( (char) aSource.Get() );
+        }
+
+        return makeAtom( token, lineNumber );
+    }
+
+
+    template <typename SOURCE>
+    bool parseList( SOURCE& aSource, const PARSER::ELEMENT_HANDLER& aHandler,
+                    const PARSER::ELEMENT_FILTER& aFilter )
+    {
+        skipWhitespace( aSource );
+
+        if( aSource.Get() != '(' )
+            throw PARSE_EXCEPTION( "expecting a list" );
+
+        while( true )
+        {
+            skipWhitespace( aSource );
+
+            const int lineNumber = aSource.LineNumber();
+            const int ch = aSource.Peek();
+
+            if( ch == EOF )
+                throw PARSE_EXCEPTION( "missing closing parenthesis" );
+
+            if( ch == ')' )
+            {
+                aSource.Get();
+                return true;
+            }
+
+            std::unique_ptr<SEXPR> element;
+
+            if( ch == '(' && aFilter )
+            {
+                aSource.Get();
+                skipWhitespace( aSource );
+
+                // The leading symbol of the element tells if it is needed
+                std::unique_ptr<SEXPR> head;
+                const int              headCh = aSource.Peek();
+
+                if( headCh != '(' && headCh != ')' && headCh != '"' && headCh != EOF )
+                    head = parseElement( aSource );
+
+                if( head && head->IsSymbol() && !aFilter( head->GetSymbol() ) )
+                {
+                    skipListElements( aSource );
+                    continue;
+                }
+
+                auto list = std::make_unique<SEXPR_LIST>( lineNumber );
+
+                if( head )
+                    list->AddChild( head.release() );
+
+                parseListElements( aSource, *list );
+                element = std::move( list );
+            }
+            else
+            {
+                element = parseElement( aSource );
+            }
+
+            if( !aHandler( std::move( element ) ) )
+                return false;
+        }
+    }
+}
+
+
+    const std::string PARSER::whitespaceCharacters = WHITESPACE_CHARACTERS;
 
     PARSER::PARSER() : m_lineNumber( 1 )
     {
@@ -56,6 +386,21 @@ namespace SEXPR
         return parseString( str, it );
     }
 
+    bool PARSER::ParseList( const std::string& aString, const ELEMENT_HANDLER& aHandler,
+                            const ELEMENT_FILTER& aFilter )
+    {
+        STRING_SOURCE source( aString );
+        return parseList( source, aHandler, aFilter );
+    }
+
+    bool PARSER::ParseListFromFile( const std::string& aFileName,
+                                    const ELEMENT_HANDLER& aHandler,
+                                    const ELEMENT_FILTER& aFilter )
+    {
+        FILE_SOURCE source( aFileName );
+        return parseList( source, aHandler, aFilter );
+    }
+
     std::string PARSER::GetFileContents( const std::string &aFileName )
     {
         std::string str;
@@ -163,34 +508,8 @@ namespace SEXPR
 
                 if( closingPos != std::string::npos )
                 {
-                    if( tmp.find_first_not_of( "0123456789." ) == std::string::npos ||
-                        ( tmp.size() > 1 && tmp[0] == '-'
-                          && tmp.find_first_not_of( "0123456789.", 1 ) == std::string::npos ) )
-                    {
-                        std::unique_ptr<SEXPR> res;
-
-                        if( tmp.find( '.' ) != std::string::npos )
-                        {
-                            res = std::make_unique<SEXPR_DOUBLE>(
-                                    strtod( tmp.c_str(), nullptr ), m_lineNumber );
-                            //floating point type
-                        }
-                        else
-                        {
-                            res = std::make_unique<SEXPR_INTEGER>(
-                                    strtoll( tmp.c_str(), nullptr, 0 ), m_lineNumber );
-                        }
-
-                        std::advance( it, closingPos - startPos );
-                        return res;
-                    }
-                    else
-                    {
-                        auto str = std::make_unique<SEXPR_SYMBOL>( tmp, m_lineNumber );
-                        std::advance( it, closingPos - startPos );
-
-                        return str;
-                    }
+                    std::advance( it, closingPos - startPos );
+                    return makeAtom( tmp, m_lineNumber );
                 }
                 else
                 {
@@ -31,6 +31,7 @@
 #include <pcb_edit_frame.h>
 #include <pcbnew_settings.h>
 #include <pcbplot.h>
+#include <advanced_config.h>
 #include <pgm_base.h>
 #include <gerber_jobfile_writer.h>
 #include <reporter.h>
@@ -1011,7 +1012,8 @@ void DIALOG_PLOT::Plot( wxCommandEvent& event )
     // Save the current plot options in the board
     m_parent->SetPlotSettings( m_plotOpts );
 
-    wxBusyCursor dummy;
+    wxBusyCursor                dummy;
+    std::vector<PLOT_BATCH_JOB> plotJobs;
 
     for( LSEQ seq = m_plotOpts.GetLayerSelection().UIOrder();  seq;  ++seq )
     {
@@ -1067,36 +1069,33 @@ void DIALOG_PLOT::Plot( wxCommandEvent& event )
         wxString fullname = fn.GetFullName();
         jobfile_writer.AddGbrFile( layer, fullname );
 
-        LOCALE_IO toggle;
-
         //@todo allow controlling the sheet name and path that will be displayed in the title block
         // Leave blank for now
-        PLOTTER* plotter = StartPlotBoard( board, &m_plotOpts, layer, fn.GetFullPath(),
-                                           wxEmptyString, wxEmptyString );
+        plotJobs.emplace_back( layer, plotSequence, fn.GetFullPath() );
+    }
 
-        // Print diags in messages box:
+    // Each file has its own plotter, so they can be created concurrently
+    PlotBoardBatch( board, m_plotOpts, plotJobs, ADVANCED_CFG::GetCfg().m_ParallelPlot );
+
+    // Print diags in messages box:
+    for( const PLOT_BATCH_JOB& job : plotJobs )
+    {
         wxString msg;
 
-        if( plotter )
+        if( job.m_Success )
         {
-            PlotBoardLayers( board, plotter, plotSequence, m_plotOpts );
-            PlotInteractiveLayer( board, plotter );
-            plotter->EndPlot();
-            delete plotter->RenderSettings();
-            delete plotter;
-
-            msg.Printf( _( "Plotted to '%s'." ), fn.GetFullPath() );
+            msg.Printf( _( "Plotted to '%s'." ), job.m_FullFileName );
             reporter.Report( msg, RPT_SEVERITY_ACTION );
         }
         else
         {
-            msg.Printf( _( "Failed to create file '%s'." ), fn.GetFullPath() );
+            msg.Printf( _( "Failed to create file '%s'." ), job.m_FullFileName );
             reporter.Report( msg, RPT_SEVERITY_ERROR );
         }
-
-        wxSafeYield();      // displays report message.
     }
 
+    wxSafeYield();      // displays report messages.
+
     if( m_plotOpts.GetFormat() == PLOT_FORMAT::GERBER && m_plotOpts.GetCreateGerberJobFile() )
     {
         // Pick the basename from the board file
@@ -141,7 +141,11 @@ bool DRC_CACHE_GENERATOR::Run()
     };
 
     forEachGeometryItem( itemTypes, LSET::AllCuMask(), countItems );
+
+    // The copper item trees are packed once all the items are gathered
+    m_board->m_CopperItemRTreeCache->StartBulkLoad();
     forEachGeometryItem( itemTypes, LSET::AllCuMask(), addToCopperTree );
+    m_board->m_CopperItemRTreeCache->FinishBulkLoad();
 
     if( !reportPhase( _( "Tessellating copper zones..." ) ) )
         return false;   // DRC cancelled
@@ -76,6 +76,7 @@ public:
 private:
 
     using drc_rtree = RTree<ITEM_WITH_SHAPE*, int, 2, double>;
+    using BULK_ENTRY = std::pair<drc_rtree::Rect, ITEM_WITH_SHAPE*>;
 
 public:
 
@@ -85,6 +86,7 @@ public:
             m_tree[layer] = new drc_rtree();
 
         m_count = 0;
+        m_bulkLoading = false;
     }
 
     ~DRC_RTREE()
@@ -96,6 +98,12 @@ public:
 
             delete tree;
         }
+
+        for( const std::vector<BULK_ENTRY>& entries : m_bulkEntries )
+        {
+            for( const BULK_ENTRY& entry : entries )
+                delete entry.second;
+        }
     }
 
     /**
@@ -135,12 +143,7 @@ public:
 
             bbox.Inflate( aWorstClearance );
 
-            const int        mmin[2] = { bbox.GetX(), bbox.GetY() };
-            const int        mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
-            ITEM_WITH_SHAPE* itemShape = new ITEM_WITH_SHAPE( aItem, subshape, shape );
-
-            m_tree[aTargetLayer]->Insert( mmin, mmax, itemShape );
-            m_count++;
+            insert( aTargetLayer, bbox, new ITEM_WITH_SHAPE( aItem, subshape, shape ) );
         }
 
         if( aItem->Type() == PCB_PAD_T && aItem->HasHole() )
@@ -150,14 +153,37 @@ public:
 
             bbox.Inflate( aWorstClearance );
 
-            const int        mmin[2] = { bbox.GetX(), bbox.GetY() };
-            const int        mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
-            ITEM_WITH_SHAPE* itemShape = new ITEM_WITH_SHAPE( aItem, hole, shape );
+            insert( aTargetLayer, bbox, new ITEM_WITH_SHAPE( aItem, hole, shape ) );
+        }
+    }
 
-            m_tree[aTargetLayer]->Insert( mmin, mmax, itemShape );
-            m_count++;
+    /**
+     * Defer the insertion of the items into the trees until FinishBulkLoad() is called, which
+     * packs each tree at once.  This is much faster than inserting a large number of items one
+     * by one, and gives trees that are faster to query.  The trees must be empty.
+     */
+    void StartBulkLoad()
+    {
+        wxASSERT( m_count == 0 );
+        m_bulkLoading = true;
+    }
 
+    /**
+     * Build the trees from the items inserted since StartBulkLoad().
+     */
+    void FinishBulkLoad()
+    {
+        for( int layer = 0; layer < PCB_LAYER_ID_COUNT; ++layer )
+        {
+            if( !m_bulkEntries[layer].empty() )
+            {
+                m_tree[layer]->BulkLoad( m_bulkEntries[layer] );
+                m_bulkEntries[layer].clear();
+                m_bulkEntries[layer].shrink_to_fit();
+            }
         }
+
+        m_bulkLoading = false;
     }
 
     /**
@@ -168,7 +194,16 @@ public:
         for( auto tree : m_tree )
             tree->RemoveAll();
 
+        for( std::vector<BULK_ENTRY>& entries : m_bulkEntries )
+        {
+            for( const BULK_ENTRY& entry : entries )
+                delete entry.second;
+
+            entries.clear();
+        }
+
         m_count = 0;
+        m_bulkLoading = false;
     }
 
     bool CheckColliding( SHAPE* aRefShape, PCB_LAYER_ID aTargetLayer, int aClearance = 0,
@@ -570,8 +605,28 @@ public:
 
 
 private:
-    drc_rtree*  m_tree[PCB_LAYER_ID_COUNT];
-    size_t      m_count;
+    void insert( PCB_LAYER_ID aLayer, const BOX2I& aBBox, ITEM_WITH_SHAPE* aItemShape )
+    {
+        drc_rtree::Rect rect;
+
+        rect.m_min[0] = aBBox.GetX();
+        rect.m_min[1] = aBBox.GetY();
+        rect.m_max[0] = aBBox.GetRight();
+        rect.m_max[1] = aBBox.GetBottom();
+
+        if( m_bulkLoading )
+            m_bulkEntries[aLayer].emplace_back( rect, aItemShape );
+        else
+            m_tree[aLayer]->Insert( rect.m_min, rect.m_max, aItemShape );
+
+        m_count++;
+    }
+
+    drc_rtree*              m_tree[PCB_LAYER_ID_COUNT];
+    size_t                  m_count;
+
+    bool                    m_bulkLoading;
+    std::vector<BULK_ENTRY> m_bulkEntries[PCB_LAYER_ID_COUNT];
 };
 
 
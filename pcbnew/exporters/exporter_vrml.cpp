@@ -45,6 +45,7 @@
 #include "streamwrapper.h"
 #include "vrml_layer.h"
 #include "pcb_edit_frame.h"
+#include <thread_pool.h>
 
 #include <convert_basic_shapes_to_polygon.h>
 #include <geometry/geometry_utils.h>
@@ -539,10 +540,42 @@ void EXPORTER_PCB_VRML::write_triangle_bag( std::ostream& aOut_file, const VRML_
 }
 
 
+void EXPORTER_PCB_VRML::tesselateLayers()
+{
+    VRML_LAYER* cutLayers[] = { &m_3D_board, &m_top_copper, &m_top_paste, &m_top_soldermask,
+                                &m_bot_copper, &m_bot_paste, &m_bot_soldermask, &m_top_silk,
+                                &m_bot_silk };
+    const int   cutLayerCount = arrayDim( cutLayers );
+
+    // The tesselation renumbers the vertices of the holes, so each layer cut by the holes
+    // gets its own copy of them to be tesselated concurrently with the other layers.
+    m_layerHoles.clear();
+    m_layerHoles.resize( cutLayerCount );
+
+    GetKiCadThreadPool().parallelize_loop( 0, cutLayerCount + 1,
+            [&]( const int a, const int b )
+            {
+                for( int ii = a; ii < b; ++ii )
+                {
+                    if( ii == cutLayerCount )
+                    {
+                        m_plated_holes.Tesselate( nullptr, true );
+                        continue;
+                    }
+
+                    m_layerHoles[ii] = std::make_unique<VRML_LAYER>();
+                    m_layerHoles[ii]->AppendContours( m_holes );
+                    cutLayers[ii]->Tesselate( m_layerHoles[ii].get() );
+                }
+            } ).wait();
+}
+
+
 void EXPORTER_PCB_VRML::writeLayers( const char* aFileName, OSTREAM* aOutputFile )
 {
+    tesselateLayers();
+
     // VRML_LAYER board;
-    m_3D_board.Tesselate( &m_holes );
     double brdz = m_brd_thickness / 2.0
                   - ( pcbIUScale.mmToIU( ART_OFFSET / 2.0 ) ) * m_BoardToVrmlScale;
 
@@ -557,8 +590,6 @@ void EXPORTER_PCB_VRML::writeLayers( const char* aFileName, OSTREAM* aOutputFile
     }
 
     // VRML_LAYER m_top_copper;
-    m_top_copper.Tesselate( &m_holes );
-
     if( m_UseInlineModelsInBrdfile )
     {
         write_triangle_bag( *aOutputFile, GetColor( VRML_COLOR_COPPER ),
@@ -571,8 +602,6 @@ void EXPORTER_PCB_VRML::writeLayers( const char* aFileName, OSTREAM* aOutputFile
     }
 
     // VRML_LAYER m_top_paste;
-    m_top_paste.Tesselate( &m_holes );
-
     if( m_UseInlineModelsInBrdfile )
     {
         write_triangle_bag( *aOutputFile, GetColor( VRML_COLOR_PASTE ),
@@ -590,8 +619,6 @@ void EXPORTER_PCB_VRML::writeLayers( const char* aFileName, OSTREAM* aOutputFile
     }
 
     // VRML_LAYER m_top_soldermask;
-    m_top_soldermask.Tesselate( &m_holes );
-
     if( m_UseInlineModelsInBrdfile )
     {
         write_triangle_bag( *aOutputFile, GetColor( VRML_COLOR_TOP_SOLDMASK ),
@@ -609,8 +636,6 @@ void EXPORTER_PCB_VRML::writeLayers( const char* aFileName, OSTREAM* aOutputFile
     }
 
     // VRML_LAYER m_bot_copper;
-    m_bot_copper.Tesselate( &m_holes );
-
     if( m_UseInlineModelsInBrdfile )
     {
         write_triangle_bag( *aOutputFile, GetColor( VRML_COLOR_COPPER ),
@@ -623,8 +648,6 @@ void EXPORTER_PCB_VRML::writeLayers( const char* aFileName, OSTREAM* aOutputFile
     }
 
     // VRML_LAYER m_bot_paste;
-    m_bot_paste.Tesselate( &m_holes );
-
     if( m_UseInlineModelsInBrdfile )
     {
         write_triangle_bag( *aOutputFile, GetColor( VRML_COLOR_PASTE ),
@@ -642,8 +665,6 @@ void EXPORTER_PCB_VRML::writeLayers( const char* aFileName, OSTREAM* aOutputFile
     }
 
     // VRML_LAYER m_bot_mask:
-    m_bot_soldermask.Tesselate( &m_holes );
-
     if( m_UseInlineModelsInBrdfile )
     {
         write_triangle_bag( *aOutputFile, GetColor( VRML_COLOR_BOT_SOLDMASK ),
@@ -661,8 +682,6 @@ void EXPORTER_PCB_VRML::writeLayers( const char* aFileName, OSTREAM* aOutputFile
     }
 
     // VRML_LAYER PTH;
-    m_plated_holes.Tesselate( nullptr, true );
-
     if( m_UseInlineModelsInBrdfile )
     {
         write_triangle_bag( *aOutputFile, GetColor( VRML_COLOR_PASTE ),
@@ -682,8 +701,6 @@ void EXPORTER_PCB_VRML::writeLayers( const char* aFileName, OSTREAM* aOutputFile
     }
 
     // VRML_LAYER m_top_silk;
-    m_top_silk.Tesselate( &m_holes );
-
     if( m_UseInlineModelsInBrdfile )
     {
         write_triangle_bag( *aOutputFile, GetColor( VRML_COLOR_TOP_SILK ), &m_top_silk,
@@ -696,8 +713,6 @@ void EXPORTER_PCB_VRML::writeLayers( const char* aFileName, OSTREAM* aOutputFile
     }
 
     // VRML_LAYER m_bot_silk;
-    m_bot_silk.Tesselate( &m_holes );
-
     if( m_UseInlineModelsInBrdfile )
     {
         write_triangle_bag( *aOutputFile, GetColor( VRML_COLOR_BOT_SILK ), &m_bot_silk,
@@ -1099,60 +1114,74 @@ void EXPORTER_PCB_VRML::ExportVrmlFootprint( FOOTPRINT* aFootprint, std::ostream
             dstFile.SetName( srcFile.GetName() );
             dstFile.SetExt( wxT( "wrl" ) );
 
-            // copy the file if necessary
-            wxDateTime srcModTime = srcFile.GetModificationTime();
-            wxDateTime destModTime = srcModTime;
+            // Each model file is copied or converted only once per export
+            wxString dstPath = dstFile.GetFullPath();
+            auto     linked = m_linkedModels.find( dstPath );
+            bool     firstUse = linked == m_linkedModels.end();
 
-            destModTime.SetToCurrent();
+            if( firstUse )
+            {
+                // copy the file if necessary
+                wxDateTime srcModTime = srcFile.GetModificationTime();
+                wxDateTime destModTime = srcModTime;
 
-            if( dstFile.FileExists() )
-                destModTime = dstFile.GetModificationTime();
+                destModTime.SetToCurrent();
 
-            if( srcModTime != destModTime )
-            {
-                wxString fileExt = srcFile.GetExt();
-                fileExt.LowerCase();
+                if( dstFile.FileExists() )
+                    destModTime = dstFile.GetModificationTime();
 
-                // copy VRML models and use the scenegraph library to
-                // translate other model types
-                if( fileExt == wxT( "wrl" ) )
+                if( srcModTime != destModTime )
                 {
-                    if( !wxCopyFile( srcFile.GetFullPath(), dstFile.GetFullPath() ) )
+                    wxString fileExt = srcFile.GetExt();
+                    fileExt.LowerCase();
+
+                    // copy VRML models and use the scenegraph library to
+                    // translate other model types
+                    if( fileExt == wxT( "wrl" ) )
                     {
-                        ++sM;
-                        continue;
+                        if( !wxCopyFile( srcFile.GetFullPath(), dstFile.GetFullPath() ) )
+                        {
+                            ++sM;
+                            continue;
+                        }
                     }
-                }
-                else if( fileExt == wxT( "wrz" ) )
-                {
-                    wxFileInputStream input_file_stream( srcFile.GetFullPath() );
-                    if( !input_file_stream.IsOk() || input_file_stream.GetSize() == wxInvalidSize )
-                    {
-                        ++sM;
-                        continue;
-                    }
-
-                    wxZlibInputStream   zlib_input_stream( input_file_stream, wxZLIB_GZIP );
-                    wxFFileOutputStream output_file_stream( dstFile.GetFullPath() );
-                    if( !zlib_input_stream.IsOk() || !output_file_stream.IsOk() )
+                    else if( fileExt == wxT( "wrz" ) )
                     {
+                        wxFileInputStream input_file_stream( srcFile.GetFullPath() );
+                        if( !input_file_stream.IsOk()
+                            || input_file_stream.GetSize() == wxInvalidSize )
+                        {
+                            ++sM;
+                            continue;
+                        }
+
+                        wxZlibInputStream   zlib_input_stream( input_file_stream, wxZLIB_GZIP );
+                        wxFFileOutputStream output_file_stream( dstFile.GetFullPath() );
+                        if( !zlib_input_stream.IsOk() || !output_file_stream.IsOk() )
+                        {
+                            output_file_stream.Close();
+                            ++sM;
+                            continue;
+                        }
+
+                        output_file_stream.Write( zlib_input_stream );
                         output_file_stream.Close();
-                        ++sM;
-                        continue;
                     }
-
-                    output_file_stream.Write( zlib_input_stream );
-                    output_file_stream.Close();
-                }
-                else
-                {
-                    if( !S3D::WriteVRML( dstFile.GetFullPath().ToUTF8(), true, mod3d, m_ReuseDef,
-                                         true ) )
+                    else
                     {
-                        ++sM;
-                        continue;
+                        if( !S3D::WriteVRML( dstFile.GetFullPath().ToUTF8(), true, mod3d,
+                                             m_ReuseDef, true ) )
+                        {
+                            ++sM;
+                            continue;
+                        }
                     }
                 }
+
+                wxString nodeName = wxString::Format( wxT( "MODEL_%u" ),
+                                                      (unsigned) m_linkedModels.size() );
+
+                linked = m_linkedModels.emplace( dstPath, nodeName ).first;
             }
 
             (*aOutputFile) << "Transform {\n";
@@ -1174,7 +1203,24 @@ void EXPORTER_PCB_VRML::ExportVrmlFootprint( FOOTPRINT* aFootprint, std::ostream
             (*aOutputFile) << sM->m_Scale.y << " ";
             (*aOutputFile) << sM->m_Scale.z << "\n";
 
-            (*aOutputFile) << "  children [\n    Inline {\n      url \"";
+            // The instances of a model share the node of its first instance
+            if( m_ReuseDef && !firstUse )
+            {
+                (*aOutputFile) << "  children [\n    USE " << TO_UTF8( linked->second )
+                               << " ]\n";
+                (*aOutputFile) << "  }\n";
+
+                aOutputFile->precision( old_precision );
+                ++sM;
+                continue;
+            }
+
+            if( m_ReuseDef )
+                (*aOutputFile) << "  children [\n    DEF " << TO_UTF8( linked->second );
+            else
+                (*aOutputFile) << "  children [\n   ";
+
+            (*aOutputFile) << " Inline {\n      url \"";
 
             if( m_UseRelPathIn3DModelFilename )
             {
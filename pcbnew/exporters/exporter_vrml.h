@@ -22,6 +22,10 @@
 #include <dialogs/dialog_color_picker.h>
 #include <export_vrml.h>
 
+#include <map>
+#include <memory>
+#include <vector>
+
 // offset for art layers, mm (silk, paste, etc)
 #define  ART_OFFSET 0.025
 // offset for plating
@@ -178,6 +182,9 @@ private:
     // previously to their main outline.
     void ExportVrmlPolygonSet( VRML_LAYER* aVlayer, const SHAPE_POLY_SET& aOutlines );
 
+    // Tesselate the board layers concurrently
+    void tesselateLayers();
+
     void writeLayers( const char* aFileName, OSTREAM* aOutputFile );
 
     // select the VRML layer object to draw on
@@ -225,6 +232,9 @@ private:
     VRML_LAYER         m_bot_paste;
     VRML_LAYER         m_plated_holes;
 
+    // copies of m_holes used to tesselate each layer cut by the holes
+    std::vector<std::unique_ptr<VRML_LAYER>> m_layerHoles;
+
     std::list<SGNODE*> m_components;
     S3D_CACHE*         m_Cache3Dmodels;
 
@@ -244,6 +254,10 @@ private:
     // true to reuse component definitions
     bool     m_ReuseDef;
 
+    // VRML node names of the footprint 3D model files already written in the 3D subdirectory,
+    // by file name, used when m_UseInlineModelsInBrdfile = true
+    std::map<wxString, wxString> m_linkedModels;
+
     // scaling from 0.1 inch to desired VRML unit
     double   m_WorldScale = 1.0;
 
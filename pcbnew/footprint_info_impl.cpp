@@ -34,8 +34,7 @@
 #include <thread_pool.h>
 #include <wildcards_and_files_ext.h>
 
-#include <wx/textfile.h>
-#include <wx/txtstrm.h>
+#include <wx/datstrm.h>
 #include <wx/wfstream.h>
 
 
@@ -98,7 +97,22 @@ bool FOOTPRINT_LIST_IMPL::CatchErrors( const std::function<void()>& aFunc )
 bool FOOTPRINT_LIST_IMPL::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* aNickname,
                                               PROGRESS_REPORTER* aProgressReporter )
 {
-    long long int generatedTimestamp = aTable->GenerateTimestamp( aNickname );
+    std::map<wxString, long long> libTimestamps;
+    long long                     generatedTimestamp = 0;
+
+    if( aNickname )
+    {
+        libTimestamps[ *aNickname ] = aTable->GenerateTimestamp( aNickname );
+    }
+    else
+    {
+        for( const wxString& nickname : aTable->GetLogicalLibs() )
+            libTimestamps[ nickname ] = aTable->GenerateTimestamp( &nickname );
+    }
+
+    // Same value as aTable->GenerateTimestamp( aNickname ), without walking the table twice
+    for( const std::pair<const wxString, long long>& libTimestamp : libTimestamps )
+        generatedTimestamp += libTimestamp.second;
 
     if( generatedTimestamp == m_list_timestamp )
         return true;
@@ -107,33 +121,46 @@ bool FOOTPRINT_LIST_IMPL::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxStri
     KIID_NIL_SET_RESET reset_kiid;
 
     m_progress_reporter = aProgressReporter;
-
-    if( m_progress_reporter )
-    {
-        m_progress_reporter->SetMaxProgress( m_queue_in.size() );
-        m_progress_reporter->Report( _( "Fetching footprint libraries..." ) );
-    }
-
     m_cancelled = false;
     m_lib_table = aTable;
 
     // Clear data before reading files
     m_errors.clear();
-    m_list.clear();
     m_queue_in.clear();
     m_queue_out.clear();
+    m_loaded_libs.clear();
 
-    if( aNickname )
+    // The list can have been cleared behind our back: in this case nothing is up to date
+    if( m_list.empty() )
+        m_lib_timestamps.clear();
+
+    // Only the libraries which have changed since they were read (or which were never read)
+    // need to be loaded again.  Entries of the other libraries are kept as they are.
+    std::set<wxString> upToDateLibs;
+
+    for( const std::pair<const wxString, long long>& libTimestamp : libTimestamps )
     {
-        m_queue_in.push( *aNickname );
+        auto it = m_lib_timestamps.find( libTimestamp.first );
+
+        if( it != m_lib_timestamps.end() && it->second == libTimestamp.second )
+            upToDateLibs.insert( libTimestamp.first );
+        else
+            m_queue_in.push( libTimestamp.first );
     }
-    else
+
+    m_list.erase( std::remove_if( m_list.begin(), m_list.end(),
+                                  [&]( const std::unique_ptr<FOOTPRINT_INFO>& aFpInfo )
+                                  {
+                                      return !upToDateLibs.count( aFpInfo->GetLibNickname() );
+                                  } ),
+                  m_list.end() );
+
+    if( m_progress_reporter )
     {
-        for( auto const& nickname : aTable->GetLogicalLibs() )
-            m_queue_in.push( nickname );
+        m_progress_reporter->SetMaxProgress( m_queue_in.size() );
+        m_progress_reporter->Report( _( "Fetching footprint libraries..." ) );
     }
 
-
     loadLibs();
 
     if( !m_cancelled )
@@ -151,6 +178,21 @@ bool FOOTPRINT_LIST_IMPL::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxStri
             m_progress_reporter->AdvancePhase();
     }
 
+    // Remember the libraries which are now up to date.  Libraries in error (or not read
+    // because we were canceled) will be tried again next time.
+    std::map<wxString, long long> listTimestamps;
+
+    for( const std::pair<const wxString, long long>& libTimestamp : libTimestamps )
+    {
+        if( upToDateLibs.count( libTimestamp.first )
+                || ( !m_cancelled && m_loaded_libs.count( libTimestamp.first ) ) )
+        {
+            listTimestamps[ libTimestamp.first ] = libTimestamp.second;
+        }
+    }
+
+    m_lib_timestamps = std::move( listTimestamps );
+
     if( m_cancelled )
         m_list_timestamp = 0;       // God knows what we got before we were canceled
     else
@@ -236,6 +278,11 @@ void FOOTPRINT_LIST_IMPL::loadFootprints()
                 return 0;
             }
 
+            {
+                std::lock_guard<std::mutex> lock( m_join );
+                m_loaded_libs.insert( nickname );
+            }
+
             for( unsigned jj = 0; jj < fpnames.size() && !m_cancelled; ++jj )
             {
                 CatchErrors( [&]()
@@ -292,31 +339,76 @@ FOOTPRINT_LIST_IMPL::FOOTPRINT_LIST_IMPL() :
 }
 
 
+/*
+ * The cache file is a binary file, written with wxDataOutputStream (little endian, strings
+ * stored as a 32 bits length followed by UTF-8 data):
+ *
+ *   magic, version
+ *   library count
+ *   for each library:
+ *       nickname, timestamp, footprint count
+ *       for each footprint:
+ *           name, description, keywords, order number, pad count, unique pad count
+ *   magic (end marker, used to detect truncated files)
+ *
+ * Each library carries its own timestamp so that only the libraries which were modified
+ * since the file was written need to be read again.
+ */
+static const wxUint32 FP_INFO_CACHE_MAGIC = 0x43504B46;    // "FKPC"
+static const wxUint32 FP_INFO_CACHE_VERSION = 2;           // version 1 was a text file
+
+
 void FOOTPRINT_LIST_IMPL::WriteCacheToFile( const wxString& aFilePath )
 {
-    wxFileName          tmpFileName = wxFileName::CreateTempFileName( aFilePath );
-    wxFFileOutputStream outStream( tmpFileName.GetFullPath() );
-    wxTextOutputStream  txtStream( outStream );
+    wxFileName             tmpFileName = wxFileName::CreateTempFileName( aFilePath );
+    wxFFileOutputStream    outStream( tmpFileName.GetFullPath() );
+    wxBufferedOutputStream bufStream( outStream );
+    wxDataOutputStream     dataStream( bufStream );
 
     if( !outStream.IsOk() )
     {
         return;
     }
 
-    txtStream << wxString::Format( wxT( "%lld" ), m_list_timestamp ) << endl;
+    // m_list is sorted by library then name: the entries of a library are contiguous
+    std::map<wxString, std::vector<FOOTPRINT_INFO*>> libs;
+
+    for( const std::pair<const wxString, long long>& libTimestamp : m_lib_timestamps )
+        libs[ libTimestamp.first ];
 
     for( std::unique_ptr<FOOTPRINT_INFO>& fpinfo : m_list )
     {
-        txtStream << fpinfo->GetLibNickname() << endl;
-        txtStream << fpinfo->GetName() << endl;
-        txtStream << EscapeString( fpinfo->GetDescription(), CTX_LINE ) << endl;
-        txtStream << EscapeString( fpinfo->GetKeywords(), CTX_LINE ) << endl;
-        txtStream << wxString::Format( wxT( "%d" ), fpinfo->GetOrderNum() ) << endl;
-        txtStream << wxString::Format( wxT( "%u" ), fpinfo->GetPadCount() ) << endl;
-        txtStream << wxString::Format( wxT( "%u" ), fpinfo->GetUniquePadCount() ) << endl;
+        // Entries of libraries without timestamp are not up to date: don't save them
+        auto it = libs.find( fpinfo->GetLibNickname() );
+
+        if( it != libs.end() )
+            it->second.push_back( fpinfo.get() );
     }
 
-    txtStream.Flush();
+    dataStream.Write32( FP_INFO_CACHE_MAGIC );
+    dataStream.Write32( FP_INFO_CACHE_VERSION );
+    dataStream.Write32( static_cast<wxUint32>( libs.size() ) );
+
+    for( const std::pair<const wxString, std::vector<FOOTPRINT_INFO*>>& lib : libs )
+    {
+        dataStream.WriteString( lib.first );
+        dataStream.Write64( static_cast<wxUint64>( m_lib_timestamps[ lib.first ] ) );
+        dataStream.Write32( static_cast<wxUint32>( lib.second.size() ) );
+
+        for( FOOTPRINT_INFO* fpinfo : lib.second )
+        {
+            dataStream.WriteString( fpinfo->GetName() );
+            dataStream.WriteString( fpinfo->GetDescription() );
+            dataStream.WriteString( fpinfo->GetKeywords() );
+            dataStream.Write32( static_cast<wxUint32>( fpinfo->GetOrderNum() ) );
+            dataStream.Write32( fpinfo->GetPadCount() );
+            dataStream.Write32( fpinfo->GetUniquePadCount() );
+        }
+    }
+
+    dataStream.Write32( FP_INFO_CACHE_MAGIC );
+
+    bufStream.Close();
     outStream.Close();
 
     if( !wxRenameFile( tmpFileName.GetFullPath(), aFilePath, true ) )
@@ -330,45 +422,101 @@ void FOOTPRINT_LIST_IMPL::WriteCacheToFile( const wxString& aFilePath )
 
 void FOOTPRINT_LIST_IMPL::ReadCacheFromFile( const wxString& aFilePath )
 {
-    wxTextFile cacheFile( aFilePath );
-
     m_list_timestamp = 0;
+    m_lib_timestamps.clear();
     m_list.clear();
 
+    if( !wxFileName::FileExists( aFilePath ) )
+        return;
+
+    wxFFileInputStream    inStream( aFilePath );
+    wxBufferedInputStream bufStream( inStream );
+    wxDataInputStream     dataStream( bufStream );
+
+    if( !inStream.IsOk() )
+        return;
+
+    // The counts and lengths read from a corrupt file can be anything: don't trust them
+    // further than the size of the file
+    wxFileOffset fileSize = inStream.GetLength();
+
+    auto readCount =
+            [&]() -> wxUint32
+            {
+                wxUint32 count = dataStream.Read32();
+
+                if( bufStream.Eof() || static_cast<wxFileOffset>( count ) > fileSize )
+                    throw std::runtime_error( "corrupt footprint info cache" );
+
+                return count;
+            };
+
+    auto readString =
+            [&]() -> wxString
+            {
+                wxUint32    length = readCount();
+                std::string buffer( length, '\0' );
+
+                if( length && bufStream.Read( &buffer[0], length ).LastRead() != length )
+                    throw std::runtime_error( "truncated footprint info cache" );
+
+                return wxString::FromUTF8( buffer.data(), length );
+            };
+
     try
     {
-        if( cacheFile.Exists() && cacheFile.Open() )
+        // Old (text) caches and foreign files are silently ignored: the libraries will
+        // just be read again.
+        if( dataStream.Read32() != FP_INFO_CACHE_MAGIC
+                || dataStream.Read32() != FP_INFO_CACHE_VERSION )
         {
-            cacheFile.GetFirstLine().ToLongLong( &m_list_timestamp );
+            return;
+        }
+
+        wxUint32 libCount = readCount();
 
-            while( cacheFile.GetCurrentLine() + 6 < cacheFile.GetLineCount() )
+        for( wxUint32 ii = 0; ii < libCount && !bufStream.Eof(); ++ii )
+        {
+            wxString  libNickname = readString();
+            long long timestamp   = static_cast<long long>( dataStream.Read64() );
+            wxUint32  fpCount     = readCount();
+
+            for( wxUint32 jj = 0; jj < fpCount && !bufStream.Eof(); ++jj )
             {
-                wxString             libNickname    = cacheFile.GetNextLine();
-                wxString             name           = cacheFile.GetNextLine();
-                wxString             desc           = UnescapeString( cacheFile.GetNextLine() );
-                wxString             keywords       = UnescapeString( cacheFile.GetNextLine() );
-                int                  orderNum       = wxAtoi( cacheFile.GetNextLine() );
-                unsigned int         padCount       = (unsigned) wxAtoi( cacheFile.GetNextLine() );
-                unsigned int         uniquePadCount = (unsigned) wxAtoi( cacheFile.GetNextLine() );
+                wxString     name           = readString();
+                wxString     desc           = readString();
+                wxString     keywords       = readString();
+                int          orderNum       = static_cast<int>( dataStream.Read32() );
+                unsigned int padCount       = dataStream.Read32();
+                unsigned int uniquePadCount = dataStream.Read32();
 
                 FOOTPRINT_INFO_IMPL* fpinfo = new FOOTPRINT_INFO_IMPL( libNickname, name, desc,
                                                                        keywords, orderNum,
-                                                                       padCount,  uniquePadCount );
+                                                                       padCount, uniquePadCount );
 
                 m_list.emplace_back( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
             }
+
+            m_lib_timestamps[ libNickname ] = timestamp;
+            m_list_timestamp += timestamp;
         }
+
+        // A truncated file cannot be trusted
+        if( dataStream.Read32() != FP_INFO_CACHE_MAGIC )
+            throw std::runtime_error( "truncated footprint info cache" );
     }
     catch( ... )
     {
         // whatever went wrong, invalidate the cache
         m_list_timestamp = 0;
+        m_lib_timestamps.clear();
+        m_list.clear();
     }
 
     // Sanity check: an empty list is very unlikely to be correct.
     if( m_list.size() == 0 )
+    {
         m_list_timestamp = 0;
-
-    if( cacheFile.IsOpened() )
-        cacheFile.Close();
+        m_lib_timestamps.clear();
+    }
 }
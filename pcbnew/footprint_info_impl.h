@@ -22,7 +22,9 @@
 
 #include <atomic>
 #include <functional>
+#include <map>
 #include <memory>
+#include <set>
 #include <thread>
 #include <vector>
 
@@ -108,6 +110,13 @@ private:
     SYNC_QUEUE<wxString>     m_queue_in;
     SYNC_QUEUE<wxString>     m_queue_out;
     long long                m_list_timestamp;
+
+    /// Timestamp of each library when its entries in m_list were read.  Libraries whose
+    /// timestamp did not change are not read again.
+    std::map<wxString, long long> m_lib_timestamps;
+
+    /// Libraries successfully enumerated by loadFootprints(), guarded by m_join
+    std::set<wxString>       m_loaded_libs;
     PROGRESS_REPORTER*       m_progress_reporter;
     std::atomic_bool         m_cancelled;
     std::mutex               m_join;
@@ -607,6 +607,55 @@ bool PCB_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
 }
 
 
+void PCB_PAINTER::PrecacheItem( const VIEW_ITEM* aItem, int aUpdateFlags )
+{
+    // Only the OpenGL GAL draws the triangulations, and they only change with the geometry
+    if( !m_gal->IsOpenGlEngine() || !( aUpdateFlags & ( KIGFX::GEOMETRY | KIGFX::INITIAL_ADD ) ) )
+        return;
+
+    const BOARD_ITEM* item = dynamic_cast<const BOARD_ITEM*>( aItem );
+
+    if( !item )
+        return;
+
+    switch( item->Type() )
+    {
+    case PCB_SHAPE_T:
+    case PCB_FP_SHAPE_T:
+    {
+        // Same triangulation as done by draw( const PCB_SHAPE* ) for filled polygons
+        PCB_SHAPE* shape = const_cast<PCB_SHAPE*>( static_cast<const PCB_SHAPE*>( item ) );
+
+        if( shape->GetShape() == SHAPE_T::POLY && shape->IsFilled() )
+        {
+            SHAPE_POLY_SET& poly = shape->GetPolyShape();
+
+            if( poly.OutlineCount() > 0 && !poly.IsTriangulationUpToDate() )
+                poly.CacheTriangulation();
+        }
+
+        break;
+    }
+
+    case PCB_ZONE_T:
+    case PCB_FP_ZONE_T:
+    {
+        // The board zones are triangulated when the board is displayed, but not the footprint
+        // zones nor the zones changed since
+        ZONE* zone = const_cast<ZONE*>( static_cast<const ZONE*>( item ) );
+
+        if( !zone->GetIsRuleArea() )
+            zone->CacheTriangulation();
+
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+
 void PCB_PAINTER::draw( const PCB_TRACK* aTrack, int aLayer )
 {
     VECTOR2I start( aTrack->GetStart() );
@@ -2324,7 +2373,17 @@ void PCB_PAINTER::draw( const ZONE* aZone, int aLayer )
             m_gal->SetIsStroke( true );
         }
 
-        m_gal->DrawPolygon( *polySet, displayMode == ZONE_DISPLAY_MODE::SHOW_TRIANGULATION );
+        if( displayMode == ZONE_DISPLAY_MODE::SHOW_FILLED && !m_pcbSettings.m_isPrinting
+                && !m_gal->IsOpenGlEngine() )
+        {
+            // The zones are drawn again at each redraw when the GAL does not cache them, so
+            // draw them with the vertices closer than half a pixel merged at low zoom levels
+            m_gal->DrawPolygon( aZone->GetFilledPolysLOD( layer, 0.5 / m_gal->GetWorldScale() ) );
+        }
+        else
+        {
+            m_gal->DrawPolygon( *polySet, displayMode == ZONE_DISPLAY_MODE::SHOW_TRIANGULATION );
+        }
     }
 }
 
@@ -166,6 +166,9 @@ public:
     /// @copydoc PAINTER::Draw()
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) override;
 
+    /// @copydoc PAINTER::PrecacheItem()
+    virtual void PrecacheItem( const VIEW_ITEM* aItem, int aUpdateFlags ) override;
+
 protected:
     PCB_VIEWERS_SETTINGS_BASE* viewer_settings();
 
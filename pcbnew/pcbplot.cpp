@@ -37,6 +37,7 @@
 #include <build_version.h>
 #include <gbr_metadata.h>
 #include <render_settings.h>
+#include <advanced_config.h>
 
 
 const wxString GetGerberProtelExtension( int aLayer )
@@ -494,6 +495,51 @@ bool PLOT_CONTROLLER::PlotLayer()
 }
 
 
+int PLOT_CONTROLLER::PlotLayers( const LSET& aLayers, PLOT_FORMAT aFormat )
+{
+    GetPlotOptions().SetFormat( aFormat );
+
+    ClosePlot();
+
+    std::function<bool( wxString* )> textResolver =
+            [&]( wxString* token ) -> bool
+            {
+                // Handles m_board->GetTitleBlock() *and* m_board->GetProject()
+                return m_board->ResolveTextVar( token, 0 );
+            };
+
+    wxString outputDirName = GetPlotOptions().GetOutputDirectory();
+    outputDirName = ExpandTextVars( outputDirName, &textResolver, nullptr, nullptr );
+    outputDirName = ExpandEnvVarSubstitutions( outputDirName, nullptr );
+
+    wxFileName outputDir = wxFileName::DirName( outputDirName );
+    wxString   boardFilename = m_board->GetFileName();
+
+    if( !EnsureFileDirectoryExists( &outputDir, boardFilename ) )
+        return 0;
+
+    std::vector<PLOT_BATCH_JOB> jobs;
+
+    for( PCB_LAYER_ID layer : aLayers.UIOrder() )
+    {
+        wxFileName fn( boardFilename );
+        wxString   fileExt = GetDefaultPlotExtension( aFormat );
+
+        if( aFormat == PLOT_FORMAT::GERBER && GetPlotOptions().GetUseGerberProtelExtensions() )
+            fileExt = GetGerberProtelExtension( layer );
+
+        BuildPlotFileName( &fn, outputDir.GetPath(), m_board->GetLayerName( layer ), fileExt );
+
+        LSEQ plotSequence;
+        plotSequence.push_back( layer );
+
+        jobs.emplace_back( layer, plotSequence, fn.GetFullPath() );
+    }
+
+    return PlotBoardBatch( m_board, GetPlotOptions(), jobs, ADVANCED_CFG::GetCfg().m_ParallelPlot );
+}
+
+
 void PLOT_CONTROLLER::SetColorMode( bool aColorMode )
 {
     if( !m_plotter )
@@ -147,6 +147,42 @@ PLOTTER* StartPlotBoard( BOARD* aBoard, const PCB_PLOT_PARAMS* aPlotOpts, int aL
                          const wxString& aFullFileName, const wxString& aSheetName,
                          const wxString& aSheetPath );
 
+/**
+ * One output file of a batch plot.
+ */
+struct PLOT_BATCH_JOB
+{
+    PLOT_BATCH_JOB( PCB_LAYER_ID aLayer, const LSEQ& aPlotSequence,
+                    const wxString& aFullFileName ) :
+            m_Layer( aLayer ),
+            m_PlotSequence( aPlotSequence ),
+            m_FullFileName( aFullFileName ),
+            m_Success( false )
+    {}
+
+    PCB_LAYER_ID m_Layer;           ///< Layer used for the file attributes and title block
+    LSEQ         m_PlotSequence;    ///< Layers plotted in the file, in plot order
+    wxString     m_FullFileName;
+    bool         m_Success;         ///< Set by PlotBoardBatch()
+};
+
+/**
+ * Plot a list of files, each one with its own plotter and output stream.
+ *
+ * When \a aParallel is true the files are plotted concurrently on the KiCad thread pool.  The
+ * board is only read, and must not be modified until the function returns.  The files are
+ * identical to the ones created by plotting each job with StartPlotBoard() and
+ * PlotBoardLayers().
+ *
+ * @param aBoard is the board to plot.
+ * @param aPlotOpts are the plot options shared by all the files.
+ * @param aJobs is the list of files to create.  m_Success is updated for each job.
+ * @param aParallel enables plotting the files concurrently.
+ * @return the number of files successfully created.
+ */
+int PlotBoardBatch( BOARD* aBoard, const PCB_PLOT_PARAMS& aPlotOpts,
+                    std::vector<PLOT_BATCH_JOB>& aJobs, bool aParallel );
+
 /**
  * Plot a sequence of board layer IDs.
  *
@@ -57,6 +57,9 @@
 #include <pcb_painter.h>
 #include <gbr_metadata.h>
 #include <advanced_config.h>
+#include <locale_io.h>
+#include <thread_pool.h>
+#include <font/font.h>
 
 /*
  * Plot a solder mask layer.  Solder mask layers have a minimum thickness value and cannot be
@@ -1239,3 +1242,93 @@ PLOTTER* StartPlotBoard( BOARD *aBoard, const PCB_PLOT_PARAMS *aPlotOpts, int aL
     delete plotter;
     return nullptr;
 }
+
+
+int PlotBoardBatch( BOARD* aBoard, const PCB_PLOT_PARAMS& aPlotOpts,
+                    std::vector<PLOT_BATCH_JOB>& aJobs, bool aParallel )
+{
+    // The locale must be switched once by the calling thread: the plot threads only nest
+    // their own LOCALE_IO inside this one and never change the process locale themselves.
+    LOCALE_IO toggle;
+
+    auto plot_file =
+            [aBoard, &aPlotOpts]( PLOT_BATCH_JOB* aJob ) -> int
+            {
+                PLOTTER* plotter = StartPlotBoard( aBoard, &aPlotOpts, aJob->m_Layer,
+                                                   aJob->m_FullFileName, wxEmptyString,
+                                                   wxEmptyString );
+
+                if( !plotter )
+                    return 0;
+
+                PlotBoardLayers( aBoard, plotter, aJob->m_PlotSequence, aPlotOpts );
+                PlotInteractiveLayer( aBoard, plotter );
+                plotter->EndPlot();
+
+                delete plotter->RenderSettings();
+                delete plotter;
+
+                aJob->m_Success = true;
+                return 1;
+            };
+
+    int plotted = 0;
+
+    if( !aParallel || aJobs.size() < 2 )
+    {
+        for( PLOT_BATCH_JOB& job : aJobs )
+            plotted += plot_file( &job );
+
+        return plotted;
+    }
+
+    // Build the lazily-computed caches shared by all the layers while we are still the only
+    // thread touching the board.
+    KIFONT::FONT::GetFont();
+
+    // The texts can be plotted by several files, e.g. when also plotted on all layers, and
+    // their bounding box and glyph caches are built without lock
+    auto buildTextCaches =
+            []( BOARD_ITEM* aItem )
+            {
+                EDA_TEXT* text = dynamic_cast<EDA_TEXT*>( aItem );
+
+                if( PCB_DIMENSION_BASE* dimension = dynamic_cast<PCB_DIMENSION_BASE*>( aItem ) )
+                    text = &dimension->Text();
+
+                if( text )
+                {
+                    text->GetTextBox();
+                    text->GetRenderCache( text->GetShownText() );
+                }
+            };
+
+    for( BOARD_ITEM* item : aBoard->Drawings() )
+        buildTextCaches( item );
+
+    for( FOOTPRINT* footprint : aBoard->Footprints() )
+    {
+        footprint->GetBoundingBox( true, true );
+        footprint->GetBoundingBox( true, false );
+        footprint->GetBoundingBox( false, false );
+
+        buildTextCaches( &footprint->Reference() );
+        buildTextCaches( &footprint->Value() );
+
+        for( BOARD_ITEM* item : footprint->GraphicalItems() )
+            buildTextCaches( item );
+    }
+
+    thread_pool&                  tp = GetKiCadThreadPool();
+    std::vector<std::future<int>> returns;
+
+    returns.reserve( aJobs.size() );
+
+    for( PLOT_BATCH_JOB& job : aJobs )
+        returns.emplace_back( tp.submit( plot_file, &job ) );
+
+    for( std::future<int>& ret : returns )
+        plotted += ret.get();
+
+    return plotted;
+}
@@ -88,6 +88,19 @@ public:
      */
     bool PlotLayer();
 
+    /**
+     * Plot each layer of \a aLayers in its own file, using the layer name as file suffix.
+     *
+     * This does not use (and closes) the current plot.  The files are created concurrently,
+     * each one with its own plotter, unless parallel plotting is disabled in the advanced
+     * config.
+     *
+     * @param aLayers is the set of layers to plot.
+     * @param aFormat is the plot file format identifier.
+     * @return the number of files successfully created.
+     */
+    int PlotLayers( const LSET& aLayers, PLOT_FORMAT aFormat );
+
     /**
      * @return the current plot full filename, set by OpenPlotfile
      */
@@ -39,6 +39,13 @@
 #include <trigo.h>
 #include <i18n_utility.h>
 
+/// Number of simplified copies of the filled polygons kept for drawing at low zoom levels.
+static const int FILL_LOD_COUNT = 5;
+
+/// Tolerance of the finest simplified copy of the filled polygons, in mm.  Each following
+/// copy is four times as coarse.
+static const double FILL_LOD_FINEST_MM = 0.01;
+
 
 ZONE::ZONE( BOARD_ITEM_CONTAINER* aParent, bool aInFP ) :
         BOARD_CONNECTED_ITEM( aParent, aInFP ? PCB_FP_ZONE_T : PCB_ZONE_T ),
@@ -266,6 +273,7 @@ void ZONE::SetLayerSet( LSET aLayerSet )
         UnFill();
 
         m_FilledPolysList.clear();
+        m_filledPolysLOD.clear();
         m_filledPolysHash.clear();
         m_insulatedIslands.clear();
 
@@ -957,6 +965,99 @@ void ZONE::CacheTriangulation( PCB_LAYER_ID aLayer )
 }
 
 
+/**
+ * Drop the vertices of a contour closer than \a aTolerance to the previous vertex kept, so
+ * that no point of the contour moves by more than \a aTolerance.
+ *
+ * @return false if less than three vertices would be left.
+ */
+static bool simplifyContour( const SHAPE_LINE_CHAIN& aContour, int aTolerance,
+                             SHAPE_LINE_CHAIN& aResult )
+{
+    const SEG::ecoord     minDist2 = SEG::Square( aTolerance );
+    std::vector<VECTOR2I> points;
+
+    for( int ii = 0; ii < aContour.PointCount(); ++ii )
+    {
+        const VECTOR2I& pt = aContour.CPoint( ii );
+
+        if( points.empty() || ( pt - points.back() ).SquaredEuclideanNorm() > minDist2 )
+            points.push_back( pt );
+    }
+
+    // The closing segment is simplified as well
+    while( points.size() > 3 && ( points.back() - points[0] ).SquaredEuclideanNorm() <= minDist2 )
+        points.pop_back();
+
+    if( points.size() < 3 )
+        return false;
+
+    aResult = SHAPE_LINE_CHAIN( points, true );
+    return true;
+}
+
+
+const SHAPE_POLY_SET& ZONE::GetFilledPolysLOD( PCB_LAYER_ID aLayer, double aMaxError ) const
+{
+    const SHAPE_POLY_SET& fill = *m_FilledPolysList.at( aLayer );
+    int                   tolerance = pcbIUScale.mmToIU( FILL_LOD_FINEST_MM );
+    int                   level = -1;
+
+    while( level + 1 < FILL_LOD_COUNT && tolerance <= aMaxError )
+    {
+        level++;
+        tolerance *= 4;
+    }
+
+    if( level < 0 )
+        return fill;
+
+    tolerance /= 4;
+
+    // As for the triangulation, the cache is checked against the checksum of the filling, which
+    // can be changed in place (e.g. by the island removal)
+    FILL_LOD& lod = m_filledPolysLOD[aLayer];
+    MD5_HASH  hash = fill.GetChecksum();
+
+    if( lod.m_levels.empty() || lod.m_hash != hash )
+    {
+        lod.m_hash = hash;
+        lod.m_levels.clear();
+        lod.m_levels.resize( FILL_LOD_COUNT );
+    }
+
+    std::vector<std::shared_ptr<SHAPE_POLY_SET>>& levels = lod.m_levels;
+
+    if( !levels[level] )
+    {
+        // Each level is simplified from the filling, so that the errors do not add up.  The
+        // contours too small for the tolerance are kept as they are, they have few vertices.
+        std::shared_ptr<SHAPE_POLY_SET> simplified = std::make_shared<SHAPE_POLY_SET>();
+        SHAPE_LINE_CHAIN                contour;
+
+        for( int ii = 0; ii < fill.OutlineCount(); ++ii )
+        {
+            if( !simplifyContour( fill.COutline( ii ), tolerance, contour ) )
+                contour = fill.COutline( ii );
+
+            int outline = simplified->AddOutline( contour );
+
+            for( int jj = 0; jj < fill.HoleCount( ii ); ++jj )
+            {
+                if( !simplifyContour( fill.CHole( ii, jj ), tolerance, contour ) )
+                    contour = fill.CHole( ii, jj );
+
+                simplified->AddHole( contour, outline );
+            }
+        }
+
+        levels[level] = simplified;
+    }
+
+    return *levels[level];
+}
+
+
 bool ZONE::IsIsland( PCB_LAYER_ID aLayer, int aPolyIdx ) const
 {
     if( GetNetCode() < 1 )
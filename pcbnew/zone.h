@@ -605,6 +605,19 @@ public:
         return m_FilledPolysList.at( aLayer ).get();
     }
 
+    /**
+     * Return the filled polygons of a layer, simplified for drawing at low zoom levels.
+     *
+     * The polygons are simplified on demand at a few tolerances, and cached with the checksum
+     * of the filling they come from, so that they are built again when the filling changes.
+     * The coarsest level within \a aMaxError of the filling is returned, or the filling itself
+     * if there is none.
+     *
+     * @param aLayer is the layer of the filling.
+     * @param aMaxError is the largest acceptable distance to the filling outlines, in IU.
+     */
+    const SHAPE_POLY_SET& GetFilledPolysLOD( PCB_LAYER_ID aLayer, double aMaxError ) const;
+
     /**
      * Create a list of triangles that "fill" the solid areas used for instance to draw
      * these solid areas on OpenGL.
@@ -868,6 +881,15 @@ protected:
      */
     std::map<PCB_LAYER_ID, std::shared_ptr<SHAPE_POLY_SET>> m_FilledPolysList;
 
+    /// Simplified copies of m_FilledPolysList, from the finest to the coarsest, built on demand
+    struct FILL_LOD
+    {
+        MD5_HASH                                     m_hash;    ///< Checksum of the filling
+        std::vector<std::shared_ptr<SHAPE_POLY_SET>> m_levels;
+    };
+
+    mutable std::map<PCB_LAYER_ID, FILL_LOD> m_filledPolysLOD;
+
     /// Temp variables used while filling
     BOX2I                                  m_bboxCache;
     LSET                                   m_fillFlags;
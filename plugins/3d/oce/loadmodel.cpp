@@ -61,6 +61,7 @@
 #include <XCAFDoc_ColorTool.hxx>
 #include <XCAFDoc_ShapeTool.hxx>
 
+#include <BRep_Builder.hxx>
 #include <BRep_Tool.hxx>
 #include <BRepMesh_IncrementalMesh.hxx>
 
@@ -82,6 +83,7 @@
 #include <Standard_Version.hxx>
 
 #include "plugins/3dapi/ifsg_all.h"
+#include <profile.h>
 
 
 // log mask for wxLogTrace
@@ -671,6 +673,50 @@ bool readSTEPZ( Handle(TDocStd_Document)& m_doc, const char* aFileName )
 }
 
 
+/**
+ * Mesh the faces of the visible free shapes of a document all at once, in parallel.
+ *
+ * processFace() then finds the faces already meshed with the wanted precision instead of
+ * meshing them one at a time.  The faces shared by several instances of a part are meshed
+ * only once.
+ */
+static void meshShapes( DATA& aData, const TDF_LabelSequence& aLabels )
+{
+    TopoDS_Compound compound;
+    BRep_Builder    builder;
+    bool            empty = true;
+
+    builder.MakeCompound( compound );
+
+    for( Standard_Integer i = 1; i <= aLabels.Length(); i++ )
+    {
+        const TDF_Label& label = aLabels.Value( i );
+
+        if( !aData.m_color->IsVisible( label ) )
+            continue;
+
+        TopoDS_Shape shape = aData.m_assy->GetShape( label );
+
+        if( !shape.IsNull() )
+        {
+            builder.Add( compound, shape );
+            empty = false;
+        }
+    }
+
+    if( empty )
+        return;
+
+    PROF_TIMER timer;
+
+    BRepMesh_IncrementalMesh mesh( compound, USER_PREC, Standard_False, USER_ANGLE,
+                                   Standard_True );
+
+    timer.Stop();
+    wxLogTrace( MASK_OCE, wxT( "Meshed the shapes in %.1f ms" ), timer.msecs() );
+}
+
+
 SCENEGRAPH* LoadModel( char const* filename )
 {
     DATA data;
@@ -729,6 +775,7 @@ SCENEGRAPH* LoadModel( char const* filename )
     // retrieve all free shapes
     TDF_LabelSequence frshapes;
     data.m_assy->GetFreeShapes( frshapes );
+    meshShapes( data, frshapes );
 
     bool ret = false;
 
@@ -0,0 +1,202 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/utility_registry.h>
+
+#include <3d_cache/3d_mesh_cache.h>
+#include <plugins/3dapi/c3dmodel.h>
+#include <plugins/3dapi/ifsg_api.h>
+#include <profile.h>
+
+#include <wx/dir.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+
+enum MODEL_CACHE_BENCH_RET_CODES
+{
+    NO_CACHE_FILES = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    WRITE_FAILED,
+};
+
+
+struct MODEL_CACHE_BENCH_RESULT
+{
+    int       models = 0;
+    long long bytes = 0;
+    double    ms = 0.0;
+};
+
+
+static void printResult( const char* aName, const MODEL_CACHE_BENCH_RESULT& aResult )
+{
+    std::cout << std::setw( 22 ) << std::left << aName << std::right << std::fixed
+              << std::setprecision( 1 ) << std::setw( 10 ) << aResult.ms << " ms, "
+              << aResult.models << " models, " << aResult.bytes / 1024 << " KiB" << std::endl;
+}
+
+
+/**
+ * Read the scene graph cache files and create the render data, as S3D_CACHE does without a
+ * mesh cache file.
+ */
+static MODEL_CACHE_BENCH_RESULT readSceneCaches( const wxArrayString& aFiles )
+{
+    MODEL_CACHE_BENCH_RESULT result;
+    PROF_TIMER               timer;
+
+    for( const wxString& file : aFiles )
+    {
+        SGNODE* scene = S3D::ReadCache( file.ToUTF8(), nullptr, nullptr );
+
+        if( !scene )
+            continue;
+
+        S3DMODEL* model = S3D::GetModel( (SCENEGRAPH*) scene );
+
+        if( model )
+        {
+            result.models++;
+            S3D::Destroy3DModel( &model );
+        }
+
+        S3D::DestroyNode( scene );
+        result.bytes += wxFileName::GetSize( file ).GetValue();
+    }
+
+    timer.Stop();
+    result.ms = timer.msecs();
+
+    return result;
+}
+
+
+static MODEL_CACHE_BENCH_RESULT readMeshCaches( const wxArrayString& aFiles )
+{
+    MODEL_CACHE_BENCH_RESULT result;
+    PROF_TIMER               timer;
+
+    for( const wxString& file : aFiles )
+    {
+        S3DMODEL* model = S3D::ReadMeshCache( file );
+
+        if( !model )
+            continue;
+
+        result.models++;
+        result.bytes += wxFileName::GetSize( file ).GetValue();
+        S3D::Destroy3DModel( &model );
+    }
+
+    timer.Stop();
+    result.ms = timer.msecs();
+
+    return result;
+}
+
+
+int model_cache_benchmark_main( int argc, char *argv[] )
+{
+    if( argc < 2 )
+    {
+        std::cerr << "Usage: " << argv[0] << " <3D model cache directory> [max models]"
+                  << std::endl;
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const wxString cacheDir = wxString::FromUTF8( argv[1] );
+    const size_t   maxModels = argc > 2 ? std::max( 1, atoi( argv[2] ) ) : 0;
+
+    wxArrayString sceneFiles;
+    wxDir::GetAllFiles( cacheDir, &sceneFiles, wxT( "*.3dc" ), wxDIR_FILES );
+
+    if( maxModels && sceneFiles.GetCount() > maxModels )
+        sceneFiles.RemoveAt( maxModels, sceneFiles.GetCount() - maxModels );
+
+    if( sceneFiles.IsEmpty() )
+        return MODEL_CACHE_BENCH_RET_CODES::NO_CACHE_FILES;
+
+    // The mesh cache files are written to a temporary directory, the user cache is unchanged
+    wxFileName meshDir( wxFileName::GetTempDir(), wxEmptyString );
+    meshDir.AppendDir( wxT( "kicad_model_cache_benchmark" ) );
+    meshDir.Mkdir( wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL );
+
+    wxArrayString meshFiles;
+    PROF_TIMER    writeTimer;
+
+    for( const wxString& file : sceneFiles )
+    {
+        SGNODE* scene = S3D::ReadCache( file.ToUTF8(), nullptr, nullptr );
+
+        if( !scene )
+            continue;
+
+        S3DMODEL* model = S3D::GetModel( (SCENEGRAPH*) scene );
+
+        if( model )
+        {
+            wxFileName meshFile( meshDir.GetPath(), wxFileName( file ).GetName(), wxT( "3dm" ) );
+
+            if( !S3D::WriteMeshCache( meshFile.GetFullPath(), *model, "benchmark:0.0.0.0" ) )
+                return MODEL_CACHE_BENCH_RET_CODES::WRITE_FAILED;
+
+            meshFiles.Add( meshFile.GetFullPath() );
+            S3D::Destroy3DModel( &model );
+        }
+
+        S3D::DestroyNode( scene );
+    }
+
+    writeTimer.Stop();
+
+    std::cout << "Converted " << meshFiles.GetCount() << " of " << sceneFiles.GetCount()
+              << " models in " << std::fixed << std::setprecision( 1 ) << writeTimer.msecs()
+              << " ms" << std::endl;
+
+    // The mesh cache files were just written, so they are always read from the system file
+    // cache.  The scene cache files are read from the disk in the first pass only if the system
+    // file cache was dropped before running the tool.
+    printResult( "Scene cache (pass 1)", readSceneCaches( sceneFiles ) );
+    printResult( "Mesh cache (pass 1)", readMeshCaches( meshFiles ) );
+    printResult( "Scene cache (pass 2)", readSceneCaches( sceneFiles ) );
+    printResult( "Mesh cache (pass 2)", readMeshCaches( meshFiles ) );
+
+    for( const wxString& file : meshFiles )
+        wxRemoveFile( file );
+
+    meshDir.Rmdir();
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "model_cache_benchmark",
+        "Benchmark the loading of the 3D model cache files against the mesh cache files",
+        model_cache_benchmark_main,
+} );
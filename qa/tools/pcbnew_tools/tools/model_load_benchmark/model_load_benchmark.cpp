@@ -0,0 +1,129 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/utility_registry.h>
+
+#include <3d_cache/3d_plugin_manager.h>
+#include <plugins/3dapi/c3dmodel.h>
+#include <plugins/3dapi/ifsg_api.h>
+#include <profile.h>
+
+#include <wx/dir.h>
+#include <wx/filename.h>
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+
+enum MODEL_LOAD_BENCH_RET_CODES
+{
+    NO_MODEL_FILES = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+int model_load_benchmark_main( int argc, char *argv[] )
+{
+    if( argc < 2 )
+    {
+        std::cerr << "Usage: " << argv[0] << " <3D model directory>" << std::endl;
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const wxString modelDir = wxString::FromUTF8( argv[1] );
+    wxArrayString  dirFiles;
+    wxArrayString  files;
+
+    // The file name patterns are case sensitive on some platforms, and the model libraries
+    // have both ".step" and ".STEP" files, so the extensions are compared here
+    wxDir::GetAllFiles( modelDir, &dirFiles, wxEmptyString, wxDIR_FILES );
+
+    for( const wxString& file : dirFiles )
+    {
+        const wxString ext = wxFileName( file ).GetExt().Lower();
+
+        if( ext == wxT( "step" ) || ext == wxT( "stp" ) || ext == wxT( "stpz" )
+            || ext == wxT( "iges" ) || ext == wxT( "igs" ) )
+        {
+            files.Add( file );
+        }
+    }
+
+    if( files.IsEmpty() )
+        return MODEL_LOAD_BENCH_RET_CODES::NO_MODEL_FILES;
+
+    files.Sort();
+
+    // The plugins are loaded before timing the first model
+    S3D_PLUGIN_MANAGER plugins;
+    double             totalMs = 0.0;
+    int                loaded = 0;
+
+    for( const wxString& file : files )
+    {
+        std::string pluginInfo;
+        PROF_TIMER  timer;
+        SCENEGRAPH* scene = plugins.Load3DModel( file, pluginInfo );
+
+        timer.Stop();
+
+        std::cout << std::setw( 40 ) << std::left << wxFileName( file ).GetFullName().ToUTF8()
+                  << std::right << std::fixed << std::setprecision( 1 ) << std::setw( 10 )
+                  << timer.msecs() << " ms";
+
+        if( !scene )
+        {
+            std::cout << ", failed" << std::endl;
+            continue;
+        }
+
+        S3DMODEL*    model = S3D::GetModel( scene );
+        unsigned int triangles = 0;
+
+        if( model )
+        {
+            for( unsigned int i = 0; i < model->m_MeshesSize; ++i )
+                triangles += model->m_Meshes[i].m_FaceIdxSize / 3;
+
+            S3D::Destroy3DModel( &model );
+        }
+
+        std::cout << ", " << triangles << " triangles" << std::endl;
+
+        S3D::DestroyNode( (SGNODE*) scene );
+        totalMs += timer.msecs();
+        loaded++;
+    }
+
+    std::cout << "Loaded " << loaded << " of " << files.GetCount() << " models in "
+              << std::fixed << std::setprecision( 1 ) << totalMs << " ms" << std::endl;
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "model_load_benchmark",
+        "Benchmark the loading of the 3D models of a directory by the model plugins",
+        model_load_benchmark_main,
+} );
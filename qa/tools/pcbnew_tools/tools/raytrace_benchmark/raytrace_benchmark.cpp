@@ -0,0 +1,205 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <gal/opengl/kiglew.h>    // Must be included first
+
+#include <pcbnew_utils/board_file_utils.h>
+#include <qa_utils/utility_registry.h>
+
+#include <3d_rendering/raytracing/accelerators/accelerator_3d.h>
+#include <3d_rendering/raytracing/render_3d_raytrace.h>
+#include <3d_rendering/raytracing/render_3d_raytrace_batch.h>
+#include <3d_rendering/track_ball.h>
+#include <3d_viewer/eda_3d_viewer_settings.h>
+#include <board.h>
+#include <profile.h>
+#include <project.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+
+
+enum RAYTRACE_BENCH_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    NO_SCENE,
+};
+
+
+struct RAYTRACE_BENCH_RESULT
+{
+    long long primaryRays = 0;
+    long long shadowRays = 0;
+    long long hits = 0;
+    double    primaryMs = 0.0;
+    double    shadowMs = 0.0;
+};
+
+
+/**
+ * Trace one primary ray per pixel of the current camera view, then one shadow ray toward
+ * the camera from each hit point, on the calling thread only.
+ */
+static void traceView( const CAMERA& aCamera, const ACCELERATOR_3D& aAccelerator,
+                       const wxSize& aSize, RAYTRACE_BENCH_RESULT& aResult )
+{
+    std::vector<SFVEC3F> hitPoints;
+    hitPoints.reserve( aSize.x * aSize.y );
+
+    PROF_TIMER primaryTimer;
+
+    for( int y = 0; y < aSize.y; ++y )
+    {
+        for( int x = 0; x < aSize.x; ++x )
+        {
+            SFVEC3F origin;
+            SFVEC3F dir;
+
+            aCamera.MakeRay( SFVEC2I( x, y ), origin, dir );
+
+            RAY     ray;
+            HITINFO hitInfo;
+
+            ray.Init( origin, dir );
+            hitInfo.m_tHit = std::numeric_limits<float>::infinity();
+            hitInfo.m_acc_node_info = 0;
+
+            if( aAccelerator.Intersect( ray, hitInfo ) )
+                hitPoints.push_back( ray.at( hitInfo.m_tHit ) + hitInfo.m_HitNormal * 1e-4f );
+        }
+    }
+
+    primaryTimer.Stop();
+
+    const SFVEC3F toLight = -aCamera.GetDir();
+
+    PROF_TIMER shadowTimer;
+
+    for( const SFVEC3F& hitPoint : hitPoints )
+    {
+        RAY ray;
+
+        ray.Init( hitPoint, toLight );
+        aAccelerator.IntersectP( ray, std::numeric_limits<float>::infinity() );
+    }
+
+    shadowTimer.Stop();
+
+    aResult.primaryRays += static_cast<long long>( aSize.x ) * aSize.y;
+    aResult.shadowRays += hitPoints.size();
+    aResult.hits += hitPoints.size();
+    aResult.primaryMs += primaryTimer.msecs();
+    aResult.shadowMs += shadowTimer.msecs();
+}
+
+
+static double raysPerSecond( long long aRays, double aMs )
+{
+    return aMs > 0.0 ? aRays * 1000.0 / aMs : 0.0;
+}
+
+
+int raytrace_benchmark_main( int argc, char *argv[] )
+{
+    if( argc < 2 )
+    {
+        std::cerr << "Usage: " << argv[0] << " <board file> [image size]" << std::endl;
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const int    imageSize = argc > 2 ? std::max( 16, atoi( argv[2] ) ) : 512;
+    const wxSize size( imageSize, imageSize );
+
+    std::unique_ptr<BOARD> brd = KI_TEST::ReadBoardFromFileOrStream( argv[1] );
+
+    if( !brd )
+        return RAYTRACE_BENCH_RET_CODES::LOAD_FAILED;
+
+    EDA_3D_VIEWER_SETTINGS cfg;
+    BOARD_ADAPTER          adapter;
+
+    // The 3D models can only be resolved when the board belongs to a project
+    adapter.SetBoard( brd.get() );
+    adapter.Set3dCacheManager( brd->GetProject() ? brd->GetProject()->Get3DCacheManager()
+                                                 : nullptr );
+    adapter.m_Cfg = &cfg;
+
+    TRACK_BALL         camera( 2 * RANGE_SCALE_3D );
+    RENDER_3D_RAYTRACE renderer( nullptr, adapter, camera );
+
+    PROF_TIMER reloadTimer;
+    renderer.Reload( nullptr, nullptr, false );
+    reloadTimer.Stop();
+
+    if( !renderer.GetAccelerator() )
+        return RAYTRACE_BENCH_RET_CODES::NO_SCENE;
+
+    std::cout << "Scene created in " << reloadTimer.msecs() << " ms" << std::endl;
+
+    const RAYTRACE_VIEW views[] = { RAYTRACE_VIEW::TOP,  RAYTRACE_VIEW::BOTTOM,
+                                    RAYTRACE_VIEW::FRONT, RAYTRACE_VIEW::BACK,
+                                    RAYTRACE_VIEW::LEFT, RAYTRACE_VIEW::RIGHT };
+
+    RAYTRACE_BENCH_RESULT total;
+
+    for( RAYTRACE_VIEW view : views )
+    {
+        RAYTRACE_BENCH_RESULT result;
+
+        SetRaytraceView( camera, view );
+        camera.SetCurWindowSize( size );
+
+        traceView( camera, *renderer.GetAccelerator(), size, result );
+
+        std::cout << "View " << static_cast<int>( view ) << ": " << std::fixed
+                  << std::setprecision( 0 )
+                  << raysPerSecond( result.primaryRays, result.primaryMs ) << " primary rays/s, "
+                  << raysPerSecond( result.shadowRays, result.shadowMs ) << " shadow rays/s, "
+                  << result.hits << " hits" << std::endl;
+
+        total.primaryRays += result.primaryRays;
+        total.shadowRays += result.shadowRays;
+        total.hits += result.hits;
+        total.primaryMs += result.primaryMs;
+        total.shadowMs += result.shadowMs;
+    }
+
+    std::cout << "Total: " << std::fixed << std::setprecision( 0 )
+              << raysPerSecond( total.primaryRays + total.shadowRays,
+                                total.primaryMs + total.shadowMs )
+              << " rays/s (" << total.primaryRays + total.shadowRays << " rays in "
+              << total.primaryMs + total.shadowMs << " ms)" << std::endl;
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "raytrace_benchmark",
+        "Benchmark the raytracer acceleration structure on fixed views of a PCB",
+        raytrace_benchmark_main,
+} );
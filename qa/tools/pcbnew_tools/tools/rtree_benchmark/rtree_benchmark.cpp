@@ -0,0 +1,219 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <pcbnew_utils/board_file_utils.h>
+#include <qa_utils/utility_registry.h>
+
+#include <board.h>
+#include <board_design_settings.h>
+#include <drc/drc_rtree.h>
+#include <footprint.h>
+#include <pad.h>
+#include <pcb_track.h>
+#include <profile.h>
+#include <view/view_rtree.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+
+enum RTREE_BENCH_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+struct RTREE_BENCH_RESULT
+{
+    double buildMs = 0.0;
+    double queryMs = 0.0;
+    long   hits = 0;
+};
+
+
+static void printResult( const char* aName, const RTREE_BENCH_RESULT& aResult )
+{
+    std::cout << std::setw( 18 ) << std::left << aName << std::right << std::fixed
+              << std::setprecision( 1 ) << "build " << std::setw( 9 ) << aResult.buildMs
+              << " ms, query " << std::setw( 9 ) << aResult.queryMs << " ms, "
+              << aResult.hits << " hits" << std::endl;
+}
+
+
+/**
+ * Build a DRC tree of the copper items as the DRC cache generator does, then look up the
+ * neighbours of each item on each of its layers.
+ */
+static RTREE_BENCH_RESULT benchDrcTree( const std::vector<BOARD_ITEM*>& aItems, int aClearance,
+                                        bool aBulkLoad )
+{
+    RTREE_BENCH_RESULT result;
+    DRC_RTREE          tree;
+    PROF_TIMER         buildTimer;
+
+    if( aBulkLoad )
+        tree.StartBulkLoad();
+
+    for( BOARD_ITEM* item : aItems )
+    {
+        for( PCB_LAYER_ID layer : ( item->GetLayerSet() & LSET::AllCuMask() ).Seq() )
+            tree.Insert( item, layer, aClearance );
+    }
+
+    if( aBulkLoad )
+        tree.FinishBulkLoad();
+
+    buildTimer.Stop();
+    result.buildMs = buildTimer.msecs();
+
+    PROF_TIMER queryTimer;
+
+    for( BOARD_ITEM* item : aItems )
+    {
+        BOX2I bbox = item->GetBoundingBox();
+
+        for( PCB_LAYER_ID layer : ( item->GetLayerSet() & LSET::AllCuMask() ).Seq() )
+        {
+            for( DRC_RTREE::ITEM_WITH_SHAPE* other : tree.Overlapping( layer, bbox ) )
+            {
+                if( other->parent != item )
+                    result.hits++;
+            }
+        }
+    }
+
+    queryTimer.Stop();
+    result.queryMs = queryTimer.msecs();
+
+    return result;
+}
+
+
+/**
+ * Build a view tree of all the items, then query it over a grid of viewports covering the
+ * board, as done when the view is redrawn.
+ */
+static RTREE_BENCH_RESULT benchViewTree( const std::vector<BOARD_ITEM*>& aItems,
+                                         const BOX2I& aBoardBox, bool aBulkLoad )
+{
+    RTREE_BENCH_RESULT result;
+    KIGFX::VIEW_RTREE  tree;
+    PROF_TIMER         buildTimer;
+
+    if( aBulkLoad )
+    {
+        tree.BulkLoad( std::vector<KIGFX::VIEW_ITEM*>( aItems.begin(), aItems.end() ) );
+    }
+    else
+    {
+        for( BOARD_ITEM* item : aItems )
+            tree.Insert( item );
+    }
+
+    buildTimer.Stop();
+    result.buildMs = buildTimer.msecs();
+
+    const int  steps = 32;
+    const int  w = std::max( 1, aBoardBox.GetWidth() / 8 );
+    const int  h = std::max( 1, aBoardBox.GetHeight() / 8 );
+    PROF_TIMER queryTimer;
+
+    auto visitor =
+            [&result]( KIGFX::VIEW_ITEM* aItem ) -> bool
+            {
+                result.hits++;
+                return true;
+            };
+
+    for( int ix = 0; ix < steps; ++ix )
+    {
+        for( int iy = 0; iy < steps; ++iy )
+        {
+            VECTOR2I origin( aBoardBox.GetX() + (int) ( (long long) aBoardBox.GetWidth() * ix
+                                                        / steps ),
+                             aBoardBox.GetY() + (int) ( (long long) aBoardBox.GetHeight() * iy
+                                                        / steps ) );
+
+            tree.Query( BOX2I( origin, VECTOR2I( w, h ) ), visitor );
+        }
+    }
+
+    queryTimer.Stop();
+    result.queryMs = queryTimer.msecs();
+
+    return result;
+}
+
+
+int rtree_benchmark_main( int argc, char *argv[] )
+{
+    if( argc < 2 )
+    {
+        std::cerr << "Usage: " << argv[0] << " <board file>" << std::endl;
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    std::unique_ptr<BOARD> brd = KI_TEST::ReadBoardFromFileOrStream( argv[1] );
+
+    if( !brd )
+        return RTREE_BENCH_RET_CODES::LOAD_FAILED;
+
+    std::vector<BOARD_ITEM*> items;
+
+    for( PCB_TRACK* track : brd->Tracks() )
+        items.push_back( track );
+
+    for( BOARD_ITEM* item : brd->Drawings() )
+        items.push_back( item );
+
+    for( FOOTPRINT* footprint : brd->Footprints() )
+    {
+        for( PAD* pad : footprint->Pads() )
+            items.push_back( pad );
+
+        for( BOARD_ITEM* item : footprint->GraphicalItems() )
+            items.push_back( item );
+    }
+
+    const int clearance = brd->GetDesignSettings().GetBiggestClearanceValue();
+
+    std::cout << items.size() << " items" << std::endl;
+
+    printResult( "DRC tree, insert", benchDrcTree( items, clearance, false ) );
+    printResult( "DRC tree, bulk", benchDrcTree( items, clearance, true ) );
+    printResult( "View tree, insert", benchViewTree( items, brd->GetBoundingBox(), false ) );
+    printResult( "View tree, bulk", benchViewTree( items, brd->GetBoundingBox(), true ) );
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "rtree_benchmark",
+        "Benchmark the building and querying of the R-trees of a PCB, inserted or bulk loaded",
+        rtree_benchmark_main,
+} );
@@ -0,0 +1,286 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the Cairo compositor: the buffers rasterized in bands on the thread pool must
+ * have the same pixels as the buffers rasterized directly.
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <gal/cairo/cairo_compositor.h>
+#include <gal/color4d.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+using namespace KIGFX;
+
+
+/// The compositor uses bands of at least 64 rows, so the buffers have up to 4 bands
+static const int WIDTH = 200;
+static const int HEIGHT = 256;
+
+/// Draws on the context of a compositor buffer; the compositor can change the context
+using DRAW_FUNC = std::function<void( CAIRO_COMPOSITOR& aCompositor, cairo_t*& aContext )>;
+
+
+/**
+ * Draw on a buffer of a compositor, composite it and return the pixels.
+ *
+ * @param aTiled enables the rasterization in bands, which is only used if the thread pool has
+ *               several threads.
+ */
+static std::vector<uint32_t> render( bool aTiled, const DRAW_FUNC& aDraw )
+{
+    cairo_surface_t* surface = cairo_image_surface_create( CAIRO_FORMAT_ARGB32, WIDTH, HEIGHT );
+    cairo_t*         mainContext = cairo_create( surface );
+    cairo_t*         context = mainContext;
+
+    {
+        CAIRO_COMPOSITOR compositor( &context );
+
+        compositor.Resize( WIDTH, HEIGHT );
+        compositor.SetAntialiasingMode( CAIRO_ANTIALIASING_MODE::GOOD );
+        compositor.SetTiledRendering( aTiled );
+
+        unsigned int buffer = compositor.CreateBuffer();
+
+        compositor.SetBuffer( buffer );
+        compositor.ClearBuffer( COLOR4D::BLACK );
+
+        aDraw( compositor, context );
+
+        compositor.DrawBuffer( buffer );
+    }
+
+    cairo_surface_flush( surface );
+
+    std::vector<uint32_t> pixels( WIDTH * HEIGHT );
+    const unsigned char*  data = cairo_image_surface_get_data( surface );
+    const int             stride = cairo_image_surface_get_stride( surface );
+
+    for( int y = 0; y < HEIGHT; ++y )
+        memcpy( &pixels[y * WIDTH], data + y * stride, WIDTH * sizeof( uint32_t ) );
+
+    cairo_destroy( mainContext );
+    cairo_surface_destroy( surface );
+
+    return pixels;
+}
+
+
+/**
+ * Check that the tiled and the direct rasterizations have the same pixels, and that something
+ * was drawn.
+ */
+static void checkSamePixels( const DRAW_FUNC& aDraw )
+{
+    const std::vector<uint32_t> expected = render( false, aDraw );
+    const std::vector<uint32_t> actual = render( true, aDraw );
+
+    int differences = 0;
+    int drawn = 0;
+
+    for( size_t i = 0; i < expected.size(); ++i )
+    {
+        if( expected[i] != actual[i] )
+            differences++;
+
+        if( expected[i] != 0 )
+            drawn++;
+    }
+
+    BOOST_CHECK_EQUAL( differences, 0 );
+    BOOST_CHECK_GT( drawn, 0 );
+}
+
+
+static void fillRectangle( cairo_t* aContext, double aX, double aY, double aW, double aH,
+                           double aRed, double aGreen, double aBlue, double aAlpha = 1.0 )
+{
+    cairo_set_source_rgba( aContext, aRed, aGreen, aBlue, aAlpha );
+    cairo_rectangle( aContext, aX, aY, aW, aH );
+    cairo_fill( aContext );
+}
+
+
+BOOST_AUTO_TEST_SUITE( CairoCompositor )
+
+
+/**
+ * Rectangles covering a band or lying inside one are only drawn in their rows
+ */
+BOOST_AUTO_TEST_CASE( RectangleInOneBand )
+{
+    // The rows of the first band, for 2, 3 and 4 bands, and a rectangle inside the last band
+    for( int bands = 2; bands <= 4; ++bands )
+    {
+        BOOST_TEST_CONTEXT( bands << " bands" )
+        {
+            checkSamePixels(
+                    [&]( CAIRO_COMPOSITOR& aCompositor, cairo_t*& aContext )
+                    {
+                        fillRectangle( aContext, 0, 0, WIDTH, HEIGHT / bands, 0.8, 0.2, 0.1 );
+                        fillRectangle( aContext, 20, HEIGHT - 30, 50, 20, 0.1, 0.9, 0.3 );
+                    } );
+        }
+    }
+
+    // A rectangle covering the whole buffer is drawn as a paint
+    checkSamePixels(
+            [&]( CAIRO_COMPOSITOR& aCompositor, cairo_t*& aContext )
+            {
+                fillRectangle( aContext, 0, 0, WIDTH, HEIGHT, 0.3, 0.3, 0.7 );
+            } );
+}
+
+
+/**
+ * Antialiased fills, strokes and transparent items crossing the band borders
+ */
+BOOST_AUTO_TEST_CASE( FillAcrossBands )
+{
+    checkSamePixels(
+            [&]( CAIRO_COMPOSITOR& aCompositor, cairo_t*& aContext )
+            {
+                cairo_set_source_rgb( aContext, 0.9, 0.8, 0.1 );
+                cairo_arc( aContext, WIDTH / 2.0, HEIGHT / 2.0, 90.3, 0.0, 2 * M_PI );
+                cairo_fill( aContext );
+
+                cairo_set_source_rgba( aContext, 0.1, 0.5, 0.9, 0.6 );
+                cairo_move_to( aContext, 10.5, 3.2 );
+                cairo_line_to( aContext, 187.3, 250.1 );
+                cairo_line_to( aContext, 33.7, 201.9 );
+                cairo_close_path( aContext );
+                cairo_fill( aContext );
+
+                cairo_set_source_rgba( aContext, 0.2, 0.9, 0.2, 0.8 );
+                cairo_set_line_width( aContext, 7.3 );
+                cairo_move_to( aContext, 190.0, 5.0 );
+                cairo_curve_to( aContext, 20.0, 60.0, 180.0, 190.0, 15.0, 245.0 );
+                cairo_stroke( aContext );
+
+                fillRectangle( aContext, 60.25, 40.5, 80.5, 170.75, 1.0, 1.0, 1.0, 0.5 );
+            } );
+}
+
+
+/**
+ * The negative items are drawn directly on the pixels drawn before them, then the next items
+ * are recorded again
+ */
+BOOST_AUTO_TEST_CASE( NegativeMode )
+{
+    checkSamePixels(
+            [&]( CAIRO_COMPOSITOR& aCompositor, cairo_t*& aContext )
+            {
+                fillRectangle( aContext, 10, 10, WIDTH - 20, HEIGHT - 20, 0.8, 0.4, 0.0 );
+
+                aCompositor.SetDirectDrawing( true );
+
+                cairo_set_operator( aContext, CAIRO_OPERATOR_CLEAR );
+                cairo_arc( aContext, WIDTH / 2.0, HEIGHT / 2.0, 70.6, 0.0, 2 * M_PI );
+                cairo_fill( aContext );
+                cairo_set_operator( aContext, CAIRO_OPERATOR_OVER );
+
+                aCompositor.SetDirectDrawing( false );
+
+                fillRectangle( aContext, 90, 0, 20, HEIGHT, 0.0, 0.3, 0.9, 0.7 );
+            } );
+}
+
+
+/**
+ * Many negative items interleaved with the other items, as in a Gerber file: the buffer is
+ * drawn directly from the first negative item
+ */
+BOOST_AUTO_TEST_CASE( InterleavedNegatives )
+{
+    checkSamePixels(
+            [&]( CAIRO_COMPOSITOR& aCompositor, cairo_t*& aContext )
+            {
+                for( int i = 0; i < 8; ++i )
+                {
+                    fillRectangle( aContext, 10 + 20 * i, 5.5 + 28 * i, 50, 60, 0.2, 0.7, 0.4 );
+
+                    aCompositor.SetDirectDrawing( true );
+
+                    cairo_set_operator( aContext, CAIRO_OPERATOR_CLEAR );
+                    cairo_arc( aContext, 30.3 + 20 * i, 30.7 + 28 * i, 12.0, 0.0, 2 * M_PI );
+                    cairo_fill( aContext );
+                    cairo_set_operator( aContext, CAIRO_OPERATOR_OVER );
+
+                    aCompositor.SetDirectDrawing( false );
+                }
+            } );
+}
+
+
+/**
+ * Clearing a buffer discards the commands recorded in it, and records the commands again
+ * after negative items
+ */
+BOOST_AUTO_TEST_CASE( Discard )
+{
+    auto drawLast =
+            []( cairo_t* aContext )
+            {
+                fillRectangle( aContext, 30, 100, 70, 100, 0.5, 0.9, 0.1 );
+            };
+
+    const std::vector<uint32_t> expected = render( false,
+            [&]( CAIRO_COMPOSITOR& aCompositor, cairo_t*& aContext )
+            {
+                drawLast( aContext );
+            } );
+
+    const std::vector<uint32_t> actual = render( true,
+            [&]( CAIRO_COMPOSITOR& aCompositor, cairo_t*& aContext )
+            {
+                fillRectangle( aContext, 0, 0, WIDTH, HEIGHT / 2, 0.9, 0.1, 0.1 );
+
+                cairo_set_source_rgb( aContext, 0.1, 0.1, 0.9 );
+                cairo_arc( aContext, WIDTH / 2.0, HEIGHT / 2.0, 60.0, 0.0, 2 * M_PI );
+                cairo_fill( aContext );
+
+                aCompositor.SetDirectDrawing( true );
+                cairo_set_operator( aContext, CAIRO_OPERATOR_CLEAR );
+                fillRectangle( aContext, 50, 50, 20, 20, 0.0, 0.0, 0.0 );
+                cairo_set_operator( aContext, CAIRO_OPERATOR_OVER );
+                aCompositor.SetDirectDrawing( false );
+
+                aCompositor.ClearBuffer( COLOR4D::BLACK );
+
+                drawLast( aContext );
+            } );
+
+    BOOST_CHECK( expected == actual );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
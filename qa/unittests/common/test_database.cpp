@@ -22,6 +22,8 @@
 * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
 */
 
+#include <set>
+
 #include <fmt/core.h>
 #include <boost/test/unit_test.hpp>
 
@@ -66,4 +68,59 @@ BOOST_AUTO_TEST_CASE( Connect )
     BOOST_CHECK_EQUAL( std::any_cast<std::string>( result.at( "MPN" ) ), "RC0603FR-0710KL" );
 }
 
+
+BOOST_AUTO_TEST_CASE( SelectMany )
+{
+    std::string cs = fmt::format( "Driver={{SQLite3}};Database={}/database.sqlite",
+                                  QA_DATABASE_FILE_LOCATION );
+
+    DATABASE_CONNECTION dc( cs, 2 );
+    BOOST_REQUIRE( dc.IsConnected() );
+
+    // More values than fit in a single query, and one which doesn't exist
+    std::vector<std::string> keys;
+
+    for( int i = 1; i <= 150; ++i )
+        keys.emplace_back( fmt::format( "RES-{:03d}", i ) );
+
+    keys.emplace_back( "RES-XXX" );
+
+    std::vector<DATABASE_CONNECTION::ROW> results;
+
+    BOOST_CHECK( dc.SelectMany( "Resistors", "Part ID", keys, results ) );
+    BOOST_CHECK_EQUAL( results.size(), 150U );
+
+    std::set<std::string> found;
+
+    for( const DATABASE_CONNECTION::ROW& row : results )
+    {
+        BOOST_REQUIRE( row.count( "Part ID" ) );
+        found.insert( std::any_cast<std::string>( row.at( "Part ID" ) ) );
+    }
+
+    BOOST_CHECK_EQUAL( found.size(), 150U );
+    BOOST_CHECK( found.count( "RES-001" ) );
+    BOOST_CHECK( found.count( "RES-150" ) );
+
+    // Prefetched rows (and repeated queries) must give the same results as a direct lookup
+    DATABASE_CONNECTION::ROW result;
+
+    BOOST_CHECK( dc.SelectOne( "Resistors", std::make_pair( "Part ID", "RES-001" ), result ) );
+    BOOST_CHECK_EQUAL( std::any_cast<std::string>( result.at( "MPN" ) ), "RC0603FR-0710KL" );
+
+    BOOST_CHECK( dc.SelectOne( "Resistors", std::make_pair( "Part ID", "RES-200" ), result ) );
+    BOOST_CHECK_EQUAL( std::any_cast<std::string>( result.at( "Part ID" ) ), "RES-200" );
+
+    BOOST_CHECK( dc.SelectOne( "Resistors", std::make_pair( "Part ID", "RES-201" ), result ) );
+    BOOST_CHECK_EQUAL( std::any_cast<std::string>( result.at( "Part ID" ) ), "RES-201" );
+
+    BOOST_CHECK( !dc.SelectOne( "Resistors", std::make_pair( "Part ID", "RES-XXX" ), result ) );
+
+    // Unknown table or column
+    results.clear();
+    BOOST_CHECK( !dc.SelectMany( "Inductors", "Part ID", keys, results ) );
+    BOOST_CHECK( !dc.SelectMany( "Resistors", "Unknown", keys, results ) );
+    BOOST_CHECK( results.empty() );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
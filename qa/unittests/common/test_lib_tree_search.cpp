@@ -0,0 +1,367 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Check the indexed search of the library trees against the full scan of the tree
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <eda_pattern_match.h>
+#include <lib_tree_item.h>
+#include <lib_tree_model.h>
+
+#include <algorithm>
+#include <list>
+#include <tuple>
+
+#include <wx/tokenzr.h>
+
+
+namespace
+{
+
+class TEST_LIB_TREE_ITEM : public LIB_TREE_ITEM
+{
+public:
+    TEST_LIB_TREE_ITEM( const wxString& aLib, const wxString& aName, const wxString& aDesc,
+                        const wxString& aKeywords ) :
+            m_lib( aLib ),
+            m_name( aName ),
+            m_desc( aDesc ),
+            m_keywords( aKeywords )
+    {}
+
+    LIB_ID   GetLibId() const override { return LIB_ID( m_lib, m_name ); }
+    wxString GetName() const override { return m_name; }
+    wxString GetLibNickname() const override { return m_lib; }
+    wxString GetDescription() override { return m_desc; }
+
+    // Same layout as the symbols and footprints: keywords first, then the description
+    wxString GetSearchText() override { return m_keywords + wxT( "  " ) + m_desc; }
+
+private:
+    wxString m_lib;
+    wxString m_name;
+    wxString m_desc;
+    wxString m_keywords;
+};
+
+
+struct LIB_TREE_SEARCH_FIXTURE
+{
+    LIB_TREE_SEARCH_FIXTURE()
+    {
+        add( wxT( "Device" ), wxT( "R" ), wxT( "Resistor" ), wxT( "r res resistor" ) );
+        add( wxT( "Device" ), wxT( "R_Small" ), wxT( "Resistor, small symbol" ),
+             wxT( "r res resistor" ) );
+        add( wxT( "Device" ), wxT( "C" ), wxT( "Unpolarized capacitor" ), wxT( "cap capacitor" ) );
+        add( wxT( "Device" ), wxT( "L" ), wxT( "Inductor" ), wxT( "inductor choke coil" ) );
+        add( wxT( "Device" ), wxT( "R_Pack04" ), wxT( "4 resistor network, 10k" ),
+             wxT( "R network parallel topology isolated" ) );
+        add( wxT( "Amplifier_Operational" ), wxT( "LM358" ), wxT( "Low-Power, Dual Op Amp" ),
+             wxT( "dual opamp" ) );
+        add( wxT( "Amplifier_Operational" ), wxT( "TL072" ), wxT( "Dual Low-Noise JFET Op Amp" ),
+             wxT( "dual opamp" ) );
+        add( wxT( "Amplifier_Operational" ), wxT( "LM324" ), wxT( "Low-Power, Quad Op Amp" ),
+             wxT( "quad opamp" ) );
+        add( wxT( "power" ), wxT( "VCC" ), wxT( "Power symbol creates a global label" ),
+             wxT( "global power" ) );
+        add( wxT( "power" ), wxT( "GND" ), wxT( "Power symbol creates a global label" ),
+             wxT( "global power ground gnd" ) );
+
+        // Non-ASCII names and texts
+        add( wxT( "Bauteile" ), wxT( "Widerstand_1kΩ" ),
+             wxT( "Widerstand 1 kΩ, Größe 0603" ), wxT( "widerstand Ω" ) );
+        add( wxT( "Bauteile" ), wxT( "Kondensator_100µF" ),
+             wxT( "Elektrolytkondensator 100 µF" ), wxT( "kondensator élco" ) );
+        add( wxT( "Composants" ), wxT( "Résistance" ), wxT( "Résistance à couche métallique" ),
+             wxT( "résistance" ) );
+        add( wxT( "部品" ), wxT( "抵抗器" ), wxT( "チップ抵抗器 電源用" ), wxT( "抵抗 電源" ) );
+        add( wxT( "Емкости" ), wxT( "Конденсатор" ), wxT( "Керамический конденсатор" ),
+             wxT( "конденсатор" ) );
+
+        for( TEST_LIB_TREE_ITEM& item : m_items )
+        {
+            for( LIB_TREE_NODE_ROOT* root : { &m_indexed, &m_scanned } )
+            {
+                LIB_TREE_NODE_LIB* lib = nullptr;
+
+                for( std::unique_ptr<LIB_TREE_NODE>& child : root->m_Children )
+                {
+                    if( child->m_Name == item.GetLibNickname() )
+                        lib = static_cast<LIB_TREE_NODE_LIB*>( child.get() );
+                }
+
+                if( !lib )
+                    lib = &root->AddLib( item.GetLibNickname(), wxEmptyString );
+
+                lib->AddItem( &item );
+            }
+        }
+
+        for( LIB_TREE_NODE_ROOT* root : { &m_indexed, &m_scanned } )
+        {
+            for( std::unique_ptr<LIB_TREE_NODE>& lib : root->m_Children )
+                lib->AssignIntrinsicRanks();
+
+            root->AssignIntrinsicRanks();
+        }
+    }
+
+    void add( const wxString& aLib, const wxString& aName, const wxString& aDesc,
+              const wxString& aKeywords )
+    {
+        m_items.emplace_back( aLib, aName, aDesc, aKeywords );
+    }
+
+    /// Split a search string in (library, term) pairs, like LIB_TREE_MODEL_ADAPTER does
+    static std::vector<std::pair<wxString, wxString>> terms( const wxString& aSearch )
+    {
+        std::vector<std::pair<wxString, wxString>> terms;
+        wxStringTokenizer                          tokenizer( aSearch );
+
+        while( tokenizer.HasMoreTokens() )
+        {
+            wxString lib;
+            wxString term = tokenizer.GetNextToken().Lower();
+
+            if( term.Contains( ":" ) )
+            {
+                lib = term.BeforeFirst( ':' );
+                term = term.AfterFirst( ':' );
+            }
+
+            terms.emplace_back( lib, term );
+        }
+
+        return terms;
+    }
+
+    /// The (library, item, score) of the items with a non zero score, best score first
+    static std::vector<std::tuple<wxString, wxString, int>> matches( LIB_TREE_NODE_ROOT& aRoot )
+    {
+        std::vector<std::tuple<wxString, wxString, int>> matches;
+
+        for( std::unique_ptr<LIB_TREE_NODE>& lib : aRoot.m_Children )
+        {
+            for( std::unique_ptr<LIB_TREE_NODE>& item : lib->m_Children )
+            {
+                if( item->m_Score > 0 )
+                    matches.emplace_back( lib->m_Name, item->m_Name, item->m_Score );
+            }
+        }
+
+        std::stable_sort( matches.begin(), matches.end(),
+                          []( const auto& a, const auto& b )
+                          {
+                              return std::get<2>( a ) > std::get<2>( b );
+                          } );
+
+        return matches;
+    }
+
+    /**
+     * Search the tree with the index, and by scanning all the items with each term like
+     * before the index, and check the results are the same.
+     */
+    void checkSearch( const wxString& aSearch )
+    {
+        BOOST_TEST_CONTEXT( "Search '" << aSearch << "'" )
+        {
+            m_indexed.ResetScore();
+            m_indexed.UpdateSearchScore( terms( aSearch ) );
+
+            m_scanned.ResetScore();
+
+            for( const std::pair<wxString, wxString>& term : terms( aSearch ) )
+            {
+                EDA_COMBINED_MATCHER matcher( term.second, CTX_LIBITEM );
+                m_scanned.UpdateScore( matcher, term.first );
+            }
+
+            std::vector<std::tuple<wxString, wxString, int>> expected = matches( m_scanned );
+            std::vector<std::tuple<wxString, wxString, int>> found = matches( m_indexed );
+
+            BOOST_REQUIRE_EQUAL( found.size(), expected.size() );
+
+            for( size_t ii = 0; ii < found.size(); ii++ )
+            {
+                BOOST_CHECK_EQUAL( std::get<0>( found[ii] ), std::get<0>( expected[ii] ) );
+                BOOST_CHECK_EQUAL( std::get<1>( found[ii] ), std::get<1>( expected[ii] ) );
+                BOOST_CHECK_EQUAL( std::get<2>( found[ii] ), std::get<2>( expected[ii] ) );
+            }
+
+            // The libraries are scored too
+            for( size_t ii = 0; ii < m_indexed.m_Children.size(); ii++ )
+            {
+                BOOST_CHECK_EQUAL( m_indexed.m_Children[ii]->m_Score,
+                                   m_scanned.m_Children[ii]->m_Score );
+            }
+        }
+    }
+
+    // A list, so the items don't move when more are added
+    std::list<TEST_LIB_TREE_ITEM> m_items;
+    LIB_TREE_NODE_ROOT            m_indexed;
+    LIB_TREE_NODE_ROOT            m_scanned;
+};
+
+} // namespace
+
+
+BOOST_FIXTURE_TEST_SUITE( LibTreeSearch, LIB_TREE_SEARCH_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( ShortTerms )
+{
+    for( const wxString& search : { wxT( "r" ), wxT( "c" ), wxT( "Ω" ), wxT( "r c" ),
+                                    wxT( "lm" ), wxT( "op" ), wxT( "µf" ), wxT( "電源" ),
+                                    wxT( "10" ) } )
+    {
+        checkSearch( search );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( IndexedTerms )
+{
+    for( const wxString& search : { wxT( "res" ), wxT( "resistor" ), wxT( "Resistor" ),
+                                    wxT( "lm358" ), wxT( "dual opamp" ), wxT( "opamp lm" ),
+                                    wxT( "10k" ), wxT( "global" ), wxT( "xyz" ),
+                                    wxT( "R_Small" ), wxT( "r_pack04" ), wxT( "amplifier" ),
+                                    wxT( "low-power" ), wxT( "tl0 dual" ) } )
+    {
+        checkSearch( search );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( Keywords )
+{
+    // Matched in the keywords only, not in the names or descriptions
+    for( const wxString& search : { wxT( "choke" ), wxT( "isolated" ), wxT( "ground" ),
+                                    wxT( "élco" ), wxT( "parallel topology" ) } )
+    {
+        checkSearch( search );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( NonAsciiTerms )
+{
+    for( const wxString& search : { wxT( "1kω" ), wxT( "widerstand_1kΩ" ), wxT( "größe" ),
+                                    wxT( "100µf" ), wxT( "résistance" ), wxT( "RÉSISTANCE" ),
+                                    wxT( "métallique" ), wxT( "抵抗器" ), wxT( "チップ抵抗" ),
+                                    wxT( "конденсатор" ), wxT( "КОНДЕНСАТОР" ),
+                                    wxT( "емкости" ), wxT( "部品" ) } )
+    {
+        checkSearch( search );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( SpecialTerms )
+{
+    // Regex, wildcard and relational terms are not looked up in the index
+    for( const wxString& search : { wxT( "r*" ), wxT( "lm3?4" ), wxT( "r.s" ), wxT( "^res" ),
+                                    wxT( "lm[0-9]+" ), wxT( "(tl|lm)0" ), wxT( "r<10k" ),
+                                    wxT( "res$" ), wxT( "dual lm*" ) } )
+    {
+        checkSearch( search );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( LibraryFilter )
+{
+    for( const wxString& search : { wxT( "device:r" ), wxT( "device:res" ), wxT( "power:" ),
+                                    wxT( "power:gnd" ), wxT( "amplifier_operational:dual" ),
+                                    wxT( "bauteile:kondensator" ), wxT( "nolib:res" ) } )
+    {
+        checkSearch( search );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( LibraryNames )
+{
+    // Items of a library whose name contains the term match through their parent
+    for( const wxString& search : { wxT( "amplifier_op" ), wxT( "device" ), wxT( "bauteile" ),
+                                    wxT( "composants" ) } )
+    {
+        checkSearch( search );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( Typing )
+{
+    // Each search extends the previous one, so the results of the previous search are reused
+    wxString typed;
+
+    for( wxUniChar c : wxString( wxT( "resistor network 10k" ) ) )
+    {
+        typed += c;
+        checkSearch( typed );
+    }
+
+    // Then removing characters, and switching to regex terms and back
+    for( const wxString& search : { wxT( "resistor net" ), wxT( "resistor" ), wxT( "res" ),
+                                    wxT( "res*" ), wxT( "res*o" ), wxT( "reso" ), wxT( "r" ),
+                                    wxT( "" ), wxT( "lm3" ), wxT( "lm35" ), wxT( "lm358" ),
+                                    wxT( "lm358 " ), wxT( "lm358 d" ), wxT( "lm358 du" ) } )
+    {
+        checkSearch( search );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( TreeChanges )
+{
+    checkSearch( wxT( "capacitor" ) );
+
+    // A new item is found once added, which rebuilds the index
+    m_items.emplace_back( wxT( "Device" ), wxT( "C_Polarized" ), wxT( "Polarized capacitor" ),
+                          wxT( "cap capacitor elec" ) );
+
+    for( LIB_TREE_NODE_ROOT* root : { &m_indexed, &m_scanned } )
+    {
+        for( std::unique_ptr<LIB_TREE_NODE>& lib : root->m_Children )
+        {
+            if( lib->m_Name == wxT( "Device" ) )
+                static_cast<LIB_TREE_NODE_LIB*>( lib.get() )->AddItem( &m_items.back() );
+        }
+    }
+
+    checkSearch( wxT( "capacitor e" ) );
+    checkSearch( wxT( "capacitor" ) );
+
+    std::vector<std::tuple<wxString, wxString, int>> found = matches( m_indexed );
+
+    BOOST_CHECK( std::any_of( found.begin(), found.end(),
+                              []( const std::tuple<wxString, wxString, int>& aMatch )
+                              {
+                                  return std::get<1>( aMatch ) == wxT( "C_Polarized" );
+                              } ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,337 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the decimation of the continuous plots: the lines built from the decimated
+ * points must be the lines built from all the points.
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <widgets/mathplot.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+
+/**
+ * A view of a plot, with the same transforms as mpWindow::x2p() and mpWindow::y2p(), and a
+ * linear or a logarithmic x scale.
+ */
+struct PLOT_VIEW
+{
+    double  m_posX;
+    double  m_scaleX;
+    double  m_posY;
+    double  m_scaleY;
+    wxCoord m_startPx;
+    wxCoord m_endPx;
+    bool    m_logX;
+
+    double transformX( double aX ) const { return m_logX ? std::log10( aX ) : aX; }
+
+    wxCoord x2p( double aX ) const
+    {
+        return (wxCoord) ( ( transformX( aX ) - m_posX ) * m_scaleX );
+    }
+
+    wxCoord y2p( double aY ) const
+    {
+        return (wxCoord) ( ( m_posY - aY ) * m_scaleY );
+    }
+};
+
+
+struct PLOT_DATA
+{
+    std::vector<double> m_xs;
+    std::vector<double> m_ys;
+
+    PLOT_DATA Prefix( size_t aCount ) const
+    {
+        return { std::vector<double>( m_xs.begin(), m_xs.begin() + aCount ),
+                 std::vector<double>( m_ys.begin(), m_ys.begin() + aCount ) };
+    }
+};
+
+
+/// A deterministic noise in [-1, 1]
+class NOISE
+{
+public:
+    double Next()
+    {
+        m_state = m_state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (double) ( m_state >> 11 ) / (double) ( 1ULL << 52 ) - 1.0;
+    }
+
+private:
+    uint64_t m_state = 12345;
+};
+
+
+static void updateDecimator( mpLineDecimator& aDecimator, const PLOT_DATA& aData,
+                             const PLOT_VIEW& aView )
+{
+    aDecimator.Update( aData.m_xs, aData.m_ys,
+                       [&]( double x )
+                       {
+                           return aView.transformX( x );
+                       },
+                       aView.m_posX, aView.m_scaleX, aView.m_startPx, aView.m_endPx );
+}
+
+
+/**
+ * Build the line of the points of the data, as mpFXY::Plot() does.
+ *
+ * @param aIndices are the indices of the points to plot, or nullptr to plot all the points.
+ */
+static mpContinuousLine buildLine( const PLOT_DATA& aData, const PLOT_VIEW& aView,
+                                   const std::vector<size_t>* aIndices )
+{
+    mpContinuousLine line( aView.m_startPx, aView.m_endPx );
+
+    auto addPoint =
+            [&]( size_t ii )
+            {
+                line.AddPoint( aView.x2p( aData.m_xs[ii] ), aView.y2p( aData.m_ys[ii] ) );
+            };
+
+    if( aIndices )
+    {
+        for( size_t ii : *aIndices )
+            addPoint( ii );
+    }
+    else
+    {
+        for( size_t ii = 0; ii < aData.m_xs.size(); ii++ )
+            addPoint( ii );
+    }
+
+    return line;
+}
+
+
+/**
+ * Check that the decimated points of the data draw the same lines as all its points, and
+ * that they are fewer.
+ */
+static void checkDecimation( const mpLineDecimator& aDecimator, const PLOT_DATA& aData,
+                             const PLOT_VIEW& aView )
+{
+    const mpContinuousLine expected = buildLine( aData, aView, nullptr );
+    const mpContinuousLine actual = buildLine( aData, aView, &aDecimator.GetIndices() );
+
+    BOOST_CHECK( expected.GetLinePoints() == actual.GetLinePoints() );
+    BOOST_CHECK( expected.GetVerticalLines() == actual.GetVerticalLines() );
+
+    // Check the test draws something
+    BOOST_CHECK_GT( expected.GetLinePoints().size(), 1 );
+
+    // The selected points are in the data order
+    for( size_t ii = 1; ii < aDecimator.GetIndices().size(); ii++ )
+        BOOST_CHECK_LT( aDecimator.GetIndices()[ii - 1], aDecimator.GetIndices()[ii] );
+
+    BOOST_CHECK_LE( aDecimator.GetIndices().size(), aData.m_xs.size() );
+}
+
+
+/// A noisy sine wave of many points per pixel column
+static PLOT_DATA noisySine()
+{
+    PLOT_DATA data;
+    NOISE     noise;
+
+    for( int ii = 0; ii < 20000; ii++ )
+    {
+        data.m_xs.push_back( ii * 1e-7 );
+        data.m_ys.push_back( std::sin( ii * 1e-3 ) + 0.1 * noise.Next() );
+    }
+
+    return data;
+}
+
+
+/// The whole sine wave, on 520 pixel columns
+static const PLOT_VIEW SINE_VIEW = { -1e-4, 520 / 2.2e-3, 1.2, 200.0, 40, 560, false };
+
+
+BOOST_AUTO_TEST_SUITE( MathPlotDecimation )
+
+
+BOOST_AUTO_TEST_CASE( SameLines )
+{
+    const PLOT_DATA data = noisySine();
+    mpLineDecimator decimator;
+
+    updateDecimator( decimator, data, SINE_VIEW );
+    checkDecimation( decimator, data, SINE_VIEW );
+
+    // About four points per column are selected
+    BOOST_CHECK_LT( decimator.GetIndices().size(), 5 * 520 );
+}
+
+
+/**
+ * Points appended to the data extend the selected points, as selecting them from all the data
+ */
+BOOST_AUTO_TEST_CASE( AppendedData )
+{
+    const PLOT_DATA data = noisySine();
+    mpLineDecimator decimator;
+
+    // Appended by chunks of different sizes, and of a single point
+    for( size_t count : { 1000, 7777, 7778, 7779, 12345, 20000 } )
+    {
+        BOOST_TEST_CONTEXT( count << " points" )
+        {
+            const PLOT_DATA prefix = data.Prefix( count );
+            mpLineDecimator fresh;
+
+            updateDecimator( decimator, prefix, SINE_VIEW );
+            updateDecimator( fresh, prefix, SINE_VIEW );
+
+            BOOST_CHECK( decimator.GetIndices() == fresh.GetIndices() );
+            checkDecimation( decimator, prefix, SINE_VIEW );
+        }
+    }
+}
+
+
+/**
+ * The selected points are selected again for a new view, zoomed, panned or resized, and
+ * with the data partly out of the view
+ */
+BOOST_AUTO_TEST_CASE( ChangedView )
+{
+    const PLOT_DATA data = noisySine();
+    mpLineDecimator decimator;
+
+    const PLOT_VIEW zoomed = { 3e-4, 520 / 0.2e-3, 1.2, 200.0, 40, 560, false };
+    const PLOT_VIEW panned = { 5e-4, 520 / 0.2e-3, 1.2, 200.0, 40, 560, false };
+    const PLOT_VIEW resized = { 5e-4, 520 / 0.2e-3, 1.2, 200.0, 40, 760, false };
+    const PLOT_VIEW scaledY = { 5e-4, 520 / 0.2e-3, 0.4, 700.0, 40, 760, false };
+
+    for( const PLOT_VIEW& view : { SINE_VIEW, zoomed, panned, resized, scaledY, SINE_VIEW } )
+    {
+        BOOST_TEST_CONTEXT( "View at " << view.m_posX << ", scale " << view.m_scaleX )
+        {
+            // The y view does not change the selected points
+            updateDecimator( decimator, data, view );
+            checkDecimation( decimator, data, view );
+        }
+    }
+}
+
+
+/**
+ * A logarithmic x scale, as the AC analyses use
+ */
+BOOST_AUTO_TEST_CASE( LogScale )
+{
+    PLOT_DATA data;
+    NOISE     noise;
+
+    for( int ii = 0; ii <= 30000; ii++ )
+    {
+        double f = std::pow( 10.0, ii * 6.0 / 30000 );
+
+        data.m_xs.push_back( f );
+        data.m_ys.push_back( -20.0 * std::log10( 1.0 + f / 1e3 ) + noise.Next() );
+    }
+
+    const PLOT_VIEW full = { -0.2, 520 / 6.4, 5.0, 3.0, 40, 560, true };
+    const PLOT_VIEW zoomed = { 2.5, 520 / 1.0, -10.0, 10.0, 40, 560, true };
+    mpLineDecimator decimator;
+
+    updateDecimator( decimator, data, full );
+    checkDecimation( decimator, data, full );
+
+    updateDecimator( decimator, data, zoomed );
+    checkDecimation( decimator, data, zoomed );
+
+    // Appended points
+    decimator.Clear();
+    updateDecimator( decimator, data.Prefix( 29000 ), zoomed );
+    updateDecimator( decimator, data, zoomed );
+    checkDecimation( decimator, data, zoomed );
+}
+
+
+/**
+ * The x values going back and forth, e.g. a hysteresis loop of a DC sweep, in and out of
+ * the view on both sides
+ */
+BOOST_AUTO_TEST_CASE( NonMonotonicX )
+{
+    PLOT_DATA data;
+    NOISE     noise;
+
+    for( int ii = 0; ii < 20000; ii++ )
+    {
+        double t = ii * 2e-3;
+
+        data.m_xs.push_back( 1.5 * std::sin( t ) + 0.01 * noise.Next() );
+        data.m_ys.push_back( std::tanh( 4.0 * std::sin( t - 0.5 ) ) + 0.05 * noise.Next() );
+    }
+
+    const PLOT_VIEW view = { -1.0, 520 / 2.0, 1.2, 200.0, 40, 560, false };
+    mpLineDecimator decimator;
+
+    updateDecimator( decimator, data.Prefix( 9000 ), view );
+    checkDecimation( decimator, data.Prefix( 9000 ), view );
+
+    updateDecimator( decimator, data, view );
+    checkDecimation( decimator, data, view );
+}
+
+
+/**
+ * The vertical line of a column is only drawn from three points, so a column of three or
+ * more points keeps three of them
+ */
+BOOST_AUTO_TEST_CASE( ShortRuns )
+{
+    const PLOT_VIEW view = { 0.0, 1.0, 100.0, 1.0, 0, 100, false };
+
+    // Column 10: 2 points, column 20: 3 rising points, column 30: 5 rising points, column 40:
+    // 4 points with the extrema inside
+    const PLOT_DATA data = { { 10.1, 10.5, 20.1, 20.4, 20.7, 30.1, 30.2, 30.3, 30.4, 30.5,
+                               40.1, 40.2, 40.3, 40.4, 50.0 },
+                             { 1, 5, 1, 5, 9, 1, 3, 5, 7, 9, 5, 1, 9, 5, 5 } };
+    mpLineDecimator decimator;
+
+    updateDecimator( decimator, data, view );
+    checkDecimation( decimator, data, view );
+
+    const mpContinuousLine line = buildLine( data, view, nullptr );
+
+    // Columns 20, 30 and 40 have a vertical line, drawn when the next column starts
+    BOOST_CHECK_EQUAL( line.GetVerticalLines().size(), 3 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,83 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for PLOT_LINE_FORMATTER
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <climits>
+
+// Code under test
+#include <plotters/plot_line_formatter.h>
+
+
+BOOST_AUTO_TEST_SUITE( PlotLineFormatter )
+
+
+/**
+ * The formatter must produce exactly what the printf formats it replaces produce
+ */
+BOOST_AUTO_TEST_CASE( MatchesPrintf )
+{
+    const std::vector<int> values = { 0, 1, -1, 9, 10, -9, -10, 99, 100, 123456789,
+                                      INT_MAX, INT_MIN };
+
+    for( int x : values )
+    {
+        for( int y : values )
+        {
+            BOOST_TEST_CONTEXT( "Testing: " << x << ", " << y )
+            {
+                char expected[256];
+                snprintf( expected, sizeof( expected ), "X%dY%dD%02d*\n", x, y, y % 100 );
+
+                PLOT_LINE_FORMATTER line;
+                line.Char( 'X' ).Int( x ).Char( 'Y' ).Int( y ).Char( 'D' ).Int02( y % 100 )
+                    .Str( "*\n" );
+
+                BOOST_CHECK_EQUAL( std::string( line.GetData(), line.GetLength() ),
+                                   std::string( expected ) );
+            }
+        }
+    }
+}
+
+
+/**
+ * Overlong lines are truncated, never overflowed
+ */
+BOOST_AUTO_TEST_CASE( Truncation )
+{
+    PLOT_LINE_FORMATTER line;
+
+    for( int ii = 0; ii < 100; ii++ )
+        line.Str( "X" ).Int( INT_MIN );
+
+    BOOST_CHECK_EQUAL( line.GetLength(), 256U );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
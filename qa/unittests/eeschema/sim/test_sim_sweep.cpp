@@ -0,0 +1,171 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the netlists and raw files of SIM_SWEEP
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+// Code under test
+#include <sim/sim_sweep.h>
+
+#include <cstring>
+
+
+BOOST_AUTO_TEST_SUITE( SimSweep )
+
+
+BOOST_AUTO_TEST_CASE( VariantNetlist )
+{
+    SIM_SWEEP::VARIANT variant;
+    variant.m_Changes.push_back( { "R1", 1000.0 } );
+    variant.m_Changes.push_back( { "C1", 1e-9 } );
+
+    std::string netlist = "KiCad schematic\nV1 in 0 1\nR1 in out 1k\nC1 out 0 1n\n"
+                          ".tran 1u 1m\n.end\n";
+
+    std::string result = SIM_SWEEP::BuildVariantNetlist( netlist, variant, { "v(out)" },
+                                                         "run.raw" );
+
+    BOOST_CHECK_EQUAL( result, "KiCad schematic\nV1 in 0 1\nR1 in out 1k\nC1 out 0 1n\n"
+                               ".tran 1u 1m\n"
+                               ".control\nalter R1 = 1000\nalter C1 = 1e-09\nrun\n"
+                               "write \"run.raw\" v(out)\n.endc\n"
+                               ".end\n" );
+
+    // A netlist without .end line is closed
+    result = SIM_SWEEP::BuildVariantNetlist( "R1 in 0 1k", SIM_SWEEP::VARIANT(), {}, "run.raw" );
+
+    BOOST_CHECK_EQUAL( result, "R1 in 0 1k\n.control\nrun\nwrite \"run.raw\"\n.endc\n.end\n" );
+}
+
+
+BOOST_AUTO_TEST_CASE( VectorNames )
+{
+    BOOST_CHECK_EQUAL( SIM_SWEEP::NormalizeVectorName( "V(OUT)" ), "v(out)" );
+    BOOST_CHECK_EQUAL( SIM_SWEEP::NormalizeVectorName( "V1#branch" ), "i(v1)" );
+    BOOST_CHECK_EQUAL( SIM_SWEEP::NormalizeVectorName( "time" ), "time" );
+}
+
+
+BOOST_AUTO_TEST_CASE( AsciiRawFile )
+{
+    std::string raw = "Title: test\n"
+                      "Date: today\n"
+                      "Plotname: AC Analysis\n"
+                      "Flags: complex\n"
+                      "No. Variables: 2\n"
+                      "No. Points: 2\n"
+                      "Variables:\n"
+                      "\t0\tfrequency\tfrequency grid=3\n"
+                      "\t1\tv1#branch\tcurrent\n"
+                      "Values:\n"
+                      " 0\t1.000000e+00,0.000000e+00\n"
+                      "\t3.000000e+00,4.000000e+00\n"
+                      "\n"
+                      " 1\t1.000000e+01,0.000000e+00\n"
+                      "\t-1.000000e+00,2.000000e+00\n";
+
+    SIM_SWEEP::RESULT result;
+
+    BOOST_REQUIRE( SIM_SWEEP::ParseRawFile( raw, result ) );
+    BOOST_CHECK( result.m_Complex );
+
+    SPICE_VECTOR_VIEW current = result.GetVector( "V1#branch" );
+
+    BOOST_REQUIRE_EQUAL( current.size(), 2 );
+    BOOST_CHECK_EQUAL( current.Real( 0 ), 3.0 );
+    BOOST_CHECK_EQUAL( current.Imag( 0 ), 4.0 );
+    BOOST_CHECK_CLOSE( current.Mag( 0 ), 5.0, 1e-9 );
+    BOOST_CHECK_EQUAL( current.Real( 1 ), -1.0 );
+    BOOST_CHECK_EQUAL( current.Imag( 1 ), 2.0 );
+
+    BOOST_CHECK_EQUAL( result.GetVector( "frequency" ).Real( 1 ), 10.0 );
+    BOOST_CHECK( result.GetVector( "v(missing)" ).empty() );
+}
+
+
+BOOST_AUTO_TEST_CASE( BinaryRawFile )
+{
+    std::string raw = "Title: test\n"
+                      "Plotname: Transient Analysis\n"
+                      "Flags: real\n"
+                      "No. Variables: 2\n"
+                      "No. Points: 3\n"
+                      "Variables:\n"
+                      "\t0\ttime\ttime\n"
+                      "\t1\tv(out)\tvoltage\n"
+                      "Binary:\n";
+
+    const double values[] = { 0.0, 1.0, 1e-3, 0.5, 2e-3, 0.25 };
+    std::string  data( sizeof( values ), '\0' );
+    std::memcpy( &data[0], values, sizeof( values ) );
+
+    SIM_SWEEP::RESULT result;
+
+    BOOST_REQUIRE( SIM_SWEEP::ParseRawFile( raw + data, result ) );
+    BOOST_CHECK( !result.m_Complex );
+
+    SPICE_VECTOR_VIEW time = result.GetVector( "time" );
+    SPICE_VECTOR_VIEW out = result.GetVector( "V(OUT)" );
+
+    BOOST_REQUIRE_EQUAL( time.size(), 3 );
+    BOOST_REQUIRE_EQUAL( out.size(), 3 );
+    BOOST_CHECK_EQUAL( time.Real( 2 ), 2e-3 );
+    BOOST_CHECK_EQUAL( out.Real( 1 ), 0.5 );
+
+    // A truncated file is an error
+    SIM_SWEEP::RESULT truncated;
+
+    BOOST_CHECK( !SIM_SWEEP::ParseRawFile( raw + data.substr( 0, data.size() - 4 ),
+                                           truncated ) );
+
+    // So is a file ending with the header, without an end of line
+    SIM_SWEEP::RESULT empty;
+
+    BOOST_CHECK( !SIM_SWEEP::ParseRawFile( raw.substr( 0, raw.size() - 1 ), empty ) );
+}
+
+
+BOOST_AUTO_TEST_CASE( StepVariants )
+{
+    SIM_SWEEP sweep( "R1 in 0 1k\n.end\n" );
+
+    sweep.AddStepVariants( "R1", 100.0, 300.0, 3 );
+
+    const std::vector<SIM_SWEEP::VARIANT>& variants = sweep.GetVariants();
+
+    BOOST_REQUIRE_EQUAL( variants.size(), 3 );
+
+    for( size_t ii = 0; ii < variants.size(); ii++ )
+    {
+        BOOST_REQUIRE_EQUAL( variants[ii].m_Changes.size(), 1 );
+        BOOST_CHECK_EQUAL( variants[ii].m_Changes[0].m_Device, "R1" );
+        BOOST_CHECK_CLOSE( variants[ii].m_Changes[0].m_Value, 100.0 * ( ii + 1 ), 1e-9 );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,111 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for SPICE_VECTOR_VIEW
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+// Code under test
+#include <sim/spice_simulator.h>
+
+#include <cmath>
+
+
+BOOST_AUTO_TEST_SUITE( SpiceVectorView )
+
+
+BOOST_AUTO_TEST_CASE( Empty )
+{
+    SPICE_VECTOR_VIEW view;
+
+    BOOST_CHECK( view.empty() );
+    BOOST_CHECK_EQUAL( view.size(), 0 );
+
+    // A view on a missing vector is empty whatever the size
+    BOOST_CHECK( SPICE_VECTOR_VIEW( nullptr, 10, false ).empty() );
+}
+
+
+BOOST_AUTO_TEST_CASE( Real )
+{
+    const double      data[] = { 1.0, -2.0, 3.0 };
+    SPICE_VECTOR_VIEW view( data, 3, false );
+
+    BOOST_CHECK( !view.IsComplex() );
+    BOOST_CHECK_EQUAL( view.size(), 3 );
+
+    for( size_t i = 0; i < view.size(); i++ )
+    {
+        BOOST_CHECK_EQUAL( view.Real( i ), data[i] );
+        BOOST_CHECK_EQUAL( view.Imag( i ), 0.0 );
+        BOOST_CHECK_EQUAL( view.Mag( i ), data[i] );      // the sign is kept
+        BOOST_CHECK_EQUAL( view.Phase( i ), 0.0 );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( Complex )
+{
+    const double      data[] = { 3.0, 4.0, 0.0, -1.0 };
+    SPICE_VECTOR_VIEW view( data, 2, true );
+
+    BOOST_CHECK( view.IsComplex() );
+    BOOST_CHECK_EQUAL( view.size(), 2 );
+
+    BOOST_CHECK_EQUAL( view.Real( 0 ), 3.0 );
+    BOOST_CHECK_EQUAL( view.Imag( 0 ), 4.0 );
+    BOOST_CHECK_CLOSE( view.Mag( 0 ), 5.0, 1e-9 );
+    BOOST_CHECK_CLOSE( view.Phase( 0 ), std::atan2( 4.0, 3.0 ), 1e-9 );
+
+    BOOST_CHECK_CLOSE( view.Mag( 1 ), 1.0, 1e-9 );
+    BOOST_CHECK_CLOSE( view.Phase( 1 ), -M_PI / 2, 1e-9 );
+}
+
+
+BOOST_AUTO_TEST_CASE( Slice )
+{
+    const double      data[] = { 0.0, 1.0, 2.0, 3.0, 4.0, 5.0 };
+    SPICE_VECTOR_VIEW real( data, 6, false );
+    SPICE_VECTOR_VIEW complex( data, 3, true );
+
+    SPICE_VECTOR_VIEW slice = real.Slice( 2, 3 );
+    BOOST_CHECK_EQUAL( slice.size(), 3 );
+    BOOST_CHECK_EQUAL( slice.Real( 0 ), 2.0 );
+    BOOST_CHECK_EQUAL( slice.Real( 2 ), 4.0 );
+
+    // The slices are clamped to the view
+    BOOST_CHECK_EQUAL( real.Slice( 4, 10 ).size(), 2 );
+    BOOST_CHECK( real.Slice( 6, 1 ).empty() );
+
+    slice = complex.Slice( 1, 2 );
+    BOOST_CHECK_EQUAL( slice.size(), 2 );
+    BOOST_CHECK_EQUAL( slice.Real( 0 ), 2.0 );
+    BOOST_CHECK_EQUAL( slice.Imag( 0 ), 3.0 );
+    BOOST_CHECK_EQUAL( slice.Imag( 1 ), 5.0 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -294,4 +294,70 @@ BOOST_AUTO_TEST_CASE( SingleElementTree )
         delete item;
 }
 
+/**
+ * Check that a rebuilt tree indexes the items at their current positions
+ */
+BOOST_AUTO_TEST_CASE( Rebuild )
+{
+    std::vector<SCH_JUNCTION*> junctions;
+
+    for( int i = 0; i < 100; i++ )
+    {
+        SCH_JUNCTION* junction = new SCH_JUNCTION(
+                VECTOR2I( schIUScale.MilsToIU( 100 ) * i, schIUScale.MilsToIU( 100 ) * i ) );
+        m_tree.insert( junction );
+        junctions.push_back( junction );
+
+        SCH_NO_CONNECT* nc = new SCH_NO_CONNECT(
+                VECTOR2I( schIUScale.MilsToIU( 100 ) * i, -schIUScale.MilsToIU( 100 ) * i ) );
+        m_tree.insert( nc );
+    }
+
+    // Move the junctions to the left, out of their indexed bounding boxes
+    for( SCH_JUNCTION* junction : junctions )
+        junction->SetPosition( VECTOR2I( -junction->GetPosition().x, junction->GetPosition().y ) );
+
+    m_tree.rebuild();
+
+    BOOST_CHECK_EQUAL( m_tree.size(), 200 );
+
+    // Both boxes leave out the items at the origin
+    BOX2I left_bbox( VECTOR2I( -schIUScale.MilsToIU( 10000 ), -schIUScale.MilsToIU( 10000 ) ),
+                     VECTOR2I( schIUScale.MilsToIU( 9950 ), schIUScale.MilsToIU( 20000 ) ) );
+    BOX2I right_bbox( VECTOR2I( schIUScale.MilsToIU( 50 ), -schIUScale.MilsToIU( 10000 ) ),
+                      VECTOR2I( schIUScale.MilsToIU( 10000 ), schIUScale.MilsToIU( 20000 ) ) );
+
+    int count = 0;
+
+    for( SCH_ITEM* item : m_tree.Overlapping( left_bbox ) )
+    {
+        BOOST_CHECK( item->Type() == SCH_JUNCTION_T );
+        count++;
+    }
+
+    BOOST_CHECK_EQUAL( count, 99 );
+
+    count = 0;
+
+    for( SCH_ITEM* item : m_tree.Overlapping( right_bbox ) )
+    {
+        BOOST_CHECK( item->Type() == SCH_NO_CONNECT_T );
+        count++;
+    }
+
+    BOOST_CHECK_EQUAL( count, 99 );
+
+    // The rebuilt tree can be modified as usual
+    for( SCH_JUNCTION* junction : junctions )
+    {
+        BOOST_CHECK( m_tree.remove( junction ) );
+        delete junction;
+    }
+
+    BOOST_CHECK_EQUAL( m_tree.size(), 100 );
+
+    for( SCH_ITEM* item : m_tree )
+        delete item;
+}
+
 BOOST_AUTO_TEST_SUITE_END()
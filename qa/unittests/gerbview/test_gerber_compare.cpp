@@ -0,0 +1,128 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <base_units.h>
+#include <gerber_compare.h>
+#include <gerber_draw_item.h>
+#include <gerber_file_image.h>
+
+
+/**
+ * Add a grid of round segments to an image, the segment of the row \a aMovedRow being
+ * moved by \a aMove.
+ */
+static void addSegments( GERBER_FILE_IMAGE& aImage, int aMovedRow, const VECTOR2I& aMove )
+{
+    const int pitch = gerbIUScale.mmToIU( 1.0 );
+
+    for( int row = 0; row < 50; row++ )
+    {
+        for( int col = 0; col < 50; col++ )
+        {
+            GERBER_DRAW_ITEM* item = aImage.NewItem();
+            VECTOR2I          start( col * pitch, row * pitch );
+
+            if( row == aMovedRow )
+                start += aMove;
+
+            item->m_Shape = GBR_SEGMENT;
+            item->m_Start = start;
+            item->m_End = start + VECTOR2I( pitch / 2, 0 );
+            item->m_Size = wxSize( pitch / 4, pitch / 4 );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE( GerberCompare )
+
+
+BOOST_AUTO_TEST_CASE( SameImages )
+{
+    GERBER_FILE_IMAGE reference( 0 );
+    GERBER_FILE_IMAGE compared( 1 );
+
+    addSegments( reference, -1, VECTOR2I( 0, 0 ) );
+    addSegments( compared, -1, VECTOR2I( 0, 0 ) );
+
+    GERBER_COMPARE compare( &reference, &compared );
+
+    BOOST_REQUIRE( compare.Compare() );
+    BOOST_CHECK_EQUAL( compare.GetDifferences().OutlineCount(), 0 );
+}
+
+
+BOOST_AUTO_TEST_CASE( MovedItems )
+{
+    GERBER_FILE_IMAGE reference( 0 );
+    GERBER_FILE_IMAGE compared( 1 );
+
+    addSegments( reference, -1, VECTOR2I( 0, 0 ) );
+    addSegments( compared, 10, VECTOR2I( 0, gerbIUScale.mmToIU( 0.1 ) ) );
+
+    GERBER_COMPARE compare( &reference, &compared );
+    compare.SetTileSize( gerbIUScale.mmToIU( 50.0 ) );
+
+    BOOST_REQUIRE( compare.Compare() );
+    BOOST_CHECK_EQUAL( compare.GetTileCount(), 1 );
+
+    SHAPE_POLY_SET wholeLayer = compare.GetDifferences();
+
+    // Each moved segment differs at its top and its bottom
+    BOOST_CHECK_EQUAL( wholeLayer.OutlineCount(), 100 );
+
+    // The differences do not depend on the tiles
+    compare.SetTileSize( gerbIUScale.mmToIU( 3.0 ) );
+
+    BOOST_REQUIRE( compare.Compare() );
+    BOOST_CHECK_GT( compare.GetTileCount(), 1 );
+
+    SHAPE_POLY_SET tiled = compare.GetDifferences();
+
+    BOOST_CHECK_EQUAL( tiled.OutlineCount(), wholeLayer.OutlineCount() );
+    BOOST_CHECK_CLOSE( tiled.Area(), wholeLayer.Area(), 0.1 );
+}
+
+
+BOOST_AUTO_TEST_CASE( NegativeItems )
+{
+    GERBER_FILE_IMAGE reference( 0 );
+    GERBER_FILE_IMAGE compared( 1 );
+
+    addSegments( reference, -1, VECTOR2I( 0, 0 ) );
+    addSegments( compared, -1, VECTOR2I( 0, 0 ) );
+
+    // Clear the first segment in the compared image
+    GERBER_DRAW_ITEM* clear = compared.NewItem( *compared.GetItems()[0] );
+    clear->SetLayerPolarity( true );
+
+    GERBER_COMPARE compare( &reference, &compared );
+
+    BOOST_REQUIRE( compare.Compare() );
+    BOOST_CHECK_EQUAL( compare.GetDifferences().OutlineCount(), 1 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,115 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <gerber_file_image.h>
+#include <gerber_draw_item.h>
+
+
+BOOST_AUTO_TEST_SUITE( GerberFileImage )
+
+
+BOOST_AUTO_TEST_CASE( NewItems )
+{
+    GERBER_FILE_IMAGE image( 0 );
+
+    // More than one block of items
+    for( int ii = 0; ii < 3000; ii++ )
+    {
+        GERBER_DRAW_ITEM* item = image.NewItem();
+        item->m_Start = VECTOR2I( ii, 0 );
+    }
+
+    BOOST_REQUIRE_EQUAL( image.GetItemsCount(), 3000 );
+
+    for( int ii = 0; ii < 3000; ii++ )
+    {
+        BOOST_CHECK_EQUAL( image.GetItems()[ii]->m_Start.x, ii );
+        BOOST_CHECK( image.GetItems()[ii]->m_GerberImageFile == &image );
+    }
+
+    GERBER_DRAW_ITEM* copy = image.NewItem( *image.GetItems()[10] );
+
+    BOOST_CHECK_EQUAL( image.GetItemsCount(), 3001 );
+    BOOST_CHECK( image.GetLastItemInList() == copy );
+    BOOST_CHECK_EQUAL( copy->m_Start.x, 10 );
+}
+
+
+BOOST_AUTO_TEST_CASE( SharedNetAttributes )
+{
+    GERBER_FILE_IMAGE image( 0 );
+
+    GBR_NETLIST_METADATA attributes;
+    attributes.m_NetAttribType = GBR_NETLIST_METADATA::GBR_NETINFO_NET;
+    attributes.m_Netname = wxT( "GND" );
+
+    GERBER_DRAW_ITEM* first = image.NewItem();
+    GERBER_DRAW_ITEM* second = image.NewItem();
+    GERBER_DRAW_ITEM* unset = image.NewItem();
+
+    first->SetNetAttributes( attributes );
+    second->SetNetAttributes( attributes );
+
+    // Consecutive items with the same attributes share them
+    BOOST_CHECK( &first->GetNetAttributes() == &second->GetNetAttributes() );
+    BOOST_CHECK( first->GetNetAttributes().m_Netname == wxT( "GND" ) );
+    BOOST_CHECK_EQUAL( unset->GetNetAttributes().m_NetAttribType,
+                       GBR_NETLIST_METADATA::GBR_NETINFO_UNSPECIFIED );
+
+    attributes.m_Netname = wxT( "VCC" );
+
+    GERBER_DRAW_ITEM* third = image.NewItem();
+    third->SetNetAttributes( attributes );
+
+    BOOST_CHECK( third->GetNetAttributes().m_Netname == wxT( "VCC" ) );
+    BOOST_CHECK( first->GetNetAttributes().m_Netname == wxT( "GND" ) );
+    BOOST_CHECK_EQUAL( image.m_NetnamesList.size(), 2 );
+}
+
+
+BOOST_AUTO_TEST_CASE( AbsolutePolygon )
+{
+    GERBER_FILE_IMAGE image( 0 );
+    GERBER_DRAW_ITEM* item = image.NewItem();
+
+    item->m_Shape = GBR_POLYGON;
+    item->m_Polygon.NewOutline();
+    item->m_Polygon.Append( VECTOR2I( 0, 0 ) );
+    item->m_Polygon.Append( VECTOR2I( 100, 0 ) );
+    item->m_Polygon.Append( VECTOR2I( 100, 100 ) );
+
+    BOOST_CHECK_EQUAL( item->GetAbsolutePolygon().FullPointCount(), 3 );
+
+    // A moved copy has its own absolute polygon
+    GERBER_DRAW_ITEM* copy = image.NewItem( *item );
+    copy->MoveXY( VECTOR2I( 1000, 0 ) );
+
+    BOOST_CHECK( &copy->GetAbsolutePolygon() != &item->GetAbsolutePolygon() );
+    BOOST_CHECK_EQUAL( copy->GetAbsolutePolygon().BBox().GetX(),
+                       item->GetAbsolutePolygon().BBox().GetX() + 1000 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -237,4 +237,119 @@ BOOST_AUTO_TEST_CASE( StringRoundtrip )
     }
 }
 
+/**
+ * The elements of a list are handed over one at a time, in order
+ */
+BOOST_AUTO_TEST_CASE( ParseListElements )
+{
+    const std::string content{ "(symbol \"string\" 42 (nested 4 ()))" };
+
+    std::vector<std::unique_ptr<SEXPR::SEXPR>> elements;
+
+    const bool completed = m_parser.ParseList( content,
+            [&]( std::unique_ptr<SEXPR::SEXPR> aElement )
+            {
+                elements.push_back( std::move( aElement ) );
+                return true;
+            } );
+
+    BOOST_CHECK( completed );
+    BOOST_REQUIRE_EQUAL( elements.size(), 4 );
+
+    BOOST_CHECK_PREDICATE( KI_TEST::SexprIsSymbolWithValue, ( *elements[0] )( "symbol" ) );
+    BOOST_CHECK_PREDICATE( KI_TEST::SexprIsStringWithValue, ( *elements[1] )( "string" ) );
+    BOOST_CHECK_PREDICATE( KI_TEST::SexprIsIntegerWithValue, ( *elements[2] )( 42 ) );
+    BOOST_REQUIRE_PREDICATE( KI_TEST::SexprIsListOfLength, ( *elements[3] )( 3 ) );
+    BOOST_CHECK_PREDICATE(
+            KI_TEST::SexprIsSymbolWithValue, ( *elements[3]->GetChild( 0 ) )( "nested" ) );
+}
+
+/**
+ * The list elements rejected by the filter are skipped, even if they hold strings with
+ * parentheses
+ */
+BOOST_AUTO_TEST_CASE( ParseListFilter )
+{
+    const std::string content{ "(board (skip (net \"a)(\")) (keep 1) (skip) (keep 2.5))" };
+
+    std::vector<std::unique_ptr<SEXPR::SEXPR>> elements;
+
+    m_parser.ParseList( content,
+            [&]( std::unique_ptr<SEXPR::SEXPR> aElement )
+            {
+                elements.push_back( std::move( aElement ) );
+                return true;
+            },
+            []( const std::string& aSymbol )
+            {
+                return aSymbol != "skip";
+            } );
+
+    BOOST_REQUIRE_EQUAL( elements.size(), 3 );
+
+    BOOST_CHECK_PREDICATE( KI_TEST::SexprIsSymbolWithValue, ( *elements[0] )( "board" ) );
+    BOOST_REQUIRE_PREDICATE( KI_TEST::SexprIsListOfLength, ( *elements[1] )( 2 ) );
+    BOOST_CHECK_PREDICATE(
+            KI_TEST::SexprIsIntegerWithValue, ( *elements[1]->GetChild( 1 ) )( 1 ) );
+    BOOST_REQUIRE_PREDICATE( KI_TEST::SexprIsListOfLength, ( *elements[2] )( 2 ) );
+    BOOST_CHECK_PREDICATE(
+            KI_TEST::SexprIsDoubleWithValue, ( *elements[2]->GetChild( 1 ) )( 2.5 ) );
+}
+
+/**
+ * The handler can stop the parsing
+ */
+BOOST_AUTO_TEST_CASE( ParseListStop )
+{
+    int count = 0;
+
+    const bool completed = m_parser.ParseList( "(a b c d)",
+            [&]( std::unique_ptr<SEXPR::SEXPR> aElement )
+            {
+                return ++count < 2;
+            } );
+
+    BOOST_CHECK( !completed );
+    BOOST_CHECK_EQUAL( count, 2 );
+}
+
+BOOST_AUTO_TEST_CASE( ParseListExceptions )
+{
+    const std::vector<TEST_SEXPR_CASE> cases = {
+        {
+            "Unclosed list",
+            "(symbol (nested 1)",
+        },
+        {
+            "Unclosed skipped list",
+            "(symbol (skip 1)",
+        },
+        {
+            "Unclosed string",
+            "(symbol \"string)",
+        },
+        {
+            "Not a list",
+            "symbol",
+        },
+    };
+
+    for( const auto& c : cases )
+    {
+        BOOST_TEST_CONTEXT( c.m_case_name )
+        {
+            BOOST_CHECK_THROW( m_parser.ParseList( c.m_sexpr_data,
+                                       []( std::unique_ptr<SEXPR::SEXPR> aElement )
+                                       {
+                                           return true;
+                                       },
+                                       []( const std::string& aSymbol )
+                                       {
+                                           return aSymbol != "skip";
+                                       } ),
+                               SEXPR::PARSE_EXCEPTION );
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,335 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the 3D model mesh cache files (".3dm")
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+#include <boost/filesystem.hpp>
+
+#include <3d_cache/3d_mesh_cache.h>
+#include <plugins/3dapi/c3dmodel.h>
+#include <plugins/3dapi/ifsg_api.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+
+namespace fs = boost::filesystem;
+
+
+static const std::string PLUGIN_INFO = "TEST:1.0.0";
+
+/// Header size: magic, 5 values and the plugin info padded to 4 bytes
+static const size_t MATERIALS_OFFSET = 8 + 5 * 4 + 12;
+
+/// Size of a material in the file
+static const size_t MATERIAL_SIZE = 14 * 4;
+
+
+struct MESH_CACHE_FIXTURE
+{
+    MESH_CACHE_FIXTURE()
+    {
+        m_dir = fs::temp_directory_path() / "mesh_cache_tst";
+        fs::remove_all( m_dir );
+        fs::create_directories( m_dir );
+
+        m_model = buildModel();
+    }
+
+    ~MESH_CACHE_FIXTURE()
+    {
+        S3D::Destroy3DModel( &m_model );
+        fs::remove_all( m_dir );
+    }
+
+    /**
+     * Build a model with two materials, a mesh with all the optional arrays and a mesh
+     * with only the positions and normals.
+     */
+    static S3DMODEL* buildModel()
+    {
+        S3DMODEL* model = S3D::New3DModel();
+
+        model->m_MaterialsSize = 2;
+        model->m_Materials = new SMATERIAL[2];
+
+        for( unsigned int i = 0; i < 2; ++i )
+        {
+            SMATERIAL& material = model->m_Materials[i];
+
+            S3D::Init3DMaterial( material );
+            material.m_Ambient = SFVEC3F( 0.1f * i, 0.2f, 0.3f );
+            material.m_Diffuse = SFVEC3F( 0.4f, 0.5f * i, 0.6f );
+            material.m_Emissive = SFVEC3F( 0.7f, 0.8f, 0.9f * i );
+            material.m_Specular = SFVEC3F( 1.0f, 0.25f, 0.125f );
+            material.m_Shininess = 0.5f + i;
+            material.m_Transparency = 0.25f * i;
+        }
+
+        model->m_MeshesSize = 2;
+        model->m_Meshes = new SMESH[2];
+
+        for( unsigned int i = 0; i < 2; ++i )
+        {
+            SMESH& mesh = model->m_Meshes[i];
+
+            S3D::Init3DMesh( mesh );
+            mesh.m_VertexSize = 4 + i;
+            mesh.m_Positions = new SFVEC3F[mesh.m_VertexSize];
+            mesh.m_Normals = new SFVEC3F[mesh.m_VertexSize];
+
+            if( i == 0 )
+            {
+                mesh.m_Texcoords = new SFVEC2F[mesh.m_VertexSize];
+                mesh.m_Color = new SFVEC3F[mesh.m_VertexSize];
+            }
+
+            for( unsigned int v = 0; v < mesh.m_VertexSize; ++v )
+            {
+                mesh.m_Positions[v] = SFVEC3F( v, 2.0f * v + i, -1.5f * v );
+                mesh.m_Normals[v] = SFVEC3F( 0.0f, 0.0f, v % 2 ? 1.0f : -1.0f );
+
+                if( mesh.m_Texcoords )
+                    mesh.m_Texcoords[v] = SFVEC2F( 0.25f * v, 1.0f - 0.25f * v );
+
+                if( mesh.m_Color )
+                    mesh.m_Color[v] = SFVEC3F( 0.1f * v, 0.2f * v, 0.3f );
+            }
+
+            mesh.m_FaceIdxSize = 6;
+            mesh.m_FaceIdx = new unsigned int[6]{ 0, 1, 2, 2, 3, i + 2 };
+            mesh.m_MaterialIdx = 1 - i;
+        }
+
+        return model;
+    }
+
+    std::string fileName( const std::string& aName ) const
+    {
+        return ( m_dir / aName ).string();
+    }
+
+    std::string readFile( const std::string& aName ) const
+    {
+        std::ifstream file( fileName( aName ), std::ios::binary );
+
+        return std::string( std::istreambuf_iterator<char>( file ),
+                            std::istreambuf_iterator<char>() );
+    }
+
+    void writeFile( const std::string& aName, const std::string& aContent ) const
+    {
+        std::ofstream file( fileName( aName ), std::ios::binary | std::ios::trunc );
+
+        file.write( aContent.data(), aContent.size() );
+    }
+
+    /// Write the model, then a copy of its file with a 32 bit value replaced at \a aOffset.
+    std::string writeCorrupt( size_t aOffset, uint32_t aValue )
+    {
+        BOOST_REQUIRE( S3D::WriteMeshCache( fileName( "model.3dm" ), *m_model, PLUGIN_INFO ) );
+
+        std::string content = readFile( "model.3dm" );
+
+        BOOST_REQUIRE( aOffset + sizeof( aValue ) <= content.size() );
+        memcpy( &content[aOffset], &aValue, sizeof( aValue ) );
+        writeFile( "corrupt.3dm", content );
+
+        return fileName( "corrupt.3dm" );
+    }
+
+    fs::path  m_dir;
+    S3DMODEL* m_model;
+};
+
+
+template <typename T>
+static void checkArray( const T* aExpected, const T* aActual, unsigned int aSize )
+{
+    BOOST_REQUIRE_EQUAL( aExpected == nullptr, aActual == nullptr );
+
+    for( unsigned int i = 0; aExpected && i < aSize; ++i )
+        BOOST_CHECK( aExpected[i] == aActual[i] );
+}
+
+
+static void checkModel( const S3DMODEL& aExpected, const S3DMODEL& aActual )
+{
+    BOOST_REQUIRE_EQUAL( aExpected.m_MaterialsSize, aActual.m_MaterialsSize );
+    BOOST_REQUIRE_EQUAL( aExpected.m_MeshesSize, aActual.m_MeshesSize );
+
+    for( unsigned int i = 0; i < aExpected.m_MaterialsSize; ++i )
+    {
+        const SMATERIAL& expected = aExpected.m_Materials[i];
+        const SMATERIAL& actual = aActual.m_Materials[i];
+
+        BOOST_CHECK( expected.m_Ambient == actual.m_Ambient );
+        BOOST_CHECK( expected.m_Diffuse == actual.m_Diffuse );
+        BOOST_CHECK( expected.m_Emissive == actual.m_Emissive );
+        BOOST_CHECK( expected.m_Specular == actual.m_Specular );
+        BOOST_CHECK_EQUAL( expected.m_Shininess, actual.m_Shininess );
+        BOOST_CHECK_EQUAL( expected.m_Transparency, actual.m_Transparency );
+    }
+
+    for( unsigned int i = 0; i < aExpected.m_MeshesSize; ++i )
+    {
+        const SMESH& expected = aExpected.m_Meshes[i];
+        const SMESH& actual = aActual.m_Meshes[i];
+
+        BOOST_REQUIRE_EQUAL( expected.m_VertexSize, actual.m_VertexSize );
+        BOOST_REQUIRE_EQUAL( expected.m_FaceIdxSize, actual.m_FaceIdxSize );
+        BOOST_CHECK_EQUAL( expected.m_MaterialIdx, actual.m_MaterialIdx );
+
+        checkArray( expected.m_Positions, actual.m_Positions, expected.m_VertexSize );
+        checkArray( expected.m_Normals, actual.m_Normals, expected.m_VertexSize );
+        checkArray( expected.m_Texcoords, actual.m_Texcoords, expected.m_VertexSize );
+        checkArray( expected.m_Color, actual.m_Color, expected.m_VertexSize );
+        checkArray( expected.m_FaceIdx, actual.m_FaceIdx, expected.m_FaceIdxSize );
+    }
+}
+
+
+BOOST_FIXTURE_TEST_SUITE( MeshCache3D, MESH_CACHE_FIXTURE )
+
+
+/**
+ * A model written to a mesh cache file is read back identical, with its plugin info
+ */
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+    BOOST_REQUIRE( S3D::WriteMeshCache( fileName( "model.3dm" ), *m_model, PLUGIN_INFO ) );
+
+    std::string pluginInfo;
+    S3DMODEL*   model = S3D::ReadMeshCache( fileName( "model.3dm" ), &pluginInfo );
+
+    BOOST_REQUIRE( model );
+    BOOST_CHECK_EQUAL( pluginInfo, PLUGIN_INFO );
+
+    checkModel( *m_model, *model );
+    S3D::Destroy3DModel( &model );
+
+    // The temporary file the model was written to has been renamed
+    int files = 0;
+
+    for( const fs::directory_entry& entry : fs::directory_iterator( m_dir ) )
+    {
+        BOOST_CHECK_EQUAL( entry.path().filename().string(), "model.3dm" );
+        files++;
+    }
+
+    BOOST_CHECK_EQUAL( files, 1 );
+}
+
+
+/**
+ * Writing a file again replaces it
+ */
+BOOST_AUTO_TEST_CASE( Overwrite )
+{
+    S3DMODEL* empty = S3D::New3DModel();
+
+    BOOST_REQUIRE( S3D::WriteMeshCache( fileName( "model.3dm" ), *empty, PLUGIN_INFO ) );
+    BOOST_REQUIRE( S3D::WriteMeshCache( fileName( "model.3dm" ), *m_model, PLUGIN_INFO ) );
+    S3D::Destroy3DModel( &empty );
+
+    S3DMODEL* model = S3D::ReadMeshCache( fileName( "model.3dm" ) );
+
+    BOOST_REQUIRE( model );
+    checkModel( *m_model, *model );
+    S3D::Destroy3DModel( &model );
+}
+
+
+/**
+ * Every truncated copy of a file is rejected
+ */
+BOOST_AUTO_TEST_CASE( Truncated )
+{
+    BOOST_REQUIRE( S3D::WriteMeshCache( fileName( "model.3dm" ), *m_model, PLUGIN_INFO ) );
+
+    const std::string content = readFile( "model.3dm" );
+
+    for( size_t size = 0; size < content.size(); ++size )
+    {
+        BOOST_TEST_CONTEXT( "Truncated to " << size << " bytes" )
+        {
+            writeFile( "truncated.3dm", content.substr( 0, size ) );
+
+            S3DMODEL* model = S3D::ReadMeshCache( fileName( "truncated.3dm" ) );
+
+            BOOST_CHECK( model == nullptr );
+            S3D::Destroy3DModel( &model );
+        }
+    }
+}
+
+
+/**
+ * Files with an invalid header, counts or indices are rejected
+ */
+BOOST_AUTO_TEST_CASE( Corrupt )
+{
+    const size_t meshOffset = MATERIALS_OFFSET + 2 * MATERIAL_SIZE;
+
+    struct CASE
+    {
+        std::string m_name;
+        size_t      m_offset;
+        uint32_t    m_value;
+    };
+
+    const std::vector<CASE> cases = {
+        { "magic", 0, 0x4d4f5246 },
+        { "version", 8, 0xffff },
+        { "byte order", 12, 0x04030201 },
+        { "plugin info size", 16, 0xfffffff0 },
+        { "materials count", 20, 0x10000000 },
+        { "meshes count", 24, 0x10000000 },
+        { "vertex count", meshOffset, 0xfffffff0 },
+        { "face index count", meshOffset + 4, 0xfffffff0 },
+        { "material index", meshOffset + 8, 2 },
+        { "face index", meshOffset + 16 + 4 * ( 3 + 3 + 2 + 3 ) * 4, 4 },
+    };
+
+    for( const CASE& c : cases )
+    {
+        BOOST_TEST_CONTEXT( c.m_name )
+        {
+            S3DMODEL* model = S3D::ReadMeshCache( writeCorrupt( c.m_offset, c.m_value ) );
+
+            BOOST_CHECK( model == nullptr );
+            S3D::Destroy3DModel( &model );
+        }
+    }
+
+    BOOST_CHECK( S3D::ReadMeshCache( fileName( "missing.3dm" ) ) == nullptr );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,271 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the footprint info cache file and the per library reloading
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+#include <pcbnew_utils/board_file_utils.h>
+#include <boost/filesystem.hpp>
+
+#include <footprint_info_impl.h>
+#include <fp_lib_table.h>
+
+#include <fstream>
+#include <iterator>
+#include <map>
+
+
+namespace fs = boost::filesystem;
+
+
+struct FP_INFO_CACHE_FIXTURE
+{
+    FP_INFO_CACHE_FIXTURE()
+    {
+        m_dir = fs::temp_directory_path() / "fp_info_cache_tst";
+        fs::remove_all( m_dir );
+        fs::create_directories( m_dir );
+
+        std::string dataPath = KI_TEST::GetPcbnewTestDataDir() + "plugins/";
+
+        addLib( "GPS", dataPath + "eagle/lbr/SparkFun-GPS.pretty" );
+        addLib( "Tracks", dataPath + "altium/pcblib/Tracks.pretty" );
+    }
+
+    ~FP_INFO_CACHE_FIXTURE()
+    {
+        fs::remove_all( m_dir );
+    }
+
+    /// Copy a library to the temporary directory, so it can be modified
+    void addLib( const std::string& aNickname, const std::string& aSource )
+    {
+        fs::path lib = m_dir / ( aNickname + ".pretty" );
+        fs::create_directories( lib );
+
+        for( const fs::directory_entry& entry : fs::directory_iterator( aSource ) )
+            fs::copy_file( entry.path(), lib / entry.path().filename() );
+
+        m_table.InsertRow( new FP_LIB_TABLE_ROW( aNickname, lib.string(), wxT( "KiCad" ),
+                                                 wxEmptyString ) );
+    }
+
+    std::string cacheFile() const { return ( m_dir / "fp-info-cache" ).string(); }
+
+    fs::path     m_dir;
+    FP_LIB_TABLE m_table;
+};
+
+
+static std::string readFile( const std::string& aPath )
+{
+    std::ifstream file( aPath, std::ios::binary );
+
+    return std::string( std::istreambuf_iterator<char>( file ), std::istreambuf_iterator<char>() );
+}
+
+
+static void writeFile( const std::string& aPath, const std::string& aContents )
+{
+    std::ofstream file( aPath, std::ios::binary | std::ios::trunc );
+    file << aContents;
+}
+
+
+static std::map<wxString, FOOTPRINT_INFO*> entries( const FOOTPRINT_LIST& aList )
+{
+    std::map<wxString, FOOTPRINT_INFO*> entries;
+
+    for( const std::unique_ptr<FOOTPRINT_INFO>& fpinfo : aList.GetList() )
+    {
+        wxString key = fpinfo->GetLibNickname() + wxT( ":" ) + fpinfo->GetFootprintName();
+        entries[ key ] = fpinfo.get();
+    }
+
+    return entries;
+}
+
+
+BOOST_FIXTURE_TEST_SUITE( FootprintInfoCache, FP_INFO_CACHE_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+    FOOTPRINT_LIST_IMPL list;
+
+    BOOST_REQUIRE( list.ReadFootprintFiles( &m_table ) );
+    BOOST_REQUIRE_GT( list.GetCount(), 0 );
+
+    list.WriteCacheToFile( cacheFile() );
+
+    FOOTPRINT_LIST_IMPL cached;
+    cached.ReadCacheFromFile( cacheFile() );
+
+    std::map<wxString, FOOTPRINT_INFO*> expected = entries( list );
+    std::map<wxString, FOOTPRINT_INFO*> read = entries( cached );
+
+    BOOST_REQUIRE_EQUAL( read.size(), expected.size() );
+
+    for( const std::pair<const wxString, FOOTPRINT_INFO*>& entry : expected )
+    {
+        BOOST_TEST_CONTEXT( entry.first )
+        {
+            BOOST_REQUIRE( read.count( entry.first ) );
+
+            FOOTPRINT_INFO* fpinfo = read[ entry.first ];
+
+            BOOST_CHECK_EQUAL( fpinfo->GetDescription(), entry.second->GetDescription() );
+            BOOST_CHECK_EQUAL( fpinfo->GetKeywords(), entry.second->GetKeywords() );
+            BOOST_CHECK_EQUAL( fpinfo->GetOrderNum(), entry.second->GetOrderNum() );
+            BOOST_CHECK_EQUAL( fpinfo->GetPadCount(), entry.second->GetPadCount() );
+            BOOST_CHECK_EQUAL( fpinfo->GetUniquePadCount(),
+                               entry.second->GetUniquePadCount() );
+        }
+    }
+
+    // The libraries did not change: the cached entries are kept as they are
+    BOOST_CHECK( cached.ReadFootprintFiles( &m_table ) );
+    BOOST_CHECK( entries( cached ) == read );
+}
+
+
+BOOST_AUTO_TEST_CASE( TruncatedFile )
+{
+    FOOTPRINT_LIST_IMPL list;
+
+    BOOST_REQUIRE( list.ReadFootprintFiles( &m_table ) );
+    list.WriteCacheToFile( cacheFile() );
+
+    std::string contents = readFile( cacheFile() );
+    std::string truncatedFile = ( m_dir / "truncated" ).string();
+
+    BOOST_REQUIRE( !contents.empty() );
+
+    for( size_t size = 0; size < contents.size(); size++ )
+    {
+        BOOST_TEST_CONTEXT( "Size " << size )
+        {
+            writeFile( truncatedFile, contents.substr( 0, size ) );
+
+            FOOTPRINT_LIST_IMPL cached;
+            cached.ReadCacheFromFile( truncatedFile );
+
+            BOOST_CHECK_EQUAL( cached.GetCount(), 0 );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( CorruptFile )
+{
+    FOOTPRINT_LIST_IMPL list;
+
+    BOOST_REQUIRE( list.ReadFootprintFiles( &m_table ) );
+    list.WriteCacheToFile( cacheFile() );
+
+    std::string contents = readFile( cacheFile() );
+    std::string corruptFile = ( m_dir / "corrupt" ).string();
+
+    // The magic number, the version, and the library count (which makes the reading run
+    // past the end of the file)
+    for( size_t offset : { 0, 4, 8 } )
+    {
+        BOOST_TEST_CONTEXT( "Offset " << offset )
+        {
+            std::string corrupt = contents;
+            corrupt[offset] ^= 0x5A;
+            writeFile( corruptFile, corrupt );
+
+            FOOTPRINT_LIST_IMPL cached;
+            cached.ReadCacheFromFile( corruptFile );
+
+            BOOST_CHECK_EQUAL( cached.GetCount(), 0 );
+        }
+    }
+
+    // An old text cache is ignored
+    writeFile( corruptFile, "1234567890\nGPS\nANT-GPS-2X7MM\n\n\n1\n2\n2\n" );
+
+    FOOTPRINT_LIST_IMPL cached;
+    cached.ReadCacheFromFile( corruptFile );
+
+    BOOST_CHECK_EQUAL( cached.GetCount(), 0 );
+}
+
+
+BOOST_AUTO_TEST_CASE( ReloadChangedLibrariesOnly )
+{
+    FOOTPRINT_LIST_IMPL list;
+
+    BOOST_REQUIRE( list.ReadFootprintFiles( &m_table ) );
+
+    std::map<wxString, FOOTPRINT_INFO*> before = entries( list );
+    size_t                              tracksCount = 0;
+
+    for( const std::pair<const wxString, FOOTPRINT_INFO*>& entry : before )
+    {
+        if( entry.second->GetLibNickname() == wxT( "Tracks" ) )
+            tracksCount++;
+    }
+
+    // Add a footprint to the Tracks library only
+    fs::path tracks = m_dir / "Tracks.pretty";
+    fs::copy_file( tracks / "WIDTHS.kicad_mod", tracks / "WIDTHS_COPY.kicad_mod" );
+
+    BOOST_REQUIRE( list.ReadFootprintFiles( &m_table ) );
+
+    std::map<wxString, FOOTPRINT_INFO*> after = entries( list );
+
+    BOOST_CHECK_EQUAL( after.size(), before.size() + 1 );
+    BOOST_CHECK( after.count( wxT( "Tracks:WIDTHS_COPY" ) ) );
+
+    size_t reloadedTracks = 0;
+
+    for( const std::pair<const wxString, FOOTPRINT_INFO*>& entry : after )
+    {
+        BOOST_TEST_CONTEXT( entry.first )
+        {
+            if( entry.second->GetLibNickname() == wxT( "GPS" ) )
+            {
+                // The entries of the unchanged library are kept as they are
+                BOOST_CHECK( before.count( entry.first ) && before[ entry.first ] == entry.second );
+            }
+            else
+            {
+                reloadedTracks++;
+            }
+        }
+    }
+
+    BOOST_CHECK_EQUAL( reloadedTracks, tracksCount + 1 );
+
+    // The list is sorted again after the reload
+    for( size_t ii = 1; ii < list.GetCount(); ii++ )
+        BOOST_CHECK( !( list.GetItem( ii ) < list.GetItem( ii - 1 ) ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,238 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the raytracer instances of the 3D model meshes: an instance must be hit as
+ * the mesh transformed to the world coordinates is.
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <3d_rendering/raytracing/accelerators/bvh_pbrt.h>
+#include <3d_rendering/raytracing/accelerators/container_3d.h>
+#include <3d_rendering/raytracing/shapes3D/model_instance_3d.h>
+#include <3d_rendering/raytracing/shapes3D/triangle_3d.h>
+
+#include <glm/glm.hpp>
+#include <glm/ext.hpp>
+
+#include <limits>
+#include <memory>
+#include <utility>
+
+
+/**
+ * An octahedron centered on the origin, in model coordinates, and the same octahedron
+ * transformed by a model matrix, in world coordinates.
+ */
+struct INSTANCE_FIXTURE
+{
+    /**
+     * @param aSmooth uses the vertex normals of a sphere instead of the face normals; they
+     *                are only transformed exactly by a similarity.
+     */
+    void build( const glm::mat4& aModelMatrix, bool aSmooth )
+    {
+        const SFVEC3F   vertices[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1.5f, 0 },
+                                        { 0, -1.5f, 0 }, { 0, 0, 0.75f }, { 0, 0, -0.75f } };
+        const glm::mat3 normalMatrix = glm::transpose( glm::inverse( glm::mat3( aModelMatrix ) ) );
+
+        auto toWorld =
+                [&]( const SFVEC3F& aPoint )
+                {
+                    return SFVEC3F( aModelMatrix * glm::vec4( aPoint, 1.0f ) );
+                };
+
+        for( int face = 0; face < 8; ++face )
+        {
+            SFVEC3F v[3] = { vertices[( face & 1 ) ? 1 : 0], vertices[( face & 2 ) ? 3 : 2],
+                             vertices[( face & 4 ) ? 5 : 4] };
+
+            // The triangles are culled when hit from the side opposite to their normal
+            if( glm::dot( glm::cross( v[2] - v[0], v[1] - v[0] ), v[0] + v[1] + v[2] ) < 0.0f )
+                std::swap( v[1], v[2] );
+
+            if( aSmooth )
+            {
+                SFVEC3F n[3];
+                SFVEC3F worldN[3];
+
+                for( int i = 0; i < 3; ++i )
+                {
+                    n[i] = glm::normalize( v[i] );
+                    worldN[i] = glm::normalize( normalMatrix * n[i] );
+                }
+
+                m_modelTriangles.Add( new TRIANGLE( v[0], v[1], v[2], n[0], n[1], n[2] ) );
+                m_worldTriangles.Add( new TRIANGLE( toWorld( v[0] ), toWorld( v[1] ),
+                                                    toWorld( v[2] ), worldN[0], worldN[1],
+                                                    worldN[2] ) );
+            }
+            else
+            {
+                m_modelTriangles.Add( new TRIANGLE( v[0], v[1], v[2] ) );
+                m_worldTriangles.Add( new TRIANGLE( toWorld( v[0] ), toWorld( v[1] ),
+                                                    toWorld( v[2] ) ) );
+            }
+        }
+
+        m_accelerator = std::make_unique<BVH_PBRT>( m_modelTriangles, 8, SPLITMETHOD::MIDDLE );
+        m_instance = std::make_unique<MODEL_INSTANCE_3D>( m_accelerator.get(),
+                                                          m_modelTriangles.GetBBox(),
+                                                          aModelMatrix );
+        m_modelMatrix = aModelMatrix;
+        m_center = toWorld( SFVEC3F( 0.0f ) );
+    }
+
+    /**
+     * Cast rays from points around the octahedron towards points inside it, which hit it,
+     * and away from it, which miss it, and compare the instance hits to the world mesh hits.
+     */
+    void checkRays()
+    {
+        for( int i = 0; i < 24; ++i )
+        {
+            const float   theta = 0.3f + i * 0.7f;
+            const float   phi = -1.2f + i * 0.1f;
+            const SFVEC3F origin = m_center + 8.0f * SFVEC3F( cos( theta ) * cos( phi ),
+                                                              sin( theta ) * cos( phi ),
+                                                              sin( phi ) );
+
+            for( int j = 0; j < 16; ++j )
+            {
+                const SFVEC3F modelTarget( 0.15f * ( j % 4 ) - 0.2f, 0.2f * ( j / 4 ) - 0.3f,
+                                           0.04f * j - 0.3f );
+                const SFVEC3F target = SFVEC3F( m_modelMatrix * glm::vec4( modelTarget, 1.0f ) );
+
+                RAY ray;
+                ray.Init( origin, glm::normalize( target - origin ) );
+
+                BOOST_TEST_CONTEXT( "Ray " << i << ", " << j << " towards the mesh" )
+                {
+                    BOOST_CHECK( checkRay( ray ) );
+                }
+
+                ray.Init( origin, glm::normalize( origin - target ) );
+
+                BOOST_TEST_CONTEXT( "Ray " << i << ", " << j << " away from the mesh" )
+                {
+                    BOOST_CHECK( !checkRay( ray ) );
+                }
+            }
+        }
+    }
+
+    /// @return true if the ray hits the mesh.
+    bool checkRay( const RAY& aRay )
+    {
+        HITINFO expected = newHitInfo();
+        HITINFO actual = newHitInfo();
+
+        const bool expectedHit = m_worldTriangles.Intersect( aRay, expected );
+
+        BOOST_CHECK_EQUAL( m_instance->Intersect( aRay, actual ), expectedHit );
+
+        if( !expectedHit )
+        {
+            BOOST_CHECK( !m_instance->IntersectP( aRay, std::numeric_limits<float>::max() ) );
+            return false;
+        }
+
+        BOOST_CHECK_CLOSE( actual.m_tHit, expected.m_tHit, 1e-3 );
+        BOOST_CHECK_LT( glm::distance( actual.m_HitPoint, expected.m_HitPoint ), 1e-4f );
+        BOOST_CHECK_GT( glm::dot( actual.m_HitNormal, expected.m_HitNormal ), 0.9999f );
+        BOOST_CHECK_CLOSE( glm::length( actual.m_HitNormal ), 1.0f, 1e-3 );
+        BOOST_CHECK( actual.pHitObject == m_instance.get() );
+
+        // A closer hit is kept
+        HITINFO closer = newHitInfo();
+        closer.m_tHit = expected.m_tHit * 0.99f;
+
+        BOOST_CHECK( !m_instance->Intersect( aRay, closer ) );
+        BOOST_CHECK_EQUAL( closer.m_tHit, expected.m_tHit * 0.99f );
+
+        // The shadow rays are tested against the world distance
+        BOOST_CHECK( m_instance->IntersectP( aRay, expected.m_tHit * 1.01f ) );
+        BOOST_CHECK( !m_instance->IntersectP( aRay, expected.m_tHit * 0.99f ) );
+
+        // The instance box contains the mesh
+        BOOST_CHECK( m_instance->GetBBox().Inside( expected.m_HitPoint ) );
+
+        return true;
+    }
+
+    static HITINFO newHitInfo()
+    {
+        HITINFO hitInfo;
+
+        hitInfo.m_tHit = std::numeric_limits<float>::infinity();
+        hitInfo.m_acc_node_info = 0;
+        hitInfo.pHitObject = nullptr;
+
+        return hitInfo;
+    }
+
+    CONTAINER_3D                       m_modelTriangles;
+    CONTAINER_3D                       m_worldTriangles;
+    std::unique_ptr<BVH_PBRT>          m_accelerator;
+    std::unique_ptr<MODEL_INSTANCE_3D> m_instance;
+    glm::mat4                          m_modelMatrix;
+    SFVEC3F                            m_center;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ModelInstance3D, INSTANCE_FIXTURE )
+
+
+/**
+ * A placement rotated, scaled and translated, as the footprints place their models
+ */
+BOOST_AUTO_TEST_CASE( Similarity )
+{
+    glm::mat4 matrix = glm::translate( glm::mat4( 1.0f ), glm::vec3( 12.5f, -3.0f, 1.6f ) );
+    matrix = glm::rotate( matrix, 0.7f, glm::vec3( 0.0f, 0.0f, 1.0f ) );
+    matrix = glm::rotate( matrix, 0.3f, glm::vec3( 1.0f, 0.0f, 0.0f ) );
+    matrix = glm::scale( matrix, glm::vec3( 2.5f ) );
+
+    build( matrix, true );
+    checkRays();
+}
+
+
+/**
+ * A placement with a different scale on each axis, which does not keep the angles: the
+ * normals must be transformed by the inverse transpose of the model matrix.
+ */
+BOOST_AUTO_TEST_CASE( NonUniformScale )
+{
+    glm::mat4 matrix = glm::translate( glm::mat4( 1.0f ), glm::vec3( -4.0f, 7.0f, -1.6f ) );
+    matrix = glm::rotate( matrix, -1.1f, glm::vec3( 0.0f, 1.0f, 0.0f ) );
+    matrix = glm::scale( matrix, glm::vec3( 0.5f, 3.0f, 1.5f ) );
+
+    build( matrix, false );
+    checkRays();
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,124 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+#include <pcbnew_utils/board_test_utils.h>
+#include <boost/filesystem.hpp>
+#include <board.h>
+#include <pcbplot.h>
+#include <settings/settings_manager.h>
+
+#include <fstream>
+#include <iterator>
+
+
+struct PLOT_BATCH_TEST_FIXTURE
+{
+    PLOT_BATCH_TEST_FIXTURE() :
+            m_settingsManager( true /* headless */ )
+    { }
+
+    SETTINGS_MANAGER       m_settingsManager;
+    std::unique_ptr<BOARD> m_board;
+};
+
+
+static std::string readFile( const std::string& aPath )
+{
+    std::ifstream file( aPath, std::ios::binary );
+
+    return std::string( std::istreambuf_iterator<char>( file ), std::istreambuf_iterator<char>() );
+}
+
+
+/**
+ * Plot the same layers sequentially and concurrently, and check the files are the same.  The
+ * formats used do not write the creation date in the files.
+ */
+BOOST_FIXTURE_TEST_CASE( PlotBatchParallelMatchesSequential, PLOT_BATCH_TEST_FIXTURE )
+{
+    KI_TEST::LoadBoard( m_settingsManager, "complex_hierarchy", m_board );
+
+    const LSEQ layers = { F_Cu, B_Cu, F_SilkS, B_SilkS, F_Mask, F_Fab, Edge_Cuts };
+
+    // The edges are plotted on all the layers, so the footprint texts and shapes are plotted
+    // by several files at the same time
+    const LSEQ plotOnAllLayers = { Edge_Cuts, F_SilkS };
+
+    boost::filesystem::path outputDir = boost::filesystem::temp_directory_path()
+                                        / "plot_batch_tst";
+
+    for( PLOT_FORMAT format : { PLOT_FORMAT::SVG, PLOT_FORMAT::DXF } )
+    {
+        PCB_PLOT_PARAMS plotOpts;
+
+        plotOpts.SetFormat( format );
+        plotOpts.SetColorSettings( m_settingsManager.GetColorSettings() );
+
+        std::vector<PLOT_BATCH_JOB> jobs[2];
+
+        for( int pass = 0; pass < 2; pass++ )
+        {
+            boost::filesystem::path dir = outputDir / ( pass ? "parallel" : "sequential" );
+            boost::filesystem::create_directories( dir );
+
+            for( PCB_LAYER_ID layer : layers )
+            {
+                LSEQ sequence = { layer };
+
+                for( PCB_LAYER_ID extra : plotOnAllLayers )
+                {
+                    if( extra != layer )
+                        sequence.push_back( extra );
+                }
+
+                wxString name = m_board->GetLayerName( layer );
+                name.Replace( wxT( "." ), wxT( "_" ) );
+
+                boost::filesystem::path file = dir / name.ToStdString();
+                jobs[pass].emplace_back( layer, sequence, file.string() );
+            }
+
+            int plotted = PlotBoardBatch( m_board.get(), plotOpts, jobs[pass], pass == 1 );
+
+            BOOST_CHECK_EQUAL( plotted, (int) layers.size() );
+        }
+
+        for( size_t ii = 0; ii < layers.size(); ii++ )
+        {
+            BOOST_TEST_CONTEXT( "Layer " << m_board->GetLayerName( layers[ii] ) )
+            {
+                BOOST_CHECK( jobs[0][ii].m_Success );
+                BOOST_CHECK( jobs[1][ii].m_Success );
+
+                std::string sequential = readFile( jobs[0][ii].m_FullFileName.ToStdString() );
+                std::string parallel = readFile( jobs[1][ii].m_FullFileName.ToStdString() );
+
+                BOOST_CHECK( !sequential.empty() );
+                BOOST_CHECK( sequential == parallel );
+            }
+        }
+    }
+
+    boost::filesystem::remove_all( outputDir );
+}
@@ -233,3 +233,51 @@ BOOST_FIXTURE_TEST_CASE( RegressionZoneFillTests, ZONE_FILL_TEST_FIXTURE )
     }
 }
 
+
+
+BOOST_FIXTURE_TEST_CASE( ZoneFillLevelsOfDetail, ZONE_FILL_TEST_FIXTURE )
+{
+    KI_TEST::LoadBoard( m_settingsManager, "zone_filler", m_board );
+
+    KI_TEST::FillZones( m_board.get() );
+
+    const int maxError = pcbIUScale.mmToIU( 0.2 );
+
+    for( ZONE* zone : m_board->Zones() )
+    {
+        for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
+        {
+            const SHAPE_POLY_SET& fill = *zone->GetFilledPolysList( layer );
+
+            // The filling itself is drawn below the finest tolerance
+            BOOST_CHECK( &zone->GetFilledPolysLOD( layer, 0.0 ) == &fill );
+
+            const SHAPE_POLY_SET& lod = zone->GetFilledPolysLOD( layer, maxError );
+
+            // The simplified polygons are cached
+            BOOST_CHECK( &zone->GetFilledPolysLOD( layer, maxError ) == &lod );
+
+            BOOST_REQUIRE_EQUAL( lod.OutlineCount(), fill.OutlineCount() );
+            BOOST_CHECK_LE( lod.TotalVertices(), fill.TotalVertices() );
+
+            // No vertex of the filling is further than the tolerance from the simplified outline
+            for( int ii = 0; ii < fill.OutlineCount(); ++ii )
+            {
+                const SHAPE_LINE_CHAIN& outline = fill.COutline( ii );
+
+                for( int jj = 0; jj < outline.PointCount(); ++jj )
+                    BOOST_CHECK_LE( lod.COutline( ii ).Distance( outline.CPoint( jj ), true ),
+                                    maxError );
+            }
+
+            // The simplified polygons follow the changes made in place, as the island removal does
+            if( fill.OutlineCount() > 0 )
+            {
+                zone->GetFilledPolysList( layer )->DeletePolygonAndTriangulationData( 0, false );
+
+                BOOST_CHECK_EQUAL( zone->GetFilledPolysLOD( layer, maxError ).OutlineCount(),
+                                   fill.OutlineCount() );
+            }
+        }
+    }
+}
@@ -60,6 +60,7 @@
 #include <iterator>
 #include <limits>
 #include <queue>
+#include <utility>
 #include <vector>
 
 #ifdef DEBUG
@@ -212,6 +213,13 @@ public:
     /// Remove all entries from tree
     void    RemoveAll();
 
+    /// Remove all entries from tree and build it again from a set of entries, packed in full
+    /// nodes with the Sort-Tile-Recursive algorithm.  This is much faster than inserting the
+    /// entries one at a time, and the nodes overlap less so the tree is faster to search.
+    /// Insert() and Remove() can be used on the tree as usual afterwards.
+    /// \param a_entries Bounding rects and data of the entries.  The vector is not modified.
+    void    BulkLoad( const std::vector<std::pair<Rect, DATATYPE>>& a_entries );
+
     /// Count the data elements in this container.  This is slow as no internal counter is maintained.
     int     Count() const;
 
@@ -603,6 +611,8 @@ protected:
         return true; // Continue searching
     }
 
+    void    PackBranches( std::vector<Branch>& a_branches, size_t a_first, size_t a_last,
+                          int a_axis, int a_level, std::vector<Branch>& a_parents ) const;
     void    RemoveAllRec( Node* a_node ) const;
     void    Reset() const;
     void    CountRec( const Node* a_node, int& a_count ) const;
@@ -1126,6 +1136,103 @@ void RTREE_QUAL::RemoveAll()
 }
 
 
+RTREE_TEMPLATE
+void RTREE_QUAL::BulkLoad( const std::vector<std::pair<Rect, DATATYPE>>& a_entries )
+{
+    RemoveAll();
+
+    std::vector<Branch> branches( a_entries.size() );
+
+    for( size_t index = 0; index < a_entries.size(); ++index )
+    {
+        branches[index].m_rect = a_entries[index].first;
+        branches[index].m_data = a_entries[index].second;
+    }
+
+    // Pack the branches of each level in nodes, bottom up, until they fit in the root
+    int level = 0;
+
+    while( branches.size() > MAXNODES )
+    {
+        std::vector<Branch> parents;
+        parents.reserve( branches.size() / MINNODES + 1 );
+
+        PackBranches( branches, 0, branches.size(), 0, level, parents );
+
+        branches.swap( parents );
+        ++level;
+    }
+
+    m_root->m_level = level;
+
+    for( const Branch& branch : branches )
+        m_root->m_branch[m_root->m_count++] = branch;
+}
+
+
+// Sort-Tile-Recursive packing of the branches [a_first, a_last) of a level in new nodes.
+// The branches are sorted on the center of their rects along a_axis and cut in slabs, each
+// slab being sorted and cut along the next axis in turn.  The slabs of the last axis are
+// cut in runs of nodes of even sizes, so that no node is less than half full.
+RTREE_TEMPLATE
+void RTREE_QUAL::PackBranches( std::vector<Branch>& a_branches, size_t a_first, size_t a_last,
+                               int a_axis, int a_level, std::vector<Branch>& a_parents ) const
+{
+    auto center =
+            [a_axis]( const Branch& aBranch ) -> ELEMTYPEREAL
+            {
+                // Sum rather than average, it cannot overflow as a real
+                return (ELEMTYPEREAL) aBranch.m_rect.m_min[a_axis]
+                       + (ELEMTYPEREAL) aBranch.m_rect.m_max[a_axis];
+            };
+
+    std::sort( a_branches.begin() + a_first, a_branches.begin() + a_last,
+               [&center]( const Branch& aA, const Branch& aB )
+               {
+                   return center( aA ) < center( aB );
+               } );
+
+    const size_t count = a_last - a_first;
+    const size_t nodeCount = ( count + MAXNODES - 1 ) / MAXNODES;
+
+    if( a_axis == NUMDIMS - 1 )
+    {
+        for( size_t node = 0; node < nodeCount; ++node )
+        {
+            size_t first = a_first + count * node / nodeCount;
+            size_t last = a_first + count * ( node + 1 ) / nodeCount;
+
+            Node* newNode = AllocNode();
+            newNode->m_level = a_level;
+
+            for( size_t index = first; index < last; ++index )
+                newNode->m_branch[newNode->m_count++] = a_branches[index];
+
+            Branch branch;
+            branch.m_rect = NodeCover( newNode );
+            branch.m_child = newNode;
+            a_parents.push_back( branch );
+        }
+
+        return;
+    }
+
+    // Slab count for about as many nodes along each remaining axis
+    size_t slabCount = (size_t) std::ceil( std::pow( (double) nodeCount,
+                                                     1.0 / ( NUMDIMS - a_axis ) ) );
+    slabCount = std::max<size_t>( 1, std::min( slabCount, nodeCount ) );
+
+    for( size_t slab = 0; slab < slabCount; ++slab )
+    {
+        size_t first = a_first + count * slab / slabCount;
+        size_t last = a_first + count * ( slab + 1 ) / slabCount;
+
+        if( first < last )
+            PackBranches( a_branches, first, last, a_axis + 1, a_level, a_parents );
+    }
+}
+
+
 RTREE_TEMPLATE
 void RTREE_QUAL::Reset() const
 {
@@ -48,12 +48,22 @@
 // minimum sides to a circle
 #define MIN_NSIDES 6
 
-static void FormatDoublet( double x, double y, int precision, std::string& strx, std::string& stry )
+// Formatting stream reused by all the numbers, creating a stream for each one is slow
+static std::ostringstream& formatStream( int precision )
 {
-    std::ostringstream ostr;
+    thread_local std::ostringstream ostr;
 
+    ostr.str( "" );
     ostr << std::fixed << std::setprecision( precision );
 
+    return ostr;
+}
+
+
+static void FormatDoublet( double x, double y, int precision, std::string& strx, std::string& stry )
+{
+    std::ostringstream& ostr = formatStream( precision );
+
     ostr << x;
     strx = ostr.str();
 
@@ -71,9 +81,7 @@ static void FormatDoublet( double x, double y, int precision, std::string& strx,
 
 static void FormatSinglet( double x, int precision, std::string& strx )
 {
-    std::ostringstream ostr;
-
-    ostr << std::fixed << std::setprecision( precision );
+    std::ostringstream& ostr = formatStream( precision );
 
     ostr << x;
     strx = ostr.str();
@@ -750,6 +758,32 @@ bool VRML_LAYER::AddArc( double aCenterX, double aCenterY, double aStartX, doubl
 }
 
 
+bool VRML_LAYER::AppendContours( const VRML_LAYER& aLayer )
+{
+    if( fix )
+    {
+        error = "AppendContours(): no more contours may be added (Tesselate was previously "
+                "executed)";
+        return false;
+    }
+
+    for( unsigned int i = 0; i < aLayer.contours.size(); ++i )
+    {
+        int contour = NewContour( aLayer.pth[i] );
+
+        for( int vertexIdx : *aLayer.contours[i] )
+        {
+            const VERTEX_3D* vertex = aLayer.vertices[vertexIdx];
+
+            if( !AddVertex( contour, vertex->x, vertex->y ) )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
 bool VRML_LAYER::Tesselate( VRML_LAYER* holes, bool aHolesOnly )
 {
     if( !tess )
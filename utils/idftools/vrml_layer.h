@@ -251,6 +251,17 @@ public:
     bool AddPolygon( const std::vector< wxRealPoint >& aPolySet, double aCenterX, double aCenterY,
                      double aAngle );
 
+    /**
+     * Append a copy of the contours of another layer to the list of contours.
+     *
+     * The tesselation renumbers the vertices of the holes object, so layers which are
+     * tesselated concurrently must each use their own copy of the holes.
+     *
+     * @param aLayer is the layer to copy the contours from; it must not be tesselated.
+     * @return true if the contours were successfully copied.
+     */
+    bool AppendContours( const VRML_LAYER& aLayer );
+
     /**
      * Create a list of outline vertices as well as the vertex sets required to render the surface.
      *
@@ -34,6 +34,7 @@
 #include <wx/wxcrtvararg.h>
 
 #include <memory>
+#include <set>
 #include <string>
 
 #include <wx_filename.h>
@@ -97,16 +98,53 @@ bool KICADPCB::ReadFile( const wxString& aFileName )
     try
     {
         SEXPR::PARSER parser;
-        std::string infile( fname.GetFullPath().ToUTF8() );
-        std::unique_ptr<SEXPR::SEXPR> data( parser.ParseFromFile( infile ) );
-
-        if( !data )
+        std::string   infile( fname.GetFullPath().ToUTF8() );
+        size_t        count = 0;
+        bool          result = true;
+
+        // The board is read one top level element at a time, and the elements which do not
+        // contribute to the model (tracks, vias, zones...) are skipped without being built.
+        auto handler =
+                [&]( std::unique_ptr<SEXPR::SEXPR> aElement ) -> bool
+                {
+                    if( count++ == 0 )
+                    {
+                        if( aElement->IsSymbol() )
+                            return true;
+
+                        ReportMessage( wxString::Format( wxT( "data is not a valid PCB "
+                                                              "file: %s\n" ),
+                                                         m_filename ) );
+                        result = false;
+                    }
+                    else
+                    {
+                        result = parseElement( aElement.get() );
+                    }
+
+                    return result;
+                };
+
+        auto filter =
+                []( const std::string& aSymbol ) -> bool
+                {
+                    static const std::set<std::string> needed = {
+                        "general", "setup", "layers", "module", "footprint", "gr_arc",
+                        "gr_line", "gr_rect", "gr_poly", "gr_circle", "gr_curve"
+                    };
+
+                    return needed.count( aSymbol ) > 0;
+                };
+
+        parser.ParseListFromFile( infile, handler, filter );
+
+        if( count == 0 )
         {
             ReportMessage( wxString::Format( wxT( "No data in file: %s\n" ), aFileName ) );
             return false;
         }
 
-        if( !parsePCB( data.get() ) )
+        if( !result )
             return false;
     }
     catch( std::exception& e )
@@ -147,61 +185,41 @@ bool KICADPCB::WriteIGES( const wxString& aFileName )
 #endif
 
 
-bool KICADPCB::parsePCB( SEXPR::SEXPR* data )
+bool KICADPCB::parseElement( SEXPR::SEXPR* data )
 {
-    if( nullptr == data )
-        return false;
-
-    if( data->IsList() )
+    if( !data->IsList() )
     {
-        size_t nc = data->GetNumberOfChildren();
-        SEXPR::SEXPR* child = data->GetChild( 0 );
-        std::string name = child->GetSymbol();
-
-        bool result = true;
-
-        for( size_t i = 1; i < nc && result; ++i )
-        {
-            child = data->GetChild( i );
-
-            if( !child->IsList() )
-            {
-                ReportMessage( wxString::Format( wxT( "corrupt PCB file (line %d)\n" ),
-                                                 child->GetLineNumber() ) );
-                return false;
-            }
-
-            std::string symname( child->GetChild( 0 )->GetSymbol() );
-
-            if( symname == "general" )
-                result = result && parseGeneral( child );
-            else if( symname == "setup" )
-                result = result && parseSetup( child );
-            else if( symname == "layers" )
-                result = result && parseLayers( child );
-            else if( symname == "module" )
-                result = result && parseModule( child );
-            else if( symname == "footprint" )
-                result = result && parseModule( child );
-            else if( symname == "gr_arc" )
-                result = result && parseCurve( child, CURVE_ARC );
-            else if( symname == "gr_line" )
-                result = result && parseCurve( child, CURVE_LINE );
-            else if( symname == "gr_rect" )
-                result = result && parseRect( child );
-            else if( symname == "gr_poly" )
-                result = result && parsePolygon( child );
-            else if( symname == "gr_circle" )
-                result = result && parseCurve( child, CURVE_CIRCLE );
-            else if( symname == "gr_curve" )
-                result = result && parseCurve( child, CURVE_BEZIER );
-        }
-
-        return result;
+        ReportMessage( wxString::Format( wxT( "corrupt PCB file (line %d)\n" ),
+                                         data->GetLineNumber() ) );
+        return false;
     }
 
-    ReportMessage( wxString::Format( wxT( "data is not a valid PCB file: %s\n" ), m_filename ) );
-    return false;
+    std::string symname( data->GetChild( 0 )->GetSymbol() );
+
+    if( symname == "general" )
+        return parseGeneral( data );
+    else if( symname == "setup" )
+        return parseSetup( data );
+    else if( symname == "layers" )
+        return parseLayers( data );
+    else if( symname == "module" )
+        return parseModule( data );
+    else if( symname == "footprint" )
+        return parseModule( data );
+    else if( symname == "gr_arc" )
+        return parseCurve( data, CURVE_ARC );
+    else if( symname == "gr_line" )
+        return parseCurve( data, CURVE_LINE );
+    else if( symname == "gr_rect" )
+        return parseRect( data );
+    else if( symname == "gr_poly" )
+        return parsePolygon( data );
+    else if( symname == "gr_circle" )
+        return parseCurve( data, CURVE_CIRCLE );
+    else if( symname == "gr_curve" )
+        return parseCurve( data, CURVE_BEZIER );
+
+    return true;
 }
 
 
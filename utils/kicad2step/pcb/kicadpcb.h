@@ -90,7 +90,8 @@ public:
 #endif
 
 private:
-    bool parsePCB( SEXPR::SEXPR* data );
+    /// Parse a top level element of the board file.
+    bool parseElement( SEXPR::SEXPR* data );
     bool parseGeneral( SEXPR::SEXPR* data );
     bool parseSetup( SEXPR::SEXPR* data );
     bool parseStackup( SEXPR::SEXPR* data );